@@ -61,6 +61,12 @@ APT_DECLARE(apt_task_vtable_t*) apt_consumer_task_vtable_get(const apt_consumer_
  */
 APT_DECLARE(void*) apt_consumer_task_object_get(const apt_consumer_task_t *task);
 
+/**
+ * Get the number of messages pending in the queue of consumer task.
+ * @param task the consumer task to get the queue size of
+ */
+APT_DECLARE(apr_size_t) apt_consumer_task_queue_size_get(const apt_consumer_task_t *task);
+
 /**
  * Create timer.
  * @param task the consumer task to create timer for
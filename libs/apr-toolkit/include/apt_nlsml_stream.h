@@ -0,0 +1,155 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifndef APT_NLSML_STREAM_H
+#define APT_NLSML_STREAM_H
+
+/**
+ * @file apt_nlsml_stream.h
+ * @brief Streaming NLSML Parser and Writer
+ * @remark Unlike nlsml_result_parse(), which builds an XML DOM tree first, the streaming parser
+ *         scans the document in a single pass and extracts interpretations, instances and inputs
+ *         directly into compact structures. Instance and input contents are not interpreted, but
+ *         referenced as raw XML slices of the parsed data, which therefore must outlive the result.
+ */
+
+#include "apt_string.h"
+
+APT_BEGIN_EXTERN_C
+
+/* Forward declarations */
+typedef struct nlsml_stream_result_t nlsml_stream_result_t;
+typedef struct nlsml_stream_interpretation_t nlsml_stream_interpretation_t;
+typedef struct nlsml_stream_input_t nlsml_stream_input_t;
+typedef struct nlsml_writer_t nlsml_writer_t;
+
+/** NLSML <input> element extracted by the streaming parser */
+struct nlsml_stream_input_t {
+	/** Raw content (inner XML) of the element */
+	apt_str_t content;
+	/** Input mode attribute [default: "speech"] */
+	apt_str_t mode;
+	/** Confidence attribute [default: 1.0] */
+	float     confidence;
+	/** Timestamp-start attribute */
+	apt_str_t timestamp_start;
+	/** Timestamp-end attribute */
+	apt_str_t timestamp_end;
+};
+
+/** NLSML <interpretation> element extracted by the streaming parser */
+struct nlsml_stream_interpretation_t {
+	/** Optional grammar attribute (raw) */
+	apt_str_t             grammar;
+	/** Confidence attribute [default: 1.0] */
+	float                 confidence;
+	/** Array of raw contents (inner XML) of the <instance> elements */
+	apt_str_t            *instances;
+	/** Number of instances */
+	apr_size_t            instance_count;
+	/** Input [0..1] */
+	nlsml_stream_input_t *input;
+};
+
+/** NLSML <result> element extracted by the streaming parser */
+struct nlsml_stream_result_t {
+	/** Optional grammar attribute (raw) */
+	apt_str_t                      grammar;
+	/** Array of interpretations */
+	nlsml_stream_interpretation_t *interpretations;
+	/** Number of interpretations */
+	apr_size_t                     interpretation_count;
+};
+
+/**
+ * Parse NLSML result in a single pass without building an XML tree.
+ * @param data the data to parse
+ * @param length the length of the data
+ * @param pool the memory pool to use
+ * @return the parsed NLSML result, referring to the data, or NULL if the data is not a valid NLSML result
+ * @remark Enrollment and verification results are skipped.
+ */
+APT_DECLARE(nlsml_stream_result_t*) nlsml_stream_result_parse(const char *data, apr_size_t length, apr_pool_t *pool);
+
+/**
+ * Get the plain text of raw XML content (attribute value, instance or input content).
+ * @param content the raw content to get the text of
+ * @param text the text to set
+ * @param pool the memory pool to use, if the content needs to be unescaped
+ * @remark Character and predefined entity references are replaced, CDATA sections are unwrapped,
+ *         other markup is kept as is. The content is referenced as is, if there is nothing to replace.
+ */
+APT_DECLARE(apt_bool_t) nlsml_stream_text_get(const apt_str_t *content, apt_str_t *text, apr_pool_t *pool);
+
+
+/**
+ * Create NLSML writer.
+ * @param size the initial size of the buffer to compose the document in
+ * @param pool the memory pool to use
+ */
+APT_DECLARE(nlsml_writer_t*) nlsml_writer_create(apr_size_t size, apr_pool_t *pool);
+
+/**
+ * Begin <result> element.
+ * @param writer the writer to use
+ * @param grammar the optional grammar attribute
+ * @remark The writer is reset, so that it can be reused to compose another document.
+ */
+APT_DECLARE(void) nlsml_writer_result_begin(nlsml_writer_t *writer, const char *grammar);
+
+/**
+ * Begin <interpretation> element.
+ * @param writer the writer to use
+ * @param grammar the optional grammar attribute
+ * @param confidence the confidence attribute in the range [0.0 ... 1.0]
+ */
+APT_DECLARE(void) nlsml_writer_interpretation_begin(nlsml_writer_t *writer, const char *grammar, float confidence);
+
+/**
+ * Add <instance> element.
+ * @param writer the writer to use
+ * @param content the content of the element
+ * @param escape whether to escape the content as plain text or to add it as is (XML)
+ */
+APT_DECLARE(void) nlsml_writer_instance_add(nlsml_writer_t *writer, const apt_str_t *content, apt_bool_t escape);
+
+/**
+ * Add <input> element.
+ * @param writer the writer to use
+ * @param mode the optional input mode attribute ("speech" or "dtmf")
+ * @param confidence the confidence attribute in the range [0.0 ... 1.0]
+ * @param content the content of the element to escape as plain text
+ */
+APT_DECLARE(void) nlsml_writer_input_add(nlsml_writer_t *writer, const char *mode, float confidence, const apt_str_t *content);
+
+/**
+ * End <interpretation> element.
+ * @param writer the writer to use
+ */
+APT_DECLARE(void) nlsml_writer_interpretation_end(nlsml_writer_t *writer);
+
+/**
+ * End <result> element and get the composed document.
+ * @param writer the writer to use
+ * @param document the document to set, valid until the writer is reset
+ */
+APT_DECLARE(apt_bool_t) nlsml_writer_result_end(nlsml_writer_t *writer, apt_str_t *document);
+
+APT_END_EXTERN_C
+
+#endif /* APT_NLSML_STREAM_H */
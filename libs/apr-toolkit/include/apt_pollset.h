@@ -29,7 +29,11 @@
  * and it is not available for APR-1.2 and APR-1.3 versions. Thus
  * apt_pollset_t is an extension of apr_pollset_t and provides
  * pollset wakeup capabilities the similar way as it's implemented
- * in APR-1.4 trunk
+ * in APR-1.4 trunk.
+ *
+ * If APT_POLLSET_EPOLL is defined at build time (Linux only), the
+ * pollset is implemented directly on top of epoll with eventfd based
+ * wakeup, otherwise APR pollset is used.
  */
 
 #include <apr_poll.h>
@@ -41,12 +45,27 @@ APT_BEGIN_EXTERN_C
 typedef struct apt_pollset_t apt_pollset_t;
 
 /**
- * Create interruptable pollset on top of APR pollset.
+ * Edge-triggered notification flag. Signalled descriptors must be
+ * non-blocking and read until EAGAIN. The flag is ignored, if the
+ * pollset is built on top of APR pollset (level-triggered only).
+ */
+#define APT_POLLSET_FLAG_EDGE_TRIGGERED 0x1
+
+/**
+ * Create interruptable pollset.
  * @param size the maximum number of descriptors pollset can hold
  * @param pool the pool to allocate memory from
  */
 APT_DECLARE(apt_pollset_t*) apt_pollset_create(apr_uint32_t size, apr_pool_t *pool);
 
+/**
+ * Create interruptable pollset with the specified flags.
+ * @param size the maximum number of descriptors pollset can hold
+ * @param flags the pollset flags (APT_POLLSET_FLAG_EDGE_TRIGGERED)
+ * @param pool the pool to allocate memory from
+ */
+APT_DECLARE(apt_pollset_t*) apt_pollset_create_ex(apr_uint32_t size, apr_uint32_t flags, apr_pool_t *pool);
+
 /**
  * Destroy pollset.
  * @param pollset the pollset to destroy
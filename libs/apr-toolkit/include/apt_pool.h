@@ -33,6 +33,28 @@
 
 APT_BEGIN_EXTERN_C
 
+/** Default max number of pools retained by the cache of recycled pools */
+#define APT_POOL_CACHE_MAX_COUNT     100
+/** Default max number of free bytes each pool retained by the cache may hold */
+#define APT_POOL_CACHE_MAX_FREE_SIZE (128 * 1024)
+
+/** Pool cache statistics declaration */
+typedef struct apt_pool_cache_stats_t apt_pool_cache_stats_t;
+
+/** Statistics of the cache of recycled pools */
+struct apt_pool_cache_stats_t {
+	/** Number of pools created from scratch */
+	apr_size_t create_count;
+	/** Number of pools reused from the cache */
+	apr_size_t reuse_count;
+	/** Number of pools currently retained in the cache */
+	apr_size_t retained_count;
+	/** Peak number of pools retained in the cache */
+	apr_size_t peak_retained_count;
+	/** Peak number of bytes the retained pools may hold (upper bound) */
+	apr_size_t peak_retained_size;
+};
+
 /**
  * Create APR pool
  */
@@ -44,6 +66,37 @@ APT_DECLARE(apr_pool_t*) apt_pool_create(void);
  */
 APT_DECLARE(apr_pool_t*) apt_subpool_create(apr_pool_t *parent);
 
+/**
+ * Create the process-wide cache of recycled pools
+ * @param max_count the max number of pools to retain
+ * @param max_free_size the max number of free bytes each retained pool may hold
+ * @remark The cache is reference counted, every successful call must be paired with apt_pool_cache_destroy()
+ */
+APT_DECLARE(apt_bool_t) apt_pool_cache_create(apr_size_t max_count, apr_size_t max_free_size);
+
+/**
+ * Destroy the process-wide cache of recycled pools
+ */
+APT_DECLARE(apt_bool_t) apt_pool_cache_destroy(void);
+
+/**
+ * Get statistics of the cache of recycled pools
+ * @param stats the statistics to fill
+ */
+APT_DECLARE(apt_bool_t) apt_pool_cache_stats_get(apt_pool_cache_stats_t *stats);
+
+/**
+ * Create APR pool taking it from the cache of recycled pools, if available
+ * @remark The pool must be released by apt_pool_recycle()
+ */
+APT_DECLARE(apr_pool_t*) apt_pool_recyclable_create(void);
+
+/**
+ * Release APR pool created by apt_pool_recyclable_create(), returning it to the cache, if possible
+ * @param pool the pool to release
+ */
+APT_DECLARE(void) apt_pool_recycle(apr_pool_t *pool);
+
 APT_END_EXTERN_C
 
 #endif /* APT_POOL_H */
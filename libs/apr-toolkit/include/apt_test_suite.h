@@ -58,6 +58,39 @@ APT_DECLARE(apt_test_suite_t*) apt_test_suite_create(apr_pool_t *pool, const cha
                                                      void *obj, apt_test_f tester);
 
 
+/** Opaque benchmark declaration */
+typedef struct apt_benchmark_t apt_benchmark_t;
+
+/** 
+ * Prototype of benchmark function, which performs one iteration of the measured operation.
+ * @remark Memory allocated per iteration must be taken from the specified pool, which is
+ *         periodically cleared by the framework and accounted for in bytes per iteration.
+ */
+typedef apt_bool_t (*apt_benchmark_f)(apt_benchmark_t *bench, apr_pool_t *pool);
+
+/** Benchmark measuring the cost of a single operation */
+struct apt_benchmark_t {
+	/** Memory pool to allocate objects used across iterations from */
+	apr_pool_t     *pool;
+	/** Unique name of the benchmark */
+	apt_str_t       name;
+	/** External object associated with the benchmark */
+	void           *obj;
+	/** Benchmark function to execute */
+	apt_benchmark_f runner;
+};
+
+/**
+ * Create benchmark.
+ * @param pool the pool to allocate memory from
+ * @param name the unique name of the benchmark
+ * @param obj the external object associated with the benchmark
+ * @param runner the benchmark function to execute
+ */
+APT_DECLARE(apt_benchmark_t*) apt_benchmark_create(apr_pool_t *pool, const char *name, 
+                                                   void *obj, apt_benchmark_f runner);
+
+
 
 
 
@@ -82,11 +115,22 @@ APT_DECLARE(void) apt_test_framework_destroy(apt_test_framework_t *framework);
  */
 APT_DECLARE(apt_bool_t) apt_test_framework_suite_add(apt_test_framework_t *framework, apt_test_suite_t *suite);
 
+/**
+ * Add benchmark to framework.
+ * @param framework the test framework to add benchmark to
+ * @param bench the benchmark to add
+ */
+APT_DECLARE(apt_bool_t) apt_test_framework_benchmark_add(apt_test_framework_t *framework, apt_benchmark_t *bench);
+
 /**
  * Run test suites.
  * @param framework the test framework
  * @param argc the number of arguments
  * @param argv the array of arguments
+ * @remark Run all the test suites, if no argument is specified, or the named one otherwise.
+ *         The argument "bench" runs the benchmarks instead, optionally followed by the name
+ *         of the benchmark to run, -t msec to set the duration of a measurement (500 by default)
+ *         and -c cpu to pin the thread to the specified CPU.
  */
 APT_DECLARE(apt_bool_t) apt_test_framework_run(apt_test_framework_t *framework, int argc, const char * const *argv);
 
@@ -62,6 +62,25 @@ APT_DECLARE(void*) apt_message_parser_object_get(apt_message_parser_t *parser);
 /** Set verbose mode for the parser */
 APT_DECLARE(void) apt_message_parser_verbose_set(apt_message_parser_t *parser, apt_bool_t verbose);
 
+/**
+ * Get the remaining (not yet received) part of the message body being parsed.
+ * @param parser the parser to get the body slice of
+ * @param buf the pointer to the slice to receive the body data into
+ * @param length the length of the slice
+ * @return TRUE if the parser awaits body data, FALSE otherwise
+ * @remark Allows to receive the body data directly into the message, bypassing the stream.
+ */
+APT_DECLARE(apt_bool_t) apt_message_parser_body_slice_get(apt_message_parser_t *parser, char **buf, apr_size_t *length);
+
+/**
+ * Advance the message body being parsed by the length of data received into the slice.
+ * @param parser the parser to advance
+ * @param length the length of received data
+ * @return TRUE if the body is complete, FALSE otherwise
+ * @remark Once the body is complete, run the parser to complete the message.
+ */
+APT_DECLARE(apt_bool_t) apt_message_parser_body_slice_advance(apt_message_parser_t *parser, apr_size_t length);
+
 
 /** Create message generator */
 APT_DECLARE(apt_message_generator_t*) apt_message_generator_create(void *obj, const apt_message_generator_vtable_t *vtable, apr_pool_t *pool);
@@ -79,6 +79,11 @@ APT_DECLARE(void*) apt_consumer_task_object_get(const apt_consumer_task_t *task)
 	return task->obj;
 }
 
+APT_DECLARE(apr_size_t) apt_consumer_task_queue_size_get(const apt_consumer_task_t *task)
+{
+	return apr_queue_size(task->msg_queue);
+}
+
 APT_DECLARE(apt_timer_t*) apt_consumer_task_timer_create(
 									apt_consumer_task_t *task, 
 									apt_timer_proc_f proc, 
@@ -0,0 +1,751 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <apr_tables.h>
+#include <apr_strings.h>
+#include "apt_nlsml_stream.h"
+#include "apt_log.h"
+
+/** Max length of a numeric attribute value */
+#define NLSML_NUMBER_MAX_LENGTH 31
+
+/** Append string literal to the document */
+#define NLSML_WRITER_LITERAL_APPEND(writer,literal) nlsml_writer_append(writer,literal,sizeof(literal)-1)
+
+/** Scanner of NLSML document */
+typedef struct nlsml_scanner_t nlsml_scanner_t;
+/** Tag of XML element */
+typedef struct nlsml_tag_t nlsml_tag_t;
+
+/** Scanner of NLSML document */
+struct nlsml_scanner_t {
+	/** Current position */
+	const char *pos;
+	/** End of the document */
+	const char *end;
+};
+
+/** Tag of XML element */
+struct nlsml_tag_t {
+	/** Beginning of the tag ('<') */
+	const char *begin;
+	/** Local name of the element (without namespace prefix) */
+	apt_str_t   name;
+	/** Beginning of the attributes */
+	const char *attrs;
+	/** End of the attributes */
+	const char *attrs_end;
+	/** Whether the tag is an end tag (</name>) */
+	apt_bool_t  closing;
+	/** Whether the tag is an empty element tag (<name/>) */
+	apt_bool_t  empty;
+};
+
+/** NLSML writer */
+struct nlsml_writer_t {
+	/** Pool to allocate memory from */
+	apr_pool_t *pool;
+	/** Buffer to compose the document in */
+	char       *buf;
+	/** Size of the buffer */
+	apr_size_t  size;
+	/** Length of the composed document */
+	apr_size_t  length;
+};
+
+
+static APR_INLINE apt_bool_t nlsml_is_space(char ch)
+{
+	return (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n') ? TRUE : FALSE;
+}
+
+/** Compare the name to the specified literal ignoring case */
+static APR_INLINE apt_bool_t nlsml_name_is(const apt_str_t *name, const char *literal, apr_size_t length)
+{
+	return (name->length == length && strncasecmp(name->buf,literal,length) == 0) ? TRUE : FALSE;
+}
+
+/** Find the token in the range */
+static const char* nlsml_token_find(const char *pos, const char *end, const char *token, apr_size_t length)
+{
+	while(pos + length <= end) {
+		pos = memchr(pos,*token,end - pos - length + 1);
+		if(!pos) {
+			return NULL;
+		}
+		if(memcmp(pos,token,length) == 0) {
+			return pos;
+		}
+		pos++;
+	}
+	return NULL;
+}
+
+/** Read the next start or end tag, skipping character data, comments, CDATA sections, PIs and declarations */
+static apt_bool_t nlsml_tag_next(nlsml_scanner_t *scanner, nlsml_tag_t *tag)
+{
+	const char *pos = scanner->pos;
+	const char *end = scanner->end;
+	const char *name;
+	const char *colon;
+	char quote;
+	while(pos < end) {
+		pos = memchr(pos,'<',end - pos);
+		if(!pos || pos + 1 >= end) {
+			break;
+		}
+
+		if(pos[1] == '?') {
+			/* processing instruction */
+			pos = nlsml_token_find(pos + 2,end,"?>",2);
+			if(!pos) {
+				break;
+			}
+			pos += 2;
+			continue;
+		}
+		if(pos[1] == '!') {
+			if(end - pos >= 4 && memcmp(pos,"<!--",4) == 0) {
+				pos = nlsml_token_find(pos + 4,end,"-->",3);
+				if(!pos) {
+					break;
+				}
+				pos += 3;
+			}
+			else if(end - pos >= 9 && memcmp(pos,"<![CDATA[",9) == 0) {
+				pos = nlsml_token_find(pos + 9,end,"]]>",3);
+				if(!pos) {
+					break;
+				}
+				pos += 3;
+			}
+			else {
+				/* document type and other declarations */
+				pos = memchr(pos,'>',end - pos);
+				if(!pos) {
+					break;
+				}
+				pos++;
+			}
+			continue;
+		}
+
+		tag->begin = pos++;
+		tag->closing = FALSE;
+		if(*pos == '/') {
+			tag->closing = TRUE;
+			pos++;
+		}
+
+		/* read the name, stripping the namespace prefix */
+		name = pos;
+		while(pos < end && *pos != '>' && *pos != '/' && nlsml_is_space(*pos) == FALSE) {
+			pos++;
+		}
+		if(pos >= end || pos == name) {
+			break;
+		}
+		colon = memchr(name,':',pos - name);
+		if(colon) {
+			name = colon + 1;
+		}
+		tag->name.buf = (char*)name;
+		tag->name.length = pos - name;
+
+		/* find the end of the tag, skipping quoted attribute values */
+		tag->attrs = pos;
+		quote = 0;
+		while(pos < end) {
+			if(quote) {
+				if(*pos == quote) {
+					quote = 0;
+				}
+			}
+			else if(*pos == '"' || *pos == '\'') {
+				quote = *pos;
+			}
+			else if(*pos == '>') {
+				break;
+			}
+			pos++;
+		}
+		if(pos >= end) {
+			break;
+		}
+
+		tag->empty = (pos > tag->attrs && *(pos - 1) == '/') ? TRUE : FALSE;
+		tag->attrs_end = tag->empty == TRUE ? pos - 1 : pos;
+		scanner->pos = pos + 1;
+		return TRUE;
+	}
+
+	scanner->pos = end;
+	return FALSE;
+}
+
+/** Read the next attribute of the tag */
+static apt_bool_t nlsml_attr_next(const char **attr_pos, const char *end, apt_str_t *name, apt_str_t *value)
+{
+	char quote;
+	const char *pos = *attr_pos;
+	while(pos < end && nlsml_is_space(*pos) == TRUE) {
+		pos++;
+	}
+	if(pos >= end) {
+		return FALSE;
+	}
+
+	name->buf = (char*)pos;
+	while(pos < end && *pos != '=' && nlsml_is_space(*pos) == FALSE) {
+		pos++;
+	}
+	name->length = pos - name->buf;
+
+	while(pos < end && nlsml_is_space(*pos) == TRUE) {
+		pos++;
+	}
+	if(pos >= end || *pos != '=') {
+		return FALSE;
+	}
+	pos++;
+	while(pos < end && nlsml_is_space(*pos) == TRUE) {
+		pos++;
+	}
+	if(pos >= end || (*pos != '"' && *pos != '\'')) {
+		return FALSE;
+	}
+
+	quote = *pos++;
+	value->buf = (char*)pos;
+	while(pos < end && *pos != quote) {
+		pos++;
+	}
+	if(pos >= end) {
+		return FALSE;
+	}
+	value->length = pos - value->buf;
+	*attr_pos = pos + 1;
+	return TRUE;
+}
+
+/** Scan the content of the element up to the matching end tag */
+static apt_bool_t nlsml_element_content_scan(nlsml_scanner_t *scanner, const nlsml_tag_t *start_tag, apt_str_t *content)
+{
+	nlsml_tag_t tag;
+	apr_size_t depth = 1;
+	content->buf = (char*)scanner->pos;
+	content->length = 0;
+	if(start_tag->empty == TRUE) {
+		return TRUE;
+	}
+
+	while(nlsml_tag_next(scanner,&tag) == TRUE) {
+		if(tag.closing == TRUE) {
+			if(--depth == 0) {
+				content->length = tag.begin - content->buf;
+				return TRUE;
+			}
+		}
+		else if(tag.empty == FALSE) {
+			depth++;
+		}
+	}
+	return FALSE;
+}
+
+/** Parse confidence value */
+static float nlsml_confidence_parse(const apt_str_t *value)
+{
+	char buf[NLSML_NUMBER_MAX_LENGTH + 1];
+	float confidence;
+	apr_size_t length = value->length;
+	if(length > NLSML_NUMBER_MAX_LENGTH) {
+		length = NLSML_NUMBER_MAX_LENGTH;
+	}
+	memcpy(buf,value->buf,length);
+	buf[length] = '\0';
+
+	confidence = (float) atof(buf);
+	if(confidence > 1.0)
+		confidence /= 100;
+
+	return confidence;
+}
+
+/** Parse <input> element */
+static nlsml_stream_input_t* nlsml_stream_input_parse(nlsml_scanner_t *scanner, const nlsml_tag_t *tag, apr_pool_t *pool)
+{
+	apt_str_t name;
+	apt_str_t value;
+	const char *attr_pos = tag->attrs;
+	nlsml_stream_input_t *input = apr_palloc(pool,sizeof(nlsml_stream_input_t));
+	apt_string_set(&input->mode,"speech");
+	input->confidence = 1.0;
+	apt_string_reset(&input->timestamp_start);
+	apt_string_reset(&input->timestamp_end);
+
+	while(nlsml_attr_next(&attr_pos,tag->attrs_end,&name,&value) == TRUE) {
+		if(nlsml_name_is(&name,"mode",4) == TRUE) {
+			input->mode = value;
+		}
+		else if(nlsml_name_is(&name,"confidence",10) == TRUE) {
+			input->confidence = nlsml_confidence_parse(&value);
+		}
+		else if(nlsml_name_is(&name,"timestamp-start",15) == TRUE) {
+			input->timestamp_start = value;
+		}
+		else if(nlsml_name_is(&name,"timestamp-end",13) == TRUE) {
+			input->timestamp_end = value;
+		}
+	}
+
+	if(nlsml_element_content_scan(scanner,tag,&input->content) == FALSE) {
+		return NULL;
+	}
+	return input;
+}
+
+/** Parse <interpretation> element */
+static apt_bool_t nlsml_stream_interpretation_parse(
+						nlsml_scanner_t *scanner,
+						const nlsml_tag_t *start_tag,
+						nlsml_stream_interpretation_t *interpretation,
+						apr_pool_t *pool)
+{
+	nlsml_tag_t tag;
+	apt_str_t name;
+	apt_str_t value;
+	apt_str_t *instance;
+	apr_array_header_t *instances = NULL;
+	const char *attr_pos = start_tag->attrs;
+
+	apt_string_reset(&interpretation->grammar);
+	interpretation->confidence = 1.0;
+	interpretation->instances = NULL;
+	interpretation->instance_count = 0;
+	interpretation->input = NULL;
+
+	/* find optional grammar and confidence attributes */
+	while(nlsml_attr_next(&attr_pos,start_tag->attrs_end,&name,&value) == TRUE) {
+		if(nlsml_name_is(&name,"grammar",7) == TRUE) {
+			interpretation->grammar = value;
+		}
+		else if(nlsml_name_is(&name,"confidence",10) == TRUE) {
+			interpretation->confidence = nlsml_confidence_parse(&value);
+		}
+	}
+
+	if(start_tag->empty == TRUE) {
+		return TRUE;
+	}
+
+	/* find input and instance elements */
+	while(nlsml_tag_next(scanner,&tag) == TRUE) {
+		if(tag.closing == TRUE) {
+			/* end of the interpretation */
+			if(instances) {
+				interpretation->instances = (apt_str_t*)instances->elts;
+				interpretation->instance_count = instances->nelts;
+			}
+			return TRUE;
+		}
+
+		if(nlsml_name_is(&tag.name,"instance",8) == TRUE) {
+			if(!instances) {
+				instances = apr_array_make(pool,1,sizeof(apt_str_t));
+			}
+			instance = apr_array_push(instances);
+			if(nlsml_element_content_scan(scanner,&tag,instance) == FALSE) {
+				return FALSE;
+			}
+		}
+		else if(nlsml_name_is(&tag.name,"input",5) == TRUE) {
+			interpretation->input = nlsml_stream_input_parse(scanner,&tag,pool);
+			if(!interpretation->input) {
+				return FALSE;
+			}
+		}
+		else if(nlsml_element_content_scan(scanner,&tag,&value) == FALSE) {
+			return FALSE;
+		}
+	}
+	return FALSE;
+}
+
+/** Parse NLSML result in a single pass */
+APT_DECLARE(nlsml_stream_result_t*) nlsml_stream_result_parse(const char *data, apr_size_t length, apr_pool_t *pool)
+{
+	nlsml_scanner_t scanner;
+	nlsml_tag_t tag;
+	apt_str_t name;
+	apt_str_t value;
+	const char *attr_pos;
+	apt_bool_t complete = FALSE;
+	apr_array_header_t *interpretations;
+	nlsml_stream_interpretation_t *interpretation;
+	nlsml_stream_result_t *result;
+
+	if(!data || !length) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"No NLSML data available");
+		return NULL;
+	}
+
+	scanner.pos = data;
+	scanner.end = data + length;
+
+	/* NLSML validity check: root element must be <result> */
+	if(nlsml_tag_next(&scanner,&tag) == FALSE || tag.closing == TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"No NLSML root element");
+		return NULL;
+	}
+	if(nlsml_name_is(&tag.name,"result",6) == FALSE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected NLSML root element <%.*s>",(int)tag.name.length,tag.name.buf);
+		return NULL;
+	}
+
+	result = apr_palloc(pool,sizeof(nlsml_stream_result_t));
+	apt_string_reset(&result->grammar);
+	result->interpretations = NULL;
+	result->interpretation_count = 0;
+
+	/* find optional grammar attribute */
+	attr_pos = tag.attrs;
+	while(nlsml_attr_next(&attr_pos,tag.attrs_end,&name,&value) == TRUE) {
+		if(nlsml_name_is(&name,"grammar",7) == TRUE) {
+			result->grammar = value;
+		}
+	}
+
+	if(tag.empty == TRUE) {
+		return result;
+	}
+
+	/* find interpretation elements, skip enrollment and verification results */
+	interpretations = apr_array_make(pool,1,sizeof(nlsml_stream_interpretation_t));
+	while(nlsml_tag_next(&scanner,&tag) == TRUE) {
+		if(tag.closing == TRUE) {
+			complete = TRUE;
+			break;
+		}
+
+		if(nlsml_name_is(&tag.name,"interpretation",14) == TRUE) {
+			interpretation = apr_array_push(interpretations);
+			if(nlsml_stream_interpretation_parse(&scanner,&tag,interpretation,pool) == FALSE) {
+				break;
+			}
+		}
+		else if(nlsml_element_content_scan(&scanner,&tag,&value) == FALSE) {
+			break;
+		}
+	}
+
+	if(complete == FALSE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Parse NLSML Result: unexpected end of document");
+		return NULL;
+	}
+
+	result->interpretations = (nlsml_stream_interpretation_t*)interpretations->elts;
+	result->interpretation_count = interpretations->nelts;
+	return result;
+}
+
+/** Encode the code point in UTF-8 */
+static char* nlsml_utf8_encode(char *out, apr_uint32_t code)
+{
+	if(code < 0x80) {
+		*out++ = (char)code;
+	}
+	else if(code < 0x800) {
+		*out++ = (char)(0xC0 | (code >> 6));
+		*out++ = (char)(0x80 | (code & 0x3F));
+	}
+	else if(code < 0x10000) {
+		*out++ = (char)(0xE0 | (code >> 12));
+		*out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+		*out++ = (char)(0x80 | (code & 0x3F));
+	}
+	else {
+		*out++ = (char)(0xF0 | (code >> 18));
+		*out++ = (char)(0x80 | ((code >> 12) & 0x3F));
+		*out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+		*out++ = (char)(0x80 | (code & 0x3F));
+	}
+	return out;
+}
+
+/** Replace the entity reference, the output is never longer than the reference itself */
+static char* nlsml_entity_replace(char *out, const char *entity, apr_size_t length)
+{
+	if(length >= 2 && *entity == '#') {
+		apr_uint32_t code = 0;
+		apr_size_t i = 1;
+		int base = 10;
+		if(entity[1] == 'x' || entity[1] == 'X') {
+			base = 16;
+			i++;
+		}
+		if(i >= length) {
+			return NULL;
+		}
+		for(; i < length; i++) {
+			char ch = entity[i];
+			int digit;
+			if(ch >= '0' && ch <= '9') {
+				digit = ch - '0';
+			}
+			else if(base == 16 && ch >= 'a' && ch <= 'f') {
+				digit = ch - 'a' + 10;
+			}
+			else if(base == 16 && ch >= 'A' && ch <= 'F') {
+				digit = ch - 'A' + 10;
+			}
+			else {
+				return NULL;
+			}
+			code = code * base + digit;
+			if(code > 0x10FFFF) {
+				return NULL;
+			}
+		}
+		return nlsml_utf8_encode(out,code);
+	}
+
+	if(length == 2 && memcmp(entity,"lt",2) == 0) {
+		*out++ = '<';
+	}
+	else if(length == 2 && memcmp(entity,"gt",2) == 0) {
+		*out++ = '>';
+	}
+	else if(length == 3 && memcmp(entity,"amp",3) == 0) {
+		*out++ = '&';
+	}
+	else if(length == 4 && memcmp(entity,"quot",4) == 0) {
+		*out++ = '"';
+	}
+	else if(length == 4 && memcmp(entity,"apos",4) == 0) {
+		*out++ = '\'';
+	}
+	else {
+		return NULL;
+	}
+	return out;
+}
+
+/** Get the plain text of raw XML content */
+APT_DECLARE(apt_bool_t) nlsml_stream_text_get(const apt_str_t *content, apt_str_t *text, apr_pool_t *pool)
+{
+	const char *pos = content->buf;
+	const char *end = pos + content->length;
+	const char *cdata_end;
+	const char *semicolon;
+	char *out;
+	char *next;
+
+	if(!content->length ||
+		(!memchr(pos,'&',content->length) && !nlsml_token_find(pos,end,"<![CDATA[",9))) {
+		/* nothing to replace */
+		*text = *content;
+		return TRUE;
+	}
+
+	out = apr_palloc(pool,content->length + 1);
+	text->buf = out;
+	while(pos < end) {
+		if(*pos == '&') {
+			semicolon = memchr(pos,';',end - pos);
+			if(semicolon) {
+				next = nlsml_entity_replace(out,pos + 1,semicolon - pos - 1);
+				if(next) {
+					out = next;
+					pos = semicolon + 1;
+					continue;
+				}
+			}
+			*out++ = *pos++;
+		}
+		else if(*pos == '<' && end - pos >= 9 && memcmp(pos,"<![CDATA[",9) == 0) {
+			pos += 9;
+			cdata_end = nlsml_token_find(pos,end,"]]>",3);
+			if(!cdata_end) {
+				cdata_end = end;
+			}
+			memcpy(out,pos,cdata_end - pos);
+			out += cdata_end - pos;
+			pos = (cdata_end == end) ? end : cdata_end + 3;
+		}
+		else {
+			*out++ = *pos++;
+		}
+	}
+	*out = '\0';
+	text->length = out - text->buf;
+	return TRUE;
+}
+
+
+/** Make sure the buffer can hold additional data and the terminating NULL character */
+static void nlsml_writer_reserve(nlsml_writer_t *writer, apr_size_t length)
+{
+	char *buf;
+	apr_size_t size = writer->size;
+	if(writer->length + length < size) {
+		return;
+	}
+
+	while(writer->length + length >= size) {
+		size *= 2;
+	}
+	buf = apr_palloc(writer->pool,size);
+	memcpy(buf,writer->buf,writer->length);
+	writer->buf = buf;
+	writer->size = size;
+}
+
+static APR_INLINE void nlsml_writer_append(nlsml_writer_t *writer, const char *data, apr_size_t length)
+{
+	nlsml_writer_reserve(writer,length);
+	memcpy(writer->buf + writer->length,data,length);
+	writer->length += length;
+}
+
+/** Append the data escaping the markup characters */
+static void nlsml_writer_escaped_append(nlsml_writer_t *writer, const char *data, apr_size_t length)
+{
+	const char *pos = data;
+	const char *end = data + length;
+	const char *run = data;
+	for(; pos < end; pos++) {
+		switch(*pos) {
+			case '<':
+				nlsml_writer_append(writer,run,pos - run);
+				NLSML_WRITER_LITERAL_APPEND(writer,"&lt;");
+				break;
+			case '>':
+				nlsml_writer_append(writer,run,pos - run);
+				NLSML_WRITER_LITERAL_APPEND(writer,"&gt;");
+				break;
+			case '&':
+				nlsml_writer_append(writer,run,pos - run);
+				NLSML_WRITER_LITERAL_APPEND(writer,"&amp;");
+				break;
+			case '"':
+				nlsml_writer_append(writer,run,pos - run);
+				NLSML_WRITER_LITERAL_APPEND(writer,"&quot;");
+				break;
+			default:
+				continue;
+		}
+		run = pos + 1;
+	}
+	nlsml_writer_append(writer,run,end - run);
+}
+
+static void nlsml_writer_grammar_append(nlsml_writer_t *writer, const char *grammar)
+{
+	if(grammar) {
+		NLSML_WRITER_LITERAL_APPEND(writer," grammar=\"");
+		nlsml_writer_escaped_append(writer,grammar,strlen(grammar));
+		NLSML_WRITER_LITERAL_APPEND(writer,"\"");
+	}
+}
+
+static void nlsml_writer_confidence_append(nlsml_writer_t *writer, float confidence)
+{
+	char buf[NLSML_NUMBER_MAX_LENGTH + 1];
+	apr_size_t length = apr_snprintf(buf,sizeof(buf),"%.2f",confidence);
+	NLSML_WRITER_LITERAL_APPEND(writer," confidence=\"");
+	nlsml_writer_append(writer,buf,length);
+	NLSML_WRITER_LITERAL_APPEND(writer,"\"");
+}
+
+/** Create NLSML writer */
+APT_DECLARE(nlsml_writer_t*) nlsml_writer_create(apr_size_t size, apr_pool_t *pool)
+{
+	nlsml_writer_t *writer = apr_palloc(pool,sizeof(nlsml_writer_t));
+	if(size < 64) {
+		size = 64;
+	}
+	writer->pool = pool;
+	writer->buf = apr_palloc(pool,size);
+	writer->size = size;
+	writer->length = 0;
+	return writer;
+}
+
+/** Begin <result> element */
+APT_DECLARE(void) nlsml_writer_result_begin(nlsml_writer_t *writer, const char *grammar)
+{
+	writer->length = 0;
+	NLSML_WRITER_LITERAL_APPEND(writer,"<?xml version=\"1.0\"?>\n<result");
+	nlsml_writer_grammar_append(writer,grammar);
+	NLSML_WRITER_LITERAL_APPEND(writer,">\n");
+}
+
+/** Begin <interpretation> element */
+APT_DECLARE(void) nlsml_writer_interpretation_begin(nlsml_writer_t *writer, const char *grammar, float confidence)
+{
+	NLSML_WRITER_LITERAL_APPEND(writer,"  <interpretation");
+	nlsml_writer_grammar_append(writer,grammar);
+	nlsml_writer_confidence_append(writer,confidence);
+	NLSML_WRITER_LITERAL_APPEND(writer,">\n");
+}
+
+/** Add <instance> element */
+APT_DECLARE(void) nlsml_writer_instance_add(nlsml_writer_t *writer, const apt_str_t *content, apt_bool_t escape)
+{
+	NLSML_WRITER_LITERAL_APPEND(writer,"    <instance>");
+	if(escape == TRUE) {
+		nlsml_writer_escaped_append(writer,content->buf,content->length);
+	}
+	else {
+		nlsml_writer_append(writer,content->buf,content->length);
+	}
+	NLSML_WRITER_LITERAL_APPEND(writer,"</instance>\n");
+}
+
+/** Add <input> element */
+APT_DECLARE(void) nlsml_writer_input_add(nlsml_writer_t *writer, const char *mode, float confidence, const apt_str_t *content)
+{
+	NLSML_WRITER_LITERAL_APPEND(writer,"    <input");
+	if(mode) {
+		NLSML_WRITER_LITERAL_APPEND(writer," mode=\"");
+		nlsml_writer_append(writer,mode,strlen(mode));
+		NLSML_WRITER_LITERAL_APPEND(writer,"\"");
+	}
+	nlsml_writer_confidence_append(writer,confidence);
+	NLSML_WRITER_LITERAL_APPEND(writer,">");
+	nlsml_writer_escaped_append(writer,content->buf,content->length);
+	NLSML_WRITER_LITERAL_APPEND(writer,"</input>\n");
+}
+
+/** End <interpretation> element */
+APT_DECLARE(void) nlsml_writer_interpretation_end(nlsml_writer_t *writer)
+{
+	NLSML_WRITER_LITERAL_APPEND(writer,"  </interpretation>\n");
+}
+
+/** End <result> element and get the composed document */
+APT_DECLARE(apt_bool_t) nlsml_writer_result_end(nlsml_writer_t *writer, apt_str_t *document)
+{
+	NLSML_WRITER_LITERAL_APPEND(writer,"</result>\n");
+	writer->buf[writer->length] = '\0';
+	document->buf = writer->buf;
+	document->length = writer->length;
+	return TRUE;
+}
@@ -20,6 +20,289 @@
 #include "apt_pollset.h"
 #include "apt_log.h"
 
+#ifdef APT_POLLSET_EPOLL
+
+#include <apr_ring.h>
+#include <apr_portable.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+
+/** Pollset element holding a copy of the added descriptor */
+typedef struct apt_pollset_elem_t apt_pollset_elem_t;
+struct apt_pollset_elem_t {
+	/** Ring entry */
+	APR_RING_ENTRY(apt_pollset_elem_t) link;
+	/** Copy of the poll descriptor */
+	apr_pollfd_t                       pfd;
+	/** OS level file descriptor */
+	int                                fd;
+};
+
+struct apt_pollset_t {
+	/** Epoll file descriptor */
+	int                  epoll_fd;
+	/** Eventfd descriptor used for wakeup */
+	int                  wakeup_fd;
+	/** Creation flags */
+	apr_uint32_t         flags;
+	/** Max number of events retrieved at once */
+	apr_uint32_t         size;
+	/** Array of events retrieved by epoll_wait() */
+	struct epoll_event  *events;
+	/** Array of signalled descriptors returned to the caller */
+	apr_pollfd_t        *result_set;
+
+	/** Ring of added descriptors */
+	APR_RING_HEAD(apt_pollset_query_head_t, apt_pollset_elem_t) query_ring;
+	/** Ring of released elements available for reuse */
+	APR_RING_HEAD(apt_pollset_free_head_t, apt_pollset_elem_t) free_ring;
+
+	/** Pool to allocate memory from */
+	apr_pool_t          *pool;
+};
+
+/** Get OS level file descriptor of the poll descriptor */
+static int apt_pollset_os_fd_get(const apr_pollfd_t *descriptor)
+{
+	if(descriptor->desc_type == APR_POLL_SOCKET) {
+		apr_os_sock_t fd;
+		if(apr_os_sock_get(&fd,descriptor->desc.s) == APR_SUCCESS) {
+			return fd;
+		}
+	}
+	else if(descriptor->desc_type == APR_POLL_FILE) {
+		apr_os_file_t fd;
+		if(apr_os_file_get(&fd,descriptor->desc.f) == APR_SUCCESS) {
+			return fd;
+		}
+	}
+	return -1;
+}
+
+/** Convert APR requested events to epoll events */
+static APR_INLINE apr_uint32_t apt_pollset_epoll_events_get(apr_int16_t reqevents, apr_uint32_t flags)
+{
+	apr_uint32_t events = 0;
+	if(reqevents & APR_POLLIN)
+		events |= EPOLLIN;
+	if(reqevents & APR_POLLPRI)
+		events |= EPOLLPRI;
+	if(reqevents & APR_POLLOUT)
+		events |= EPOLLOUT;
+	if(flags & APT_POLLSET_FLAG_EDGE_TRIGGERED)
+		events |= EPOLLET;
+	return events;
+}
+
+/** Convert returned epoll events to APR events */
+static APR_INLINE apr_int16_t apt_pollset_apr_events_get(apr_uint32_t events)
+{
+	apr_int16_t rtnevents = 0;
+	if(events & EPOLLIN)
+		rtnevents |= APR_POLLIN;
+	if(events & EPOLLPRI)
+		rtnevents |= APR_POLLPRI;
+	if(events & EPOLLOUT)
+		rtnevents |= APR_POLLOUT;
+	if(events & EPOLLERR)
+		rtnevents |= APR_POLLERR;
+	if(events & EPOLLHUP)
+		rtnevents |= APR_POLLHUP;
+	return rtnevents;
+}
+
+/** Create interruptable pollset on top of epoll */
+APT_DECLARE(apt_pollset_t*) apt_pollset_create_ex(apr_uint32_t size, apr_uint32_t flags, apr_pool_t *pool)
+{
+	struct epoll_event event;
+	apt_pollset_t *pollset = apr_palloc(pool,sizeof(apt_pollset_t));
+	pollset->pool = pool;
+	pollset->flags = flags;
+	/* +1 is builtin wakeup descriptor */
+	pollset->size = size + 1;
+	pollset->events = apr_palloc(pool,sizeof(struct epoll_event) * pollset->size);
+	pollset->result_set = apr_palloc(pool,sizeof(apr_pollfd_t) * pollset->size);
+	APR_RING_INIT(&pollset->query_ring, apt_pollset_elem_t, link);
+	APR_RING_INIT(&pollset->free_ring, apt_pollset_elem_t, link);
+
+	pollset->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if(pollset->epoll_fd < 0) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Epoll Instance [%d]",errno);
+		return NULL;
+	}
+
+	/* create wakeup eventfd */
+	pollset->wakeup_fd = eventfd(0,EFD_NONBLOCK | EFD_CLOEXEC);
+	if(pollset->wakeup_fd < 0) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Wakeup Eventfd [%d]",errno);
+		close(pollset->epoll_fd);
+		return NULL;
+	}
+
+	/* add wakeup eventfd to pollset, the event is identified by NULL data pointer */
+	memset(&event,0,sizeof(event));
+	event.events = EPOLLIN;
+	event.data.ptr = NULL;
+	if(epoll_ctl(pollset->epoll_fd,EPOLL_CTL_ADD,pollset->wakeup_fd,&event) != 0) {
+		close(pollset->wakeup_fd);
+		close(pollset->epoll_fd);
+		return NULL;
+	}
+	return pollset;
+}
+
+/** Destroy pollset */
+APT_DECLARE(apt_bool_t) apt_pollset_destroy(apt_pollset_t *pollset)
+{
+	if(pollset->wakeup_fd >= 0) {
+		close(pollset->wakeup_fd);
+		pollset->wakeup_fd = -1;
+	}
+	if(pollset->epoll_fd >= 0) {
+		close(pollset->epoll_fd);
+		pollset->epoll_fd = -1;
+	}
+	return TRUE;
+}
+
+/** Add pollset descriptor to a pollset */
+APT_DECLARE(apt_bool_t) apt_pollset_add(apt_pollset_t *pollset, const apr_pollfd_t *descriptor)
+{
+	struct epoll_event event;
+	apt_pollset_elem_t *elem;
+	int fd = apt_pollset_os_fd_get(descriptor);
+	if(fd < 0) {
+		return FALSE;
+	}
+
+	if(!APR_RING_EMPTY(&pollset->free_ring, apt_pollset_elem_t, link)) {
+		elem = APR_RING_FIRST(&pollset->free_ring);
+		APR_RING_REMOVE(elem,link);
+	}
+	else {
+		elem = apr_palloc(pollset->pool,sizeof(apt_pollset_elem_t));
+		APR_RING_ELEM_INIT(elem,link);
+	}
+	elem->pfd = *descriptor;
+	elem->fd = fd;
+
+	memset(&event,0,sizeof(event));
+	event.events = apt_pollset_epoll_events_get(descriptor->reqevents,pollset->flags);
+	event.data.ptr = elem;
+	if(epoll_ctl(pollset->epoll_fd,EPOLL_CTL_ADD,fd,&event) != 0) {
+		APR_RING_INSERT_TAIL(&pollset->free_ring,elem,apt_pollset_elem_t,link);
+		return FALSE;
+	}
+
+	APR_RING_INSERT_TAIL(&pollset->query_ring,elem,apt_pollset_elem_t,link);
+	return TRUE;
+}
+
+/** Remove pollset descriptor from a pollset */
+APT_DECLARE(apt_bool_t) apt_pollset_remove(apt_pollset_t *pollset, const apr_pollfd_t *descriptor)
+{
+	struct epoll_event event;
+	apt_pollset_elem_t *elem;
+	int fd = apt_pollset_os_fd_get(descriptor);
+	if(fd < 0) {
+		return FALSE;
+	}
+
+	APR_RING_FOREACH(elem, &pollset->query_ring, apt_pollset_elem_t, link) {
+		if(elem->fd == fd) {
+			/* a non-NULL event is required by kernels prior to 2.6.9 */
+			memset(&event,0,sizeof(event));
+			epoll_ctl(pollset->epoll_fd,EPOLL_CTL_DEL,fd,&event);
+			APR_RING_REMOVE(elem,link);
+			APR_RING_INSERT_TAIL(&pollset->free_ring,elem,apt_pollset_elem_t,link);
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/** Block for activity on the descriptor(s) in a pollset */
+APT_DECLARE(apr_status_t) apt_pollset_poll(
+								apt_pollset_t *pollset,
+								apr_interval_time_t timeout,
+								apr_int32_t *num,
+								const apr_pollfd_t **descriptors)
+{
+	int i;
+	int count;
+	int msec_timeout = -1;
+	apr_pollfd_t *result;
+	apt_pollset_elem_t *elem;
+
+	if(timeout >= 0) {
+		/* round up to the nearest msec */
+		msec_timeout = (int)((timeout + 999) / 1000);
+	}
+
+	*num = 0;
+	*descriptors = pollset->result_set;
+	count = epoll_wait(pollset->epoll_fd,pollset->events,(int)pollset->size,msec_timeout);
+	if(count < 0) {
+		return APR_FROM_OS_ERROR(errno);
+	}
+	if(count == 0) {
+		return APR_TIMEUP;
+	}
+
+	for(i = 0; i < count; i++) {
+		result = &pollset->result_set[i];
+		elem = pollset->events[i].data.ptr;
+		if(elem) {
+			*result = elem->pfd;
+		}
+		else {
+			/* builtin wakeup descriptor is identified by the pollset itself */
+			memset(result,0,sizeof(apr_pollfd_t));
+			result->client_data = pollset;
+		}
+		result->rtnevents = apt_pollset_apr_events_get(pollset->events[i].events);
+	}
+	*num = count;
+	return APR_SUCCESS;
+}
+
+/** Interrupt the blocked poll call */
+APT_DECLARE(apt_bool_t) apt_pollset_wakeup(apt_pollset_t *pollset)
+{
+	apr_uint64_t value = 1;
+	if(write(pollset->wakeup_fd,&value,sizeof(value)) != sizeof(value)) {
+		/* EAGAIN means the counter is already signalled */
+		if(errno != EAGAIN) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/** Match against builtin wake up descriptor in a pollset */
+APT_DECLARE(apt_bool_t) apt_pollset_is_wakeup(apt_pollset_t *pollset, const apr_pollfd_t *descriptor)
+{
+	if(descriptor->client_data == pollset) {
+		apr_uint64_t value;
+		/* reset the eventfd counter */
+		if(read(pollset->wakeup_fd,&value,sizeof(value)) < 0) {
+			/* nothing to read, the counter has already been reset */
+		}
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/** Create interruptable pollset */
+APT_DECLARE(apt_pollset_t*) apt_pollset_create(apr_uint32_t size, apr_pool_t *pool)
+{
+	return apt_pollset_create_ex(size,0,pool);
+}
+
+#else /* APT_POLLSET_EPOLL */
+
 struct apt_pollset_t {
 	/** APR pollset */
 	apr_pollset_t *base;
@@ -41,11 +324,16 @@ static apt_bool_t apt_wakeup_pipe_create(apt_pollset_t *pollset);
 static apt_bool_t apt_wakeup_pipe_destroy(apt_pollset_t *pollset);
 
 /** Create interruptable pollset on top of APR pollset */
-APT_DECLARE(apt_pollset_t*) apt_pollset_create(apr_uint32_t size, apr_pool_t *pool)
+APT_DECLARE(apt_pollset_t*) apt_pollset_create_ex(apr_uint32_t size, apr_uint32_t flags, apr_pool_t *pool)
 {
 	apt_pollset_t *pollset = apr_palloc(pool,sizeof(apt_pollset_t));
 	pollset->pool = pool;
 	memset(&pollset->wakeup_pfd,0,sizeof(pollset->wakeup_pfd));
+
+	if(flags & APT_POLLSET_FLAG_EDGE_TRIGGERED) {
+		/* APR pollset is always level-triggered, which is still safe for handlers draining descriptors */
+		apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Edge-Triggered Mode Is Not Supported by APR Pollset");
+	}
 	
 	/* create pollset with max number of descriptors size+1, 
 	where +1 is builtin wakeup descriptor */
@@ -68,6 +356,12 @@ APT_DECLARE(apt_pollset_t*) apt_pollset_create(apr_uint32_t size, apr_pool_t *po
 	return pollset;
 }
 
+/** Create interruptable pollset */
+APT_DECLARE(apt_pollset_t*) apt_pollset_create(apr_uint32_t size, apr_pool_t *pool)
+{
+	return apt_pollset_create_ex(size,0,pool);
+}
+
 /** Destroy pollset */
 APT_DECLARE(apt_bool_t) apt_pollset_destroy(apt_pollset_t *pollset)
 {
@@ -323,3 +617,5 @@ static apt_bool_t apt_wakeup_pipe_destroy(apt_pollset_t *pollset)
 }
 
 #endif
+
+#endif /* APT_POLLSET_EPOLL */
@@ -55,3 +55,184 @@ APT_DECLARE(apr_pool_t*) apt_subpool_create(apr_pool_t *parent)
 	apr_pool_create(&pool,parent);
 	return pool;
 }
+
+
+/** Key of the pool userdata referencing the holder of a recyclable pool */
+#define APT_POOL_HOLDER_KEY "apt-pool-holder"
+
+/** Cache of recycled pools */
+typedef struct apt_pool_cache_t apt_pool_cache_t;
+
+struct apt_pool_cache_t {
+	/** Stack of holders, each owning an allocator and a mutex (apr_pool_t*) */
+	apr_pool_t           **holders;
+	/** Number of holders in the stack */
+	apr_size_t             count;
+	/** Max number of holders in the stack */
+	apr_size_t             max_count;
+	/** Max number of free bytes each allocator may retain */
+	apr_size_t             max_free_size;
+	/** Reference count */
+	apr_size_t             ref_count;
+	/** Statistics */
+	apt_pool_cache_stats_t stats;
+	/** Guard of the stack */
+	apr_thread_mutex_t    *guard;
+	/** Pool to allocate memory from */
+	apr_pool_t            *pool;
+};
+
+static apt_pool_cache_t *apt_pool_cache = NULL;
+
+APT_DECLARE(apt_bool_t) apt_pool_cache_create(apr_size_t max_count, apr_size_t max_free_size)
+{
+	apt_pool_cache_t *cache;
+	apr_pool_t *pool;
+	if(apt_pool_cache) {
+		apt_pool_cache->ref_count++;
+		return TRUE;
+	}
+
+	if(!max_count) {
+		return FALSE;
+	}
+
+	if(apr_pool_create(&pool,NULL) != APR_SUCCESS) {
+		return FALSE;
+	}
+	cache = apr_palloc(pool,sizeof(apt_pool_cache_t));
+	cache->pool = pool;
+	cache->holders = apr_palloc(pool,sizeof(apr_pool_t*) * max_count);
+	cache->count = 0;
+	cache->max_count = max_count;
+	cache->max_free_size = max_free_size;
+	cache->ref_count = 1;
+	cache->stats.create_count = 0;
+	cache->stats.reuse_count = 0;
+	cache->stats.retained_count = 0;
+	cache->stats.peak_retained_count = 0;
+	cache->stats.peak_retained_size = 0;
+	cache->guard = NULL;
+	if(apr_thread_mutex_create(&cache->guard,APR_THREAD_MUTEX_DEFAULT,pool) != APR_SUCCESS) {
+		apr_pool_destroy(pool);
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Create Pool Cache [%"APR_SIZE_T_FMT" pools] [%"APR_SIZE_T_FMT" bytes]",
+		max_count,max_free_size);
+	apt_pool_cache = cache;
+	return TRUE;
+}
+
+APT_DECLARE(apt_bool_t) apt_pool_cache_destroy()
+{
+	apt_pool_cache_t *cache = apt_pool_cache;
+	if(!cache) {
+		return FALSE;
+	}
+	if(--cache->ref_count) {
+		return TRUE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Destroy Pool Cache [%"APR_SIZE_T_FMT" created] [%"APR_SIZE_T_FMT" reused] [%"APR_SIZE_T_FMT" peak retained]",
+		cache->stats.create_count,
+		cache->stats.reuse_count,
+		cache->stats.peak_retained_count);
+
+	apr_thread_mutex_lock(cache->guard);
+	apt_pool_cache = NULL;
+	while(cache->count) {
+		apr_pool_destroy(cache->holders[--cache->count]);
+	}
+	apr_thread_mutex_unlock(cache->guard);
+
+	apr_thread_mutex_destroy(cache->guard);
+	apr_pool_destroy(cache->pool);
+	return TRUE;
+}
+
+APT_DECLARE(apt_bool_t) apt_pool_cache_stats_get(apt_pool_cache_stats_t *stats)
+{
+	apt_pool_cache_t *cache = apt_pool_cache;
+	if(!cache) {
+		return FALSE;
+	}
+	apr_thread_mutex_lock(cache->guard);
+	*stats = cache->stats;
+	apr_thread_mutex_unlock(cache->guard);
+	return TRUE;
+}
+
+APT_DECLARE(apr_pool_t*) apt_pool_recyclable_create()
+{
+	apr_pool_t *holder = NULL;
+	apr_pool_t *pool = NULL;
+	apt_pool_cache_t *cache = apt_pool_cache;
+	if(!cache) {
+		return apt_pool_create();
+	}
+
+	apr_thread_mutex_lock(cache->guard);
+	if(cache->count) {
+		holder = cache->holders[--cache->count];
+		cache->stats.retained_count = cache->count;
+		cache->stats.reuse_count++;
+	}
+	else {
+		cache->stats.create_count++;
+	}
+	apr_thread_mutex_unlock(cache->guard);
+
+	if(!holder) {
+		/* the holder owns the allocator and the mutex, which survive the pools created from it */
+		holder = apt_pool_create();
+		if(!holder) {
+			return NULL;
+		}
+		if(cache->max_free_size) {
+			apr_allocator_max_free_set(apr_pool_allocator_get(holder),cache->max_free_size);
+		}
+	}
+
+	if(apr_pool_create(&pool,holder) != APR_SUCCESS) {
+		apr_pool_destroy(holder);
+		return NULL;
+	}
+	apr_pool_userdata_setn(holder,APT_POOL_HOLDER_KEY,NULL,pool);
+	return pool;
+}
+
+APT_DECLARE(void) apt_pool_recycle(apr_pool_t *pool)
+{
+	apt_pool_cache_t *cache;
+	apr_pool_t *holder = NULL;
+	if(!pool) {
+		return;
+	}
+
+	apr_pool_userdata_get((void**)&holder,APT_POOL_HOLDER_KEY,pool);
+	apr_pool_destroy(pool);
+	if(!holder) {
+		/* the pool has been created while there was no cache */
+		return;
+	}
+
+	cache = apt_pool_cache;
+	if(cache) {
+		apr_thread_mutex_lock(cache->guard);
+		if(apt_pool_cache == cache && cache->count < cache->max_count) {
+			cache->holders[cache->count++] = holder;
+			cache->stats.retained_count = cache->count;
+			if(cache->count > cache->stats.peak_retained_count) {
+				cache->stats.peak_retained_count = cache->count;
+				cache->stats.peak_retained_size = cache->count * cache->max_free_size;
+			}
+			holder = NULL;
+		}
+		apr_thread_mutex_unlock(cache->guard);
+	}
+
+	if(holder) {
+		apr_pool_destroy(holder);
+	}
+}
@@ -16,14 +16,33 @@
  * $Id$
  */
 
+#ifdef APT_HAVE_SCHED_SETAFFINITY
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <sched.h>
+#endif
+#if defined(APT_HAVE_MALLINFO2) || defined(APT_HAVE_MALLINFO)
+#include <malloc.h>
+#endif
+#include <stdlib.h>
+#include <apr_allocator.h>
 #include "apt_pool.h"
 #include "apt_obj_list.h"
 #include "apt_test_suite.h"
 #include "apt_log.h"
 
+/** Number of iterations between clearing the pool, also used to measure memory per iteration */
+#define APT_BENCHMARK_POOL_ITERATIONS 1024
+/** Default duration of a measurement in msec */
+#define APT_BENCHMARK_DEFAULT_TIME    500
+/** Max number of iterations of a measurement */
+#define APT_BENCHMARK_MAX_ITERATIONS  1000000000
+
 struct apt_test_framework_t{
 	apr_pool_t     *pool;
 	apt_obj_list_t *suites;
+	apt_obj_list_t *benchmarks;
 };
 
 APT_DECLARE(apt_test_suite_t*) apt_test_suite_create(apr_pool_t *pool, const char *name, 
@@ -37,6 +56,17 @@ APT_DECLARE(apt_test_suite_t*) apt_test_suite_create(apr_pool_t *pool, const cha
 	return suite;
 }
 
+APT_DECLARE(apt_benchmark_t*) apt_benchmark_create(apr_pool_t *pool, const char *name, 
+												   void *obj, apt_benchmark_f runner)
+{
+	apt_benchmark_t *bench = apr_palloc(pool,sizeof(apt_benchmark_t));
+	bench->pool = pool;
+	apt_string_assign(&bench->name,name,pool);
+	bench->obj = obj;
+	bench->runner = runner;
+	return bench;
+}
+
 APT_DECLARE(apt_test_framework_t*) apt_test_framework_create()
 {
 	apt_test_framework_t *framework;
@@ -44,6 +74,7 @@ APT_DECLARE(apt_test_framework_t*) apt_test_framework_create()
 	framework = apr_palloc(pool,sizeof(apt_test_framework_t));
 	framework->pool = pool;
 	framework->suites = apt_list_create(pool);
+	framework->benchmarks = apt_list_create(pool);
 
 	apt_log_instance_create(APT_LOG_OUTPUT_CONSOLE,APT_PRIO_INFO,pool);
 	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Create Test Framework");
@@ -63,6 +94,12 @@ APT_DECLARE(apt_bool_t) apt_test_framework_suite_add(apt_test_framework_t *frame
 	return (apt_list_push_back(framework->suites,suite,suite->pool) ? TRUE : FALSE);
 }
 
+APT_DECLARE(apt_bool_t) apt_test_framework_benchmark_add(apt_test_framework_t *framework, apt_benchmark_t *bench)
+{
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Add Benchmark [%s]",bench->name.buf);
+	return (apt_list_push_back(framework->benchmarks,bench,bench->pool) ? TRUE : FALSE);
+}
+
 APT_DECLARE(apr_pool_t*) apt_test_framework_pool_get(const apt_test_framework_t *framework)
 {
 	return framework->pool;
@@ -80,10 +117,201 @@ static apt_bool_t apt_test_framework_suite_run(apt_test_framework_t *framework,
 	return status;
 }
 
+/** Pin the calling thread to the specified CPU */
+static apt_bool_t apt_benchmark_cpu_pin(int cpu)
+{
+#if defined(WIN32)
+	return SetThreadAffinityMask(GetCurrentThread(),(DWORD_PTR)1 << cpu) ? TRUE : FALSE;
+#elif defined(APT_HAVE_SCHED_SETAFFINITY)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu,&set);
+	return (sched_setaffinity(0,sizeof(set),&set) == 0) ? TRUE : FALSE;
+#else
+	return FALSE;
+#endif
+}
+
+/** Get the number of bytes allocated from the heap, or -1 if not available */
+static apr_int64_t apt_benchmark_heap_usage_get(void)
+{
+#if defined(APT_HAVE_MALLINFO2)
+	struct mallinfo2 info = mallinfo2();
+	return (apr_int64_t)(info.uordblks + info.hblkhd);
+#elif defined(APT_HAVE_MALLINFO)
+	struct mallinfo info = mallinfo();
+	return (apr_int64_t)info.uordblks + info.hblkhd;
+#else
+	return -1;
+#endif
+}
+
+/** Run the specified number of iterations and return the elapsed time */
+static apt_bool_t apt_benchmark_iterate(apt_benchmark_t *bench, apr_pool_t *pool, apr_size_t iterations, apr_interval_time_t *elapsed)
+{
+	apr_size_t i;
+	apr_time_t start = apr_time_now();
+	for(i = 1; i <= iterations; i++) {
+		if(bench->runner(bench,pool) == FALSE) {
+			return FALSE;
+		}
+		if(i % APT_BENCHMARK_POOL_ITERATIONS == 0) {
+			apr_pool_clear(pool);
+		}
+	}
+	*elapsed = apr_time_now() - start;
+	apr_pool_clear(pool);
+	return TRUE;
+}
+
+/** Measure the heap memory allocated per iteration in bytes, or -1 if not available */
+static apr_int64_t apt_benchmark_memory_measure(apt_benchmark_t *bench)
+{
+	apr_allocator_t *allocator;
+	apr_pool_t *pool;
+	apr_int64_t before;
+	apr_int64_t after;
+	apr_size_t i;
+
+	if(apt_benchmark_heap_usage_get() < 0) {
+		return -1;
+	}
+
+	/* use a dedicated allocator, so that every block taken by the pool comes from the heap */
+	if(apr_allocator_create(&allocator) != APR_SUCCESS) {
+		return -1;
+	}
+	if(apr_pool_create_ex(&pool,NULL,NULL,allocator) != APR_SUCCESS) {
+		apr_allocator_destroy(allocator);
+		return -1;
+	}
+	apr_allocator_owner_set(allocator,pool);
+
+	before = apt_benchmark_heap_usage_get();
+	for(i = 0; i < APT_BENCHMARK_POOL_ITERATIONS; i++) {
+		if(bench->runner(bench,pool) == FALSE) {
+			break;
+		}
+	}
+	after = apt_benchmark_heap_usage_get();
+	apr_pool_destroy(pool);
+
+	if(i < APT_BENCHMARK_POOL_ITERATIONS || after <= before) {
+		return 0;
+	}
+	return (after - before) / APT_BENCHMARK_POOL_ITERATIONS;
+}
+
+/** Run benchmark: warm up, scale the number of iterations to the target time and measure */
+static apt_bool_t apt_benchmark_run(apt_test_framework_t *framework, apt_benchmark_t *bench, apr_interval_time_t target)
+{
+	apr_pool_t *pool;
+	apr_size_t iterations = 1;
+	apr_size_t next;
+	apr_interval_time_t elapsed = 0;
+	apr_int64_t bytes;
+	apt_bool_t status = FALSE;
+
+	if(apr_pool_create(&pool,framework->pool) != APR_SUCCESS) {
+		return FALSE;
+	}
+
+	/* the scaling runs also serve as a warm-up of caches and lazily created objects */
+	while(apt_benchmark_iterate(bench,pool,iterations,&elapsed) == TRUE) {
+		if(elapsed >= target || iterations >= APT_BENCHMARK_MAX_ITERATIONS) {
+			status = TRUE;
+			break;
+		}
+
+		/* predict the number of iterations for the target time, but grow at most 100 times at once */
+		if(elapsed > 0) {
+			next = (apr_size_t)((double)iterations * target * 1.2 / elapsed);
+		}
+		else {
+			next = iterations * 100;
+		}
+		if(next > iterations * 100) {
+			next = iterations * 100;
+		}
+		if(next <= iterations) {
+			next = iterations + 1;
+		}
+		if(next > APT_BENCHMARK_MAX_ITERATIONS) {
+			next = APT_BENCHMARK_MAX_ITERATIONS;
+		}
+		iterations = next;
+	}
+	apr_pool_destroy(pool);
+
+	if(status == FALSE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Run Benchmark [%s]",bench->name.buf);
+		return FALSE;
+	}
+
+	bytes = apt_benchmark_memory_measure(bench);
+	if(bytes >= 0) {
+		apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Benchmark [%-24s] %10"APR_SIZE_T_FMT" iterations %12.1f ns/op %8"APR_INT64_T_FMT" B/op",
+			bench->name.buf,iterations,(double)elapsed * 1000 / iterations,bytes);
+	}
+	else {
+		apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Benchmark [%-24s] %10"APR_SIZE_T_FMT" iterations %12.1f ns/op",
+			bench->name.buf,iterations,(double)elapsed * 1000 / iterations);
+	}
+	return TRUE;
+}
+
+/** Run benchmarks */
+static apt_bool_t apt_test_framework_benchmarks_run(apt_test_framework_t *framework, int argc, const char * const *argv)
+{
+	apt_benchmark_t *bench;
+	apt_list_elem_t *elem;
+	apr_interval_time_t target = apr_time_from_msec(APT_BENCHMARK_DEFAULT_TIME);
+	const char *name = NULL;
+	apt_bool_t status = TRUE;
+	int i;
+
+	for(i = 0; i < argc; i++) {
+		if(strcmp(argv[i],"-t") == 0 && i + 1 < argc) {
+			target = apr_time_from_msec(atol(argv[++i]));
+		}
+		else if(strcmp(argv[i],"-c") == 0 && i + 1 < argc) {
+			int cpu = atoi(argv[++i]);
+			if(apt_benchmark_cpu_pin(cpu) == TRUE) {
+				apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Pin Benchmarks to CPU [%d]",cpu);
+			}
+			else {
+				apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Pin Benchmarks to CPU [%d]",cpu);
+			}
+		}
+		else {
+			name = argv[i];
+		}
+	}
+	if(target <= 0) {
+		target = apr_time_from_msec(APT_BENCHMARK_DEFAULT_TIME);
+	}
+
+	elem = apt_list_first_elem_get(framework->benchmarks);
+	while(elem) {
+		bench = apt_list_elem_object_get(elem);
+		if(bench && (!name || strcmp(bench->name.buf,name) == 0)) {
+			if(apt_benchmark_run(framework,bench,target) == FALSE) {
+				status = FALSE;
+			}
+		}
+		elem = apt_list_next_elem_get(framework->benchmarks,elem);
+	}
+	return status;
+}
+
 APT_DECLARE(apt_bool_t) apt_test_framework_run(apt_test_framework_t *framework, int argc, const char * const *argv)
 {
 	apt_test_suite_t *suite = NULL;
 	apt_list_elem_t *elem = apt_list_first_elem_get(framework->suites);
+	if(argc >= 2 && strcmp(argv[1],"bench") == 0) {
+		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Run Benchmarks");
+		return apt_test_framework_benchmarks_run(framework,argc-2,&argv[2]);
+	}
 	if(argc == 1) {
 		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Run All Test Suites");
 		/* walk through the list of test suites and run all of them */
@@ -352,6 +352,37 @@ APT_DECLARE(void) apt_message_parser_verbose_set(apt_message_parser_t *parser, a
 	parser->verbose = verbose;
 }
 
+/** Get the remaining part of the message body being parsed */
+APT_DECLARE(apt_bool_t) apt_message_parser_body_slice_get(apt_message_parser_t *parser, char **buf, apr_size_t *length)
+{
+	apt_str_t *body = parser->context.body;
+	if(parser->stage != APT_MESSAGE_STAGE_BODY || parser->skip_lf == TRUE) {
+		return FALSE;
+	}
+	if(!body || !body->buf || body->length >= parser->content_length) {
+		return FALSE;
+	}
+
+	*buf = body->buf + body->length;
+	*length = parser->content_length - body->length;
+	return TRUE;
+}
+
+/** Advance the message body being parsed */
+APT_DECLARE(apt_bool_t) apt_message_parser_body_slice_advance(apt_message_parser_t *parser, apr_size_t length)
+{
+	apt_str_t *body = parser->context.body;
+	if(parser->stage != APT_MESSAGE_STAGE_BODY || !body || !body->buf) {
+		return FALSE;
+	}
+
+	if(length > parser->content_length - body->length) {
+		length = parser->content_length - body->length;
+	}
+	body->length += length;
+	return (body->length == parser->content_length) ? TRUE : FALSE;
+}
+
 
 /** Create message generator */
 APT_DECLARE(apt_message_generator_t*) apt_message_generator_create(void *obj, const apt_message_generator_vtable_t *vtable, apr_pool_t *pool)
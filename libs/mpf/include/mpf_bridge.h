@@ -25,6 +25,7 @@
  */ 
 
 #include "mpf_object.h"
+#include "mpf_slab.h"
 
 APT_BEGIN_EXTERN_C
 
@@ -43,6 +44,24 @@ MPF_DECLARE(mpf_object_t*) mpf_bridge_create(
 								const char *name,
 								apr_pool_t *pool);
 
+/**
+ * Create bridge of audio streams allocating the bridge and its frame buffer from the slab.
+ * @param source the source audio stream
+ * @param sink the sink audio stream
+ * @param codec_manager the codec manager
+ * @param name the informative name used for debugging
+ * @param slab the slab to allocate the bridge from (optional)
+ * @param pool the pool to allocate memory from, if the slab is exhausted or not specified
+ * @remark The memory taken from the slab is released, when the bridge is destroyed.
+ */
+MPF_DECLARE(mpf_object_t*) mpf_bridge_create_ex(
+								mpf_audio_stream_t *source, 
+								mpf_audio_stream_t *sink, 
+								const mpf_codec_manager_t *codec_manager,
+								const char *name,
+								mpf_slab_t *slab,
+								apr_pool_t *pool);
+
 
 APT_END_EXTERN_C
 
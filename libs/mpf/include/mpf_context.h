@@ -28,6 +28,13 @@
 
 APT_BEGIN_EXTERN_C
 
+/** Max number of terminations in contexts allocated from the slab of the factory */
+#define MPF_CONTEXT_SLAB_TERMINATION_COUNT 5
+/** Number of media processing objects (bridges, multipliers, mixers) reserved in the slab per context */
+#define MPF_CONTEXT_SLAB_OBJECT_COUNT      2
+/** Size of blocks of media processing objects, which fits a bridge with a frame of 48 kHz mono audio */
+#define MPF_OBJECT_SLAB_BLOCK_SIZE         2048
+
 /** Opaque factory of media contexts */
 typedef struct mpf_context_factory_t mpf_context_factory_t;
  
@@ -46,6 +53,17 @@ MPF_DECLARE(void) mpf_context_factory_destroy(mpf_context_factory_t *factory);
  */
 MPF_DECLARE(apt_bool_t) mpf_context_factory_process(mpf_context_factory_t *factory);
 
+/**
+ * Preallocate contexts and media processing objects of the factory.
+ * @param factory the factory to set slabs for
+ * @param max_context_count the max number of contexts (sessions) to preallocate memory for
+ * @param pool the pool to allocate memory from
+ * @remark Contexts and objects are then carved from contiguous, cache-aligned memory and recycled,
+ *         when released, instead of being allocated from the pools of sessions.
+ *         Once the slabs are exhausted, memory is allocated from the pools again.
+ */
+MPF_DECLARE(apt_bool_t) mpf_context_factory_slab_set(mpf_context_factory_t *factory, apr_size_t max_context_count, apr_pool_t *pool);
+
 /**
  * Create MPF context.
  * @param factory the factory context belongs to
@@ -67,6 +85,13 @@ MPF_DECLARE(mpf_context_t*) mpf_context_create(
  */
 MPF_DECLARE(apt_bool_t) mpf_context_destroy(mpf_context_t *context);
 
+/**
+ * Release memory of MPF context, which may no longer be used.
+ * @param context the context to release
+ * @remark The context is released only, if all its terminations have been subtracted.
+ */
+MPF_DECLARE(apt_bool_t) mpf_context_release(mpf_context_t *context);
+
 /**
  * Get external object associated with MPF context.
  * @param context the context to get object from
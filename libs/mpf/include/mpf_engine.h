@@ -26,6 +26,7 @@
 
 #include "apt_task.h"
 #include "mpf_message.h"
+#include "mpf_scheduler.h"
 
 APT_BEGIN_EXTERN_C
 
@@ -70,6 +71,8 @@ MPF_DECLARE(mpf_context_t*) mpf_engine_context_create(
 /**
  * Destroy MPF context.
  * @param context the context to destroy
+ * @remark Must be called once all the terminations of the context have been subtracted
+ *         by the engine, and no further requests are sent for the context.
  */
 MPF_DECLARE(apt_bool_t) mpf_engine_context_destroy(mpf_context_t *context);
 
@@ -146,6 +149,23 @@ MPF_DECLARE(apt_bool_t) mpf_engine_topology_message_add(
  */
 MPF_DECLARE(apt_bool_t) mpf_engine_message_send(mpf_engine_t *engine, mpf_task_msg_t **task_msg);
 
+/**
+ * Move RTCP processing of RTP streams off the media clock to a dedicated worker thread.
+ * @param engine the engine to set RTCP worker for
+ * @param max_streams the max number of RTP streams the worker handles RTCP for
+ * @remark Must be called before the engine is started. RTP streams exceeding
+ *         the max number fall back to RTCP processing on the timer clock.
+ */
+MPF_DECLARE(apt_bool_t) mpf_engine_rtcp_worker_set(mpf_engine_t *engine, apr_size_t max_streams);
+
+/**
+ * Preallocate media contexts, bridges and their frame buffers from per-engine slabs.
+ * @param engine the engine to set slabs for
+ * @param max_context_count the max number of contexts (sessions) to preallocate memory for
+ * @remark Must be called before the engine is started. Contexts are recycled by mpf_engine_context_destroy().
+ */
+MPF_DECLARE(apt_bool_t) mpf_engine_slab_set(mpf_engine_t *engine, apr_size_t max_context_count);
+
 /**
  * Set scheduler rate.
  * @param engine the engine to set rate for
@@ -153,6 +173,19 @@ MPF_DECLARE(apt_bool_t) mpf_engine_message_send(mpf_engine_t *engine, mpf_task_m
  */
 MPF_DECLARE(apt_bool_t) mpf_engine_scheduler_rate_set(mpf_engine_t *engine, unsigned long rate);
 
+/**
+ * Get the number of media ticks processed a whole period late (load indicator).
+ * @param engine the engine to get the overrun count of
+ */
+MPF_DECLARE(apr_uint32_t) mpf_engine_overrun_count_get(mpf_engine_t *engine);
+
+/**
+ * Get the statistics of the media clock (tick count, overruns and jitter).
+ * @param engine the engine to get the statistics of
+ * @param stats the statistics to fill
+ */
+MPF_DECLARE(void) mpf_engine_scheduler_stats_get(mpf_engine_t *engine, mpf_scheduler_stats_t *stats);
+
 /**
  * Get the identifier of the engine .
  * @param engine the engine to get name of
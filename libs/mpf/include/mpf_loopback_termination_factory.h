@@ -0,0 +1,50 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifndef MPF_LOOPBACK_TERMINATION_FACTORY_H
+#define MPF_LOOPBACK_TERMINATION_FACTORY_H
+
+/**
+ * @file mpf_loopback_termination_factory.h
+ * @brief MPF Loopback Termination Factory
+ */ 
+
+#include "mpf_termination_factory.h"
+#include "mpf_rtp_descriptor.h"
+
+APT_BEGIN_EXTERN_C
+
+/**
+ * Create loopback termination factory.
+ * @param max_stream_count the max number of streams to exist simultaneously
+ * @param pool the pool to allocate memory from
+ * @remark Terminations of the factory are used in place of RTP terminations and
+ *         accept the same descriptors (mpf_rtp_termination_descriptor_t). Instead of
+ *         RTP sockets, a pair of terminations of the same factory exchange media frames
+ *         in process through lock-free single-producer/single-consumer rings. The same
+ *         factory should be assigned to both MRCP client and server profiles. The port
+ *         of the local media descriptor identifies the ring of the stream.
+ */
+MPF_DECLARE(mpf_termination_factory_t*) mpf_loopback_termination_factory_create(
+										apr_size_t max_stream_count,
+										apr_pool_t *pool);
+
+
+APT_END_EXTERN_C
+
+#endif /* MPF_LOOPBACK_TERMINATION_FACTORY_H */
@@ -25,6 +25,7 @@
  */ 
 
 #include "mpf_object.h"
+#include "mpf_slab.h"
 
 APT_BEGIN_EXTERN_C
 
@@ -45,6 +46,26 @@ MPF_DECLARE(mpf_object_t*) mpf_mixer_create(
 								const char *name,
 								apr_pool_t *pool);
 
+/**
+ * Create audio stream mixer allocating it from the slab.
+ * @param source_arr the array of audio sources
+ * @param source_count the number of audio sources
+ * @param sink the audio sink
+ * @param codec_manager the codec manager
+ * @param name the informative name used for debugging
+ * @param slab the slab to allocate the mixer and its frame buffers from (optional)
+ * @param pool the pool to allocate memory from, if the slab is exhausted or not specified
+ * @remark The memory taken from the slab is released, when the mixer is destroyed.
+ */
+MPF_DECLARE(mpf_object_t*) mpf_mixer_create_ex(
+								mpf_audio_stream_t **source_arr, 
+								apr_size_t source_count, 
+								mpf_audio_stream_t *sink, 
+								const mpf_codec_manager_t *codec_manager,
+								const char *name,
+								mpf_slab_t *slab,
+								apr_pool_t *pool);
+
 
 APT_END_EXTERN_C
 
@@ -25,6 +25,7 @@
  */ 
 
 #include "mpf_object.h"
+#include "mpf_slab.h"
 
 APT_BEGIN_EXTERN_C
 
@@ -45,6 +46,26 @@ MPF_DECLARE(mpf_object_t*) mpf_multiplier_create(
 								const char *name,
 								apr_pool_t *pool);
 
+/**
+ * Create audio stream multiplier allocating it from the slab.
+ * @param source the audio source
+ * @param sink_arr the array of audio sinks
+ * @param sink_count the number of audio sinks
+ * @param codec_manager the codec manager
+ * @param name the informative name used for debugging
+ * @param slab the slab to allocate the multiplier and its frame buffer from (optional)
+ * @param pool the pool to allocate memory from, if the slab is exhausted or not specified
+ * @remark The memory taken from the slab is released, when the multiplier is destroyed.
+ */
+MPF_DECLARE(mpf_object_t*) mpf_multiplier_create_ex(
+								mpf_audio_stream_t *source,
+								mpf_audio_stream_t **sink_arr,
+								apr_size_t sink_count,
+								const mpf_codec_manager_t *codec_manager,
+								const char *name,
+								mpf_slab_t *slab,
+								apr_pool_t *pool);
+
 
 APT_END_EXTERN_C
 
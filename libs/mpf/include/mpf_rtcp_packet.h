@@ -25,6 +25,7 @@
  */ 
 
 #include "mpf_rtp_stat.h"
+#include "apt_string.h"
 
 APT_BEGIN_EXTERN_C
 
@@ -198,6 +199,42 @@ static APR_INLINE void rtcp_rr_ntoh(rtcp_rr_stat_t *rr_stat)
 #endif
 }
 
+/**
+ * Generate RTCP SR or RR packet.
+ * @param record the statistics record to generate the report from
+ * @param rtcp_packet the packet to generate
+ * @param length the available length
+ * @return the length of the generated packet
+ */
+MPF_DECLARE(apr_size_t) mpf_rtcp_report_generate(const mpf_rtp_stat_record_t *record, rtcp_packet_t *rtcp_packet, apr_size_t length);
+
+/**
+ * Generate RTCP SDES packet.
+ * @param ssrc the source identifier
+ * @param cname the canonical name of the source
+ * @param rtcp_packet the packet to generate
+ * @param length the available length
+ * @return the length of the generated packet
+ */
+MPF_DECLARE(apr_size_t) mpf_rtcp_sdes_generate(apr_uint32_t ssrc, const apt_str_t *cname, rtcp_packet_t *rtcp_packet, apr_size_t length);
+
+/**
+ * Generate RTCP BYE packet.
+ * @param ssrc the source identifier
+ * @param reason the optional reason string
+ * @param rtcp_packet the packet to generate
+ * @param length the available length
+ * @return the length of the generated packet
+ */
+MPF_DECLARE(apr_size_t) mpf_rtcp_bye_generate(apr_uint32_t ssrc, const apt_str_t *reason, rtcp_packet_t *rtcp_packet, apr_size_t length);
+
+/**
+ * Parse received compound RTCP packet.
+ * @param buffer the buffer to parse (converted to host byte order in place)
+ * @param length the length of the buffer
+ */
+MPF_DECLARE(apt_bool_t) mpf_rtcp_compound_packet_parse(char *buffer, apr_size_t length);
+
 APT_END_EXTERN_C
 
 #endif /* MPF_RTCP_PACKET_H */
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#ifndef MPF_RTCP_WORKER_H
+#define MPF_RTCP_WORKER_H
+
+/**
+ * @file mpf_rtcp_worker.h
+ * @brief MPF RTCP Worker (RTCP Processing off the Media Clock)
+ */ 
+
+#include <apr_network_io.h>
+#include <apr_atomic.h>
+#include "mpf_rtp_stat.h"
+#include "apt_string.h"
+
+APT_BEGIN_EXTERN_C
+
+/** Opaque RTCP worker declaration */
+typedef struct mpf_rtcp_worker_t mpf_rtcp_worker_t;
+/** Opaque RTCP slot (entry of an RTP stream in the worker) declaration */
+typedef struct mpf_rtcp_slot_t mpf_rtcp_slot_t;
+
+/**
+ * Create RTCP worker.
+ * @param max_streams the max number of RTP streams the worker handles RTCP for
+ * @param pool the pool to allocate memory from
+ * @remark The worker generates and sends RTCP reports and polls for incoming RTCP packets
+ *         in its own thread, reading per-stream statistics records the media thread updates.
+ */
+MPF_DECLARE(mpf_rtcp_worker_t*) mpf_rtcp_worker_create(apr_size_t max_streams, apr_pool_t *pool);
+
+/** Destroy RTCP worker */
+MPF_DECLARE(void) mpf_rtcp_worker_destroy(mpf_rtcp_worker_t *worker);
+
+/** Start RTCP worker */
+MPF_DECLARE(apt_bool_t) mpf_rtcp_worker_start(mpf_rtcp_worker_t *worker);
+
+/** Stop RTCP worker */
+MPF_DECLARE(apt_bool_t) mpf_rtcp_worker_stop(mpf_rtcp_worker_t *worker);
+
+/**
+ * Acquire a free slot (media thread).
+ * @param worker the worker to acquire slot from
+ * @return the slot, or NULL if all the slots are in use
+ * @remark Until activated, the slot and its pool are owned by the caller.
+ */
+MPF_DECLARE(mpf_rtcp_slot_t*) mpf_rtcp_slot_acquire(mpf_rtcp_worker_t *worker);
+
+/** Get the pool to create RTCP socket from, which is cleared when the slot is released */
+MPF_DECLARE(apr_pool_t*) mpf_rtcp_slot_pool_get(mpf_rtcp_slot_t *slot);
+
+/** Get the statistics record of the slot to update by the media thread */
+MPF_DECLARE(mpf_rtp_stat_record_t*) mpf_rtcp_slot_record_get(mpf_rtcp_slot_t *slot);
+
+/**
+ * Hand the slot over to the worker (media thread).
+ * @param slot the slot to activate
+ * @param socket the RTCP socket created from the pool of the slot
+ * @param cname the canonical name used in SDES
+ * @param tx_interval the RTCP report transmission interval (msec)
+ * @param rx_resolution the RTCP rx resolution (msec)
+ */
+MPF_DECLARE(void) mpf_rtcp_slot_activate(
+						mpf_rtcp_slot_t *slot,
+						apr_socket_t *socket,
+						const apt_str_t *cname,
+						apr_uint16_t tx_interval,
+						apr_uint16_t rx_resolution);
+
+/** Set the remote RTCP address of the slot (media thread) */
+MPF_DECLARE(void) mpf_rtcp_slot_remote_set(mpf_rtcp_slot_t *slot, const apt_str_t *ip, apr_port_t port);
+
+/** Enable or disable RTCP processing of the slot (media thread) */
+MPF_DECLARE(void) mpf_rtcp_slot_enable(mpf_rtcp_slot_t *slot, apt_bool_t enable);
+
+/**
+ * Request the worker to send RTCP BYE (media thread).
+ * @param slot the slot to send BYE for
+ * @param reason the reason string, which must remain valid for the lifetime of the process
+ */
+MPF_DECLARE(void) mpf_rtcp_slot_bye_request(mpf_rtcp_slot_t *slot, const char *reason);
+
+/**
+ * Release the slot (media thread).
+ * @remark A pending BYE is sent before the worker closes the socket and returns the slot to the free ones.
+ */
+MPF_DECLARE(void) mpf_rtcp_slot_release(mpf_rtcp_slot_t *slot);
+
+/** Get the number of RTCP reports generated for the slot */
+MPF_DECLARE(apr_uint32_t) mpf_rtcp_slot_report_count_get(mpf_rtcp_slot_t *slot);
+
+/** Start updating the statistics record (media thread) */
+static APR_INLINE void mpf_rtp_stat_record_update_begin(mpf_rtp_stat_record_t *record)
+{
+	apr_atomic_inc32(&record->version);
+}
+
+/** Complete updating the statistics record (media thread) */
+static APR_INLINE void mpf_rtp_stat_record_update_end(mpf_rtp_stat_record_t *record)
+{
+	apr_atomic_inc32(&record->version);
+}
+
+APT_END_EXTERN_C
+
+#endif /* MPF_RTCP_WORKER_H */
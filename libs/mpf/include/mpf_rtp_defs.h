@@ -25,6 +25,7 @@
  */ 
 
 #include "mpf_rtp_stat.h"
+#include "mpf_rtp_header.h"
 #include "mpf_jitter_buffer.h"
 
 APT_BEGIN_EXTERN_C
@@ -144,6 +145,10 @@ struct rtp_transmitter_t {
 	/** RTP packet payload size */
 	apr_size_t      packet_size;
 
+	/** RTP header template with version, payload type and SSRC pre-filled
+	 *  (marker, sequence number and timestamp are patched per packet) */
+	rtp_header_t    header_template;
+
 	/** RTCP statistics used in SR */
 	rtcp_sr_stat_t  sr_stat;
 };
@@ -177,6 +182,16 @@ static APR_INLINE void rtp_transmitter_init(rtp_transmitter_t *transmitter)
 	transmitter->packet_data = NULL;
 	transmitter->packet_size = 0;
 
+	transmitter->header_template.version = RTP_VERSION;
+	transmitter->header_template.padding = 0;
+	transmitter->header_template.extension = 0;
+	transmitter->header_template.count = 0;
+	transmitter->header_template.marker = 0;
+	transmitter->header_template.type = 0;
+	transmitter->header_template.sequence = 0;
+	transmitter->header_template.timestamp = 0;
+	transmitter->header_template.ssrc = 0;
+
 	mpf_rtcp_sr_stat_reset(&transmitter->sr_stat);
 }
 
@@ -35,6 +35,8 @@ typedef struct rtp_rx_stat_t rtp_rx_stat_t;
 typedef struct rtcp_sr_stat_t rtcp_sr_stat_t;
 /** RTCP statistics used in Receiver Report (RR) */
 typedef struct rtcp_rr_stat_t rtcp_rr_stat_t;
+/** Compact per-stream statistics record */
+typedef struct mpf_rtp_stat_record_t mpf_rtp_stat_record_t;
 
 
 /** RTP receiver statistics */
@@ -90,6 +92,22 @@ struct rtcp_rr_stat_t {
 	apr_uint32_t dlsr;
 };
 
+/** Compact per-stream statistics record, which is all the RTCP reports are generated from */
+struct mpf_rtp_stat_record_t {
+	/** update counter, odd while the record is being updated */
+	volatile apr_uint32_t version;
+	/** direction of the stream (mpf_stream_direction_e) */
+	apr_uint32_t          direction;
+	/** statistics used in SR (NTP timestamp is set on report generation) */
+	rtcp_sr_stat_t        sr_stat;
+	/** statistics used in RR (fraction and cumulative number of lost packets are set on report generation) */
+	rtcp_rr_stat_t        rr_stat;
+	/** number of valid RTP packets received */
+	apr_uint32_t          received_packets;
+	/** number of RTP packets expected */
+	apr_uint32_t          expected_packets;
+};
+
 
 
 /** Reset RTCP SR statistics */
@@ -110,6 +128,39 @@ static APR_INLINE void mpf_rtp_rx_stat_reset(rtp_rx_stat_t *rx_stat)
 	memset(rx_stat,0,sizeof(rtp_rx_stat_t));
 }
 
+/** Calculate lost fraction since the prior report and cumulative number of lost packets (RFC3550 A.3) */
+static APR_INLINE void mpf_rtcp_rr_loss_calculate(
+							rtcp_rr_stat_t *rr_stat,
+							apr_uint32_t expected_packets,
+							apr_uint32_t received_packets,
+							apr_uint32_t *expected_prior,
+							apr_uint32_t *received_prior)
+{
+	apr_uint32_t expected_interval = expected_packets - *expected_prior;
+	apr_uint32_t received_interval = received_packets - *received_prior;
+	apr_uint32_t lost_interval = 0;
+
+	*expected_prior = expected_packets;
+	*received_prior = received_packets;
+	if(expected_interval > received_interval) {
+		lost_interval = expected_interval - received_interval;
+	}
+
+	if(expected_interval == 0 || lost_interval == 0) {
+		rr_stat->fraction = 0;
+	}
+	else {
+		rr_stat->fraction = (lost_interval << 8) / expected_interval;
+	}
+
+	if(expected_packets > received_packets) {
+		rr_stat->lost = expected_packets - received_packets;
+	}
+	else {
+		rr_stat->lost = 0;
+	}
+}
+
 APT_END_EXTERN_C
 
 #endif /* MPF_RTP_STAT_H */
@@ -28,6 +28,21 @@
 
 APT_BEGIN_EXTERN_C
 
+/** Scheduler statistics declaration */
+typedef struct mpf_scheduler_stats_t mpf_scheduler_stats_t;
+
+/** Scheduler statistics accumulated since the scheduler was started */
+struct mpf_scheduler_stats_t {
+	/** Number of processed ticks */
+	apr_uint32_t tick_count;
+	/** Number of ticks processed a whole period late */
+	apr_uint32_t overrun_count;
+	/** Mean deviation of the interval between ticks from the period (usec) */
+	apr_uint32_t jitter_mean;
+	/** Max deviation of the interval between ticks from the period (usec) */
+	apr_uint32_t jitter_max;
+};
+
 /** Prototype of scheduler callback */
 typedef void (*mpf_scheduler_proc_f)(mpf_scheduler_t *scheduler, void *obj);
 
@@ -56,6 +71,12 @@ MPF_DECLARE(apt_bool_t) mpf_scheduler_rate_set(
 								mpf_scheduler_t *scheduler,
 								unsigned long rate);
 
+/** Get the number of ticks processed a whole period late since the scheduler was started */
+MPF_DECLARE(apr_uint32_t) mpf_scheduler_overrun_count_get(mpf_scheduler_t *scheduler);
+
+/** Get the statistics of the scheduler */
+MPF_DECLARE(void) mpf_scheduler_stats_get(mpf_scheduler_t *scheduler, mpf_scheduler_stats_t *stats);
+
 /** Start scheduler */
 MPF_DECLARE(apt_bool_t) mpf_scheduler_start(mpf_scheduler_t *scheduler);
 
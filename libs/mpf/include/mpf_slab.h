@@ -0,0 +1,96 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#ifndef MPF_SLAB_H
+#define MPF_SLAB_H
+
+/**
+ * @file mpf_slab.h
+ * @brief MPF Slab of Fixed-Size Memory Blocks
+ */ 
+
+#include "mpf_types.h"
+
+APT_BEGIN_EXTERN_C
+
+/** Alignment of the blocks of the slab (cache line) */
+#define MPF_SLAB_ALIGNMENT 64
+
+/** Align the size to the boundary of the blocks of the slab */
+#define MPF_SLAB_ALIGN(size) (((size) + MPF_SLAB_ALIGNMENT - 1) & ~((apr_size_t)MPF_SLAB_ALIGNMENT - 1))
+
+/** Opaque slab declaration */
+typedef struct mpf_slab_t mpf_slab_t;
+
+/**
+ * Create slab.
+ * @param block_size the size of each block, rounded up to MPF_SLAB_ALIGNMENT
+ * @param block_count the number of blocks
+ * @param pool the pool to allocate the contiguous memory of the blocks from
+ * @remark Blocks are taken and released in LIFO order, so that recently used memory is reused first.
+ *         The slab may be used by several threads.
+ */
+MPF_DECLARE(mpf_slab_t*) mpf_slab_create(apr_size_t block_size, apr_size_t block_count, apr_pool_t *pool);
+
+/** Destroy slab */
+MPF_DECLARE(void) mpf_slab_destroy(mpf_slab_t *slab);
+
+/**
+ * Take a block from the slab.
+ * @param slab the slab to take block from
+ * @param size the required size
+ * @return the block, or NULL, if the size exceeds the size of blocks or all the blocks are in use
+ */
+MPF_DECLARE(void*) mpf_slab_block_take(mpf_slab_t *slab, apr_size_t size);
+
+/**
+ * Release a block back to the slab.
+ * @param slab the slab the block has been taken from
+ * @param block the block to release
+ * @return FALSE, if the memory does not belong to the slab, which is then left untouched
+ */
+MPF_DECLARE(apt_bool_t) mpf_slab_block_release(mpf_slab_t *slab, void *block);
+
+/** Get the number of blocks in use */
+MPF_DECLARE(apr_size_t) mpf_slab_used_count_get(mpf_slab_t *slab);
+
+/**
+ * Allocate memory from the slab, if there is one and a block fits the size, or from the pool otherwise.
+ * @remark Memory is returned by mpf_slab_pfree(), which ignores memory allocated from the pool.
+ */
+static APR_INLINE void* mpf_slab_palloc(mpf_slab_t *slab, apr_size_t size, apr_pool_t *pool)
+{
+	void *mem = slab ? mpf_slab_block_take(slab,size) : NULL;
+	if(!mem) {
+		mem = apr_palloc(pool,size);
+	}
+	return mem;
+}
+
+/** Release memory allocated by mpf_slab_palloc() */
+static APR_INLINE void mpf_slab_pfree(mpf_slab_t *slab, void *mem)
+{
+	if(slab) {
+		mpf_slab_block_release(slab,mem);
+	}
+}
+
+APT_END_EXTERN_C
+
+#endif /* MPF_SLAB_H */
@@ -25,6 +25,7 @@
  */ 
 
 #include "mpf_types.h"
+#include "mpf_rtcp_worker.h"
 #include "apt_timer_queue.h"
 
 APT_BEGIN_EXTERN_C
@@ -65,6 +66,8 @@ struct mpf_termination_t {
 	const mpf_codec_manager_t      *codec_manager;
 	/** Timer queue */
 	apt_timer_queue_t              *timer_queue;
+	/** RTCP worker (optional) */
+	mpf_rtcp_worker_t              *rtcp_worker;
 	/** Termination factory entire termination created by */
 	mpf_termination_factory_t      *termination_factory;
 	/** Table of virtual methods */
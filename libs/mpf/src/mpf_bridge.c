@@ -21,6 +21,7 @@
 #include "mpf_decoder.h"
 #include "mpf_resampler.h"
 #include "mpf_codec_manager.h"
+#include "mpf_slab.h"
 #include "apt_log.h"
 
 typedef struct mpf_bridge_t mpf_bridge_t;
@@ -37,6 +38,8 @@ struct mpf_bridge_t {
 	mpf_codec_t        *codec;
 	/** Media frame used to read data from source and write it to sink */
 	mpf_frame_t         frame;
+	/** Slab the bridge and its frame buffer are allocated from, if any */
+	mpf_slab_t         *slab;
 };
 
 static apt_bool_t mpf_bridge_process(mpf_object_t *object)
@@ -100,20 +103,25 @@ static apt_bool_t mpf_bridge_destroy(mpf_object_t *object)
 	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Destroy Audio Bridge %s",object->name);
 	mpf_audio_stream_rx_close(bridge->source);
 	mpf_audio_stream_tx_close(bridge->sink);
+	mpf_slab_pfree(bridge->slab,bridge);
 	return TRUE;
 }
 
-static mpf_bridge_t* mpf_bridge_base_create(mpf_audio_stream_t *source, mpf_audio_stream_t *sink, const char *name, apr_pool_t *pool)
+static mpf_bridge_t* mpf_bridge_base_create(mpf_audio_stream_t *source, mpf_audio_stream_t *sink, const char *name, apr_size_t frame_size, mpf_slab_t *slab, apr_pool_t *pool)
 {
 	mpf_bridge_t *bridge;
 	if(!source || !sink) {
 		return NULL;
 	}
 
-	bridge = apr_palloc(pool,sizeof(mpf_bridge_t));
+	/* the frame buffer immediately follows the bridge */
+	bridge = mpf_slab_palloc(slab,sizeof(mpf_bridge_t) + frame_size,pool);
 	bridge->source = source;
 	bridge->sink = sink;
 	bridge->codec = NULL;
+	bridge->slab = slab;
+	bridge->frame.codec_frame.size = frame_size;
+	bridge->frame.codec_frame.buffer = bridge + 1;
 	mpf_object_init(&bridge->base,name);
 	bridge->base.destroy = mpf_bridge_destroy;
 	bridge->base.process = mpf_bridge_process;
@@ -121,59 +129,57 @@ static mpf_bridge_t* mpf_bridge_base_create(mpf_audio_stream_t *source, mpf_audi
 	return bridge;
 }
 
-static mpf_object_t* mpf_linear_bridge_create(mpf_audio_stream_t *source, mpf_audio_stream_t *sink, const mpf_codec_manager_t *codec_manager, const char *name, apr_pool_t *pool)
+static mpf_object_t* mpf_linear_bridge_create(mpf_audio_stream_t *source, mpf_audio_stream_t *sink, const mpf_codec_manager_t *codec_manager, const char *name, mpf_slab_t *slab, apr_pool_t *pool)
 {
 	mpf_codec_descriptor_t *descriptor;
 	apr_size_t frame_size;
 	mpf_bridge_t *bridge;
 	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Create Linear Audio Bridge %s",name);
-	bridge = mpf_bridge_base_create(source,sink,name,pool);
+	descriptor = source->rx_descriptor;
+	frame_size = mpf_codec_linear_frame_size_calculate(descriptor->sampling_rate,descriptor->channel_count);
+	bridge = mpf_bridge_base_create(source,sink,name,frame_size,slab,pool);
 	if(!bridge) {
 		return NULL;
 	}
 
-	descriptor = source->rx_descriptor;
-	frame_size = mpf_codec_linear_frame_size_calculate(descriptor->sampling_rate,descriptor->channel_count);
-	bridge->frame.codec_frame.size = frame_size;
-	bridge->frame.codec_frame.buffer = apr_palloc(pool,frame_size);
-	
 	if(mpf_audio_stream_rx_open(source,NULL) == FALSE) {
+		mpf_slab_pfree(slab,bridge);
 		return NULL;
 	}
 	if(mpf_audio_stream_tx_open(sink,NULL) == FALSE) {
 		mpf_audio_stream_rx_close(source);
+		mpf_slab_pfree(slab,bridge);
 		return NULL;
 	}
 	return &bridge->base;
 }
 
-static mpf_object_t* mpf_null_bridge_create(mpf_audio_stream_t *source, mpf_audio_stream_t *sink, const mpf_codec_manager_t *codec_manager, const char *name, apr_pool_t *pool)
+static mpf_object_t* mpf_null_bridge_create(mpf_audio_stream_t *source, mpf_audio_stream_t *sink, const mpf_codec_manager_t *codec_manager, const char *name, mpf_slab_t *slab, apr_pool_t *pool)
 {
 	mpf_codec_t *codec;
 	apr_size_t frame_size;
 	mpf_bridge_t *bridge;
 	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Create Null Audio Bridge %s",name);
-	bridge = mpf_bridge_base_create(source,sink,name,pool);
-	if(!bridge) {
-		return NULL;
-	}
-	bridge->base.process = mpf_null_bridge_process;
-
 	codec = mpf_codec_manager_codec_get(codec_manager,source->rx_descriptor,pool);
 	if(!codec) {
 		return NULL;
 	}
 
 	frame_size = mpf_codec_frame_size_calculate(source->rx_descriptor,codec->attribs);
+	bridge = mpf_bridge_base_create(source,sink,name,frame_size,slab,pool);
+	if(!bridge) {
+		return NULL;
+	}
+	bridge->base.process = mpf_null_bridge_process;
 	bridge->codec = codec;
-	bridge->frame.codec_frame.size = frame_size;
-	bridge->frame.codec_frame.buffer = apr_palloc(pool,frame_size);
 
 	if(mpf_audio_stream_rx_open(source,codec) == FALSE) {
+		mpf_slab_pfree(slab,bridge);
 		return NULL;
 	}
 	if(mpf_audio_stream_tx_open(sink,codec) == FALSE) {
 		mpf_audio_stream_rx_close(source);
+		mpf_slab_pfree(slab,bridge);
 		return NULL;
 	}
 	return &bridge->base;
@@ -185,6 +191,17 @@ MPF_DECLARE(mpf_object_t*) mpf_bridge_create(
 						const mpf_codec_manager_t *codec_manager, 
 						const char *name,
 						apr_pool_t *pool)
+{
+	return mpf_bridge_create_ex(source,sink,codec_manager,name,NULL,pool);
+}
+
+MPF_DECLARE(mpf_object_t*) mpf_bridge_create_ex(
+						mpf_audio_stream_t *source, 
+						mpf_audio_stream_t *sink, 
+						const mpf_codec_manager_t *codec_manager, 
+						const char *name,
+						mpf_slab_t *slab,
+						apr_pool_t *pool)
 {
 	if(!source || !sink) {
 		return NULL;
@@ -196,7 +213,7 @@ MPF_DECLARE(mpf_object_t*) mpf_bridge_create(
 	}
 
 	if(mpf_codec_descriptors_match(source->rx_descriptor,sink->tx_descriptor) == TRUE) {
-		return mpf_null_bridge_create(source,sink,codec_manager,name,pool);
+		return mpf_null_bridge_create(source,sink,codec_manager,name,slab,pool);
 	}
 
 	if(mpf_codec_lpcm_descriptor_match(source->rx_descriptor) == FALSE) {
@@ -226,5 +243,5 @@ MPF_DECLARE(mpf_object_t*) mpf_bridge_create(
 		source = resampler;
 	}
 
-	return mpf_linear_bridge_create(source,sink,codec_manager,name,pool);
+	return mpf_linear_bridge_create(source,sink,codec_manager,name,slab,pool);
 }
@@ -26,8 +26,12 @@
 #include "mpf_bridge.h"
 #include "mpf_multiplier.h"
 #include "mpf_mixer.h"
+#include "mpf_slab.h"
 #include "apt_log.h"
 
+/** Max number of media processing objects per termination (bridge or multiplier, and mixer) */
+#define MAX_OBJECTS_PER_TERMINATION 2
+
 /** Item of the association matrix */
 typedef struct {
 	unsigned char on;
@@ -64,13 +68,19 @@ struct mpf_context_t {
 
 	/** Array of media processing objects constructed while 
 	applying topology based on association matrix */
-	apr_array_header_t           *mpf_objects;
+	mpf_object_t                **mpf_objects;
+	/** Number of media processing objects */
+	apr_size_t                    mpf_object_count;
 };
 
 /** Factory of media contexts */
 struct mpf_context_factory_t {
 	/** Ring head */
 	APR_RING_HEAD(mpf_context_head_t, mpf_context_t) head;
+	/** Slab to allocate contexts from (optional) */
+	mpf_slab_t                   *context_slab;
+	/** Slab to allocate media processing objects from (optional) */
+	mpf_slab_t                   *object_slab;
 };
 
 
@@ -84,9 +94,38 @@ MPF_DECLARE(mpf_context_factory_t*) mpf_context_factory_create(apr_pool_t *pool)
 {
 	mpf_context_factory_t *factory = apr_palloc(pool, sizeof(mpf_context_factory_t));
 	APR_RING_INIT(&factory->head, mpf_context_t, link);
+	factory->context_slab = NULL;
+	factory->object_slab = NULL;
 	return factory;
 }
 
+/** Calculate the size of the memory holding the context, its association matrix and array of objects */
+static apr_size_t mpf_context_storage_size(apr_size_t capacity)
+{
+	return APR_ALIGN_DEFAULT(sizeof(mpf_context_t)) +
+		APR_ALIGN_DEFAULT(capacity * sizeof(header_item_t)) +
+		APR_ALIGN_DEFAULT(capacity * sizeof(matrix_item_t*)) +
+		APR_ALIGN_DEFAULT(capacity * MAX_OBJECTS_PER_TERMINATION * sizeof(mpf_object_t*)) +
+		capacity * capacity * sizeof(matrix_item_t);
+}
+
+MPF_DECLARE(apt_bool_t) mpf_context_factory_slab_set(mpf_context_factory_t *factory, apr_size_t max_context_count, apr_pool_t *pool)
+{
+	if(factory->context_slab || !max_context_count) {
+		return FALSE;
+	}
+
+	factory->context_slab = mpf_slab_create(
+								mpf_context_storage_size(MPF_CONTEXT_SLAB_TERMINATION_COUNT),
+								max_context_count,
+								pool);
+	factory->object_slab = mpf_slab_create(
+								MPF_OBJECT_SLAB_BLOCK_SIZE,
+								max_context_count * MPF_CONTEXT_SLAB_OBJECT_COUNT,
+								pool);
+	return factory->context_slab ? TRUE : FALSE;
+}
+
 MPF_DECLARE(void) mpf_context_factory_destroy(mpf_context_factory_t *factory)
 {
 	mpf_context_t *context;
@@ -95,6 +134,15 @@ MPF_DECLARE(void) mpf_context_factory_destroy(mpf_context_factory_t *factory)
 		mpf_context_destroy(context);
 		APR_RING_REMOVE(context, link);
 	}
+
+	if(factory->object_slab) {
+		mpf_slab_destroy(factory->object_slab);
+		factory->object_slab = NULL;
+	}
+	if(factory->context_slab) {
+		mpf_slab_destroy(factory->context_slab);
+		factory->context_slab = NULL;
+	}
 }
 
 MPF_DECLARE(apt_bool_t) mpf_context_factory_process(mpf_context_factory_t *factory)
@@ -121,7 +169,20 @@ MPF_DECLARE(mpf_context_t*) mpf_context_create(
 	apr_size_t i,j;
 	matrix_item_t *matrix_item;
 	header_item_t *header_item;
-	mpf_context_t *context = apr_palloc(pool,sizeof(mpf_context_t));
+	matrix_item_t *matrix_items;
+	mpf_context_t *context;
+	/* the context, its association matrix and array of objects are allocated as a whole */
+	char *mem = mpf_slab_palloc(factory->context_slab,mpf_context_storage_size(max_termination_count),pool);
+	context = (mpf_context_t*) mem;
+	mem += APR_ALIGN_DEFAULT(sizeof(mpf_context_t));
+	context->header = (header_item_t*) mem;
+	mem += APR_ALIGN_DEFAULT(max_termination_count * sizeof(header_item_t));
+	context->matrix = (matrix_item_t**) mem;
+	mem += APR_ALIGN_DEFAULT(max_termination_count * sizeof(matrix_item_t*));
+	context->mpf_objects = (mpf_object_t**) mem;
+	mem += APR_ALIGN_DEFAULT(max_termination_count * MAX_OBJECTS_PER_TERMINATION * sizeof(mpf_object_t*));
+	matrix_items = (matrix_item_t*) mem;
+
 	APR_RING_ELEM_INIT(context,link);
 	context->factory = factory;
 	context->obj = obj;
@@ -132,15 +193,13 @@ MPF_DECLARE(mpf_context_t*) mpf_context_create(
 	}
 	context->capacity = max_termination_count;
 	context->count = 0;
-	context->mpf_objects = apr_array_make(pool,1,sizeof(mpf_object_t*));
-	context->header = apr_palloc(pool,context->capacity * sizeof(header_item_t));
-	context->matrix = apr_palloc(pool,context->capacity * sizeof(matrix_item_t*));
+	context->mpf_object_count = 0;
 	for(i=0; i<context->capacity; i++) {
 		header_item = &context->header[i];
 		header_item->termination = NULL;
 		header_item->tx_count = 0;
 		header_item->rx_count = 0;
-		context->matrix[i] = apr_palloc(pool,context->capacity * sizeof(matrix_item_t));
+		context->matrix[i] = matrix_items + i * context->capacity;
 		for(j=0; j<context->capacity; j++) {
 			matrix_item = &context->matrix[i][j];
 			matrix_item->on = 0;
@@ -164,6 +223,21 @@ MPF_DECLARE(apt_bool_t) mpf_context_destroy(mpf_context_t *context)
 	return TRUE;
 }
 
+MPF_DECLARE(apt_bool_t) mpf_context_release(mpf_context_t *context)
+{
+	if(context->count) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Cannot Release Media Context %s [%"APR_SIZE_T_FMT" terminations]",
+			context->name,
+			context->count);
+		return FALSE;
+	}
+
+	/* the topology is normally destroyed by the media engine before terminations are subtracted */
+	mpf_context_topology_destroy(context);
+	mpf_slab_pfree(context->factory->context_slab,context);
+	return TRUE;
+}
+
 MPF_DECLARE(void*) mpf_context_object_get(const mpf_context_t *context)
 {
 	return context->obj;
@@ -372,8 +446,12 @@ static apt_bool_t mpf_context_object_add(mpf_context_t *context, mpf_object_t *o
 	if(!object) {
 		return FALSE;
 	}
+	if(context->mpf_object_count >= context->capacity * MAX_OBJECTS_PER_TERMINATION) {
+		mpf_object_destroy(object);
+		return FALSE;
+	}
 	
-	APR_ARRAY_PUSH(context->mpf_objects, mpf_object_t*) = object;
+	context->mpf_objects[context->mpf_object_count++] = object;
 #if 1
 	mpf_object_trace(object);
 #endif
@@ -418,24 +496,22 @@ MPF_DECLARE(apt_bool_t) mpf_context_topology_apply(mpf_context_t *context)
 
 MPF_DECLARE(apt_bool_t) mpf_context_topology_destroy(mpf_context_t *context)
 {
-	if(context->mpf_objects->nelts) {
-		int i;
-		mpf_object_t *object;
-		for(i=0; i<context->mpf_objects->nelts; i++) {
-			object = APR_ARRAY_IDX(context->mpf_objects,i,mpf_object_t*);
-			mpf_object_destroy(object);
+	if(context->mpf_object_count) {
+		apr_size_t i;
+		for(i=0; i<context->mpf_object_count; i++) {
+			mpf_object_destroy(context->mpf_objects[i]);
 		}
-		apr_array_clear(context->mpf_objects);
+		context->mpf_object_count = 0;
 	}
 	return TRUE;
 }
 
 MPF_DECLARE(apt_bool_t) mpf_context_process(mpf_context_t *context)
 {
-	int i;
+	apr_size_t i;
 	mpf_object_t *object;
-	for(i=0; i<context->mpf_objects->nelts; i++) {
-		object = APR_ARRAY_IDX(context->mpf_objects,i,mpf_object_t*);
+	for(i=0; i<context->mpf_object_count; i++) {
+		object = context->mpf_objects[i];
 		if(object && object->process) {
 			object->process(object);
 		}
@@ -467,11 +543,12 @@ static mpf_object_t* mpf_context_bridge_create(mpf_context_t *context, apr_size_
 		
 		/* create bridge i -> j */
 		if(header_item1->termination && header_item2->termination) {
-			return mpf_bridge_create(
+			return mpf_bridge_create_ex(
 				header_item1->termination->audio_stream,
 				header_item2->termination->audio_stream,
 				header_item1->termination->codec_manager,
 				context->name,
+				context->factory->object_slab,
 				context->pool);
 		}
 	}
@@ -498,12 +575,13 @@ static mpf_object_t* mpf_context_multiplier_create(mpf_context_t *context, apr_s
 		sink_arr[k] = header_item2->termination->audio_stream;
 		k++;
 	}
-	return mpf_multiplier_create(
+	return mpf_multiplier_create_ex(
 				header_item1->termination->audio_stream,
 				sink_arr,
 				header_item1->tx_count,
 				header_item1->termination->codec_manager,
 				context->name,
+				context->factory->object_slab,
 				context->pool);
 }
 
@@ -527,12 +605,13 @@ static mpf_object_t* mpf_context_mixer_create(mpf_context_t *context, apr_size_t
 		source_arr[k] = header_item2->termination->audio_stream;
 		k++;
 	}
-	return mpf_mixer_create(
+	return mpf_mixer_create_ex(
 				source_arr,
 				header_item1->rx_count,
 				header_item1->termination->audio_stream,
 				header_item1->termination->codec_manager,
 				context->name,
+				context->factory->object_slab,
 				context->pool);
 }
 
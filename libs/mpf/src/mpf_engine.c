@@ -39,6 +39,7 @@ struct mpf_engine_t {
 	mpf_scheduler_t           *scheduler;
 	apt_timer_queue_t         *timer_queue;
 	const mpf_codec_manager_t *codec_manager;
+	mpf_rtcp_worker_t         *rtcp_worker;
 };
 
 static void mpf_engine_main(mpf_scheduler_t *scheduler, void *obj);
@@ -63,6 +64,7 @@ MPF_DECLARE(mpf_engine_t*) mpf_engine_create(const char *id, apr_pool_t *pool)
 	engine->request_queue = NULL;
 	engine->context_factory = NULL;
 	engine->codec_manager = NULL;
+	engine->rtcp_worker = NULL;
 
 	msg_pool = apt_task_msg_pool_create_dynamic(sizeof(mpf_message_container_t),pool);
 
@@ -109,7 +111,7 @@ MPF_DECLARE(mpf_context_t*) mpf_engine_context_create(
 
 MPF_DECLARE(apt_bool_t) mpf_engine_context_destroy(mpf_context_t *context)
 {
-	return mpf_context_destroy(context);
+	return mpf_context_release(context);
 }
 
 MPF_DECLARE(void*) mpf_engine_context_object_get(const mpf_context_t *context)
@@ -227,6 +229,10 @@ static apt_bool_t mpf_engine_destroy(apt_task_t *task)
 {
 	mpf_engine_t *engine = apt_task_object_get(task);
 
+	if(engine->rtcp_worker) {
+		mpf_rtcp_worker_destroy(engine->rtcp_worker);
+		engine->rtcp_worker = NULL;
+	}
 	apt_timer_queue_destroy(engine->timer_queue);
 	mpf_scheduler_destroy(engine->scheduler);
 	mpf_context_factory_destroy(engine->context_factory);
@@ -239,6 +245,9 @@ static apt_bool_t mpf_engine_start(apt_task_t *task)
 {
 	mpf_engine_t *engine = apt_task_object_get(task);
 
+	if(engine->rtcp_worker) {
+		mpf_rtcp_worker_start(engine->rtcp_worker);
+	}
 	mpf_scheduler_start(engine->scheduler);
 	apt_task_start_request_process(task);
 	return TRUE;
@@ -249,6 +258,9 @@ static apt_bool_t mpf_engine_terminate(apt_task_t *task)
 	mpf_engine_t *engine = apt_task_object_get(task);
 
 	mpf_scheduler_stop(engine->scheduler);
+	if(engine->rtcp_worker) {
+		mpf_rtcp_worker_stop(engine->rtcp_worker);
+	}
 	apt_task_terminate_request_process(task);
 	return TRUE;
 }
@@ -334,6 +346,7 @@ static apt_bool_t mpf_engine_msg_process(apt_task_t *task, apt_task_msg_t *msg)
 				termination->event_handler = mpf_engine_event_raise;
 				termination->codec_manager = engine->codec_manager;
 				termination->timer_queue = engine->timer_queue;
+				termination->rtcp_worker = engine->rtcp_worker;
 
 				mpf_termination_add(termination,mpf_request->descriptor);
 				if(mpf_context_termination_add(context,termination) == FALSE) {
@@ -442,11 +455,35 @@ MPF_DECLARE(apt_bool_t) mpf_engine_codec_manager_register(mpf_engine_t *engine,
 	return TRUE;
 }
 
+MPF_DECLARE(apt_bool_t) mpf_engine_rtcp_worker_set(mpf_engine_t *engine, apr_size_t max_streams)
+{
+	if(engine->rtcp_worker || !max_streams) {
+		return FALSE;
+	}
+	engine->rtcp_worker = mpf_rtcp_worker_create(max_streams,engine->pool);
+	return engine->rtcp_worker ? TRUE : FALSE;
+}
+
+MPF_DECLARE(apt_bool_t) mpf_engine_slab_set(mpf_engine_t *engine, apr_size_t max_context_count)
+{
+	return mpf_context_factory_slab_set(engine->context_factory,max_context_count,engine->pool);
+}
+
 MPF_DECLARE(apt_bool_t) mpf_engine_scheduler_rate_set(mpf_engine_t *engine, unsigned long rate)
 {
 	return mpf_scheduler_rate_set(engine->scheduler,rate);
 }
 
+MPF_DECLARE(apr_uint32_t) mpf_engine_overrun_count_get(mpf_engine_t *engine)
+{
+	return mpf_scheduler_overrun_count_get(engine->scheduler);
+}
+
+MPF_DECLARE(void) mpf_engine_scheduler_stats_get(mpf_engine_t *engine, mpf_scheduler_stats_t *stats)
+{
+	mpf_scheduler_stats_get(engine->scheduler,stats);
+}
+
 MPF_DECLARE(const char*) mpf_engine_id_get(const mpf_engine_t *engine)
 {
 	return apt_task_name_get(engine->task);
@@ -0,0 +1,605 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include <apr_atomic.h>
+#include <apr_thread_mutex.h>
+#include "mpf_termination.h"
+#include "mpf_loopback_termination_factory.h"
+#include "mpf_codec_manager.h"
+#include "mpf_stream.h"
+#include "apt_log.h"
+
+/** Max size of a media frame conveyed through the ring (10 msec of 48kHz L16) */
+#define LOOPBACK_FRAME_MAX_SIZE 960
+/** Number of media frames each ring can hold */
+#define LOOPBACK_RING_DEPTH     16
+/** IP address reported in media descriptors of loopback streams */
+#define LOOPBACK_IP             "loopback"
+
+/* The write position of a ring is combined with the generation of the slot into a single word,
+   so that the producer validates its link and claims the position by one CAS:
+   generation (16 bits) | busy flag (1 bit) | write index (15 bits) */
+#define LOOPBACK_INDEX_MASK     0x7FFF
+#define LOOPBACK_BUSY_FLAG      0x8000
+#define LOOPBACK_GENERATION_GET(word)        ((word) >> 16)
+#define LOOPBACK_WORD_MAKE(generation,index) (((generation) << 16) | ((index) & LOOPBACK_INDEX_MASK))
+
+typedef struct loopback_frame_t loopback_frame_t;
+typedef struct loopback_slot_t loopback_slot_t;
+typedef struct loopback_termination_factory_t loopback_termination_factory_t;
+typedef struct mpf_loopback_stream_t mpf_loopback_stream_t;
+
+/** Media frame held in the ring */
+struct loopback_frame_t {
+	int                     type;
+	int                     marker;
+	mpf_named_event_frame_t event_frame;
+	apr_size_t              size;
+	char                    buffer[LOOPBACK_FRAME_MAX_SIZE];
+};
+
+/** Receive ring of a stream, written by the peer stream */
+struct loopback_slot_t {
+	/** Frames of the ring (allocated on first use) */
+	loopback_frame_t      *frames;
+	/** Generation, busy flag and write position, advanced by the producer only */
+	volatile apr_uint32_t  head;
+	/** Read position, advanced by the consumer only */
+	volatile apr_uint32_t  tail;
+	/** Whether the slot is in use (guarded by the factory mutex) */
+	apt_bool_t             in_use;
+};
+
+struct loopback_termination_factory_t {
+	mpf_termination_factory_t base;
+
+	loopback_slot_t          *slots;
+	apr_size_t                slot_count;
+	apr_size_t                next_slot;
+	apr_thread_mutex_t       *mutex;
+	apr_pool_t               *pool;
+};
+
+struct mpf_loopback_stream_t {
+	mpf_audio_stream_t             *base;
+	loopback_termination_factory_t *factory;
+	apr_pool_t                     *pool;
+	mpf_rtp_settings_t             *settings;
+	mpf_rtp_media_descriptor_t     *local_media;
+	mpf_rtp_media_descriptor_t     *remote_media;
+
+	/** Own (receive) slot */
+	loopback_slot_t                *rx_slot;
+	/** Peer (transmit) slot, if linked */
+	loopback_slot_t                *tx_slot;
+	/** Generation of the peer slot at the time of linking */
+	apr_uint32_t                    tx_generation;
+	/** Number of frames dropped due to the full peer ring */
+	apr_uint32_t                    dropped_frames;
+};
+
+static apt_bool_t mpf_loopback_stream_destroy(mpf_audio_stream_t *stream);
+static apt_bool_t mpf_loopback_rx_stream_open(mpf_audio_stream_t *stream, mpf_codec_t *codec);
+static apt_bool_t mpf_loopback_rx_stream_close(mpf_audio_stream_t *stream);
+static apt_bool_t mpf_loopback_stream_receive(mpf_audio_stream_t *stream, mpf_frame_t *frame);
+static apt_bool_t mpf_loopback_tx_stream_open(mpf_audio_stream_t *stream, mpf_codec_t *codec);
+static apt_bool_t mpf_loopback_tx_stream_close(mpf_audio_stream_t *stream);
+static apt_bool_t mpf_loopback_stream_transmit(mpf_audio_stream_t *stream, const mpf_frame_t *frame);
+
+static const mpf_audio_stream_vtable_t loopback_stream_vtable = {
+	mpf_loopback_stream_destroy,
+	mpf_loopback_rx_stream_open,
+	mpf_loopback_rx_stream_close,
+	mpf_loopback_stream_receive,
+	mpf_loopback_tx_stream_open,
+	mpf_loopback_tx_stream_close,
+	mpf_loopback_stream_transmit,
+	NULL
+};
+
+/** Map the port of media descriptor to the slot */
+static APR_INLINE loopback_slot_t* loopback_slot_get(loopback_termination_factory_t *factory, apr_port_t port)
+{
+	apr_size_t index;
+	if(port < 2) {
+		return NULL;
+	}
+	index = port / 2 - 1;
+	if(index >= factory->slot_count) {
+		return NULL;
+	}
+	return &factory->slots[index];
+}
+
+/** Allocate free slot and return its port */
+static apr_port_t loopback_slot_alloc(loopback_termination_factory_t *factory, loopback_slot_t **slot_out)
+{
+	apr_size_t i;
+	apr_size_t index;
+	apr_port_t port = 0;
+	loopback_slot_t *slot;
+
+	apr_thread_mutex_lock(factory->mutex);
+	for(i = 0; i < factory->slot_count; i++) {
+		index = (factory->next_slot + i) % factory->slot_count;
+		slot = &factory->slots[index];
+		if(slot->in_use == TRUE) {
+			continue;
+		}
+
+		if(!slot->frames) {
+			slot->frames = apr_palloc(factory->pool,sizeof(loopback_frame_t) * LOOPBACK_RING_DEPTH);
+		}
+		/* the write position has been reset on release, no producer is linked to the new generation yet */
+		slot->in_use = TRUE;
+		apr_atomic_set32(&slot->tail,0);
+		factory->next_slot = (index + 1) % factory->slot_count;
+		port = (apr_port_t)((index + 1) * 2);
+		*slot_out = slot;
+		break;
+	}
+	apr_thread_mutex_unlock(factory->mutex);
+	return port;
+}
+
+/** Release slot, invalidating the links of peer streams */
+static void loopback_slot_release(loopback_termination_factory_t *factory, loopback_slot_t *slot)
+{
+	apr_uint32_t head;
+	apr_uint32_t next;
+	/* advance the generation and reset the write position, once the frame being written (if any) is published */
+	for(;;) {
+		head = apr_atomic_read32(&slot->head);
+		if(head & LOOPBACK_BUSY_FLAG) {
+			continue;
+		}
+		next = LOOPBACK_WORD_MAKE((LOOPBACK_GENERATION_GET(head) + 1) & 0xFFFF,0);
+		if(apr_atomic_cas32(&slot->head,next,head) == head) {
+			break;
+		}
+	}
+
+	apr_thread_mutex_lock(factory->mutex);
+	slot->in_use = FALSE;
+	apr_thread_mutex_unlock(factory->mutex);
+}
+
+static mpf_audio_stream_t* mpf_loopback_stream_create(mpf_termination_t *termination, mpf_rtp_settings_t *settings, apr_pool_t *pool)
+{
+	mpf_loopback_stream_t *loopback_stream = apr_palloc(pool,sizeof(mpf_loopback_stream_t));
+	mpf_stream_capabilities_t *capabilities = mpf_stream_capabilities_create(STREAM_DIRECTION_DUPLEX,pool);
+	mpf_audio_stream_t *audio_stream = mpf_audio_stream_create(loopback_stream,&loopback_stream_vtable,capabilities,pool);
+	if(!audio_stream) {
+		return NULL;
+	}
+
+	audio_stream->direction = STREAM_DIRECTION_NONE;
+	audio_stream->termination = termination;
+
+	loopback_stream->base = audio_stream;
+	loopback_stream->factory = (loopback_termination_factory_t*)termination->termination_factory;
+	loopback_stream->pool = pool;
+	loopback_stream->settings = settings;
+	loopback_stream->local_media = NULL;
+	loopback_stream->remote_media = NULL;
+	loopback_stream->rx_slot = NULL;
+	loopback_stream->tx_slot = NULL;
+	loopback_stream->tx_generation = 0;
+	loopback_stream->dropped_frames = 0;
+	return audio_stream;
+}
+
+static apt_bool_t mpf_loopback_stream_local_media_create(mpf_loopback_stream_t *loopback_stream, mpf_rtp_media_descriptor_t *local_media, mpf_rtp_media_descriptor_t *remote_media, mpf_stream_capabilities_t *capabilities)
+{
+	apt_bool_t status = TRUE;
+	if(!local_media) {
+		/* local media is not specified, create the default one */
+		local_media = apr_palloc(loopback_stream->pool,sizeof(mpf_rtp_media_descriptor_t));
+		mpf_rtp_media_descriptor_init(local_media);
+		local_media->state = MPF_MEDIA_ENABLED;
+		local_media->direction = STREAM_DIRECTION_DUPLEX;
+	}
+	if(remote_media) {
+		local_media->id = remote_media->id;
+	}
+	if(local_media->ip.length == 0) {
+		apt_string_set(&local_media->ip,LOOPBACK_IP);
+	}
+
+	local_media->port = loopback_slot_alloc(loopback_stream->factory,&loopback_stream->rx_slot);
+	if(!local_media->port) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Find Free Loopback Slot [%"APR_SIZE_T_FMT"]",
+			loopback_stream->factory->slot_count);
+		local_media->state = MPF_MEDIA_DISABLED;
+		status = FALSE;
+	}
+
+	if(loopback_stream->settings && loopback_stream->settings->ptime) {
+		local_media->ptime = loopback_stream->settings->ptime;
+	}
+
+	if(mpf_codec_list_is_empty(&local_media->codec_list) == TRUE) {
+		if(!loopback_stream->settings || mpf_codec_list_is_empty(&loopback_stream->settings->codec_list) == TRUE) {
+			mpf_codec_manager_codec_list_get(
+								loopback_stream->base->termination->codec_manager,
+								&local_media->codec_list,
+								loopback_stream->pool);
+		}
+		else {
+			mpf_codec_list_copy(&local_media->codec_list,
+								&loopback_stream->settings->codec_list,
+								loopback_stream->pool);
+		}
+	}
+
+	if(capabilities) {
+		if(mpf_codec_list_match(&local_media->codec_list,&capabilities->codecs) == FALSE) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Match Codec List %s:%hu",
+									local_media->ip.buf,
+									local_media->port);
+			local_media->state = MPF_MEDIA_DISABLED;
+			status = FALSE;
+		}
+	}
+
+	loopback_stream->local_media = local_media;
+	return status;
+}
+
+static apt_bool_t mpf_loopback_stream_media_negotiate(mpf_loopback_stream_t *loopback_stream)
+{
+	mpf_rtp_media_descriptor_t *local_media = loopback_stream->local_media;
+	mpf_rtp_media_descriptor_t *remote_media = loopback_stream->remote_media;
+	if(!local_media || !remote_media) {
+		return FALSE;
+	}
+
+	local_media->id = remote_media->id;
+	local_media->mid = remote_media->mid;
+	local_media->ptime = remote_media->ptime;
+	local_media->state = remote_media->state;
+	local_media->direction = mpf_stream_reverse_direction_get(remote_media->direction);
+
+	loopback_stream->tx_slot = NULL;
+	if(remote_media->state == MPF_MEDIA_ENABLED) {
+		mpf_codec_list_t *codec_list1 = NULL;
+		mpf_codec_list_t *codec_list2 = NULL;
+
+		/* intersect local and remote codecs */
+		if(loopback_stream->settings && loopback_stream->settings->own_preferrence == TRUE) {
+			codec_list1 = &local_media->codec_list;
+			codec_list2 = &remote_media->codec_list;
+		}
+		else {
+			codec_list2 = &local_media->codec_list;
+			codec_list1 = &remote_media->codec_list;
+		}
+
+		if(mpf_codec_lists_intersect(codec_list1,codec_list2) == FALSE) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Reject Loopback Session %hu no codecs matched",local_media->port);
+			local_media->direction = STREAM_DIRECTION_NONE;
+			local_media->state = MPF_MEDIA_DISABLED;
+		}
+		else {
+			/* link to the ring of the peer stream */
+			loopback_stream->tx_slot = loopback_slot_get(loopback_stream->factory,remote_media->port);
+			if(loopback_stream->tx_slot) {
+				loopback_stream->tx_generation = LOOPBACK_GENERATION_GET(apr_atomic_read32(&loopback_stream->tx_slot->head));
+			}
+			else {
+				apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"No Such Loopback Slot %hu",remote_media->port);
+			}
+		}
+	}
+
+	loopback_stream->base->direction = local_media->direction;
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_stream_modify(mpf_audio_stream_t *stream, mpf_rtp_stream_descriptor_t *descriptor)
+{
+	apt_bool_t status = TRUE;
+	mpf_loopback_stream_t *loopback_stream = stream->obj;
+
+	if(!loopback_stream->local_media) {
+		/* create local media */
+		status = mpf_loopback_stream_local_media_create(loopback_stream,descriptor->local,descriptor->remote,descriptor->capabilities);
+	}
+	else if(descriptor->local) {
+		/* update local media, the slot (port) is retained */
+		descriptor->local->port = loopback_stream->local_media->port;
+		if(mpf_codec_list_is_empty(&descriptor->local->codec_list) == TRUE) {
+			mpf_codec_list_copy(&descriptor->local->codec_list,
+								&loopback_stream->local_media->codec_list,
+								loopback_stream->pool);
+		}
+		loopback_stream->local_media = descriptor->local;
+	}
+
+	if(descriptor->remote && status == TRUE) {
+		/* update remote media and negotiate local and remote media */
+		loopback_stream->remote_media = descriptor->remote;
+		mpf_loopback_stream_media_negotiate(loopback_stream);
+	}
+
+	if((stream->direction & STREAM_DIRECTION_SEND) == STREAM_DIRECTION_SEND) {
+		mpf_codec_list_t *codec_list = &loopback_stream->remote_media->codec_list;
+		stream->tx_descriptor = codec_list->primary_descriptor;
+		if(codec_list->event_descriptor) {
+			stream->tx_event_descriptor = codec_list->event_descriptor;
+		}
+	}
+	if((stream->direction & STREAM_DIRECTION_RECEIVE) == STREAM_DIRECTION_RECEIVE) {
+		mpf_codec_list_t *codec_list = &loopback_stream->local_media->codec_list;
+		stream->rx_descriptor = codec_list->primary_descriptor;
+		if(codec_list->event_descriptor) {
+			stream->rx_event_descriptor = codec_list->event_descriptor;
+		}
+	}
+
+	if(!descriptor->local) {
+		descriptor->local = loopback_stream->local_media;
+	}
+	return status;
+}
+
+static apt_bool_t mpf_loopback_stream_remove(mpf_audio_stream_t *stream)
+{
+	mpf_loopback_stream_t *loopback_stream = stream->obj;
+	loopback_stream->tx_slot = NULL;
+	if(loopback_stream->rx_slot) {
+		loopback_slot_release(loopback_stream->factory,loopback_stream->rx_slot);
+		loopback_stream->rx_slot = NULL;
+	}
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_stream_destroy(mpf_audio_stream_t *stream)
+{
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_rx_stream_open(mpf_audio_stream_t *stream, mpf_codec_t *codec)
+{
+	mpf_loopback_stream_t *loopback_stream = stream->obj;
+	if(!loopback_stream->rx_slot) {
+		return FALSE;
+	}
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Open Loopback Receiver %hu <- %hu",
+		loopback_stream->local_media->port,
+		loopback_stream->remote_media ? loopback_stream->remote_media->port : 0);
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_rx_stream_close(mpf_audio_stream_t *stream)
+{
+	mpf_loopback_stream_t *loopback_stream = stream->obj;
+	if(!loopback_stream->local_media) {
+		return FALSE;
+	}
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Close Loopback Receiver %hu",loopback_stream->local_media->port);
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_stream_receive(mpf_audio_stream_t *stream, mpf_frame_t *frame)
+{
+	mpf_loopback_stream_t *loopback_stream = stream->obj;
+	loopback_slot_t *slot = loopback_stream->rx_slot;
+	loopback_frame_t *ring_frame;
+	apr_uint32_t tail;
+	if(!slot) {
+		return TRUE;
+	}
+
+	tail = apr_atomic_read32(&slot->tail);
+	if((apr_atomic_read32(&slot->head) & LOOPBACK_INDEX_MASK) == tail) {
+		/* nothing received */
+		return TRUE;
+	}
+
+	ring_frame = &slot->frames[tail % LOOPBACK_RING_DEPTH];
+	frame->type = ring_frame->type;
+	frame->marker = ring_frame->marker;
+	if((ring_frame->type & MEDIA_FRAME_TYPE_AUDIO) == MEDIA_FRAME_TYPE_AUDIO) {
+		apr_size_t size = ring_frame->size;
+		if(size > frame->codec_frame.size) {
+			size = frame->codec_frame.size;
+		}
+		memcpy(frame->codec_frame.buffer,ring_frame->buffer,size);
+	}
+	if((ring_frame->type & MEDIA_FRAME_TYPE_EVENT) == MEDIA_FRAME_TYPE_EVENT) {
+		frame->event_frame = ring_frame->event_frame;
+	}
+	apr_atomic_set32(&slot->tail,(tail + 1) & LOOPBACK_INDEX_MASK);
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_tx_stream_open(mpf_audio_stream_t *stream, mpf_codec_t *codec)
+{
+	mpf_loopback_stream_t *loopback_stream = stream->obj;
+	if(!loopback_stream->tx_slot) {
+		return FALSE;
+	}
+	loopback_stream->dropped_frames = 0;
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Open Loopback Transmitter %hu -> %hu",
+		loopback_stream->local_media->port,
+		loopback_stream->remote_media->port);
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_tx_stream_close(mpf_audio_stream_t *stream)
+{
+	mpf_loopback_stream_t *loopback_stream = stream->obj;
+	if(!loopback_stream->local_media || !loopback_stream->remote_media) {
+		return FALSE;
+	}
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Close Loopback Transmitter %hu -> %hu [d:%u]",
+		loopback_stream->local_media->port,
+		loopback_stream->remote_media->port,
+		loopback_stream->dropped_frames);
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_stream_transmit(mpf_audio_stream_t *stream, const mpf_frame_t *frame)
+{
+	mpf_loopback_stream_t *loopback_stream = stream->obj;
+	loopback_slot_t *slot = loopback_stream->tx_slot;
+	loopback_frame_t *ring_frame;
+	apr_uint32_t head;
+	apr_uint32_t index;
+	if(!slot || frame->type == MEDIA_FRAME_TYPE_NONE) {
+		return TRUE;
+	}
+
+	head = apr_atomic_read32(&slot->head);
+	if(LOOPBACK_GENERATION_GET(head) != loopback_stream->tx_generation) {
+		/* the peer stream has been removed */
+		loopback_stream->tx_slot = NULL;
+		return TRUE;
+	}
+
+	index = head & LOOPBACK_INDEX_MASK;
+	if(((index - apr_atomic_read32(&slot->tail)) & LOOPBACK_INDEX_MASK) >= LOOPBACK_RING_DEPTH ||
+		frame->codec_frame.size > LOOPBACK_FRAME_MAX_SIZE) {
+		loopback_stream->dropped_frames++;
+		return TRUE;
+	}
+
+	/* claim the write position of the linked generation by a single CAS, the slot can't be
+	released and reused until the frame is published */
+	if(apr_atomic_cas32(&slot->head,head | LOOPBACK_BUSY_FLAG,head) != head) {
+		/* the peer stream has been removed in the meantime */
+		loopback_stream->tx_slot = NULL;
+		return TRUE;
+	}
+
+	ring_frame = &slot->frames[index % LOOPBACK_RING_DEPTH];
+	ring_frame->type = frame->type;
+	ring_frame->marker = frame->marker;
+	ring_frame->size = 0;
+	if((frame->type & MEDIA_FRAME_TYPE_AUDIO) == MEDIA_FRAME_TYPE_AUDIO) {
+		ring_frame->size = frame->codec_frame.size;
+		memcpy(ring_frame->buffer,frame->codec_frame.buffer,ring_frame->size);
+	}
+	if((frame->type & MEDIA_FRAME_TYPE_EVENT) == MEDIA_FRAME_TYPE_EVENT) {
+		ring_frame->event_frame = frame->event_frame;
+	}
+	/* publish the frame and clear the busy flag */
+	apr_atomic_set32(&slot->head,LOOPBACK_WORD_MAKE(loopback_stream->tx_generation,index + 1));
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_termination_destroy(mpf_termination_t *termination)
+{
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_termination_add(mpf_termination_t *termination, void *descriptor)
+{
+	mpf_rtp_termination_descriptor_t *rtp_descriptor = descriptor;
+	mpf_audio_stream_t *audio_stream = termination->audio_stream;
+	if(!audio_stream) {
+		audio_stream = mpf_loopback_stream_create(
+							termination,
+							rtp_descriptor ? rtp_descriptor->audio.settings : NULL,
+							termination->pool);
+		if(!audio_stream) {
+			return FALSE;
+		}
+		termination->audio_stream = audio_stream;
+	}
+
+	if(rtp_descriptor) {
+		return mpf_loopback_stream_modify(audio_stream,&rtp_descriptor->audio);
+	}
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_termination_modify(mpf_termination_t *termination, void *descriptor)
+{
+	mpf_rtp_termination_descriptor_t *rtp_descriptor = descriptor;
+	mpf_audio_stream_t *audio_stream = termination->audio_stream;
+	if(!audio_stream) {
+		return FALSE;
+	}
+
+	if(rtp_descriptor) {
+		return mpf_loopback_stream_modify(audio_stream,&rtp_descriptor->audio);
+	}
+	return TRUE;
+}
+
+static apt_bool_t mpf_loopback_termination_subtract(mpf_termination_t *termination)
+{
+	mpf_audio_stream_t *audio_stream = termination->audio_stream;
+	if(!audio_stream) {
+		return FALSE;
+	}
+
+	return mpf_loopback_stream_remove(audio_stream);
+}
+
+static const mpf_termination_vtable_t loopback_vtable = {
+	mpf_loopback_termination_destroy,
+	mpf_loopback_termination_add,
+	mpf_loopback_termination_modify,
+	mpf_loopback_termination_subtract
+};
+
+static mpf_termination_t* mpf_loopback_termination_create(mpf_termination_factory_t *termination_factory, void *obj, apr_pool_t *pool)
+{
+	mpf_termination_t *termination = mpf_termination_base_create(termination_factory,obj,&loopback_vtable,NULL,NULL,pool);
+	if(termination) {
+		termination->name = "loopback-tm";
+	}
+	return termination;
+}
+
+static apt_bool_t mpf_loopback_factory_engine_assign(mpf_termination_factory_t *termination_factory, mpf_engine_t *media_engine)
+{
+	/* slots are shared among all the media engines */
+	return TRUE;
+}
+
+MPF_DECLARE(mpf_termination_factory_t*) mpf_loopback_termination_factory_create(
+											apr_size_t max_stream_count,
+											apr_pool_t *pool)
+{
+	loopback_termination_factory_t *loopback_termination_factory;
+	if(!max_stream_count) {
+		return NULL;
+	}
+	if(max_stream_count > 32766) {
+		/* ports must fit into apr_port_t */
+		max_stream_count = 32766;
+	}
+
+	loopback_termination_factory = apr_palloc(pool,sizeof(loopback_termination_factory_t));
+	loopback_termination_factory->base.create_termination = mpf_loopback_termination_create;
+	loopback_termination_factory->base.assign_engine = mpf_loopback_factory_engine_assign;
+	loopback_termination_factory->pool = pool;
+	loopback_termination_factory->slot_count = max_stream_count;
+	loopback_termination_factory->next_slot = 0;
+	loopback_termination_factory->slots = apr_pcalloc(pool,sizeof(loopback_slot_t) * max_stream_count);
+	loopback_termination_factory->mutex = NULL;
+	if(apr_thread_mutex_create(&loopback_termination_factory->mutex,APR_THREAD_MUTEX_DEFAULT,pool) != APR_SUCCESS) {
+		return NULL;
+	}
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Create Loopback Termination Factory [%"APR_SIZE_T_FMT"]",max_stream_count);
+	return &loopback_termination_factory->base;
+}
@@ -21,6 +21,7 @@
 #include "mpf_decoder.h"
 #include "mpf_resampler.h"
 #include "mpf_codec_manager.h"
+#include "mpf_slab.h"
 #include "apt_log.h"
 
 typedef struct mpf_mixer_t mpf_mixer_t;
@@ -40,6 +41,8 @@ struct mpf_mixer_t {
 	mpf_frame_t          frame;
 	/** Mixed frame to write to audio sink */
 	mpf_frame_t          mix_frame;
+	/** Slab the mixer and its frame buffers are allocated from, if any */
+	mpf_slab_t          *slab;
 };
 
 static apt_bool_t mpf_frames_mix(mpf_frame_t *mix_frame, const mpf_frame_t *frame)
@@ -100,6 +103,7 @@ static apt_bool_t mpf_mixer_destroy(mpf_object_t *object)
 		}
 	}
 	mpf_audio_stream_tx_close(mixer->sink);
+	mpf_slab_pfree(mixer->slab,mixer);
 	return TRUE;
 }
 
@@ -141,6 +145,18 @@ MPF_DECLARE(mpf_object_t*) mpf_mixer_create(
 								const mpf_codec_manager_t *codec_manager, 
 								const char *name,
 								apr_pool_t *pool)
+{
+	return mpf_mixer_create_ex(source_arr,source_count,sink,codec_manager,name,NULL,pool);
+}
+
+MPF_DECLARE(mpf_object_t*) mpf_mixer_create_ex(
+								mpf_audio_stream_t **source_arr, 
+								apr_size_t source_count, 
+								mpf_audio_stream_t *sink, 
+								const mpf_codec_manager_t *codec_manager, 
+								const char *name,
+								mpf_slab_t *slab,
+								apr_pool_t *pool)
 {
 	apr_size_t i;
 	apr_size_t frame_size;
@@ -152,15 +168,6 @@ MPF_DECLARE(mpf_object_t*) mpf_mixer_create(
 	}
 
 	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Create Mixer %s",name);
-	mixer = apr_palloc(pool,sizeof(mpf_mixer_t));
-	mixer->source_arr = NULL;
-	mixer->source_count = 0;
-	mixer->sink = NULL;
-	mpf_object_init(&mixer->base,name);
-	mixer->base.process = mpf_mixer_process;
-	mixer->base.destroy = mpf_mixer_destroy;
-	mixer->base.trace = mpf_mixer_trace;
-
 	if(mpf_audio_stream_tx_validate(sink,NULL,NULL,pool) == FALSE) {
 		return NULL;
 	}
@@ -174,6 +181,21 @@ MPF_DECLARE(mpf_object_t*) mpf_mixer_create(
 			sink = encoder;
 		}
 	}
+
+	/* the frame buffers immediately follow the mixer */
+	descriptor = sink->tx_descriptor;
+	frame_size = mpf_codec_linear_frame_size_calculate(descriptor->sampling_rate,descriptor->channel_count);
+	mixer = mpf_slab_palloc(slab,sizeof(mpf_mixer_t) + 2 * frame_size,pool);
+	mpf_object_init(&mixer->base,name);
+	mixer->base.process = mpf_mixer_process;
+	mixer->base.destroy = mpf_mixer_destroy;
+	mixer->base.trace = mpf_mixer_trace;
+	mixer->slab = slab;
+	mixer->frame.codec_frame.size = frame_size;
+	mixer->frame.codec_frame.buffer = mixer + 1;
+	mixer->mix_frame.codec_frame.size = frame_size;
+	mixer->mix_frame.codec_frame.buffer = (char*)(mixer + 1) + frame_size;
+
 	mixer->sink = sink;
 	mpf_audio_stream_tx_open(sink,NULL);
 
@@ -199,12 +221,5 @@ MPF_DECLARE(mpf_object_t*) mpf_mixer_create(
 	}
 	mixer->source_arr = source_arr;
 	mixer->source_count = source_count;
-
-	descriptor = sink->tx_descriptor;
-	frame_size = mpf_codec_linear_frame_size_calculate(descriptor->sampling_rate,descriptor->channel_count);
-	mixer->frame.codec_frame.size = frame_size;
-	mixer->frame.codec_frame.buffer = apr_palloc(pool,frame_size);
-	mixer->mix_frame.codec_frame.size = frame_size;
-	mixer->mix_frame.codec_frame.buffer = apr_palloc(pool,frame_size);
 	return &mixer->base;
 }
@@ -21,6 +21,7 @@
 #include "mpf_decoder.h"
 #include "mpf_resampler.h"
 #include "mpf_codec_manager.h"
+#include "mpf_slab.h"
 #include "apt_log.h"
 
 typedef struct mpf_multiplier_t mpf_multiplier_t;
@@ -38,6 +39,8 @@ struct mpf_multiplier_t {
 
 	/** Media frame used to read data from source and write it to sinks */
 	mpf_frame_t          frame;
+	/** Slab the multiplier and its frame buffer are allocated from, if any */
+	mpf_slab_t          *slab;
 };
 
 static apt_bool_t mpf_multiplier_process(mpf_object_t *object)
@@ -79,6 +82,7 @@ static apt_bool_t mpf_multiplier_destroy(mpf_object_t *object)
 			mpf_audio_stream_tx_close(sink);
 		}
 	}
+	mpf_slab_pfree(multiplier->slab,multiplier);
 	return TRUE;
 }
 
@@ -120,6 +124,18 @@ MPF_DECLARE(mpf_object_t*) mpf_multiplier_create(
 								const mpf_codec_manager_t *codec_manager,
 								const char *name,
 								apr_pool_t *pool)
+{
+	return mpf_multiplier_create_ex(source,sink_arr,sink_count,codec_manager,name,NULL,pool);
+}
+
+MPF_DECLARE(mpf_object_t*) mpf_multiplier_create_ex(
+								mpf_audio_stream_t *source,
+								mpf_audio_stream_t **sink_arr,
+								apr_size_t sink_count,
+								const mpf_codec_manager_t *codec_manager,
+								const char *name,
+								mpf_slab_t *slab,
+								apr_pool_t *pool)
 {
 	apr_size_t i;
 	apr_size_t frame_size;
@@ -131,15 +147,6 @@ MPF_DECLARE(mpf_object_t*) mpf_multiplier_create(
 	}
 
 	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Create Multiplier %s",name);
-	multiplier = apr_palloc(pool,sizeof(mpf_multiplier_t));
-	multiplier->source = NULL;
-	multiplier->sink_arr = NULL;
-	multiplier->sink_count = 0;
-	mpf_object_init(&multiplier->base,name);
-	multiplier->base.process = mpf_multiplier_process;
-	multiplier->base.destroy = mpf_multiplier_destroy;
-	multiplier->base.trace = mpf_multiplier_trace;
-
 	if(mpf_audio_stream_rx_validate(source,NULL,NULL,pool) == FALSE) {
 		return NULL;
 	}
@@ -153,6 +160,19 @@ MPF_DECLARE(mpf_object_t*) mpf_multiplier_create(
 			source = decoder;
 		}
 	}
+
+	/* the frame buffer immediately follows the multiplier */
+	descriptor = source->rx_descriptor;
+	frame_size = mpf_codec_linear_frame_size_calculate(descriptor->sampling_rate,descriptor->channel_count);
+	multiplier = mpf_slab_palloc(slab,sizeof(mpf_multiplier_t) + frame_size,pool);
+	mpf_object_init(&multiplier->base,name);
+	multiplier->base.process = mpf_multiplier_process;
+	multiplier->base.destroy = mpf_multiplier_destroy;
+	multiplier->base.trace = mpf_multiplier_trace;
+	multiplier->slab = slab;
+	multiplier->frame.codec_frame.size = frame_size;
+	multiplier->frame.codec_frame.buffer = multiplier + 1;
+
 	multiplier->source = source;
 	mpf_audio_stream_rx_open(source,NULL);
 	
@@ -178,10 +198,5 @@ MPF_DECLARE(mpf_object_t*) mpf_multiplier_create(
 	}
 	multiplier->sink_arr = sink_arr;
 	multiplier->sink_count = sink_count;
-	
-	descriptor = source->rx_descriptor;
-	frame_size = mpf_codec_linear_frame_size_calculate(descriptor->sampling_rate,descriptor->channel_count);
-	multiplier->frame.codec_frame.size = frame_size;
-	multiplier->frame.codec_frame.buffer = apr_palloc(pool,frame_size);
 	return &multiplier->base;
 }
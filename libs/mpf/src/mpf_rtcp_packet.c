@@ -0,0 +1,211 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include "mpf_rtp_header.h"
+#include "mpf_rtcp_packet.h"
+#include "mpf_stream_descriptor.h"
+#include "apt_net.h"
+#include "apt_log.h"
+
+static APR_INLINE void rtcp_sr_generate(const mpf_rtp_stat_record_t *record, rtcp_sr_stat_t *sr_stat)
+{
+	*sr_stat = record->sr_stat;
+	apt_ntp_time_get(&sr_stat->ntp_sec, &sr_stat->ntp_frac);
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Generate RTCP SR [ssrc:%u s:%u o:%u ts:%u]",
+				sr_stat->ssrc,
+				sr_stat->sent_packets,
+				sr_stat->sent_octets,
+				sr_stat->rtp_ts);
+	rtcp_sr_hton(sr_stat);
+}
+
+static APR_INLINE void rtcp_rr_generate(const mpf_rtp_stat_record_t *record, rtcp_rr_stat_t *rr_stat)
+{
+	*rr_stat = record->rr_stat;
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Generate RTCP RR [ssrc:%u last_seq:%u j:%u lost:%u frac:%d]",
+				rr_stat->ssrc,
+				rr_stat->last_seq,
+				rr_stat->jitter,
+				rr_stat->lost,
+				rr_stat->fraction);
+	rtcp_rr_hton(rr_stat);
+}
+
+/* Generate either RTCP SR or RTCP RR packet */
+MPF_DECLARE(apr_size_t) mpf_rtcp_report_generate(const mpf_rtp_stat_record_t *record, rtcp_packet_t *rtcp_packet, apr_size_t length)
+{
+	apr_size_t offset = 0;
+	rtcp_header_init(&rtcp_packet->header,RTCP_RR);
+	if(record->direction & STREAM_DIRECTION_SEND) {
+		rtcp_packet->header.pt = RTCP_SR;
+	}
+	if(record->direction & STREAM_DIRECTION_RECEIVE) {
+		rtcp_packet->header.count = 1;
+	}
+	offset += sizeof(rtcp_header_t);
+
+	if(rtcp_packet->header.pt == RTCP_SR) {
+		rtcp_sr_generate(record,&rtcp_packet->r.sr.sr_stat);
+		offset += sizeof(rtcp_sr_stat_t);
+		if(rtcp_packet->header.count) {
+			rtcp_rr_generate(record,rtcp_packet->r.sr.rr_stat);
+			offset += sizeof(rtcp_rr_stat_t);
+		}
+	}
+	else if(rtcp_packet->header.pt == RTCP_RR) {
+		rtcp_packet->r.rr.ssrc = htonl(record->sr_stat.ssrc);
+		rtcp_rr_generate(record,rtcp_packet->r.rr.rr_stat);
+		offset += sizeof(rtcp_packet->r.rr);
+	}
+	rtcp_header_length_set(&rtcp_packet->header,offset);
+	return offset;
+}
+
+/* Generate RTCP SDES packet */
+MPF_DECLARE(apr_size_t) mpf_rtcp_sdes_generate(apr_uint32_t ssrc, const apt_str_t *cname, rtcp_packet_t *rtcp_packet, apr_size_t length)
+{
+	rtcp_sdes_item_t *item;
+	apr_size_t offset = 0;
+	apr_size_t padding;
+	rtcp_header_init(&rtcp_packet->header,RTCP_SDES);
+	offset += sizeof(rtcp_header_t);
+
+	rtcp_packet->header.count ++;
+	rtcp_packet->r.sdes.ssrc = htonl(ssrc);
+	offset += sizeof(apr_uint32_t);
+
+	/* insert SDES CNAME item */
+	item = &rtcp_packet->r.sdes.item[0];
+	item->type = RTCP_SDES_CNAME;
+	item->length = (apr_byte_t)cname->length;
+	memcpy(item->data,cname->buf,item->length);
+	offset += sizeof(rtcp_sdes_item_t) - 1 + item->length;
+	
+	/* terminate with end marker and pad to next 4-octet boundary */
+	padding = 4 - (offset & 0x3);
+	while(padding--) {
+		item = (rtcp_sdes_item_t*) ((char*)rtcp_packet + offset);
+		item->type = RTCP_SDES_END;
+		offset++;
+	}
+
+	rtcp_header_length_set(&rtcp_packet->header,offset);
+	return offset;
+}
+
+/* Generate RTCP BYE packet */
+MPF_DECLARE(apr_size_t) mpf_rtcp_bye_generate(apr_uint32_t ssrc, const apt_str_t *reason, rtcp_packet_t *rtcp_packet, apr_size_t length)
+{
+	apr_size_t offset = 0;
+	rtcp_header_init(&rtcp_packet->header,RTCP_BYE);
+	offset += sizeof(rtcp_header_t);
+
+	rtcp_packet->r.bye.ssrc[0] = htonl(ssrc);
+	rtcp_packet->header.count++;
+	offset += rtcp_packet->header.count * sizeof(apr_uint32_t);
+
+	if(reason->length) {
+		apr_size_t padding;
+
+		memcpy(rtcp_packet->r.bye.data,reason->buf,reason->length);
+		rtcp_packet->r.bye.length = (apr_byte_t)reason->length;
+		offset += rtcp_packet->r.bye.length;
+	
+		/* terminate with end marker and pad to next 4-octet boundary */
+		padding = 4 - (reason->length & 0x3);
+		if(padding) {
+			char *end = rtcp_packet->r.bye.data + reason->length;
+			memset(end,0,padding);
+			offset += padding;
+		}
+	}
+
+	rtcp_header_length_set(&rtcp_packet->header,offset);
+	return offset;
+}
+
+static APR_INLINE void rtcp_sr_get(rtcp_sr_stat_t *sr_stat)
+{
+	rtcp_sr_ntoh(sr_stat);
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Get RTCP SR [ssrc:%u s:%u o:%u ts:%u]",
+				sr_stat->ssrc,
+				sr_stat->sent_packets,
+				sr_stat->sent_octets,
+				sr_stat->rtp_ts);
+}
+
+static APR_INLINE void rtcp_rr_get(rtcp_rr_stat_t *rr_stat)
+{
+	rtcp_rr_ntoh(rr_stat);
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Get RTCP RR [ssrc:%u last_seq:%u j:%u lost:%u frac:%d]",
+				rr_stat->ssrc,
+				rr_stat->last_seq,
+				rr_stat->jitter,
+				rr_stat->lost,
+				rr_stat->fraction);
+}
+
+/* Parse received compound RTCP packet */
+MPF_DECLARE(apt_bool_t) mpf_rtcp_compound_packet_parse(char *buffer, apr_size_t length)
+{
+	rtcp_packet_t *rtcp_packet = (rtcp_packet_t*) buffer;
+	rtcp_packet_t *rtcp_packet_end;
+
+	rtcp_packet_end = (rtcp_packet_t*)(buffer + length);
+
+	while(rtcp_packet < rtcp_packet_end && rtcp_packet->header.version == RTP_VERSION) {
+		rtcp_packet->header.length = ntohs((apr_uint16_t)rtcp_packet->header.length);
+		
+		if(rtcp_packet->header.pt == RTCP_SR) {
+			/* RTCP SR */
+			rtcp_sr_get(&rtcp_packet->r.sr.sr_stat);
+			if(rtcp_packet->header.count) {
+				rtcp_rr_get(rtcp_packet->r.sr.rr_stat);
+			}
+		}
+		else if(rtcp_packet->header.pt == RTCP_RR) {
+			/* RTCP RR */
+			rtcp_packet->r.rr.ssrc = ntohl(rtcp_packet->r.rr.ssrc);
+			if(rtcp_packet->header.count) {
+				rtcp_rr_get(rtcp_packet->r.rr.rr_stat);
+			}
+		}
+		else if(rtcp_packet->header.pt == RTCP_SDES) {
+			/* RTCP SDES */
+		}
+		else if(rtcp_packet->header.pt == RTCP_BYE) {
+			/* RTCP BYE */
+		}
+		else {
+			/* unknown RTCP packet */
+		}
+
+		/* get next RTCP packet */
+		rtcp_packet = (rtcp_packet_t*)((apr_uint32_t*)rtcp_packet + rtcp_packet->header.length + 1);
+	}
+
+	if(rtcp_packet != rtcp_packet_end) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Malformed Compound RTCP Packet");
+		return FALSE;
+	}
+
+	return TRUE;
+}
@@ -0,0 +1,504 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include <apr_thread_proc.h>
+#include <apr_time.h>
+#include "mpf_rtcp_worker.h"
+#include "mpf_rtp_header.h"
+#include "mpf_rtcp_packet.h"
+#include "mpf_stream_descriptor.h"
+#include "apt_pool.h"
+#include "apt_log.h"
+
+/** Resolution of the RTCP worker (msec) */
+#define MPF_RTCP_WORKER_RESOLUTION 100
+/** Max size of RTCP packet */
+#define MAX_RTCP_PACKET_SIZE       1500
+/** Max length of remote IP address */
+#define MAX_RTCP_REMOTE_IP_LENGTH  64
+/** Max number of attempts to get a consistent snapshot of the statistics record */
+#define MAX_RTCP_SNAPSHOT_ATTEMPTS 100
+
+/** States of the slot */
+typedef enum {
+	RTCP_SLOT_FREE,     /**< free to acquire */
+	RTCP_SLOT_RESERVED, /**< acquired, owned by the media thread */
+	RTCP_SLOT_ACTIVE,   /**< processed by the worker */
+	RTCP_SLOT_RELEASED  /**< released, to be closed by the worker */
+} mpf_rtcp_slot_state_e;
+
+/** RTCP slot */
+struct mpf_rtcp_slot_t {
+	/* fields shared between the media thread and the worker */
+
+	/** state of the slot (mpf_rtcp_slot_state_e) */
+	volatile apr_uint32_t state;
+	/** whether RTCP processing is enabled */
+	volatile apr_uint32_t enabled;
+	/** reason of pending BYE, if any */
+	volatile void        *bye_reason;
+	/** number of reports generated */
+	volatile apr_uint32_t report_count;
+	/** update counter of the remote address, odd while being updated */
+	volatile apr_uint32_t remote_version;
+	/** remote IP address */
+	char                  remote_ip[MAX_RTCP_REMOTE_IP_LENGTH];
+	/** remote RTCP port */
+	apr_port_t            remote_port;
+
+	/* fields set by the media thread before activation */
+
+	/** statistics record updated by the media thread */
+	mpf_rtp_stat_record_t *record;
+
+	/** pool to allocate slot specific data from */
+	apr_pool_t           *pool;
+	/** RTCP socket */
+	apr_socket_t         *socket;
+	/** local RTCP address */
+	apr_sockaddr_t       *local_sockaddr;
+	/** canonical name used in SDES */
+	apt_str_t             cname;
+	/** RTCP report transmission interval (msec) */
+	apr_uint16_t          tx_interval;
+	/** RTCP rx resolution (msec) */
+	apr_uint16_t          rx_resolution;
+
+	/* fields private to the worker */
+
+	/** remote RTCP address */
+	apr_sockaddr_t       *remote_sockaddr;
+	/** version of the remote address resolved */
+	apr_uint32_t          remote_applied_version;
+	/** time of the next report transmission */
+	apr_time_t            tx_time;
+	/** time of the next poll for incoming packets */
+	apr_time_t            rx_time;
+	/** number of expected packets at the prior report */
+	apr_uint32_t          expected_prior;
+	/** number of received packets at the prior report */
+	apr_uint32_t          received_prior;
+};
+
+/** RTCP worker */
+struct mpf_rtcp_worker_t {
+	/** root pool slot pools are created from */
+	apr_pool_t            *pool;
+	/** thread handle */
+	apr_thread_t          *thread;
+	/** running flag */
+	apt_bool_t             running;
+
+	/** array of slots */
+	mpf_rtcp_slot_t       *slots;
+	/** array of statistics records (parallel to slots) */
+	mpf_rtp_stat_record_t *records;
+	/** max number of slots */
+	apr_size_t             max_slots;
+	/** number of slots ever acquired (high-water mark the worker scans up to) */
+	volatile apr_uint32_t  slot_count;
+};
+
+static APR_INLINE void mpf_rtcp_slot_reset(mpf_rtcp_slot_t *slot)
+{
+	slot->enabled = FALSE;
+	slot->bye_reason = NULL;
+	slot->report_count = 0;
+	slot->remote_version = 0;
+	slot->remote_ip[0] = '\0';
+	slot->remote_port = 0;
+	slot->socket = NULL;
+	slot->local_sockaddr = NULL;
+	apt_string_reset(&slot->cname);
+	slot->tx_interval = 0;
+	slot->rx_resolution = 0;
+	slot->remote_sockaddr = NULL;
+	slot->remote_applied_version = 0;
+	slot->tx_time = 0;
+	slot->rx_time = 0;
+	slot->expected_prior = 0;
+	slot->received_prior = 0;
+}
+
+MPF_DECLARE(mpf_rtcp_worker_t*) mpf_rtcp_worker_create(apr_size_t max_streams, apr_pool_t *pool)
+{
+	apr_size_t i;
+	mpf_rtcp_worker_t *worker;
+	if(!max_streams) {
+		return NULL;
+	}
+
+	worker = apr_palloc(pool,sizeof(mpf_rtcp_worker_t));
+	/* slot pools are created by the media thread and cleared by the worker, 
+	hence the root pool with its own (mutexed) allocator */
+	worker->pool = apt_pool_create();
+	if(!worker->pool) {
+		return NULL;
+	}
+	worker->thread = NULL;
+	worker->running = FALSE;
+	worker->max_slots = max_streams;
+	worker->slot_count = 0;
+	worker->slots = apr_palloc(pool,sizeof(mpf_rtcp_slot_t) * max_streams);
+	worker->records = apr_pcalloc(pool,sizeof(mpf_rtp_stat_record_t) * max_streams);
+	for(i=0; i<max_streams; i++) {
+		mpf_rtcp_slot_t *slot = &worker->slots[i];
+		slot->state = RTCP_SLOT_FREE;
+		slot->pool = NULL;
+		slot->record = &worker->records[i];
+		mpf_rtcp_slot_reset(slot);
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Create RTCP Worker [%"APR_SIZE_T_FMT" streams]",max_streams);
+	return worker;
+}
+
+MPF_DECLARE(void) mpf_rtcp_worker_destroy(mpf_rtcp_worker_t *worker)
+{
+	if(worker->pool) {
+		/* sockets of the slots are closed by the pool cleanups */
+		apr_pool_destroy(worker->pool);
+		worker->pool = NULL;
+	}
+}
+
+/* Take a consistent copy of the record the media thread may be updating */
+static apt_bool_t mpf_rtp_stat_record_snapshot(mpf_rtp_stat_record_t *record, mpf_rtp_stat_record_t *snapshot)
+{
+	apr_uint32_t version;
+	apr_size_t attempts = 0;
+	do {
+		version = apr_atomic_add32(&record->version,0);
+		if((version & 1) == 0) {
+			*snapshot = *record;
+			if(apr_atomic_add32(&record->version,0) == version) {
+				return TRUE;
+			}
+		}
+	}
+	while(++attempts < MAX_RTCP_SNAPSHOT_ATTEMPTS);
+	return FALSE;
+}
+
+/* Re-resolve the remote address, if updated by the media thread */
+static void mpf_rtcp_slot_remote_update(mpf_rtcp_slot_t *slot)
+{
+	char ip[MAX_RTCP_REMOTE_IP_LENGTH];
+	apr_port_t port;
+	apr_uint32_t version = apr_atomic_add32(&slot->remote_version,0);
+	if(version == slot->remote_applied_version || (version & 1) != 0) {
+		return;
+	}
+
+	memcpy(ip,slot->remote_ip,sizeof(ip));
+	port = slot->remote_port;
+	if(apr_atomic_add32(&slot->remote_version,0) != version) {
+		/* being updated, retry next time */
+		return;
+	}
+
+	slot->remote_applied_version = version;
+	slot->remote_sockaddr = NULL;
+	if(*ip != '\0') {
+		apr_sockaddr_info_get(&slot->remote_sockaddr,ip,APR_INET,port,0,slot->pool);
+	}
+}
+
+/* Send compound RTCP packet (SR/RR + SDES [+ BYE]) */
+static apt_bool_t mpf_rtcp_slot_compound_send(mpf_rtcp_slot_t *slot, const char *bye_reason)
+{
+	char buffer[MAX_RTCP_PACKET_SIZE];
+	apr_size_t length = 0;
+	rtcp_packet_t *rtcp_packet;
+	mpf_rtp_stat_record_t record;
+
+	if(!slot->remote_sockaddr) {
+		/* session is not initialized */
+		return FALSE;
+	}
+
+	if(mpf_rtp_stat_record_snapshot(slot->record,&record) == FALSE) {
+		return FALSE;
+	}
+
+	if(record.direction != STREAM_DIRECTION_NONE) {
+		mpf_rtcp_rr_loss_calculate(
+			&record.rr_stat,
+			record.expected_packets,
+			record.received_packets,
+			&slot->expected_prior,
+			&slot->received_prior);
+	}
+
+	rtcp_packet = (rtcp_packet_t*) (buffer + length);
+	length += mpf_rtcp_report_generate(&record,rtcp_packet,sizeof(buffer)-length);
+
+	rtcp_packet = (rtcp_packet_t*) (buffer + length);
+	length += mpf_rtcp_sdes_generate(record.sr_stat.ssrc,&slot->cname,rtcp_packet,sizeof(buffer)-length);
+
+	if(bye_reason) {
+		apt_str_t reason;
+		apt_string_set(&reason,bye_reason);
+		rtcp_packet = (rtcp_packet_t*) (buffer + length);
+		length += mpf_rtcp_bye_generate(record.sr_stat.ssrc,&reason,rtcp_packet,sizeof(buffer)-length);
+	}
+
+	/* let the media thread start a new reporting interval */
+	apr_atomic_inc32(&slot->report_count);
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Send Compound RTCP Packet%s [%"APR_SIZE_T_FMT" bytes] %s:%hu -> %s:%hu",
+		bye_reason ? " [BYE]" : "",
+		length,
+		slot->cname.buf,
+		slot->local_sockaddr ? slot->local_sockaddr->port : 0,
+		slot->remote_sockaddr->hostname,
+		slot->remote_sockaddr->port);
+	if(apr_socket_sendto(slot->socket,slot->remote_sockaddr,0,buffer,&length) != APR_SUCCESS) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Send Compound RTCP Packet%s [%"APR_SIZE_T_FMT" bytes] %s:%hu -> %s:%hu",
+			bye_reason ? " [BYE]" : "",
+			length,
+			slot->cname.buf,
+			slot->local_sockaddr ? slot->local_sockaddr->port : 0,
+			slot->remote_sockaddr->hostname,
+			slot->remote_sockaddr->port);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* Receive and parse pending compound RTCP packets */
+static void mpf_rtcp_slot_receive(mpf_rtcp_slot_t *slot)
+{
+	char buffer[MAX_RTCP_PACKET_SIZE];
+	apr_size_t length = sizeof(buffer);
+
+	if(!slot->remote_sockaddr) {
+		/* session is not initialized */
+		return;
+	}
+
+	while(apr_socket_recv(slot->socket,buffer,&length) == APR_SUCCESS) {
+		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Receive Compound RTCP Packet [%"APR_SIZE_T_FMT" bytes] %s:%hu <- %s:%hu",
+				length,
+				slot->cname.buf,
+				slot->local_sockaddr ? slot->local_sockaddr->port : 0,
+				slot->remote_sockaddr->hostname,
+				slot->remote_sockaddr->port);
+		mpf_rtcp_compound_packet_parse(buffer,length);
+		length = sizeof(buffer);
+	}
+}
+
+static void mpf_rtcp_slot_process(mpf_rtcp_slot_t *slot, apr_time_t now)
+{
+	const char *bye_reason;
+	apr_uint32_t state = apr_atomic_read32(&slot->state);
+	if(state != RTCP_SLOT_ACTIVE && state != RTCP_SLOT_RELEASED) {
+		return;
+	}
+
+	mpf_rtcp_slot_remote_update(slot);
+
+	if(apr_atomic_read32(&slot->enabled) == TRUE) {
+		if(!slot->tx_time) {
+			/* (re)enabled, the first report is sent in one interval */
+			slot->tx_time = now + (apr_time_t)slot->tx_interval * 1000;
+			slot->rx_time = now + (apr_time_t)slot->rx_resolution * 1000;
+		}
+
+		if(slot->rx_resolution && now >= slot->rx_time) {
+			mpf_rtcp_slot_receive(slot);
+			slot->rx_time = now + (apr_time_t)slot->rx_resolution * 1000;
+		}
+	}
+	else {
+		slot->tx_time = 0;
+	}
+
+	/* a pending BYE is sent regardless of the slot being disabled or released */
+	bye_reason = apr_atomic_xchgptr(&slot->bye_reason,NULL);
+	if(bye_reason) {
+		mpf_rtcp_slot_compound_send(slot,bye_reason);
+	}
+	else if(state == RTCP_SLOT_ACTIVE && slot->tx_time && slot->tx_interval && now >= slot->tx_time) {
+		mpf_rtcp_slot_compound_send(slot,NULL);
+		slot->tx_time = now + (apr_time_t)slot->tx_interval * 1000;
+	}
+
+	if(state == RTCP_SLOT_RELEASED) {
+		apr_socket_close(slot->socket);
+		apr_pool_clear(slot->pool);
+		apr_atomic_xchg32(&slot->state,RTCP_SLOT_FREE);
+	}
+}
+
+static void* APR_THREAD_FUNC mpf_rtcp_worker_thread_proc(apr_thread_t *thread, void *data)
+{
+	mpf_rtcp_worker_t *worker = data;
+	apr_time_t now;
+	apr_uint32_t i;
+	apr_uint32_t count;
+
+#if APR_HAS_SETTHREADNAME
+	apr_thread_name_set("MPF RTCP");
+#endif
+	while(worker->running == TRUE) {
+		now = apr_time_now();
+		count = apr_atomic_read32(&worker->slot_count);
+		for(i=0; i<count; i++) {
+			mpf_rtcp_slot_process(&worker->slots[i],now);
+		}
+
+		apr_sleep(MPF_RTCP_WORKER_RESOLUTION * 1000);
+	}
+
+	apr_thread_exit(thread,APR_SUCCESS);
+	return NULL;
+}
+
+MPF_DECLARE(apt_bool_t) mpf_rtcp_worker_start(mpf_rtcp_worker_t *worker)
+{
+	worker->running = TRUE;
+	if(apr_thread_create(&worker->thread,NULL,mpf_rtcp_worker_thread_proc,worker,worker->pool) != APR_SUCCESS) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create RTCP Worker Thread");
+		worker->running = FALSE;
+		worker->thread = NULL;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+MPF_DECLARE(apt_bool_t) mpf_rtcp_worker_stop(mpf_rtcp_worker_t *worker)
+{
+	if(worker->thread) {
+		apr_status_t s;
+		worker->running = FALSE;
+		apr_thread_join(&s,worker->thread);
+		worker->thread = NULL;
+	}
+	return TRUE;
+}
+
+MPF_DECLARE(mpf_rtcp_slot_t*) mpf_rtcp_slot_acquire(mpf_rtcp_worker_t *worker)
+{
+	apr_size_t i;
+	for(i=0; i<worker->max_slots; i++) {
+		mpf_rtcp_slot_t *slot = &worker->slots[i];
+		if(apr_atomic_cas32(&slot->state,RTCP_SLOT_RESERVED,RTCP_SLOT_FREE) == RTCP_SLOT_FREE) {
+			mpf_rtp_stat_record_t *record = slot->record;
+			apr_uint32_t count;
+			if(!slot->pool) {
+				slot->pool = apt_subpool_create(worker->pool);
+				if(!slot->pool) {
+					apr_atomic_xchg32(&slot->state,RTCP_SLOT_FREE);
+					return NULL;
+				}
+			}
+			mpf_rtcp_slot_reset(slot);
+
+			mpf_rtp_stat_record_update_begin(record);
+			record->direction = STREAM_DIRECTION_NONE;
+			memset(&record->sr_stat,0,sizeof(record->sr_stat));
+			memset(&record->rr_stat,0,sizeof(record->rr_stat));
+			record->received_packets = 0;
+			record->expected_packets = 0;
+			mpf_rtp_stat_record_update_end(record);
+
+			/* raise the high-water mark the worker scans up to */
+			count = apr_atomic_read32(&worker->slot_count);
+			while(count <= i) {
+				count = apr_atomic_cas32(&worker->slot_count,(apr_uint32_t)i+1,count);
+			}
+			return slot;
+		}
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"No Free RTCP Worker Slot [%"APR_SIZE_T_FMT"]",worker->max_slots);
+	return NULL;
+}
+
+MPF_DECLARE(apr_pool_t*) mpf_rtcp_slot_pool_get(mpf_rtcp_slot_t *slot)
+{
+	return slot->pool;
+}
+
+MPF_DECLARE(mpf_rtp_stat_record_t*) mpf_rtcp_slot_record_get(mpf_rtcp_slot_t *slot)
+{
+	return slot->record;
+}
+
+MPF_DECLARE(void) mpf_rtcp_slot_activate(
+						mpf_rtcp_slot_t *slot,
+						apr_socket_t *socket,
+						const apt_str_t *cname,
+						apr_uint16_t tx_interval,
+						apr_uint16_t rx_resolution)
+{
+	slot->socket = socket;
+	slot->local_sockaddr = NULL;
+	apr_socket_addr_get(&slot->local_sockaddr,APR_LOCAL,socket);
+	apt_string_copy(&slot->cname,cname,slot->pool);
+	slot->tx_interval = tx_interval;
+	slot->rx_resolution = rx_resolution;
+
+	/* publish the slot to the worker */
+	apr_atomic_xchg32(&slot->state,RTCP_SLOT_ACTIVE);
+}
+
+MPF_DECLARE(void) mpf_rtcp_slot_remote_set(mpf_rtcp_slot_t *slot, const apt_str_t *ip, apr_port_t port)
+{
+	apr_size_t length = ip->length;
+	if(length >= sizeof(slot->remote_ip)) {
+		length = sizeof(slot->remote_ip) - 1;
+	}
+
+	apr_atomic_inc32(&slot->remote_version);
+	memcpy(slot->remote_ip,ip->buf,length);
+	slot->remote_ip[length] = '\0';
+	slot->remote_port = port;
+	apr_atomic_inc32(&slot->remote_version);
+}
+
+MPF_DECLARE(void) mpf_rtcp_slot_enable(mpf_rtcp_slot_t *slot, apt_bool_t enable)
+{
+	apr_atomic_xchg32(&slot->enabled,enable);
+}
+
+MPF_DECLARE(void) mpf_rtcp_slot_bye_request(mpf_rtcp_slot_t *slot, const char *reason)
+{
+	apr_atomic_xchgptr(&slot->bye_reason,(void*)reason);
+}
+
+MPF_DECLARE(void) mpf_rtcp_slot_release(mpf_rtcp_slot_t *slot)
+{
+	if(apr_atomic_read32(&slot->state) == RTCP_SLOT_RESERVED) {
+		/* never handed over to the worker */
+		apr_pool_clear(slot->pool);
+		apr_atomic_xchg32(&slot->state,RTCP_SLOT_FREE);
+		return;
+	}
+
+	/* the worker sends a pending BYE, closes the socket and frees the slot */
+	apr_atomic_xchg32(&slot->state,RTCP_SLOT_RELEASED);
+}
+
+MPF_DECLARE(apr_uint32_t) mpf_rtcp_slot_report_count_get(mpf_rtcp_slot_t *slot)
+{
+	return apr_atomic_read32(&slot->report_count);
+}
@@ -24,6 +24,7 @@
 #include "mpf_codec_manager.h"
 #include "mpf_rtp_header.h"
 #include "mpf_rtcp_packet.h"
+#include "mpf_rtcp_worker.h"
 #include "mpf_rtp_defs.h"
 #include "mpf_rtp_pt.h"
 #include "mpf_trace.h"
@@ -70,6 +71,10 @@ struct mpf_rtp_stream_t {
 
 	apt_timer_t                *rtcp_tx_timer;
 	apt_timer_t                *rtcp_rx_timer;
+
+	mpf_rtcp_slot_t            *rtcp_slot;
+	apt_bool_t                  rtcp_slot_active;
+	apr_uint32_t                rtcp_report_count;
 	
 	apr_pool_t                 *pool;
 };
@@ -101,6 +106,8 @@ static apt_bool_t mpf_rtcp_report_send(mpf_rtp_stream_t *stream);
 static apt_bool_t mpf_rtcp_bye_send(mpf_rtp_stream_t *stream, apt_str_t *reason);
 static void mpf_rtcp_tx_timer_proc(apt_timer_t *timer, void *obj);
 static void mpf_rtcp_rx_timer_proc(apt_timer_t *timer, void *obj);
+static void mpf_rtcp_slot_update(mpf_rtp_stream_t *rtp_stream);
+static APR_INLINE void mpf_rtcp_slot_sync(mpf_rtp_stream_t *rtp_stream);
 
 
 MPF_DECLARE(mpf_audio_stream_t*) mpf_rtp_stream_create(mpf_termination_t *termination, mpf_rtp_config_t *config, mpf_rtp_settings_t *settings, apr_pool_t *pool)
@@ -129,6 +136,9 @@ MPF_DECLARE(mpf_audio_stream_t*) mpf_rtp_stream_create(mpf_termination_t *termin
 	rtp_stream->rtcp_r_sockaddr = NULL;
 	rtp_stream->rtcp_tx_timer = NULL;
 	rtp_stream->rtcp_rx_timer = NULL;
+	rtp_stream->rtcp_slot = NULL;
+	rtp_stream->rtcp_slot_active = FALSE;
+	rtp_stream->rtcp_report_count = 0;
 	rtp_stream->state = MPF_MEDIA_DISABLED;
 	rtp_receiver_init(&rtp_stream->receiver);
 	rtp_transmitter_init(&rtp_stream->transmitter);
@@ -305,6 +315,9 @@ static apt_bool_t mpf_rtp_stream_remote_media_update(mpf_rtp_stream_t *rtp_strea
 				media->port+1,
 				0,
 				rtp_stream->pool);
+			if(rtp_stream->rtcp_slot) {
+				mpf_rtcp_slot_remote_set(rtp_stream->rtcp_slot,&media->ip,media->port+1);
+			}
 		}
 	}
 
@@ -333,11 +346,14 @@ static apt_bool_t mpf_rtp_stream_media_negotiate(mpf_rtp_stream_t *rtp_stream)
 				rtp_stream->rtp_l_sockaddr->port);
 		}
 
-		if(rtp_stream->rtcp_tx_timer) {
-			apt_timer_set(rtp_stream->rtcp_tx_timer,rtp_stream->settings->rtcp_tx_interval);
-		}
-		if(rtp_stream->rtcp_rx_timer) {
-			apt_timer_set(rtp_stream->rtcp_rx_timer,rtp_stream->settings->rtcp_rx_resolution);
+		if(!rtp_stream->rtcp_slot) {
+			/* RTCP is processed on the timer clock, unless handed over to the RTCP worker */
+			if(rtp_stream->rtcp_tx_timer) {
+				apt_timer_set(rtp_stream->rtcp_tx_timer,rtp_stream->settings->rtcp_tx_interval);
+			}
+			if(rtp_stream->rtcp_rx_timer) {
+				apt_timer_set(rtp_stream->rtcp_rx_timer,rtp_stream->settings->rtcp_rx_resolution);
+			}
 		}
 	}
 	else if(rtp_stream->state == MPF_MEDIA_ENABLED && remote_media->state == MPF_MEDIA_DISABLED) {
@@ -467,6 +483,7 @@ MPF_DECLARE(apt_bool_t) mpf_rtp_stream_modify(mpf_audio_stream_t *stream, mpf_rt
 		if(rtp_stream->base->tx_descriptor) {
 			rtp_stream->transmitter.samples_per_frame = 
 				(apr_uint32_t)mpf_codec_frame_samples_calculate(rtp_stream->base->tx_descriptor);
+			rtp_stream->transmitter.header_template.type = rtp_stream->base->tx_descriptor->payload_type;
 		}
 		if(codec_list->event_descriptor) {
 			rtp_stream->base->tx_event_descriptor = codec_list->event_descriptor;
@@ -480,6 +497,8 @@ MPF_DECLARE(apt_bool_t) mpf_rtp_stream_modify(mpf_audio_stream_t *stream, mpf_rt
 		}
 	}
 
+	mpf_rtcp_slot_update(rtp_stream);
+
 	if(!descriptor->local) {
 		descriptor->local = rtp_stream->local_media;
 	}
@@ -607,53 +626,24 @@ static rtp_header_t* rtp_rx_header_skip(void **buffer, apr_size_t *size)
 	return header;
 }
 
-static APR_INLINE void rtp_periodic_history_update(rtp_receiver_t *receiver)
+static APR_INLINE apr_uint32_t rtp_rx_expected_packets_get(rtp_receiver_t *receiver)
 {
-	apr_uint32_t expected_packets;
-	apr_uint32_t expected_interval;
-	apr_uint32_t received_interval;
-	apr_uint32_t lost_interval;
-
-	/* calculate expected packets */
-	if(receiver->stat.received_packets) {
-		expected_packets = receiver->history.seq_cycles + 
-			receiver->history.seq_num_max - receiver->history.seq_num_base + 1;
-	}
-	else {
-		expected_packets = 0;
-	}
-
-	/* calculate expected interval */
-	expected_interval = expected_packets - receiver->periodic_history.expected_prior;
-	/* update expected prior */
-	receiver->periodic_history.expected_prior = expected_packets;
-
-	/* calculate received interval */
-	received_interval = receiver->stat.received_packets - receiver->periodic_history.received_prior;
-	/* update received prior */
-	receiver->periodic_history.received_prior = receiver->stat.received_packets;
-	/* calculate lost interval */
-	if(expected_interval > received_interval) {
-		lost_interval = expected_interval - received_interval;
-	}
-	else {
-		lost_interval = 0;
-	}
-
-	/* update lost fraction */
-	if(expected_interval == 0 || lost_interval == 0) {
-		receiver->rr_stat.fraction = 0;
-	}
-	else {
-		receiver->rr_stat.fraction = (lost_interval << 8) / expected_interval;
+	if(!receiver->stat.received_packets) {
+		return 0;
 	}
+	return receiver->history.seq_cycles + 
+		receiver->history.seq_num_max - receiver->history.seq_num_base + 1;
+}
 
-	if(expected_packets > receiver->stat.received_packets) {
-		receiver->rr_stat.lost = expected_packets - receiver->stat.received_packets;
-	}
-	else {
-		receiver->rr_stat.lost = 0;
-	}
+static APR_INLINE void rtp_periodic_history_update(rtp_receiver_t *receiver)
+{
+	/* update lost fraction and cumulative number of lost packets */
+	mpf_rtcp_rr_loss_calculate(
+		&receiver->rr_stat,
+		rtp_rx_expected_packets_get(receiver),
+		receiver->stat.received_packets,
+		&receiver->periodic_history.expected_prior,
+		&receiver->periodic_history.received_prior);
 
 	receiver->periodic_history.discarded_prior = receiver->stat.discarded_packets;
 	receiver->periodic_history.jitter_min = receiver->rr_stat.jitter;
@@ -880,6 +870,9 @@ static apt_bool_t mpf_rtp_stream_receive(mpf_audio_stream_t *stream, mpf_frame_t
 {
 	mpf_rtp_stream_t *rtp_stream = stream->obj;
 	rtp_rx_process(rtp_stream);
+	if(rtp_stream->rtcp_slot_active == TRUE) {
+		mpf_rtcp_slot_sync(rtp_stream);
+	}
 
 	return mpf_jitter_buffer_read(rtp_stream->receiver.jb,frame);
 }
@@ -916,6 +909,10 @@ static apt_bool_t mpf_rtp_tx_stream_open(mpf_audio_stream_t *stream, mpf_codec_t
 	transmitter->packet_data = apr_palloc(
 							rtp_stream->pool,
 							sizeof(rtp_header_t) + transmitter->packet_frames * frame_size);
+
+	/* fill in the fields which remain the same for all the packets of the stream */
+	transmitter->header_template.type = stream->tx_descriptor->payload_type;
+	transmitter->header_template.ssrc = htonl(transmitter->sr_stat.ssrc);
 	
 	transmitter->inactivity = 1;
 	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Open RTP Transmitter %s:%hu -> %s:%hu",
@@ -943,21 +940,16 @@ static apt_bool_t mpf_rtp_tx_stream_close(mpf_audio_stream_t *stream)
 }
 
 
+/** Prepare RTP header by the template of the transmitter, timestamp is in host order */
 static APR_INLINE void rtp_header_prepare(
 					rtp_transmitter_t *transmitter,
 					rtp_header_t *header,
-					apr_byte_t payload_type,
 					apr_byte_t marker,
 					apr_uint32_t timestamp)
 {
-	header->version = RTP_VERSION;
-	header->padding = 0;
-	header->extension = 0;
-	header->count = 0;
+	*header = transmitter->header_template;
 	header->marker = marker;
-	header->type = payload_type;
-	header->timestamp = timestamp;
-	header->ssrc = htonl(transmitter->sr_stat.ssrc);
+	header->timestamp = htonl(timestamp);
 }
 
 static APR_INLINE apt_bool_t mpf_rtp_data_send(mpf_rtp_stream_t *rtp_stream, rtp_transmitter_t *transmitter, const mpf_frame_t *frame)
@@ -976,8 +968,7 @@ static APR_INLINE apt_bool_t mpf_rtp_data_send(mpf_rtp_stream_t *rtp_stream, rtp
 			(apr_uint32_t)apr_time_usec(apr_time_now()),
 			transmitter->sr_stat.ssrc, header->type, 
 			(header->marker == 1) ? '*' : ' ',
-			header->timestamp, transmitter->last_seq_num);
-		header->timestamp = htonl(header->timestamp);
+			ntohl(header->timestamp), transmitter->last_seq_num);
 		if(apr_socket_sendto(
 					rtp_stream->rtp_socket,
 					rtp_stream->rtp_r_sockaddr,
@@ -1004,9 +995,9 @@ static APR_INLINE apt_bool_t mpf_rtp_event_send(mpf_rtp_stream_t *rtp_stream, rt
 	rtp_header_prepare(
 		transmitter,
 		header,
-		rtp_stream->base->tx_event_descriptor->payload_type,
 		(frame->marker == MPF_MARKER_START_OF_EVENT) ? 1 : 0,
 		transmitter->timestamp_base);
+	header->type = rtp_stream->base->tx_event_descriptor->payload_type;
 
 	*named_event = frame->event_frame;
 	named_event->edge = (frame->marker == MPF_MARKER_END_OF_EVENT) ? 1 : 0;
@@ -1016,10 +1007,9 @@ static APR_INLINE apt_bool_t mpf_rtp_event_send(mpf_rtp_stream_t *rtp_stream, rt
 		(apr_uint32_t)apr_time_usec(apr_time_now()),
 		transmitter->sr_stat.ssrc, 
 		header->type, (header->marker == 1) ? '*' : ' ',
-		header->timestamp, transmitter->last_seq_num,
+		transmitter->timestamp_base, transmitter->last_seq_num,
 		named_event->event_id, named_event->duration,
 		(named_event->edge == 1) ? '*' : ' ');
-	header->timestamp = htonl(header->timestamp);
 	named_event->duration = htons((apr_uint16_t)named_event->duration);
 	if(apr_socket_sendto(
 				rtp_stream->rtp_socket,
@@ -1040,6 +1030,11 @@ static apt_bool_t mpf_rtp_stream_transmit(mpf_audio_stream_t *stream, const mpf_
 	mpf_rtp_stream_t *rtp_stream = stream->obj;
 	rtp_transmitter_t *transmitter = &rtp_stream->transmitter;
 
+	if(rtp_stream->rtcp_slot_active == TRUE && (stream->direction & STREAM_DIRECTION_RECEIVE) == 0) {
+		/* otherwise synchronized on receive */
+		mpf_rtcp_slot_sync(rtp_stream);
+	}
+
 	transmitter->timestamp += transmitter->samples_per_frame;
 
 	if(frame->type == MEDIA_FRAME_TYPE_NONE) {
@@ -1082,7 +1077,6 @@ static apt_bool_t mpf_rtp_stream_transmit(mpf_audio_stream_t *stream, const mpf_
 			rtp_header_prepare(
 					transmitter,
 					header,
-					stream->tx_descriptor->payload_type,
 					transmitter->inactivity,
 					transmitter->timestamp);
 			transmitter->packet_size = sizeof(rtp_header_t);
@@ -1137,6 +1131,15 @@ static apt_bool_t mpf_socket_bind(apr_socket_t *socket, const char *ip, apr_port
 	return TRUE;
 }
 
+/* Get the pool to create RTCP socket from */
+static APR_INLINE apr_pool_t* mpf_rtcp_pool_get(mpf_rtp_stream_t *stream)
+{
+	if(stream->rtcp_slot) {
+		return mpf_rtcp_slot_pool_get(stream->rtcp_slot);
+	}
+	return stream->pool;
+}
+
 /* Create RTP/RTCP sockets */
 static apt_bool_t mpf_rtp_socket_pair_create(mpf_rtp_stream_t *stream, mpf_rtp_media_descriptor_t *local_media, apt_bool_t bind)
 {
@@ -1152,13 +1155,28 @@ static apt_bool_t mpf_rtp_socket_pair_create(mpf_rtp_stream_t *stream, mpf_rtp_m
 		}
 	}
 
+	/* Acquire RTCP worker slot, if available. The RTCP socket is then created from the pool of the slot
+	and closed by the worker. */
+	if(stream->settings->rtcp == TRUE && stream->base->termination->rtcp_worker) {
+		stream->rtcp_slot = mpf_rtcp_slot_acquire(stream->base->termination->rtcp_worker);
+		stream->rtcp_slot_active = FALSE;
+		stream->rtcp_report_count = 0;
+		if(stream->rtcp_slot && stream->remote_media && stream->remote_media->state == MPF_MEDIA_ENABLED) {
+			mpf_rtcp_slot_remote_set(stream->rtcp_slot,&stream->remote_media->ip,stream->remote_media->port+1);
+		}
+	}
+
 	/* Create and optionally bind RCTP socket. Continue in either way. */
-	if(mpf_socket_create(stream->pool,&stream->rtcp_socket) == TRUE && bind == TRUE) {
-		if(mpf_socket_bind(stream->rtcp_socket,local_media->ip.buf,local_media->port+1,stream->pool,&stream->rtcp_l_sockaddr) == FALSE) {
+	if(mpf_socket_create(mpf_rtcp_pool_get(stream),&stream->rtcp_socket) == TRUE && bind == TRUE) {
+		if(mpf_socket_bind(stream->rtcp_socket,local_media->ip.buf,local_media->port+1,mpf_rtcp_pool_get(stream),&stream->rtcp_l_sockaddr) == FALSE) {
 			apr_socket_close(stream->rtcp_socket);
 			stream->rtcp_socket = NULL;
 		}
 	}
+	if(!stream->rtcp_socket && stream->rtcp_slot) {
+		mpf_rtcp_slot_release(stream->rtcp_slot);
+		stream->rtcp_slot = NULL;
+	}
 	return TRUE;
 }
 
@@ -1171,7 +1189,7 @@ static apt_bool_t mpf_rtp_socket_pair_bind(mpf_rtp_stream_t *stream, mpf_rtp_med
 	}
 	
 	/* Try to bind RTCP socket. Continue in either way. */
-	mpf_socket_bind(stream->rtcp_socket,local_media->ip.buf,local_media->port+1,stream->pool,&stream->rtcp_l_sockaddr);
+	mpf_socket_bind(stream->rtcp_socket,local_media->ip.buf,local_media->port+1,mpf_rtcp_pool_get(stream),&stream->rtcp_l_sockaddr);
 	return TRUE;
 }
 
@@ -1182,133 +1200,34 @@ static void mpf_rtp_socket_pair_close(mpf_rtp_stream_t *stream)
 		apr_socket_close(stream->rtp_socket);
 		stream->rtp_socket = NULL;
 	}
-	if(stream->rtcp_socket) {
-		apr_socket_close(stream->rtcp_socket);
+	if(stream->rtcp_slot) {
+		/* a pending BYE is sent and the socket is closed by the worker */
+		mpf_rtcp_slot_release(stream->rtcp_slot);
+		stream->rtcp_slot = NULL;
+		stream->rtcp_slot_active = FALSE;
 		stream->rtcp_socket = NULL;
+		stream->rtcp_l_sockaddr = NULL;
 	}
-}
-
-
-
-static APR_INLINE void rtcp_sr_generate(mpf_rtp_stream_t *rtp_stream, rtcp_sr_stat_t *sr_stat)
-{
-	*sr_stat = rtp_stream->transmitter.sr_stat;
-	apt_ntp_time_get(&sr_stat->ntp_sec, &sr_stat->ntp_frac);
-	sr_stat->rtp_ts = rtp_stream->transmitter.timestamp;
-
-	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Generate RTCP SR [ssrc:%u s:%u o:%u ts:%u]",
-				sr_stat->ssrc,
-				sr_stat->sent_packets,
-				sr_stat->sent_octets,
-				sr_stat->rtp_ts);
-	rtcp_sr_hton(sr_stat);
-}
-
-static APR_INLINE void rtcp_rr_generate(mpf_rtp_stream_t *rtp_stream, rtcp_rr_stat_t *rr_stat)
-{
-	*rr_stat = rtp_stream->receiver.rr_stat;
-	rr_stat->last_seq =	rtp_stream->receiver.history.seq_num_max;
-
-	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Generate RTCP RR [ssrc:%u last_seq:%u j:%u lost:%u frac:%d]",
-				rr_stat->ssrc,
-				rr_stat->last_seq,
-				rr_stat->jitter,
-				rr_stat->lost,
-				rr_stat->fraction);
-	rtcp_rr_hton(rr_stat);
-}
-
-/* Generate either RTCP SR or RTCP RR packet */
-static APR_INLINE apr_size_t rtcp_report_generate(mpf_rtp_stream_t *rtp_stream, rtcp_packet_t *rtcp_packet, apr_size_t length)
-{
-	apr_size_t offset = 0;
-	rtcp_header_init(&rtcp_packet->header,RTCP_RR);
-	if(rtp_stream->base->direction & STREAM_DIRECTION_SEND) {
-		rtcp_packet->header.pt = RTCP_SR;
-	}
-	if(rtp_stream->base->direction & STREAM_DIRECTION_RECEIVE) {
-		rtcp_packet->header.count = 1;
-	}
-	offset += sizeof(rtcp_header_t);
-
-	if(rtcp_packet->header.pt == RTCP_SR) {
-		rtcp_sr_generate(rtp_stream,&rtcp_packet->r.sr.sr_stat);
-		offset += sizeof(rtcp_sr_stat_t);
-		if(rtcp_packet->header.count) {
-			rtcp_rr_generate(rtp_stream,rtcp_packet->r.sr.rr_stat);
-			offset += sizeof(rtcp_rr_stat_t);
-		}
-	}
-	else if(rtcp_packet->header.pt == RTCP_RR) {
-		rtcp_packet->r.rr.ssrc = htonl(rtp_stream->transmitter.sr_stat.ssrc);
-		rtcp_rr_generate(rtp_stream,rtcp_packet->r.rr.rr_stat);
-		offset += sizeof(rtcp_packet->r.rr);
+	else if(stream->rtcp_socket) {
+		apr_socket_close(stream->rtcp_socket);
+		stream->rtcp_socket = NULL;
 	}
-	rtcp_header_length_set(&rtcp_packet->header,offset);
-	return offset;
 }
 
-/* Generate RTCP SDES packet */
-static APR_INLINE apr_size_t rtcp_sdes_generate(mpf_rtp_stream_t *rtp_stream, rtcp_packet_t *rtcp_packet, apr_size_t length)
-{
-	rtcp_sdes_item_t *item;
-	apr_size_t offset = 0;
-	apr_size_t padding;
-	rtcp_header_init(&rtcp_packet->header,RTCP_SDES);
-	offset += sizeof(rtcp_header_t);
-
-	rtcp_packet->header.count ++;
-	rtcp_packet->r.sdes.ssrc = htonl(rtp_stream->transmitter.sr_stat.ssrc);
-	offset += sizeof(apr_uint32_t);
-
-	/* insert SDES CNAME item */
-	item = &rtcp_packet->r.sdes.item[0];
-	item->type = RTCP_SDES_CNAME;
-	item->length = (apr_byte_t)rtp_stream->local_media->ip.length;
-	memcpy(item->data,rtp_stream->local_media->ip.buf,item->length);
-	offset += sizeof(rtcp_sdes_item_t) - 1 + item->length;
-	
-	/* terminate with end marker and pad to next 4-octet boundary */
-	padding = 4 - (offset & 0x3);
-	while(padding--) {
-		item = (rtcp_sdes_item_t*) ((char*)rtcp_packet + offset);
-		item->type = RTCP_SDES_END;
-		offset++;
-	}
 
-	rtcp_header_length_set(&rtcp_packet->header,offset);
-	return offset;
-}
 
-/* Generate RTCP BYE packet */
-static APR_INLINE apr_size_t rtcp_bye_generate(mpf_rtp_stream_t *rtp_stream, rtcp_packet_t *rtcp_packet, apr_size_t length, apt_str_t *reason)
+/* Fill statistics record RTCP reports are generated from */
+static APR_INLINE void mpf_rtp_stat_record_fill(mpf_rtp_stream_t *rtp_stream, mpf_rtp_stat_record_t *record)
 {
-	apr_size_t offset = 0;
-	rtcp_header_init(&rtcp_packet->header,RTCP_BYE);
-	offset += sizeof(rtcp_header_t);
-
-	rtcp_packet->r.bye.ssrc[0] = htonl(rtp_stream->transmitter.sr_stat.ssrc);
-	rtcp_packet->header.count++;
-	offset += rtcp_packet->header.count * sizeof(apr_uint32_t);
-
-	if(reason->length) {
-		apr_size_t padding;
-
-		memcpy(rtcp_packet->r.bye.data,reason->buf,reason->length);
-		rtcp_packet->r.bye.length = (apr_byte_t)reason->length;
-		offset += rtcp_packet->r.bye.length;
-	
-		/* terminate with end marker and pad to next 4-octet boundary */
-		padding = 4 - (reason->length & 0x3);
-		if(padding) {
-			char *end = rtcp_packet->r.bye.data + reason->length;
-			memset(end,0,padding);
-			offset += padding;
-		}
-	}
+	rtp_receiver_t *receiver = &rtp_stream->receiver;
 
-	rtcp_header_length_set(&rtcp_packet->header,offset);
-	return offset;
+	record->direction = rtp_stream->base->direction;
+	record->sr_stat = rtp_stream->transmitter.sr_stat;
+	record->sr_stat.rtp_ts = rtp_stream->transmitter.timestamp;
+	record->rr_stat = receiver->rr_stat;
+	record->rr_stat.last_seq = receiver->history.seq_num_max;
+	record->received_packets = receiver->stat.received_packets;
+	record->expected_packets = rtp_rx_expected_packets_get(receiver);
 }
 
 /* Send compound RTCP packet (SR/RR + SDES) */
@@ -1317,6 +1236,7 @@ static apt_bool_t mpf_rtcp_report_send(mpf_rtp_stream_t *rtp_stream)
 	char buffer[MAX_RTCP_PACKET_SIZE];
 	apr_size_t length = 0;
 	rtcp_packet_t *rtcp_packet;
+	mpf_rtp_stat_record_t record;
 
 	if(!rtp_stream->rtcp_socket || !rtp_stream->rtcp_l_sockaddr || !rtp_stream->rtcp_r_sockaddr) {
 		/* session is not initialized */
@@ -1327,12 +1247,13 @@ static apt_bool_t mpf_rtcp_report_send(mpf_rtp_stream_t *rtp_stream)
 		/* update periodic (prior) history */
 		rtp_periodic_history_update(&rtp_stream->receiver);
 	}
+	mpf_rtp_stat_record_fill(rtp_stream,&record);
 
 	rtcp_packet = (rtcp_packet_t*) (buffer + length);
-	length += rtcp_report_generate(rtp_stream,rtcp_packet,sizeof(buffer)-length);
+	length += mpf_rtcp_report_generate(&record,rtcp_packet,sizeof(buffer)-length);
 
 	rtcp_packet = (rtcp_packet_t*) (buffer + length);
-	length += rtcp_sdes_generate(rtp_stream,rtcp_packet,sizeof(buffer)-length);
+	length += mpf_rtcp_sdes_generate(record.sr_stat.ssrc,&rtp_stream->local_media->ip,rtcp_packet,sizeof(buffer)-length);
 	
 	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Send Compound RTCP Packet [%"APR_SIZE_T_FMT" bytes] %s:%hu -> %s:%hu",
 		length,
@@ -1363,6 +1284,13 @@ static apt_bool_t mpf_rtcp_bye_send(mpf_rtp_stream_t *rtp_stream, apt_str_t *rea
 	char buffer[MAX_RTCP_PACKET_SIZE];
 	apr_size_t length = 0;
 	rtcp_packet_t *rtcp_packet;
+	mpf_rtp_stat_record_t record;
+
+	if(rtp_stream->rtcp_slot) {
+		/* sent by the worker (the reason is a string literal) */
+		mpf_rtcp_slot_bye_request(rtp_stream->rtcp_slot,reason->buf);
+		return TRUE;
+	}
 
 	if(!rtp_stream->rtcp_socket || !rtp_stream->rtcp_l_sockaddr || !rtp_stream->rtcp_r_sockaddr) {
 		/* session is not initialized */
@@ -1373,15 +1301,16 @@ static apt_bool_t mpf_rtcp_bye_send(mpf_rtp_stream_t *rtp_stream, apt_str_t *rea
 		/* update periodic (prior) history */
 		rtp_periodic_history_update(&rtp_stream->receiver);
 	}
+	mpf_rtp_stat_record_fill(rtp_stream,&record);
 
 	rtcp_packet = (rtcp_packet_t*) (buffer + length);
-	length += rtcp_report_generate(rtp_stream,rtcp_packet,sizeof(buffer)-length);
+	length += mpf_rtcp_report_generate(&record,rtcp_packet,sizeof(buffer)-length);
 
 	rtcp_packet = (rtcp_packet_t*) (buffer + length);
-	length += rtcp_sdes_generate(rtp_stream,rtcp_packet,sizeof(buffer)-length);
+	length += mpf_rtcp_sdes_generate(record.sr_stat.ssrc,&rtp_stream->local_media->ip,rtcp_packet,sizeof(buffer)-length);
 
 	rtcp_packet = (rtcp_packet_t*) (buffer + length);
-	length += rtcp_bye_generate(rtp_stream,rtcp_packet,sizeof(buffer)-length,reason);
+	length += mpf_rtcp_bye_generate(record.sr_stat.ssrc,reason,rtcp_packet,sizeof(buffer)-length);
 
 	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Send Compound RTCP Packet [BYE] [%"APR_SIZE_T_FMT" bytes] %s:%hu -> %s:%hu",
 		length,
@@ -1406,73 +1335,6 @@ static apt_bool_t mpf_rtcp_bye_send(mpf_rtp_stream_t *rtp_stream, apt_str_t *rea
 	return TRUE;
 }
 
-static APR_INLINE void rtcp_sr_get(mpf_rtp_stream_t *rtp_stream, rtcp_sr_stat_t *sr_stat)
-{
-	rtcp_sr_ntoh(sr_stat);
-	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Get RTCP SR [ssrc:%u s:%u o:%u ts:%u]",
-				sr_stat->ssrc,
-				sr_stat->sent_packets,
-				sr_stat->sent_octets,
-				sr_stat->rtp_ts);
-}
-
-static APR_INLINE void rtcp_rr_get(mpf_rtp_stream_t *rtp_stream, rtcp_rr_stat_t *rr_stat)
-{
-	rtcp_rr_ntoh(rr_stat);
-	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Get RTCP RR [ssrc:%u last_seq:%u j:%u lost:%u frac:%d]",
-				rr_stat->ssrc,
-				rr_stat->last_seq,
-				rr_stat->jitter,
-				rr_stat->lost,
-				rr_stat->fraction);
-}
-
-static apt_bool_t mpf_rtcp_compound_packet_receive(mpf_rtp_stream_t *rtp_stream, char *buffer, apr_size_t length)
-{
-	rtcp_packet_t *rtcp_packet = (rtcp_packet_t*) buffer;
-	rtcp_packet_t *rtcp_packet_end;
-
-	rtcp_packet_end = (rtcp_packet_t*)(buffer + length);
-
-	while(rtcp_packet < rtcp_packet_end && rtcp_packet->header.version == RTP_VERSION) {
-		rtcp_packet->header.length = ntohs((apr_uint16_t)rtcp_packet->header.length);
-		
-		if(rtcp_packet->header.pt == RTCP_SR) {
-			/* RTCP SR */
-			rtcp_sr_get(rtp_stream,&rtcp_packet->r.sr.sr_stat);
-			if(rtcp_packet->header.count) {
-				rtcp_rr_get(rtp_stream,rtcp_packet->r.sr.rr_stat);
-			}
-		}
-		else if(rtcp_packet->header.pt == RTCP_RR) {
-			/* RTCP RR */
-			rtcp_packet->r.rr.ssrc = ntohl(rtcp_packet->r.rr.ssrc);
-			if(rtcp_packet->header.count) {
-				rtcp_rr_get(rtp_stream,rtcp_packet->r.rr.rr_stat);
-			}
-		}
-		else if(rtcp_packet->header.pt == RTCP_SDES) {
-			/* RTCP SDES */
-		}
-		else if(rtcp_packet->header.pt == RTCP_BYE) {
-			/* RTCP BYE */
-		}
-		else {
-			/* unknown RTCP packet */
-		}
-
-		/* get next RTCP packet */
-		rtcp_packet = (rtcp_packet_t*)((apr_uint32_t*)rtcp_packet + rtcp_packet->header.length + 1);
-	}
-
-	if(rtcp_packet != rtcp_packet_end) {
-		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Malformed Compound RTCP Packet");
-		return FALSE;
-	}
-
-	return TRUE;
-}
-
 static void mpf_rtcp_tx_timer_proc(apt_timer_t *timer, void *obj)
 {
 	mpf_rtp_stream_t *rtp_stream = obj;
@@ -1498,10 +1360,51 @@ static void mpf_rtcp_rx_timer_proc(apt_timer_t *timer, void *obj)
 					rtp_stream->rtcp_l_sockaddr->port,
 					rtp_stream->rtcp_r_sockaddr->hostname,
 					rtp_stream->rtcp_r_sockaddr->port);
-			mpf_rtcp_compound_packet_receive(rtp_stream,buffer,length);
+			mpf_rtcp_compound_packet_parse(buffer,length);
 		}
 	}
 
 	/* re-schedule timer */
 	apt_timer_set(timer,rtp_stream->settings->rtcp_rx_resolution);
 }
+
+/* Hand RTCP processing over to the worker, once the slot is acquired */
+static void mpf_rtcp_slot_update(mpf_rtp_stream_t *rtp_stream)
+{
+	if(!rtp_stream->rtcp_slot) {
+		return;
+	}
+
+	if(rtp_stream->rtcp_slot_active == FALSE) {
+		if(!rtp_stream->local_media) {
+			return;
+		}
+		mpf_rtcp_slot_activate(
+			rtp_stream->rtcp_slot,
+			rtp_stream->rtcp_socket,
+			&rtp_stream->local_media->ip,
+			rtp_stream->settings->rtcp_tx_interval,
+			rtp_stream->settings->rtcp_rx_resolution);
+		rtp_stream->rtcp_slot_active = TRUE;
+	}
+
+	mpf_rtcp_slot_enable(rtp_stream->rtcp_slot,rtp_stream->state == MPF_MEDIA_ENABLED ? TRUE : FALSE);
+}
+
+/* Publish statistics to the worker and follow the reporting intervals of the worker */
+static APR_INLINE void mpf_rtcp_slot_sync(mpf_rtp_stream_t *rtp_stream)
+{
+	mpf_rtp_stat_record_t *record = mpf_rtcp_slot_record_get(rtp_stream->rtcp_slot);
+	apr_uint32_t report_count = mpf_rtcp_slot_report_count_get(rtp_stream->rtcp_slot);
+	if(report_count != rtp_stream->rtcp_report_count) {
+		rtp_stream->rtcp_report_count = report_count;
+		if(rtp_stream->base->direction != STREAM_DIRECTION_NONE) {
+			/* update periodic (prior) history */
+			rtp_periodic_history_update(&rtp_stream->receiver);
+		}
+	}
+
+	mpf_rtp_stat_record_update_begin(record);
+	mpf_rtp_stat_record_fill(rtp_stream,record);
+	mpf_rtp_stat_record_update_end(record);
+}
@@ -16,6 +16,8 @@
  * $Id$
  */
 
+#include <apr_atomic.h>
+#include <apr_time.h>
 #include "mpf_scheduler.h"
 
 #ifdef WIN32
@@ -50,6 +52,14 @@ struct mpf_scheduler_t {
 	mpf_scheduler_proc_f timer_proc;
 	void                *timer_obj;
 
+	volatile apr_uint32_t overrun_count; /* number of ticks started a whole period late */
+	volatile apr_uint32_t tick_count;    /* number of processed ticks */
+	volatile apr_uint32_t jitter_max;    /* max deviation of tick interval from the period (usec) */
+	volatile apr_uint32_t jitter_mean;   /* mean deviation of tick interval from the period (usec) */
+	apr_uint64_t          jitter_sum;    /* sum of deviations of tick intervals (usec), scheduler thread only */
+	apr_uint64_t          jitter_count;  /* number of accounted tick intervals, scheduler thread only */
+	apr_time_t            tick_time;     /* time of the last tick */
+
 #ifdef ENABLE_MULTIMEDIA_TIMERS
 	unsigned int         timer_id;
 #else
@@ -76,6 +86,14 @@ MPF_DECLARE(mpf_scheduler_t*) mpf_scheduler_create(apr_pool_t *pool)
 	scheduler->timer_elapsed_time = 0;
 	scheduler->timer_obj = NULL;
 	scheduler->timer_proc = NULL;
+
+	scheduler->overrun_count = 0;
+	scheduler->tick_count = 0;
+	scheduler->jitter_max = 0;
+	scheduler->jitter_mean = 0;
+	scheduler->jitter_sum = 0;
+	scheduler->jitter_count = 0;
+	scheduler->tick_time = 0;
 	return scheduler;
 }
 
@@ -129,6 +147,42 @@ MPF_DECLARE(apt_bool_t) mpf_scheduler_rate_set(
 	return TRUE;
 }
 
+/** Get the number of overrun ticks */
+MPF_DECLARE(apr_uint32_t) mpf_scheduler_overrun_count_get(mpf_scheduler_t *scheduler)
+{
+	return apr_atomic_read32(&scheduler->overrun_count);
+}
+
+/** Get the statistics of the scheduler */
+MPF_DECLARE(void) mpf_scheduler_stats_get(mpf_scheduler_t *scheduler, mpf_scheduler_stats_t *stats)
+{
+	stats->tick_count = apr_atomic_read32(&scheduler->tick_count);
+	stats->overrun_count = apr_atomic_read32(&scheduler->overrun_count);
+	stats->jitter_max = apr_atomic_read32(&scheduler->jitter_max);
+	stats->jitter_mean = apr_atomic_read32(&scheduler->jitter_mean);
+}
+
+/** Account the interval between the current and the previous ticks */
+static APR_INLINE void mpf_scheduler_tick_account(mpf_scheduler_t *scheduler, apr_time_t time_now)
+{
+	if(scheduler->tick_time) {
+		apr_interval_time_t period = scheduler->resolution * 1000;
+		apr_interval_time_t jitter = time_now - scheduler->tick_time - period;
+		if(jitter < 0) {
+			jitter = -jitter;
+		}
+		/* the 64-bit sum can't be read atomically by other threads, publish the mean instead */
+		scheduler->jitter_sum += jitter;
+		scheduler->jitter_count++;
+		apr_atomic_set32(&scheduler->jitter_mean,(apr_uint32_t)(scheduler->jitter_sum / scheduler->jitter_count));
+		if(jitter > apr_atomic_read32(&scheduler->jitter_max)) {
+			apr_atomic_set32(&scheduler->jitter_max,(apr_uint32_t)jitter);
+		}
+	}
+	scheduler->tick_time = time_now;
+	apr_atomic_inc32(&scheduler->tick_count);
+}
+
 static APR_INLINE void mpf_scheduler_resolution_set(mpf_scheduler_t *scheduler)
 {
 	if(scheduler->media_resolution) {
@@ -151,6 +205,7 @@ static APR_INLINE void mpf_scheduler_init(mpf_scheduler_t *scheduler)
 static void CALLBACK mm_timer_proc(UINT uID, UINT uMsg, DWORD_PTR dwUser, DWORD_PTR dw1, DWORD_PTR dw2)
 {
 	mpf_scheduler_t *scheduler = (mpf_scheduler_t*) dwUser;
+	mpf_scheduler_tick_account(scheduler,apr_time_now());
 	if(scheduler->media_proc) {
 		scheduler->media_proc(scheduler,scheduler->media_obj);
 	}
@@ -209,6 +264,7 @@ static void* APR_THREAD_FUNC timer_thread_proc(apr_thread_t *thread, void *data)
 	time_now = apr_time_now();
 	while(scheduler->running == TRUE) {
 		time_last = time_now;
+		mpf_scheduler_tick_account(scheduler,time_now);
 
 		if(scheduler->media_proc) {
 			scheduler->media_proc(scheduler,scheduler->media_obj);
@@ -228,6 +284,10 @@ static void* APR_THREAD_FUNC timer_thread_proc(apr_thread_t *thread, void *data)
 
 		time_now = apr_time_now();
 		time_drift += time_now - time_last - timeout;
+		if(time_drift >= timeout) {
+			/* the next tick is already a whole period late */
+			apr_atomic_inc32(&scheduler->overrun_count);
+		}
 #if 0
 		printf("time_drift=%d\n",time_drift);
 #endif
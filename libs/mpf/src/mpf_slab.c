@@ -0,0 +1,137 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include <apr_thread_mutex.h>
+#include "mpf_slab.h"
+#include "apt_log.h"
+
+/** Free block, linked into the free list */
+typedef struct mpf_slab_block_t mpf_slab_block_t;
+
+struct mpf_slab_block_t {
+	/** Next free block */
+	mpf_slab_block_t *next;
+};
+
+/** Slab of fixed-size memory blocks */
+struct mpf_slab_t {
+	/** Beginning of the contiguous memory of the blocks */
+	char               *begin;
+	/** End of the contiguous memory of the blocks */
+	char               *end;
+	/** Size of each block */
+	apr_size_t          block_size;
+	/** Number of blocks */
+	apr_size_t          block_count;
+	/** Number of blocks in use */
+	apr_size_t          used_count;
+	/** List of free blocks */
+	mpf_slab_block_t   *free_list;
+	/** Mutex to protect the free list */
+	apr_thread_mutex_t *guard;
+};
+
+MPF_DECLARE(mpf_slab_t*) mpf_slab_create(apr_size_t block_size, apr_size_t block_count, apr_pool_t *pool)
+{
+	apr_size_t i;
+	char *mem;
+	mpf_slab_t *slab;
+	if(!block_size || !block_count) {
+		return NULL;
+	}
+
+	slab = apr_palloc(pool,sizeof(mpf_slab_t));
+	slab->block_size = MPF_SLAB_ALIGN(block_size);
+	slab->block_count = block_count;
+	slab->used_count = 0;
+	slab->guard = NULL;
+	if(apr_thread_mutex_create(&slab->guard,APR_THREAD_MUTEX_DEFAULT,pool) != APR_SUCCESS) {
+		return NULL;
+	}
+
+	/* allocate extra memory to start the blocks at a cache line boundary */
+	mem = apr_palloc(pool,slab->block_size * block_count + MPF_SLAB_ALIGNMENT);
+	slab->begin = (char*)MPF_SLAB_ALIGN((apr_size_t)mem);
+	slab->end = slab->begin + slab->block_size * block_count;
+
+	/* link the blocks in the order of addresses, the first block is taken first */
+	slab->free_list = NULL;
+	for(i=block_count; i>0; i--) {
+		mpf_slab_block_t *block = (mpf_slab_block_t*)(slab->begin + slab->block_size * (i-1));
+		block->next = slab->free_list;
+		slab->free_list = block;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Create Slab [%"APR_SIZE_T_FMT" x %"APR_SIZE_T_FMT" bytes]",
+		block_count,
+		slab->block_size);
+	return slab;
+}
+
+MPF_DECLARE(void) mpf_slab_destroy(mpf_slab_t *slab)
+{
+	if(slab->used_count) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Destroy Slab [%"APR_SIZE_T_FMT" blocks in use]",slab->used_count);
+	}
+	if(slab->guard) {
+		apr_thread_mutex_destroy(slab->guard);
+		slab->guard = NULL;
+	}
+}
+
+MPF_DECLARE(void*) mpf_slab_block_take(mpf_slab_t *slab, apr_size_t size)
+{
+	mpf_slab_block_t *block;
+	if(size > slab->block_size) {
+		return NULL;
+	}
+
+	apr_thread_mutex_lock(slab->guard);
+	block = slab->free_list;
+	if(block) {
+		slab->free_list = block->next;
+		slab->used_count++;
+	}
+	apr_thread_mutex_unlock(slab->guard);
+	return block;
+}
+
+MPF_DECLARE(apt_bool_t) mpf_slab_block_release(mpf_slab_t *slab, void *mem)
+{
+	mpf_slab_block_t *block = mem;
+	if((char*)mem < slab->begin || (char*)mem >= slab->end) {
+		return FALSE;
+	}
+
+	apr_thread_mutex_lock(slab->guard);
+	block->next = slab->free_list;
+	slab->free_list = block;
+	slab->used_count--;
+	apr_thread_mutex_unlock(slab->guard);
+	return TRUE;
+}
+
+MPF_DECLARE(apr_size_t) mpf_slab_used_count_get(mpf_slab_t *slab)
+{
+	apr_size_t used_count;
+	apr_thread_mutex_lock(slab->guard);
+	used_count = slab->used_count;
+	apr_thread_mutex_unlock(slab->guard);
+	return used_count;
+}
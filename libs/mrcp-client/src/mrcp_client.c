@@ -214,6 +214,9 @@ MRCP_DECLARE(mrcp_client_t*) mrcp_client_create(apt_dir_layout_t *dir_layout)
 	client->on_start_complete = NULL;
 	client->sync_start_object = NULL;
 	client->sync_start_mutex = NULL;
+
+	/* recycle pools of sessions and connections */
+	apt_pool_cache_create(APT_POOL_CACHE_MAX_COUNT,APT_POOL_CACHE_MAX_FREE_SIZE);
 	return client;
 }
 
@@ -304,6 +307,7 @@ MRCP_DECLARE(apt_bool_t) mrcp_client_destroy(mrcp_client_t *client)
 	apt_task_destroy(task);
 
 	apr_pool_destroy(client->pool);
+	apt_pool_cache_destroy();
 	return TRUE;
 }
 
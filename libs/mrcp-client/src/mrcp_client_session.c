@@ -431,6 +431,11 @@ static apt_bool_t mrcp_app_session_terminate_raise(mrcp_client_session_t *sessio
 			channel->control_channel = NULL;
 		}
 	}
+	if(session->context) {
+		/* the media engine has responded to all the requests, recycle the context */
+		mpf_engine_context_destroy(session->context);
+		session->context = NULL;
+	}
 
 	mrcp_client_session_remove(session->application->client,session);
 	/* raise app response */
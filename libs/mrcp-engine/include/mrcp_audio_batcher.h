@@ -0,0 +1,140 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifndef MRCP_AUDIO_BATCHER_H
+#define MRCP_AUDIO_BATCHER_H
+
+/**
+ * @file mrcp_audio_batcher.h
+ * @brief Batched Delivery of Audio Frames of Multiple Channels
+ */ 
+
+#include "mrcp_engine_types.h"
+#include "mpf_frame.h"
+
+APT_BEGIN_EXTERN_C
+
+/** Index returned when no slot is available */
+#define MRCP_AUDIO_BATCHER_INVALID_SLOT ((apr_size_t)-1)
+
+/** Opaque audio batcher declaration */
+typedef struct mrcp_audio_batcher_t mrcp_audio_batcher_t;
+/** Audio batch declaration */
+typedef struct mrcp_audio_batch_t mrcp_audio_batch_t;
+
+/** Batch of audio frames of multiple channels */
+struct mrcp_audio_batch_t {
+	/** Number of channels in the batch */
+	apr_size_t              count;
+	/** Slot indices of the channels [count] */
+	apr_size_t             *slots;
+	/** Engine channels [count] */
+	mrcp_engine_channel_t **channels;
+	/** Number of frames per channel */
+	apr_size_t              frame_count;
+	/** Size of frame in bytes */
+	apr_size_t              frame_size;
+	/** Size of audio per channel in bytes (frame_count * frame_size) */
+	apr_size_t              stride;
+	/** Contiguous audio of all the channels [count * stride] */
+	char                   *data;
+};
+
+/**
+ * Function to process a batch of audio with.
+ * @remark The function is invoked in the context of the batcher thread without holding
+ * any lock, adding and removing of channels doesn't wait for the function to return.
+ * A channel removed meanwhile may still be delivered in the batch being processed,
+ * the channel remains valid until the plugin responds to the close request.
+ */
+typedef apt_bool_t (*mrcp_audio_batch_process_f)(void *obj, const mrcp_audio_batch_t *batch);
+
+/**
+ * Create audio batcher.
+ * @param max_channel_count the max number of channels (slots)
+ * @param frame_size the size of frame in bytes (e.g. 320 for 10 msec of L16/16000)
+ * @param frame_count the number of frames per channel to collect per batch
+ * @param period the interval to check for complete frames in msec
+ * @param obj the external object to pass to the process function
+ * @param process the function to process batches with
+ * @param name the name of the batcher thread
+ * @param pool the pool to allocate memory from
+ */
+MRCP_DECLARE(mrcp_audio_batcher_t*) mrcp_audio_batcher_create(
+										apr_size_t max_channel_count,
+										apr_size_t frame_size,
+										apr_size_t frame_count,
+										apr_size_t period,
+										void *obj,
+										mrcp_audio_batch_process_f process,
+										const char *name,
+										apr_pool_t *pool);
+
+/** Destroy audio batcher */
+MRCP_DECLARE(apt_bool_t) mrcp_audio_batcher_destroy(mrcp_audio_batcher_t *batcher);
+
+/** Start audio batcher */
+MRCP_DECLARE(apt_bool_t) mrcp_audio_batcher_start(mrcp_audio_batcher_t *batcher);
+
+/** Terminate audio batcher */
+MRCP_DECLARE(apt_bool_t) mrcp_audio_batcher_terminate(mrcp_audio_batcher_t *batcher);
+
+/**
+ * Bind channel to a free slot.
+ * @param batcher the audio batcher
+ * @param channel the engine channel to bind
+ * @return the slot index or MRCP_AUDIO_BATCHER_INVALID_SLOT
+ * @remark Typically called on opening of the audio stream.
+ */
+MRCP_DECLARE(apr_size_t) mrcp_audio_batcher_channel_add(mrcp_audio_batcher_t *batcher, mrcp_engine_channel_t *channel);
+
+/**
+ * Release slot of the channel, discarding frames not delivered yet.
+ * @param batcher the audio batcher
+ * @param slot the slot index returned by mrcp_audio_batcher_channel_add()
+ * @remark Must not be called concurrently with mrcp_audio_batcher_frame_write() for the same slot,
+ * typically called on closing of the audio stream.
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_audio_batcher_channel_remove(mrcp_audio_batcher_t *batcher, apr_size_t slot);
+
+/**
+ * Write frame to the slot of the channel.
+ * @param batcher the audio batcher
+ * @param slot the slot index returned by mrcp_audio_batcher_channel_add()
+ * @param frame the frame to write
+ * @remark Called from the write_frame() method of the audio stream in the context of the media thread.
+ * The function does not block: the frame is copied into the single-producer/single-consumer ring
+ * of the slot, or dropped, if the ring is full.
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_audio_batcher_frame_write(mrcp_audio_batcher_t *batcher, apr_size_t slot, const mpf_frame_t *frame);
+
+/**
+ * Deliver complete frames of all the channels in one batch.
+ * @param batcher the audio batcher
+ * @return the number of channels delivered
+ * @remark Invoked periodically in the context of the batcher thread. May also be called
+ * directly, if the batcher is not started.
+ */
+MRCP_DECLARE(apr_size_t) mrcp_audio_batcher_flush(mrcp_audio_batcher_t *batcher);
+
+/** Get the number of frames dropped due to full rings */
+MRCP_DECLARE(apr_size_t) mrcp_audio_batcher_overrun_count_get(const mrcp_audio_batcher_t *batcher);
+
+APT_END_EXTERN_C
+
+#endif /* MRCP_AUDIO_BATCHER_H */
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifndef MRCP_CONTENT_CACHE_H
+#define MRCP_CONTENT_CACHE_H
+
+/**
+ * @file mrcp_content_cache.h
+ * @brief Server-wide Cache of Message Content (Grammars, Prompts)
+ */
+
+#include "mrcp_message.h"
+
+APT_BEGIN_EXTERN_C
+
+/** Opaque content cache declaration */
+typedef struct mrcp_content_cache_t mrcp_content_cache_t;
+/** Opaque content cache entry declaration */
+typedef struct mrcp_content_entry_t mrcp_content_entry_t;
+/** Content cache statistics declaration */
+typedef struct mrcp_content_cache_stats_t mrcp_content_cache_stats_t;
+
+/** Function to destroy an object associated with the content (e.g. compiled grammar, rendered prompt) */
+typedef void (*mrcp_content_object_destroy_f)(void *obj);
+
+/** Content cache statistics */
+struct mrcp_content_cache_stats_t {
+	/** Number of cached entries */
+	apr_size_t entry_count;
+	/** Total size of cached entries in bytes */
+	apr_size_t size;
+	/** Max size of cached entries in bytes */
+	apr_size_t max_size;
+	/** Number of lookups found in the cache */
+	apr_size_t hits;
+	/** Number of lookups not found in the cache */
+	apr_size_t misses;
+	/** Number of entries added to the cache */
+	apr_size_t insertions;
+	/** Number of entries evicted from the cache */
+	apr_size_t evictions;
+};
+
+/**
+ * Create content cache.
+ * @param max_size the max total size of cached entries in bytes
+ * @param pool the pool to allocate memory from
+ */
+MRCP_DECLARE(mrcp_content_cache_t*) mrcp_content_cache_create(apr_size_t max_size, apr_pool_t *pool);
+
+/**
+ * Destroy content cache.
+ * @param cache the cache to destroy
+ */
+MRCP_DECLARE(void) mrcp_content_cache_destroy(mrcp_content_cache_t *cache);
+
+/**
+ * Find cache entry by content.
+ * @param cache the cache to find entry in
+ * @param content_type the content type
+ * @param content_id the content identifier (optional)
+ * @param body the content body
+ * @return the referenced entry, if found, which must be released by mrcp_content_cache_release()
+ */
+MRCP_DECLARE(mrcp_content_entry_t*) mrcp_content_cache_find(
+										mrcp_content_cache_t *cache,
+										const apt_str_t *content_type,
+										const apt_str_t *content_id,
+										const apt_str_t *body);
+
+/**
+ * Add content to the cache.
+ * @param cache the cache to add content to
+ * @param content_type the content type
+ * @param content_id the content identifier (optional)
+ * @param body the content body to copy
+ * @param obj the object associated with the content (optional)
+ * @param obj_size the size of the object in bytes to account for
+ * @param destroy the function to destroy the object with, when the entry is released
+ * @return the referenced entry, which must be released by mrcp_content_cache_release(),
+ *         or NULL, if the content cannot be cached, in which case the object remains owned by the caller
+ * @remark An entry previously cached for the same content is replaced.
+ */
+MRCP_DECLARE(mrcp_content_entry_t*) mrcp_content_cache_add(
+										mrcp_content_cache_t *cache,
+										const apt_str_t *content_type,
+										const apt_str_t *content_id,
+										const apt_str_t *body,
+										void *obj,
+										apr_size_t obj_size,
+										mrcp_content_object_destroy_f destroy);
+
+/**
+ * Find cache entry by content of MRCP message (e.g. DEFINE-GRAMMAR, SPEAK).
+ * @param cache the cache to find entry in
+ * @param message the message to use the content type, identifier and body of
+ */
+MRCP_DECLARE(mrcp_content_entry_t*) mrcp_content_cache_message_find(
+										mrcp_content_cache_t *cache,
+										const mrcp_message_t *message);
+
+/**
+ * Add content of MRCP message to the cache.
+ * @param cache the cache to add content to
+ * @param message the message to use the content type, identifier and body of
+ * @param obj the object associated with the content (optional)
+ * @param obj_size the size of the object in bytes to account for
+ * @param destroy the function to destroy the object with, when the entry is released
+ */
+MRCP_DECLARE(mrcp_content_entry_t*) mrcp_content_cache_message_add(
+										mrcp_content_cache_t *cache,
+										const mrcp_message_t *message,
+										void *obj,
+										apr_size_t obj_size,
+										mrcp_content_object_destroy_f destroy);
+
+/**
+ * Release cache entry previously found or added.
+ * @param cache the cache the entry belongs to
+ * @param entry the entry to release
+ */
+MRCP_DECLARE(void) mrcp_content_cache_release(mrcp_content_cache_t *cache, mrcp_content_entry_t *entry);
+
+/**
+ * Get content cache statistics.
+ * @param cache the cache to get statistics of
+ * @param stats the statistics to fill
+ */
+MRCP_DECLARE(void) mrcp_content_cache_stats_get(mrcp_content_cache_t *cache, mrcp_content_cache_stats_t *stats);
+
+/** Get the object associated with the cache entry */
+MRCP_DECLARE(void*) mrcp_content_entry_object_get(const mrcp_content_entry_t *entry);
+
+/** Get the content body of the cache entry */
+MRCP_DECLARE(const apt_str_t*) mrcp_content_entry_body_get(const mrcp_content_entry_t *entry);
+
+APT_END_EXTERN_C
+
+#endif /* MRCP_CONTENT_CACHE_H */
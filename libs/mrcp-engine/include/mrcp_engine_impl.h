@@ -55,6 +55,12 @@ const mrcp_engine_config_t* mrcp_engine_config_get(const mrcp_engine_t *engine);
 /** Get engine param by name */
 const char* mrcp_engine_param_get(const mrcp_engine_t *engine, const char *name);
 
+/** Get server-wide content cache, if configured, to reuse compiled grammars or rendered prompts */
+static APR_INLINE mrcp_content_cache_t* mrcp_engine_content_cache_get(const mrcp_engine_t *engine)
+{
+	return engine->content_cache;
+}
+
 
 /** Create engine channel */
 mrcp_engine_channel_t* mrcp_engine_channel_create(
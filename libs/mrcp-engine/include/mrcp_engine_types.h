@@ -26,6 +26,7 @@
 
 #include <apr_tables.h>
 #include "mrcp_state_machine.h"
+#include "mrcp_content_cache.h"
 #include "mpf_types.h"
 #include "apt_string.h"
 
@@ -45,6 +46,8 @@ typedef struct mrcp_engine_channel_t mrcp_engine_channel_t;
 typedef struct mrcp_engine_channel_method_vtable_t mrcp_engine_channel_method_vtable_t;
 /** MRCP engine channel virtual event table declaration */
 typedef struct mrcp_engine_channel_event_vtable_t mrcp_engine_channel_event_vtable_t;
+/** Offloader of engine audio streams declaration */
+typedef struct mrcp_stream_offloader_t mrcp_stream_offloader_t;
 
 /** Table of channel virtual methods */
 struct mrcp_engine_channel_method_vtable_t {
@@ -130,10 +133,16 @@ struct mrcp_engine_t {
 	const mpf_codec_manager_t         *codec_manager;
 	/** Dir layout structure */
 	const apt_dir_layout_t            *dir_layout;
+	/** Server-wide content cache (optional) */
+	mrcp_content_cache_t              *content_cache;
+	/** Offloader of audio streams to worker threads (optional) */
+	mrcp_stream_offloader_t           *stream_offloader;
 	/** Config of engine */
 	mrcp_engine_config_t              *config;
 	/** Number of simultaneous channels currently in use */
 	apr_size_t                         cur_channel_count;
+	/** Number of requests dispatched to the engine and not responded yet */
+	apr_size_t                         pending_request_count;
 	/** Is engine successfully opened */
 	apt_bool_t                         is_open;
 	/** Pool to allocate memory from */
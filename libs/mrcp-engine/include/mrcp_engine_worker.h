@@ -0,0 +1,125 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifndef MRCP_ENGINE_WORKER_H
+#define MRCP_ENGINE_WORKER_H
+
+/**
+ * @file mrcp_engine_worker.h
+ * @brief Pool of Engine Worker Threads with Per-Channel Affinity
+ */ 
+
+#include "mrcp_engine_types.h"
+
+APT_BEGIN_EXTERN_C
+
+/** Default number of worker threads */
+#define MRCP_ENGINE_WORKER_DEFAULT_COUNT 1
+/** Name of the engine param to specify the number of worker threads with */
+#define MRCP_ENGINE_WORKER_COUNT_PARAM "worker-count"
+
+/** Opaque engine worker pool declaration */
+typedef struct mrcp_engine_worker_pool_t mrcp_engine_worker_pool_t;
+/** Engine worker message declaration */
+typedef struct mrcp_engine_worker_msg_t mrcp_engine_worker_msg_t;
+
+/** Engine worker message */
+struct mrcp_engine_worker_msg_t {
+	/** Message type defined by the plugin (e.g. open, close, request process) */
+	int                    type;
+	/** Engine channel the message is associated with */
+	mrcp_engine_channel_t *channel;
+	/** MRCP request (optional) */
+	mrcp_message_t        *request;
+};
+
+/**
+ * Function to process engine worker message with.
+ * @remark The function is invoked in the context of the worker thread the channel is bound to.
+ * Responses and events are sent back by mrcp_engine_channel_message_send() and similar routines,
+ * which are safe to call from any thread.
+ */
+typedef apt_bool_t (*mrcp_engine_worker_msg_process_f)(void *obj, const mrcp_engine_worker_msg_t *msg);
+
+/**
+ * Create pool of engine worker threads.
+ * @param worker_count the number of worker threads (MRCP_ENGINE_WORKER_DEFAULT_COUNT, if 0)
+ * @param obj the external object to pass to the process function
+ * @param process the function to process messages with
+ * @param name the name of the worker threads
+ * @param pool the pool to allocate memory from
+ */
+MRCP_DECLARE(mrcp_engine_worker_pool_t*) mrcp_engine_worker_pool_create(
+											apr_size_t worker_count,
+											void *obj,
+											mrcp_engine_worker_msg_process_f process,
+											const char *name,
+											apr_pool_t *pool);
+
+/**
+ * Create pool of engine worker threads taking the number of threads from the engine params.
+ * @param engine the engine to get the "worker-count" param of
+ * @param obj the external object to pass to the process function
+ * @param process the function to process messages with
+ * @param name the name of the worker threads
+ */
+MRCP_DECLARE(mrcp_engine_worker_pool_t*) mrcp_engine_worker_pool_create_ex(
+											mrcp_engine_t *engine,
+											void *obj,
+											mrcp_engine_worker_msg_process_f process,
+											const char *name);
+
+/**
+ * Destroy pool of engine worker threads.
+ * @param worker_pool the pool to destroy
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_engine_worker_pool_destroy(mrcp_engine_worker_pool_t *worker_pool);
+
+/**
+ * Start worker threads.
+ * @param worker_pool the pool to start
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_engine_worker_pool_start(mrcp_engine_worker_pool_t *worker_pool);
+
+/**
+ * Terminate worker threads, processing pending messages first.
+ * @param worker_pool the pool to terminate
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_engine_worker_pool_terminate(mrcp_engine_worker_pool_t *worker_pool);
+
+/**
+ * Signal message to the worker thread the channel is bound to.
+ * @param worker_pool the pool to signal message to
+ * @param type the plugin defined message type
+ * @param channel the engine channel to signal message for
+ * @param request the MRCP request (optional)
+ * @remark Messages signaled for the same channel are processed in order by the same thread,
+ * while messages of different channels are spread among all the worker threads.
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_engine_worker_pool_signal(
+							mrcp_engine_worker_pool_t *worker_pool,
+							int type,
+							mrcp_engine_channel_t *channel,
+							mrcp_message_t *request);
+
+/** Get the number of worker threads */
+MRCP_DECLARE(apr_size_t) mrcp_engine_worker_pool_count_get(const mrcp_engine_worker_pool_t *worker_pool);
+
+APT_END_EXTERN_C
+
+#endif /* MRCP_ENGINE_WORKER_H */
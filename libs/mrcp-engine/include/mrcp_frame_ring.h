@@ -0,0 +1,90 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#ifndef MRCP_FRAME_RING_H
+#define MRCP_FRAME_RING_H
+
+/**
+ * @file mrcp_frame_ring.h
+ * @brief Single-Producer/Single-Consumer Ring of Media Frames
+ */ 
+
+#include "mrcp_types.h"
+#include "mpf_frame.h"
+
+APT_BEGIN_EXTERN_C
+
+/** Frame ring declaration */
+typedef struct mrcp_frame_ring_t mrcp_frame_ring_t;
+
+/**
+ * Ring of frames exchanged between two threads without locking.
+ * @remark Only one thread may write and only one thread may read frames at a time.
+ */
+struct mrcp_frame_ring_t {
+	/** Array of frames, the buffers of which point into a contiguous block */
+	mpf_frame_t           *frames;
+	/** Capacity of the ring in frames (power of two) */
+	apr_uint32_t           capacity;
+	/** Size of the buffer of each frame */
+	apr_size_t             frame_size;
+	/** Number of frames written (by the producer) */
+	volatile apr_uint32_t  head;
+	/** Number of frames read (by the consumer) */
+	volatile apr_uint32_t  tail;
+};
+
+/**
+ * Create frame ring.
+ * @param capacity the min number of frames the ring can hold (rounded up to a power of two)
+ * @param frame_size the size of the buffer of each frame
+ * @param pool the pool to allocate memory from
+ */
+MRCP_DECLARE(mrcp_frame_ring_t*) mrcp_frame_ring_create(apr_size_t capacity, apr_size_t frame_size, apr_pool_t *pool);
+
+/**
+ * Discard frames of the ring.
+ * @remark Must be called while neither the producer, nor the consumer accesses the ring.
+ */
+MRCP_DECLARE(void) mrcp_frame_ring_reset(mrcp_frame_ring_t *ring);
+
+/**
+ * Get the entry to write the next frame to (producer).
+ * @return the entry, or NULL, if the ring is full
+ */
+MRCP_DECLARE(mpf_frame_t*) mrcp_frame_ring_write_begin(mrcp_frame_ring_t *ring);
+
+/** Publish the frame written to the entry to the consumer (producer) */
+MRCP_DECLARE(void) mrcp_frame_ring_write_end(mrcp_frame_ring_t *ring);
+
+/**
+ * Get the entry to read the next frame from (consumer).
+ * @return the entry, or NULL, if the ring is empty
+ */
+MRCP_DECLARE(const mpf_frame_t*) mrcp_frame_ring_read_begin(mrcp_frame_ring_t *ring);
+
+/** Release the entry read back to the producer (consumer) */
+MRCP_DECLARE(void) mrcp_frame_ring_read_end(mrcp_frame_ring_t *ring);
+
+/** Get the number of frames written, but not read yet */
+MRCP_DECLARE(apr_size_t) mrcp_frame_ring_count_get(const mrcp_frame_ring_t *ring);
+
+APT_END_EXTERN_C
+
+#endif /* MRCP_FRAME_RING_H */
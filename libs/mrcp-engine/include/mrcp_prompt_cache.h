@@ -0,0 +1,153 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifndef MRCP_PROMPT_CACHE_H
+#define MRCP_PROMPT_CACHE_H
+
+/**
+ * @file mrcp_prompt_cache.h
+ * @brief Memory-Mapped Cache of Synthesized Prompts
+ */ 
+
+#include "mrcp_message.h"
+#include "mpf_frame.h"
+#include "mpf_codec_descriptor.h"
+
+APT_BEGIN_EXTERN_C
+
+/** Opaque prompt cache declaration */
+typedef struct mrcp_prompt_cache_t mrcp_prompt_cache_t;
+/** Opaque prompt cache entry declaration */
+typedef struct mrcp_prompt_entry_t mrcp_prompt_entry_t;
+/** Opaque prompt writer declaration */
+typedef struct mrcp_prompt_writer_t mrcp_prompt_writer_t;
+/** Prompt key declaration */
+typedef struct mrcp_prompt_key_t mrcp_prompt_key_t;
+
+/** Key identifying a synthesized prompt */
+struct mrcp_prompt_key_t {
+	/** Content to synthesize (plain text or SSML) */
+	apt_str_t content;
+	/** Voice name */
+	apt_str_t voice;
+	/** Prosody rate */
+	apt_str_t rate;
+	/** Codec the prompt is rendered in (e.g. LPCM/8000) */
+	apt_str_t codec;
+};
+
+/**
+ * Create prompt cache.
+ * @param dir_path the directory to store rendered prompts in
+ * @param max_size the max total size of rendered prompts in bytes
+ * @param pool the pool to allocate memory from
+ * @remark Prompt files left in the directory by a previous run are removed.
+ */
+MRCP_DECLARE(mrcp_prompt_cache_t*) mrcp_prompt_cache_create(const char *dir_path, apr_size_t max_size, apr_pool_t *pool);
+
+/**
+ * Destroy prompt cache and remove the prompt files.
+ * @param cache the cache to destroy
+ * @remark The entries evicted while referenced are destroyed too, so none of the entries
+ * may be referenced past this call.
+ */
+MRCP_DECLARE(void) mrcp_prompt_cache_destroy(mrcp_prompt_cache_t *cache);
+
+/**
+ * Initialize prompt key based on SPEAK request.
+ * @param key the key to initialize
+ * @param request the SPEAK request to get the content, voice name and prosody rate of
+ * @param descriptor the codec descriptor of the source stream
+ * @param pool the pool to allocate memory from
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_prompt_key_init(
+							mrcp_prompt_key_t *key,
+							const mrcp_message_t *request,
+							const mpf_codec_descriptor_t *descriptor,
+							apr_pool_t *pool);
+
+/**
+ * Find rendered prompt.
+ * @param cache the cache to find prompt in
+ * @param key the prompt key
+ * @return the referenced entry, if found, which must be released by mrcp_prompt_cache_release()
+ */
+MRCP_DECLARE(mrcp_prompt_entry_t*) mrcp_prompt_cache_find(mrcp_prompt_cache_t *cache, const mrcp_prompt_key_t *key);
+
+/**
+ * Release prompt entry previously found or committed.
+ * @param cache the cache the entry belongs to
+ * @param entry the entry to release
+ * @remark The prompt file is unmapped and removed, if the entry has been evicted meanwhile,
+ * so the function must not be called in the context of the media thread.
+ */
+MRCP_DECLARE(void) mrcp_prompt_cache_release(mrcp_prompt_cache_t *cache, mrcp_prompt_entry_t *entry);
+
+/**
+ * Create writer to store a prompt being rendered.
+ * @param cache the cache to store prompt in
+ * @param key the prompt key
+ * @remark The function does no I/O, the prompt file is created on commit.
+ */
+MRCP_DECLARE(mrcp_prompt_writer_t*) mrcp_prompt_writer_create(mrcp_prompt_cache_t *cache, const mrcp_prompt_key_t *key);
+
+/**
+ * Write rendered audio.
+ * @param writer the writer to write audio to
+ * @param data the audio data
+ * @param size the size of data in bytes
+ * @return FALSE, if the prompt can't be cached (e.g. it's too large), subsequent writes are ignored
+ * and the commit fails then
+ * @remark The audio is buffered in memory and the function does no I/O, so it may be called
+ * from the stream read() method in the context of the media thread.
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_prompt_writer_write(mrcp_prompt_writer_t *writer, const void *data, apr_size_t size);
+
+/**
+ * Complete rendering and add the prompt to the cache.
+ * @param writer the writer to commit (the writer is destroyed)
+ * @return the referenced entry, which must be released by mrcp_prompt_cache_release(), or NULL
+ * @remark The buffered audio is written to the prompt file, which is then mapped, and the least
+ * recently used prompts may be evicted. As the function blocks on file I/O, it must not be called
+ * in the context of the media thread.
+ */
+MRCP_DECLARE(mrcp_prompt_entry_t*) mrcp_prompt_writer_commit(mrcp_prompt_writer_t *writer);
+
+/**
+ * Abort rendering (e.g. on STOP) and discard the written audio.
+ * @param writer the writer to abort (the writer is destroyed)
+ * @remark The function must not be called in the context of the media thread.
+ */
+MRCP_DECLARE(void) mrcp_prompt_writer_abort(mrcp_prompt_writer_t *writer);
+
+/**
+ * Read next frame of the prompt directly from the mapping.
+ * @param entry the prompt entry to read from
+ * @param offset the offset to read from, advanced on success
+ * @param frame the frame to read into
+ * @return FALSE, if there is no complete frame left
+ * @remark The function does no I/O and may be called from the stream read() method in the context of the media thread.
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_prompt_entry_frame_read(const mrcp_prompt_entry_t *entry, apr_size_t *offset, mpf_frame_t *frame);
+
+/** Get the size of the rendered prompt in bytes */
+MRCP_DECLARE(apr_size_t) mrcp_prompt_entry_size_get(const mrcp_prompt_entry_t *entry);
+
+APT_END_EXTERN_C
+
+#endif /* MRCP_PROMPT_CACHE_H */
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#ifndef MRCP_STREAM_OFFLOADER_H
+#define MRCP_STREAM_OFFLOADER_H
+
+/**
+ * @file mrcp_stream_offloader.h
+ * @brief Offload of Plugin Audio Stream Callbacks to Worker Threads
+ */ 
+
+#include "mrcp_engine_types.h"
+#include "mpf_stream.h"
+
+APT_BEGIN_EXTERN_C
+
+/** Name of the engine param to specify the number of offload threads with (offload is disabled, if 0 or not set) */
+#define MRCP_STREAM_OFFLOAD_THREADS_PARAM "stream-offload-threads"
+/** Name of the engine param to specify the number of frames read ahead from source streams (synthesizer) */
+#define MRCP_STREAM_LOOKAHEAD_PARAM       "stream-lookahead"
+/** Name of the engine param to specify the max number of frames queued to sink streams (recognizer, recorder) */
+#define MRCP_STREAM_DELAY_PARAM           "stream-delay"
+
+/** Default number of frames read ahead from source streams */
+#define MRCP_STREAM_DEFAULT_LOOKAHEAD     4
+/** Default max number of frames queued to sink streams */
+#define MRCP_STREAM_DEFAULT_DELAY         10
+
+/**
+ * Create stream offloader.
+ * @param thread_count the number of worker threads
+ * @param lookahead the number of frames read ahead from source streams
+ * @param delay the max number of frames queued to sink streams
+ * @param name the name of the worker threads
+ * @param pool the pool to allocate memory from
+ * @remark All the methods of offloaded streams of the plugin, including open and close, are invoked
+ * by the worker threads. The media thread only requests opening and closing by atomic state transitions
+ * and exchanges frames with single-producer/single-consumer rings, so it never blocks on a slow plugin.
+ * The ring capacities are rounded up to a power of two.
+ */
+MRCP_DECLARE(mrcp_stream_offloader_t*) mrcp_stream_offloader_create(
+											apr_size_t thread_count,
+											apr_size_t lookahead,
+											apr_size_t delay,
+											const char *name,
+											apr_pool_t *pool);
+
+/**
+ * Create stream offloader taking the settings from the engine params.
+ * @param engine the engine to get the params of
+ * @return the offloader, or NULL, if offload is not enabled for the engine
+ */
+MRCP_DECLARE(mrcp_stream_offloader_t*) mrcp_stream_offloader_create_ex(mrcp_engine_t *engine);
+
+/** Destroy stream offloader */
+MRCP_DECLARE(apt_bool_t) mrcp_stream_offloader_destroy(mrcp_stream_offloader_t *offloader);
+
+/** Start worker threads */
+MRCP_DECLARE(apt_bool_t) mrcp_stream_offloader_start(mrcp_stream_offloader_t *offloader);
+
+/** Terminate worker threads */
+MRCP_DECLARE(apt_bool_t) mrcp_stream_offloader_terminate(mrcp_stream_offloader_t *offloader);
+
+/**
+ * Create offloaded audio stream.
+ * @param offloader the stream offloader
+ * @param obj the object associated with the stream of the plugin
+ * @param vtable the virtual methods of the stream of the plugin
+ * @param capabilities the stream capabilities
+ * @param pool the pool to allocate memory from
+ * @return the stream to place into the media termination
+ * @remark The plugin methods are invoked with a stream of its own, the object of which is the specified one.
+ */
+MRCP_DECLARE(mpf_audio_stream_t*) mrcp_stream_offloader_audio_stream_create(
+										mrcp_stream_offloader_t *offloader,
+										void *obj,
+										const mpf_audio_stream_vtable_t *vtable,
+										const mpf_stream_capabilities_t *capabilities,
+										apr_pool_t *pool);
+
+/**
+ * Wait for the worker thread to close the stream of the plugin and release the stream.
+ * @param offloader the stream offloader
+ * @param stream the stream created by mrcp_stream_offloader_audio_stream_create() (other streams are ignored)
+ * @remark Must be called before the object associated with the stream of the plugin is destroyed,
+ * and not in the context of the media thread.
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_stream_offloader_audio_stream_release(mrcp_stream_offloader_t *offloader, mpf_audio_stream_t *stream);
+
+/** Get the number of frames read by the media thread before being read ahead from source streams */
+MRCP_DECLARE(apr_size_t) mrcp_stream_offloader_underrun_count_get(const mrcp_stream_offloader_t *offloader);
+
+/** Get the number of frames dropped due to sink streams lagging behind */
+MRCP_DECLARE(apr_size_t) mrcp_stream_offloader_overrun_count_get(const mrcp_stream_offloader_t *offloader);
+
+APT_END_EXTERN_C
+
+#endif /* MRCP_STREAM_OFFLOADER_H */
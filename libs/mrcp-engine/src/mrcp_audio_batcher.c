@@ -0,0 +1,319 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include <string.h>
+#include <apr_atomic.h>
+#include <apr_thread_mutex.h>
+#include "mrcp_audio_batcher.h"
+#include "apt_consumer_task.h"
+#include "apt_log.h"
+
+/** Number of batches each ring can hold */
+#define MRCP_AUDIO_BATCHER_RING_DEPTH 4
+
+/** Slot of a channel */
+typedef struct mrcp_audio_slot_t mrcp_audio_slot_t;
+
+struct mrcp_audio_slot_t {
+	/** Engine channel bound to the slot */
+	mrcp_engine_channel_t *channel;
+	/** Indicates whether the slot is in use */
+	volatile apr_uint32_t  active;
+	/** Number of frames written (by the media thread) */
+	volatile apr_uint32_t  head;
+	/** Number of frames read (by the batcher thread) */
+	volatile apr_uint32_t  tail;
+	/** Ring of frames */
+	char                  *ring;
+};
+
+/** Audio batcher */
+struct mrcp_audio_batcher_t {
+	/** Consumer task running the batcher */
+	apt_consumer_task_t       *task;
+	/** Timer to check for complete frames with */
+	apt_timer_t               *timer;
+	/** Interval to check for complete frames in msec */
+	apr_uint32_t               period;
+	/** Mutex to protect slots being added, removed and read (never held while processing) */
+	apr_thread_mutex_t        *guard;
+
+	/** Array of slots */
+	mrcp_audio_slot_t         *slots;
+	/** Number of slots */
+	apr_size_t                 slot_count;
+	/** Capacity of each ring in frames (power of two) */
+	apr_uint32_t               ring_capacity;
+	/** Number of dropped frames */
+	volatile apr_uint32_t      overrun_count;
+
+	/** Batch being composed */
+	mrcp_audio_batch_t         batch;
+
+	/** External object */
+	void                      *obj;
+	/** Function to process batches with */
+	mrcp_audio_batch_process_f process;
+};
+
+static void mrcp_audio_batcher_timer_proc(apt_timer_t *timer, void *obj);
+
+/** Create audio batcher */
+MRCP_DECLARE(mrcp_audio_batcher_t*) mrcp_audio_batcher_create(
+										apr_size_t max_channel_count,
+										apr_size_t frame_size,
+										apr_size_t frame_count,
+										apr_size_t period,
+										void *obj,
+										mrcp_audio_batch_process_f process,
+										const char *name,
+										apr_pool_t *pool)
+{
+	apr_size_t i;
+	mrcp_audio_batcher_t *batcher;
+	mrcp_audio_batch_t *batch;
+
+	if(!max_channel_count || !frame_size || !frame_count || !process) {
+		return NULL;
+	}
+
+	batcher = apr_palloc(pool,sizeof(mrcp_audio_batcher_t));
+	batcher->period = period ? (apr_uint32_t)period : 10;
+	batcher->slot_count = max_channel_count;
+	/* the counters wrap around at 2^32, which a power of two capacity divides evenly */
+	batcher->ring_capacity = 1;
+	while(batcher->ring_capacity < frame_count * MRCP_AUDIO_BATCHER_RING_DEPTH) {
+		batcher->ring_capacity <<= 1;
+	}
+	batcher->overrun_count = 0;
+	batcher->obj = obj;
+	batcher->process = process;
+	batcher->guard = NULL;
+	batcher->timer = NULL;
+
+	batcher->slots = apr_palloc(pool,sizeof(mrcp_audio_slot_t) * max_channel_count);
+	for(i=0; i<max_channel_count; i++) {
+		mrcp_audio_slot_t *slot = &batcher->slots[i];
+		slot->channel = NULL;
+		slot->active = 0;
+		slot->head = 0;
+		slot->tail = 0;
+		slot->ring = apr_palloc(pool,batcher->ring_capacity * frame_size);
+	}
+
+	batch = &batcher->batch;
+	batch->count = 0;
+	batch->slots = apr_palloc(pool,sizeof(apr_size_t) * max_channel_count);
+	batch->channels = apr_palloc(pool,sizeof(mrcp_engine_channel_t*) * max_channel_count);
+	batch->frame_count = frame_count;
+	batch->frame_size = frame_size;
+	batch->stride = frame_count * frame_size;
+	batch->data = apr_palloc(pool,batch->stride * max_channel_count);
+
+	if(apr_thread_mutex_create(&batcher->guard,APR_THREAD_MUTEX_DEFAULT,pool) != APR_SUCCESS) {
+		return NULL;
+	}
+
+	batcher->task = apt_consumer_task_create(batcher,NULL,pool);
+	if(!batcher->task) {
+		apr_thread_mutex_destroy(batcher->guard);
+		return NULL;
+	}
+	if(name) {
+		apt_task_name_set(apt_consumer_task_base_get(batcher->task),name);
+	}
+	batcher->timer = apt_consumer_task_timer_create(batcher->task,mrcp_audio_batcher_timer_proc,batcher,pool);
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Create Audio Batcher %s [%"APR_SIZE_T_FMT" channels x %"APR_SIZE_T_FMT" frames]",
+		name ? name : "",
+		max_channel_count,
+		frame_count);
+	return batcher;
+}
+
+/** Destroy audio batcher */
+MRCP_DECLARE(apt_bool_t) mrcp_audio_batcher_destroy(mrcp_audio_batcher_t *batcher)
+{
+	if(batcher->task) {
+		apt_task_t *task = apt_consumer_task_base_get(batcher->task);
+		apt_task_destroy(task);
+		batcher->task = NULL;
+	}
+	if(batcher->guard) {
+		apr_thread_mutex_destroy(batcher->guard);
+		batcher->guard = NULL;
+	}
+	return TRUE;
+}
+
+/** Start audio batcher */
+MRCP_DECLARE(apt_bool_t) mrcp_audio_batcher_start(mrcp_audio_batcher_t *batcher)
+{
+	/* the timer queue is not running yet, it's safe to set the timer from this thread */
+	apt_timer_set(batcher->timer,batcher->period);
+	return apt_task_start(apt_consumer_task_base_get(batcher->task));
+}
+
+/** Terminate audio batcher */
+MRCP_DECLARE(apt_bool_t) mrcp_audio_batcher_terminate(mrcp_audio_batcher_t *batcher)
+{
+	return apt_task_terminate(apt_consumer_task_base_get(batcher->task),TRUE);
+}
+
+/** Bind channel to a free slot */
+MRCP_DECLARE(apr_size_t) mrcp_audio_batcher_channel_add(mrcp_audio_batcher_t *batcher, mrcp_engine_channel_t *channel)
+{
+	apr_size_t i;
+	apr_size_t index = MRCP_AUDIO_BATCHER_INVALID_SLOT;
+	apr_thread_mutex_lock(batcher->guard);
+	for(i=0; i<batcher->slot_count; i++) {
+		mrcp_audio_slot_t *slot = &batcher->slots[i];
+		if(!apr_atomic_read32(&slot->active)) {
+			slot->channel = channel;
+			slot->head = 0;
+			slot->tail = 0;
+			apr_atomic_set32(&slot->active,1);
+			index = i;
+			break;
+		}
+	}
+	apr_thread_mutex_unlock(batcher->guard);
+
+	if(index == MRCP_AUDIO_BATCHER_INVALID_SLOT) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"No Free Audio Batcher Slot [%s]",
+			channel->engine ? channel->engine->id : "");
+	}
+	return index;
+}
+
+/** Release slot of the channel */
+MRCP_DECLARE(apt_bool_t) mrcp_audio_batcher_channel_remove(mrcp_audio_batcher_t *batcher, apr_size_t index)
+{
+	mrcp_audio_slot_t *slot;
+	if(index >= batcher->slot_count) {
+		return FALSE;
+	}
+
+	slot = &batcher->slots[index];
+	apr_thread_mutex_lock(batcher->guard);
+	apr_atomic_set32(&slot->active,0);
+	slot->channel = NULL;
+	apr_thread_mutex_unlock(batcher->guard);
+	return TRUE;
+}
+
+/** Write frame to the slot of the channel */
+MRCP_DECLARE(apt_bool_t) mrcp_audio_batcher_frame_write(mrcp_audio_batcher_t *batcher, apr_size_t index, const mpf_frame_t *frame)
+{
+	mrcp_audio_slot_t *slot;
+	apr_uint32_t head;
+	apr_size_t frame_size;
+	char *dest;
+
+	if(index >= batcher->slot_count) {
+		return FALSE;
+	}
+	slot = &batcher->slots[index];
+	if(!apr_atomic_read32(&slot->active)) {
+		return FALSE;
+	}
+
+	head = slot->head;
+	if(head - apr_atomic_read32(&slot->tail) >= batcher->ring_capacity) {
+		apr_atomic_inc32(&batcher->overrun_count);
+		return FALSE;
+	}
+
+	frame_size = batcher->batch.frame_size;
+	dest = slot->ring + (head & (batcher->ring_capacity - 1)) * frame_size;
+	if((frame->type & MEDIA_FRAME_TYPE_AUDIO) == MEDIA_FRAME_TYPE_AUDIO) {
+		apr_size_t size = frame->codec_frame.size;
+		if(size > frame_size) {
+			size = frame_size;
+		}
+		memcpy(dest,frame->codec_frame.buffer,size);
+		if(size < frame_size) {
+			memset(dest + size,0,frame_size - size);
+		}
+	}
+	else {
+		/* keep the timing by delivering silence in place of missing audio */
+		memset(dest,0,frame_size);
+	}
+
+	/* publish the frame to the batcher thread */
+	apr_atomic_set32(&slot->head,head + 1);
+	return TRUE;
+}
+
+/** Get the number of frames dropped due to full rings */
+MRCP_DECLARE(apr_size_t) mrcp_audio_batcher_overrun_count_get(const mrcp_audio_batcher_t *batcher)
+{
+	return apr_atomic_read32((volatile apr_uint32_t*)&batcher->overrun_count);
+}
+
+/** Deliver complete frames of all the channels in one batch */
+MRCP_DECLARE(apr_size_t) mrcp_audio_batcher_flush(mrcp_audio_batcher_t *batcher)
+{
+	mrcp_audio_batch_t *batch = &batcher->batch;
+	apr_size_t i;
+
+	/* compose the batch under the lock, then release it before processing,
+	   so the media thread adding or removing channels never waits for the plugin */
+	apr_thread_mutex_lock(batcher->guard);
+	batch->count = 0;
+	for(i=0; i<batcher->slot_count; i++) {
+		mrcp_audio_slot_t *slot = &batcher->slots[i];
+		apr_uint32_t tail;
+		apr_size_t k;
+		char *dest;
+		if(!apr_atomic_read32(&slot->active)) {
+			continue;
+		}
+
+		tail = slot->tail;
+		if(apr_atomic_read32(&slot->head) - tail < batch->frame_count) {
+			continue;
+		}
+
+		/* copy frames into the contiguous batch, the ring may wrap around */
+		dest = batch->data + batch->count * batch->stride;
+		for(k=0; k<batch->frame_count; k++) {
+			memcpy(dest,slot->ring + ((tail + k) & (batcher->ring_capacity - 1)) * batch->frame_size,batch->frame_size);
+			dest += batch->frame_size;
+		}
+		apr_atomic_set32(&slot->tail,tail + (apr_uint32_t)batch->frame_count);
+
+		batch->slots[batch->count] = i;
+		batch->channels[batch->count] = slot->channel;
+		batch->count++;
+	}
+	apr_thread_mutex_unlock(batcher->guard);
+
+	if(batch->count) {
+		batcher->process(batcher->obj,batch);
+	}
+	return batch->count;
+}
+
+static void mrcp_audio_batcher_timer_proc(apt_timer_t *timer, void *obj)
+{
+	mrcp_audio_batcher_t *batcher = obj;
+	mrcp_audio_batcher_flush(batcher);
+	apt_timer_set(timer,batcher->period);
+}
@@ -0,0 +1,382 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifdef WIN32
+#pragma warning(disable: 4127)
+#endif
+#include <apr_ring.h>
+#include <apr_hash.h>
+#include <apr_thread_mutex.h>
+#include "mrcp_content_cache.h"
+#include "mrcp_generic_header.h"
+#include "apt_pool.h"
+#include "apt_log.h"
+
+/** Content cache entry */
+struct mrcp_content_entry_t {
+	/** Ring entry (LRU list) */
+	APR_RING_ENTRY(mrcp_content_entry_t) link;
+
+	/** Digest of the content used as a key */
+	apr_uint32_t                  digest;
+	/** Content type */
+	apt_str_t                     content_type;
+	/** Content identifier */
+	apt_str_t                     content_id;
+	/** Content body */
+	apt_str_t                     body;
+
+	/** Object associated with the content */
+	void                         *obj;
+	/** Function to destroy the object with */
+	mrcp_content_object_destroy_f destroy;
+	/** Size of the entry accounted for */
+	apr_size_t                    size;
+
+	/** Reference count */
+	apr_size_t                    ref_count;
+	/** Whether the entry is still held in the cache */
+	apt_bool_t                    cached;
+	/** Entry specific pool */
+	apr_pool_t                   *pool;
+};
+
+/** Content cache */
+struct mrcp_content_cache_t {
+	/** Table of entries (mrcp_content_entry_t*) */
+	apr_hash_t          *table;
+	/** List of entries ordered from the most to the least recently used */
+	APR_RING_HEAD(mrcp_content_entry_head_t, mrcp_content_entry_t) lru_list;
+	/** Guard of the table and the list */
+	apr_thread_mutex_t  *guard;
+	/** Statistics */
+	mrcp_content_cache_stats_t stats;
+	/** Own pool entry specific pools are created from */
+	apr_pool_t          *pool;
+};
+
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME        16777619U
+
+/** Calculate FNV-1a digest of the data */
+static APR_INLINE apr_uint32_t mrcp_content_digest_update(apr_uint32_t digest, const char *data, apr_size_t length)
+{
+	const unsigned char *pos = (const unsigned char*)data;
+	const unsigned char *end = pos + length;
+	for(; pos < end; pos++) {
+		digest ^= *pos;
+		digest *= FNV_PRIME;
+	}
+	return digest;
+}
+
+static apr_uint32_t mrcp_content_digest_calculate(const apt_str_t *content_type, const apt_str_t *content_id, const apt_str_t *body)
+{
+	apr_uint32_t digest = FNV_OFFSET_BASIS;
+	digest = mrcp_content_digest_update(digest,content_type->buf,content_type->length);
+	/* separate the fields so that their boundaries contribute to the digest */
+	digest = mrcp_content_digest_update(digest,"",1);
+	if(content_id) {
+		digest = mrcp_content_digest_update(digest,content_id->buf,content_id->length);
+	}
+	digest = mrcp_content_digest_update(digest,"",1);
+	return mrcp_content_digest_update(digest,body->buf,body->length);
+}
+
+static APR_INLINE apt_bool_t mrcp_content_string_compare(const apt_str_t *str1, const apt_str_t *str2)
+{
+	apr_size_t length1 = str1 ? str1->length : 0;
+	apr_size_t length2 = str2 ? str2->length : 0;
+	if(length1 != length2) {
+		return FALSE;
+	}
+	if(!length1) {
+		return TRUE;
+	}
+	return (memcmp(str1->buf,str2->buf,length1) == 0) ? TRUE : FALSE;
+}
+
+static apt_bool_t mrcp_content_entry_match(
+						const mrcp_content_entry_t *entry,
+						const apt_str_t *content_type,
+						const apt_str_t *content_id,
+						const apt_str_t *body)
+{
+	return (mrcp_content_string_compare(&entry->body,body) == TRUE &&
+			mrcp_content_string_compare(&entry->content_type,content_type) == TRUE &&
+			mrcp_content_string_compare(&entry->content_id,content_id) == TRUE) ? TRUE : FALSE;
+}
+
+static void mrcp_content_entry_destroy(mrcp_content_entry_t *entry)
+{
+	if(entry->obj && entry->destroy) {
+		entry->destroy(entry->obj);
+	}
+	apr_pool_destroy(entry->pool);
+}
+
+/** Remove the entry from the cache and destroy it, unless it's still referenced */
+static void mrcp_content_entry_remove(mrcp_content_cache_t *cache, mrcp_content_entry_t *entry)
+{
+	if(apr_hash_get(cache->table,&entry->digest,sizeof(entry->digest)) == entry) {
+		apr_hash_set(cache->table,&entry->digest,sizeof(entry->digest),NULL);
+	}
+	APR_RING_REMOVE(entry,link);
+	entry->cached = FALSE;
+	cache->stats.entry_count--;
+	cache->stats.size -= entry->size;
+
+	if(!entry->ref_count) {
+		mrcp_content_entry_destroy(entry);
+	}
+}
+
+/** Create content cache */
+MRCP_DECLARE(mrcp_content_cache_t*) mrcp_content_cache_create(apr_size_t max_size, apr_pool_t *pool)
+{
+	mrcp_content_cache_t *cache;
+	apr_pool_t *own_pool = apt_pool_create();
+	if(!own_pool) {
+		return NULL;
+	}
+
+	cache = apr_palloc(pool,sizeof(mrcp_content_cache_t));
+	cache->pool = own_pool;
+	cache->table = apr_hash_make(own_pool);
+	APR_RING_INIT(&cache->lru_list, mrcp_content_entry_t, link);
+	cache->guard = NULL;
+	if(apr_thread_mutex_create(&cache->guard,APR_THREAD_MUTEX_DEFAULT,own_pool) != APR_SUCCESS) {
+		apr_pool_destroy(own_pool);
+		return NULL;
+	}
+
+	cache->stats.entry_count = 0;
+	cache->stats.size = 0;
+	cache->stats.max_size = max_size;
+	cache->stats.hits = 0;
+	cache->stats.misses = 0;
+	cache->stats.insertions = 0;
+	cache->stats.evictions = 0;
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Create Content Cache [%"APR_SIZE_T_FMT" bytes]",max_size);
+	return cache;
+}
+
+/** Destroy content cache */
+MRCP_DECLARE(void) mrcp_content_cache_destroy(mrcp_content_cache_t *cache)
+{
+	mrcp_content_entry_t *entry;
+	if(!cache) {
+		return;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Destroy Content Cache [%"APR_SIZE_T_FMT" hits %"APR_SIZE_T_FMT" misses %"APR_SIZE_T_FMT" evictions]",
+		cache->stats.hits,
+		cache->stats.misses,
+		cache->stats.evictions);
+	while(!APR_RING_EMPTY(&cache->lru_list, mrcp_content_entry_t, link)) {
+		entry = APR_RING_FIRST(&cache->lru_list);
+		APR_RING_REMOVE(entry,link);
+		if(entry->obj && entry->destroy) {
+			entry->destroy(entry->obj);
+		}
+	}
+	apr_thread_mutex_destroy(cache->guard);
+	apr_pool_destroy(cache->pool);
+}
+
+/** Find cache entry by content */
+MRCP_DECLARE(mrcp_content_entry_t*) mrcp_content_cache_find(
+										mrcp_content_cache_t *cache,
+										const apt_str_t *content_type,
+										const apt_str_t *content_id,
+										const apt_str_t *body)
+{
+	mrcp_content_entry_t *entry;
+	apr_uint32_t digest;
+	if(!cache || !content_type || !body || !body->length) {
+		return NULL;
+	}
+
+	digest = mrcp_content_digest_calculate(content_type,content_id,body);
+
+	apr_thread_mutex_lock(cache->guard);
+	entry = apr_hash_get(cache->table,&digest,sizeof(digest));
+	if(entry && mrcp_content_entry_match(entry,content_type,content_id,body) == TRUE) {
+		/* move the entry to the head of the LRU list */
+		APR_RING_REMOVE(entry,link);
+		APR_RING_INSERT_HEAD(&cache->lru_list,entry,mrcp_content_entry_t,link);
+		entry->ref_count++;
+		cache->stats.hits++;
+	}
+	else {
+		entry = NULL;
+		cache->stats.misses++;
+	}
+	apr_thread_mutex_unlock(cache->guard);
+	return entry;
+}
+
+/** Add content to the cache */
+MRCP_DECLARE(mrcp_content_entry_t*) mrcp_content_cache_add(
+										mrcp_content_cache_t *cache,
+										const apt_str_t *content_type,
+										const apt_str_t *content_id,
+										const apt_str_t *body,
+										void *obj,
+										apr_size_t obj_size,
+										mrcp_content_object_destroy_f destroy)
+{
+	mrcp_content_entry_t *entry;
+	mrcp_content_entry_t *existing_entry;
+	apr_pool_t *pool;
+	apr_size_t size;
+	if(!cache || !content_type || !body || !body->length) {
+		return NULL;
+	}
+
+	size = sizeof(mrcp_content_entry_t) + content_type->length + body->length + obj_size;
+	if(content_id) {
+		size += content_id->length;
+	}
+	if(size > cache->stats.max_size) {
+		/* the content is too large to be cached */
+		return NULL;
+	}
+
+	apr_thread_mutex_lock(cache->guard);
+	pool = apt_subpool_create(cache->pool);
+	if(!pool) {
+		apr_thread_mutex_unlock(cache->guard);
+		return NULL;
+	}
+
+	entry = apr_palloc(pool,sizeof(mrcp_content_entry_t));
+	entry->pool = pool;
+	entry->digest = mrcp_content_digest_calculate(content_type,content_id,body);
+	apt_string_copy(&entry->content_type,content_type,pool);
+	if(content_id) {
+		apt_string_copy(&entry->content_id,content_id,pool);
+	}
+	else {
+		apt_string_reset(&entry->content_id);
+	}
+	apt_string_copy(&entry->body,body,pool);
+	entry->obj = obj;
+	entry->destroy = destroy;
+	entry->size = size;
+	entry->ref_count = 1;
+	entry->cached = TRUE;
+
+	/* replace the entry previously cached with the same digest, if any */
+	existing_entry = apr_hash_get(cache->table,&entry->digest,sizeof(entry->digest));
+	if(existing_entry) {
+		mrcp_content_entry_remove(cache,existing_entry);
+	}
+
+	/* evict the least recently used entries to make room for the new one */
+	while(cache->stats.size + size > cache->stats.max_size &&
+		!APR_RING_EMPTY(&cache->lru_list, mrcp_content_entry_t, link)) {
+		mrcp_content_entry_remove(cache,APR_RING_LAST(&cache->lru_list));
+		cache->stats.evictions++;
+	}
+
+	APR_RING_INSERT_HEAD(&cache->lru_list,entry,mrcp_content_entry_t,link);
+	apr_hash_set(cache->table,&entry->digest,sizeof(entry->digest),entry);
+	cache->stats.entry_count++;
+	cache->stats.size += size;
+	cache->stats.insertions++;
+	apr_thread_mutex_unlock(cache->guard);
+	return entry;
+}
+
+static APR_INLINE void mrcp_content_message_fields_get(const mrcp_message_t *message, const apt_str_t **content_type, const apt_str_t **content_id)
+{
+	mrcp_generic_header_t *generic_header = mrcp_generic_header_get(message);
+	*content_type = NULL;
+	*content_id = NULL;
+	if(!generic_header) {
+		return;
+	}
+	if(mrcp_generic_header_property_check(message,GENERIC_HEADER_CONTENT_TYPE) == TRUE) {
+		*content_type = &generic_header->content_type;
+	}
+	if(mrcp_generic_header_property_check(message,GENERIC_HEADER_CONTENT_ID) == TRUE) {
+		*content_id = &generic_header->content_id;
+	}
+}
+
+/** Find cache entry by content of MRCP message */
+MRCP_DECLARE(mrcp_content_entry_t*) mrcp_content_cache_message_find(mrcp_content_cache_t *cache, const mrcp_message_t *message)
+{
+	const apt_str_t *content_type;
+	const apt_str_t *content_id;
+	mrcp_content_message_fields_get(message,&content_type,&content_id);
+	return mrcp_content_cache_find(cache,content_type,content_id,&message->body);
+}
+
+/** Add content of MRCP message to the cache */
+MRCP_DECLARE(mrcp_content_entry_t*) mrcp_content_cache_message_add(
+										mrcp_content_cache_t *cache,
+										const mrcp_message_t *message,
+										void *obj,
+										apr_size_t obj_size,
+										mrcp_content_object_destroy_f destroy)
+{
+	const apt_str_t *content_type;
+	const apt_str_t *content_id;
+	mrcp_content_message_fields_get(message,&content_type,&content_id);
+	return mrcp_content_cache_add(cache,content_type,content_id,&message->body,obj,obj_size,destroy);
+}
+
+/** Release cache entry */
+MRCP_DECLARE(void) mrcp_content_cache_release(mrcp_content_cache_t *cache, mrcp_content_entry_t *entry)
+{
+	if(!cache || !entry) {
+		return;
+	}
+
+	apr_thread_mutex_lock(cache->guard);
+	if(entry->ref_count) {
+		entry->ref_count--;
+	}
+	if(!entry->ref_count && entry->cached == FALSE) {
+		/* the entry has been evicted or replaced meanwhile */
+		mrcp_content_entry_destroy(entry);
+	}
+	apr_thread_mutex_unlock(cache->guard);
+}
+
+/** Get content cache statistics */
+MRCP_DECLARE(void) mrcp_content_cache_stats_get(mrcp_content_cache_t *cache, mrcp_content_cache_stats_t *stats)
+{
+	apr_thread_mutex_lock(cache->guard);
+	*stats = cache->stats;
+	apr_thread_mutex_unlock(cache->guard);
+}
+
+/** Get the object associated with the cache entry */
+MRCP_DECLARE(void*) mrcp_content_entry_object_get(const mrcp_content_entry_t *entry)
+{
+	return entry->obj;
+}
+
+/** Get the content body of the cache entry */
+MRCP_DECLARE(const apt_str_t*) mrcp_content_entry_body_get(const mrcp_content_entry_t *entry)
+{
+	return &entry->body;
+}
@@ -17,11 +17,18 @@
  */
 
 #include "mrcp_engine_iface.h"
+#include "mrcp_stream_offloader.h"
+#include "mpf_termination_factory.h"
 #include "apt_log.h"
 
 /** Destroy engine */
 apt_bool_t mrcp_engine_virtual_destroy(mrcp_engine_t *engine)
 {
+	if(engine->stream_offloader) {
+		mrcp_stream_offloader_terminate(engine->stream_offloader);
+		mrcp_stream_offloader_destroy(engine->stream_offloader);
+		engine->stream_offloader = NULL;
+	}
 	return engine->method_vtable->destroy(engine);
 }
 
@@ -30,6 +37,12 @@ apt_bool_t mrcp_engine_virtual_open(mrcp_engine_t *engine)
 {
 	if(engine->is_open == FALSE) {
 		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Open Engine [%s]",engine->id);
+		if(!engine->stream_offloader) {
+			engine->stream_offloader = mrcp_stream_offloader_create_ex(engine);
+			if(engine->stream_offloader) {
+				mrcp_stream_offloader_start(engine->stream_offloader);
+			}
+		}
 		return engine->method_vtable->open(engine);
 	}
 	return FALSE;
@@ -89,6 +102,12 @@ apt_bool_t mrcp_engine_channel_virtual_destroy(mrcp_engine_channel_t *channel)
 	if(engine->cur_channel_count) {
 		engine->cur_channel_count--;
 	}
+	if(engine->stream_offloader && channel->termination) {
+		/* the plugin stream may still be being closed by the offload worker */
+		mrcp_stream_offloader_audio_stream_release(
+			engine->stream_offloader,
+			mpf_termination_audio_stream_get(channel->termination));
+	}
 	return channel->method_vtable->destroy(channel);
 }
 
@@ -17,6 +17,7 @@
  */
 
 #include "mrcp_engine_impl.h"
+#include "mrcp_stream_offloader.h"
 #include "mpf_termination_factory.h"
 
 /** Create engine */
@@ -36,7 +37,10 @@ mrcp_engine_t* mrcp_engine_create(
 	engine->config = NULL;
 	engine->codec_manager = NULL;
 	engine->dir_layout = NULL;
+	engine->content_cache = NULL;
+	engine->stream_offloader = NULL;
 	engine->cur_channel_count = 0;
+	engine->pending_request_count = 0;
 	engine->is_open = FALSE;
 	engine->pool = pool;
 	engine->create_state_machine = NULL;
@@ -115,6 +119,29 @@ mpf_termination_t* mrcp_engine_audio_termination_create(
 }
 
 
+/** Create audio stream of the engine channel, offloaded to worker threads, if configured */
+static mpf_audio_stream_t* mrcp_engine_audio_stream_create(
+								mrcp_engine_t *engine,
+								void *method_obj,
+								const mpf_audio_stream_vtable_t *stream_vtable,
+								const mpf_stream_capabilities_t *capabilities,
+								apr_pool_t *pool)
+{
+	if(engine->stream_offloader) {
+		return mrcp_stream_offloader_audio_stream_create(
+				engine->stream_offloader, /* offloader */
+				method_obj,               /* object to associate */
+				stream_vtable,            /* virtual methods table of audio stream */
+				capabilities,             /* stream capabilities */
+				pool);                    /* pool to allocate memory from */
+	}
+	return mpf_audio_stream_create(
+			method_obj,           /* object to associate */
+			stream_vtable,        /* virtual methods table of audio stream */
+			capabilities,         /* stream capabilities */
+			pool);                /* pool to allocate memory from */
+}
+
 /** Create engine channel and source media termination */
 mrcp_engine_channel_t* mrcp_engine_source_channel_create(
 							mrcp_engine_t *engine,
@@ -140,11 +167,7 @@ mrcp_engine_channel_t* mrcp_engine_source_channel_create(
 	}
 
 	/* create audio stream */
-	audio_stream = mpf_audio_stream_create(
-			method_obj,           /* object to associate */
-			stream_vtable,        /* virtual methods table of audio stream */
-			capabilities,         /* stream capabilities */
-			pool);                /* pool to allocate memory from */
+	audio_stream = mrcp_engine_audio_stream_create(engine,method_obj,stream_vtable,capabilities,pool);
 
 	if(!audio_stream) {
 		return NULL;
@@ -193,11 +216,7 @@ mrcp_engine_channel_t* mrcp_engine_sink_channel_create(
 	}
 
 	/* create audio stream */
-	audio_stream = mpf_audio_stream_create(
-			method_obj,             /* object to associate */
-			stream_vtable,          /* virtual methods table of audio stream */
-			capabilities,           /* stream capabilities */
-			pool);                  /* pool to allocate memory from */
+	audio_stream = mrcp_engine_audio_stream_create(engine,method_obj,stream_vtable,capabilities,pool);
 
 	if(!audio_stream) {
 		return NULL;
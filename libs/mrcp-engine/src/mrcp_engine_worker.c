@@ -0,0 +1,234 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include "mrcp_engine_worker.h"
+#include "mrcp_engine_impl.h"
+#include "apt_consumer_task.h"
+#include "apt_log.h"
+
+/** Engine worker thread */
+typedef struct mrcp_engine_worker_t mrcp_engine_worker_t;
+
+struct mrcp_engine_worker_t {
+	/** Consumer task */
+	apt_consumer_task_t       *task;
+	/** Back pointer to the pool */
+	mrcp_engine_worker_pool_t *worker_pool;
+};
+
+/** Pool of engine worker threads */
+struct mrcp_engine_worker_pool_t {
+	/** Array of workers */
+	mrcp_engine_worker_t            *workers;
+	/** Number of workers */
+	apr_size_t                       worker_count;
+	/** External object */
+	void                            *obj;
+	/** Function to process messages with */
+	mrcp_engine_worker_msg_process_f process;
+};
+
+static apt_bool_t mrcp_engine_worker_msg_process(apt_task_t *task, apt_task_msg_t *msg)
+{
+	apt_consumer_task_t *consumer_task = apt_task_object_get(task);
+	mrcp_engine_worker_t *worker = apt_consumer_task_object_get(consumer_task);
+	mrcp_engine_worker_pool_t *worker_pool = worker->worker_pool;
+	const mrcp_engine_worker_msg_t *worker_msg = (const mrcp_engine_worker_msg_t*)msg->data;
+	return worker_pool->process(worker_pool->obj,worker_msg);
+}
+
+/** Create pool of engine worker threads */
+MRCP_DECLARE(mrcp_engine_worker_pool_t*) mrcp_engine_worker_pool_create(
+											apr_size_t worker_count,
+											void *obj,
+											mrcp_engine_worker_msg_process_f process,
+											const char *name,
+											apr_pool_t *pool)
+{
+	apr_size_t i;
+	mrcp_engine_worker_pool_t *worker_pool;
+	apt_task_msg_pool_t *msg_pool;
+
+	if(!process) {
+		return NULL;
+	}
+	if(!worker_count) {
+		worker_count = MRCP_ENGINE_WORKER_DEFAULT_COUNT;
+	}
+
+	worker_pool = apr_palloc(pool,sizeof(mrcp_engine_worker_pool_t));
+	worker_pool->workers = apr_pcalloc(pool,sizeof(mrcp_engine_worker_t) * worker_count);
+	worker_pool->worker_count = worker_count;
+	worker_pool->obj = obj;
+	worker_pool->process = process;
+
+	/* the message pool is shared by the workers, messages are returned to the pool they are taken from */
+	msg_pool = apt_task_msg_pool_create_dynamic(sizeof(mrcp_engine_worker_msg_t),pool);
+	for(i=0; i<worker_count; i++) {
+		mrcp_engine_worker_t *worker = &worker_pool->workers[i];
+		apt_task_t *task;
+		apt_task_vtable_t *vtable;
+
+		worker->worker_pool = worker_pool;
+		worker->task = apt_consumer_task_create(worker,msg_pool,pool);
+		if(!worker->task) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Engine Worker [%"APR_SIZE_T_FMT"]",i);
+			mrcp_engine_worker_pool_destroy(worker_pool);
+			return NULL;
+		}
+		task = apt_consumer_task_base_get(worker->task);
+		if(name) {
+			apt_task_name_set(task,
+				worker_count > 1 ? apr_psprintf(pool,"%s-%"APR_SIZE_T_FMT,name,i) : name);
+		}
+		vtable = apt_task_vtable_get(task);
+		if(vtable) {
+			vtable->process_msg = mrcp_engine_worker_msg_process;
+		}
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Create Engine Worker Pool %s [%"APR_SIZE_T_FMT"]",
+		name ? name : "",
+		worker_count);
+	return worker_pool;
+}
+
+/** Create pool of engine worker threads taking the number of threads from the engine params */
+MRCP_DECLARE(mrcp_engine_worker_pool_t*) mrcp_engine_worker_pool_create_ex(
+											mrcp_engine_t *engine,
+											void *obj,
+											mrcp_engine_worker_msg_process_f process,
+											const char *name)
+{
+	apr_size_t worker_count = MRCP_ENGINE_WORKER_DEFAULT_COUNT;
+	const char *param = mrcp_engine_param_get(engine,MRCP_ENGINE_WORKER_COUNT_PARAM);
+	if(param) {
+		long value = atol(param);
+		if(value > 0) {
+			worker_count = value;
+		}
+	}
+	return mrcp_engine_worker_pool_create(worker_count,obj,process,name,engine->pool);
+}
+
+/** Destroy pool of engine worker threads */
+MRCP_DECLARE(apt_bool_t) mrcp_engine_worker_pool_destroy(mrcp_engine_worker_pool_t *worker_pool)
+{
+	apr_size_t i;
+	for(i=0; i<worker_pool->worker_count; i++) {
+		mrcp_engine_worker_t *worker = &worker_pool->workers[i];
+		if(worker->task) {
+			apt_task_t *task = apt_consumer_task_base_get(worker->task);
+			apt_task_destroy(task);
+			worker->task = NULL;
+		}
+	}
+	return TRUE;
+}
+
+/** Start worker threads */
+MRCP_DECLARE(apt_bool_t) mrcp_engine_worker_pool_start(mrcp_engine_worker_pool_t *worker_pool)
+{
+	apt_bool_t status = TRUE;
+	apr_size_t i;
+	for(i=0; i<worker_pool->worker_count; i++) {
+		mrcp_engine_worker_t *worker = &worker_pool->workers[i];
+		if(worker->task) {
+			apt_task_t *task = apt_consumer_task_base_get(worker->task);
+			if(apt_task_start(task) == FALSE) {
+				status = FALSE;
+			}
+		}
+	}
+	return status;
+}
+
+/** Terminate worker threads, processing pending messages first */
+MRCP_DECLARE(apt_bool_t) mrcp_engine_worker_pool_terminate(mrcp_engine_worker_pool_t *worker_pool)
+{
+	apr_size_t i;
+	/* request all the workers to terminate first, then wait for them */
+	for(i=0; i<worker_pool->worker_count; i++) {
+		mrcp_engine_worker_t *worker = &worker_pool->workers[i];
+		if(worker->task) {
+			apt_task_t *task = apt_consumer_task_base_get(worker->task);
+			apt_task_terminate(task,FALSE);
+		}
+	}
+	for(i=0; i<worker_pool->worker_count; i++) {
+		mrcp_engine_worker_t *worker = &worker_pool->workers[i];
+		if(worker->task) {
+			apt_task_t *task = apt_consumer_task_base_get(worker->task);
+			apt_task_wait_till_complete(task);
+		}
+	}
+	return TRUE;
+}
+
+/** Get the worker the channel is bound to */
+static APR_INLINE mrcp_engine_worker_t* mrcp_engine_worker_get(mrcp_engine_worker_pool_t *worker_pool, const mrcp_engine_channel_t *channel)
+{
+	apr_size_t index = 0;
+	if(worker_pool->worker_count > 1) {
+		/* channels are allocated from their own pools, drop alignment bits and scatter the rest */
+		apr_uint32_t hash = (apr_uint32_t)((apr_uintptr_t)channel >> 4) * 2654435761U;
+		index = (hash >> 16) % worker_pool->worker_count;
+	}
+	return &worker_pool->workers[index];
+}
+
+/** Signal message to the worker thread the channel is bound to */
+MRCP_DECLARE(apt_bool_t) mrcp_engine_worker_pool_signal(
+							mrcp_engine_worker_pool_t *worker_pool,
+							int type,
+							mrcp_engine_channel_t *channel,
+							mrcp_message_t *request)
+{
+	mrcp_engine_worker_t *worker;
+	apt_task_t *task;
+	apt_task_msg_t *msg;
+	mrcp_engine_worker_msg_t *worker_msg;
+
+	if(!channel) {
+		return FALSE;
+	}
+	worker = mrcp_engine_worker_get(worker_pool,channel);
+	if(!worker->task) {
+		return FALSE;
+	}
+
+	task = apt_consumer_task_base_get(worker->task);
+	msg = apt_task_msg_get(task);
+	if(!msg) {
+		return FALSE;
+	}
+
+	msg->type = TASK_MSG_USER;
+	worker_msg = (mrcp_engine_worker_msg_t*) msg->data;
+	worker_msg->type = type;
+	worker_msg->channel = channel;
+	worker_msg->request = request;
+	return apt_task_msg_signal(task,msg);
+}
+
+/** Get the number of worker threads */
+MRCP_DECLARE(apr_size_t) mrcp_engine_worker_pool_count_get(const mrcp_engine_worker_pool_t *worker_pool)
+{
+	return worker_pool->worker_count;
+}
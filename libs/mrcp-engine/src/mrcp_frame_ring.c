@@ -0,0 +1,92 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include <apr_atomic.h>
+#include "mrcp_frame_ring.h"
+
+/** Create frame ring */
+MRCP_DECLARE(mrcp_frame_ring_t*) mrcp_frame_ring_create(apr_size_t capacity, apr_size_t frame_size, apr_pool_t *pool)
+{
+	mrcp_frame_ring_t *ring;
+	apr_uint32_t i;
+	char *buffer;
+	/* the counters wrap around at 2^32, which a power of two capacity divides evenly */
+	apr_uint32_t ring_capacity = 1;
+	while(ring_capacity < capacity) {
+		ring_capacity <<= 1;
+	}
+
+	ring = apr_palloc(pool,sizeof(mrcp_frame_ring_t));
+	ring->capacity = ring_capacity;
+	ring->frame_size = frame_size;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->frames = apr_pcalloc(pool,sizeof(mpf_frame_t) * ring_capacity);
+	buffer = apr_palloc(pool,ring_capacity * frame_size);
+	for(i=0; i<ring_capacity; i++) {
+		ring->frames[i].codec_frame.buffer = buffer + i * frame_size;
+		ring->frames[i].codec_frame.size = frame_size;
+	}
+	return ring;
+}
+
+/** Discard frames of the ring */
+MRCP_DECLARE(void) mrcp_frame_ring_reset(mrcp_frame_ring_t *ring)
+{
+	apr_atomic_set32(&ring->head,0);
+	apr_atomic_set32(&ring->tail,0);
+}
+
+/** Get the entry to write the next frame to */
+MRCP_DECLARE(mpf_frame_t*) mrcp_frame_ring_write_begin(mrcp_frame_ring_t *ring)
+{
+	apr_uint32_t head = ring->head;
+	if(head - apr_atomic_read32(&ring->tail) >= ring->capacity) {
+		return NULL;
+	}
+	return &ring->frames[head & (ring->capacity - 1)];
+}
+
+/** Publish the frame written to the entry */
+MRCP_DECLARE(void) mrcp_frame_ring_write_end(mrcp_frame_ring_t *ring)
+{
+	apr_atomic_set32(&ring->head,ring->head + 1);
+}
+
+/** Get the entry to read the next frame from */
+MRCP_DECLARE(const mpf_frame_t*) mrcp_frame_ring_read_begin(mrcp_frame_ring_t *ring)
+{
+	apr_uint32_t tail = ring->tail;
+	if(apr_atomic_read32(&ring->head) == tail) {
+		return NULL;
+	}
+	return &ring->frames[tail & (ring->capacity - 1)];
+}
+
+/** Release the entry read */
+MRCP_DECLARE(void) mrcp_frame_ring_read_end(mrcp_frame_ring_t *ring)
+{
+	apr_atomic_set32(&ring->tail,ring->tail + 1);
+}
+
+/** Get the number of frames written, but not read yet */
+MRCP_DECLARE(apr_size_t) mrcp_frame_ring_count_get(const mrcp_frame_ring_t *ring)
+{
+	return apr_atomic_read32((volatile apr_uint32_t*)&ring->head) - apr_atomic_read32((volatile apr_uint32_t*)&ring->tail);
+}
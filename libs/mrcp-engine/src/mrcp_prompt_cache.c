@@ -0,0 +1,551 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifdef WIN32
+#pragma warning(disable: 4127)
+#endif
+#include <apr_ring.h>
+#include <apr_hash.h>
+#include <apr_file_io.h>
+#include <apr_fnmatch.h>
+#include <apr_mmap.h>
+#include <apr_strings.h>
+#include <apr_thread_mutex.h>
+#include "mrcp_prompt_cache.h"
+#include "mrcp_synth_header.h"
+#include "mrcp_generic_header.h"
+#include "apt_pool.h"
+#include "apt_log.h"
+
+/** Prefix and pattern of the prompt file names */
+#define PROMPT_FILE_PREFIX  "prompt-"
+#define PROMPT_FILE_PATTERN "prompt-*.pcm"
+/** Size of memory chunks rendered audio is buffered in */
+#define PROMPT_CHUNK_SIZE   16384
+
+/** Prompt cache entry */
+struct mrcp_prompt_entry_t {
+	/** Ring entry (LRU list or list of evicted entries) */
+	APR_RING_ENTRY(mrcp_prompt_entry_t) link;
+
+	/** Digest of the key */
+	apr_uint32_t        digest;
+	/** Prompt key */
+	mrcp_prompt_key_t   key;
+	/** Path to the prompt file */
+	const char         *file_path;
+	/** Prompt file */
+	apr_file_t         *file;
+	/** Mapping of the prompt file */
+	apr_mmap_t         *mmap;
+	/** Rendered audio (mapped) */
+	const char         *data;
+	/** Size of the rendered audio */
+	apr_size_t          size;
+
+	/** Reference count */
+	apr_size_t          ref_count;
+	/** Whether the entry is still held in the cache */
+	apt_bool_t          cached;
+	/** Entry specific pool */
+	apr_pool_t         *pool;
+};
+
+/** Chunk of rendered audio buffered in memory */
+typedef struct mrcp_prompt_chunk_t mrcp_prompt_chunk_t;
+
+struct mrcp_prompt_chunk_t {
+	/** Next chunk */
+	mrcp_prompt_chunk_t *next;
+	/** Size of the data written to the chunk */
+	apr_size_t           size;
+	/** Buffered data [PROMPT_CHUNK_SIZE] */
+	char                *data;
+};
+
+/** Prompt writer */
+struct mrcp_prompt_writer_t {
+	/** Cache to store prompt in */
+	mrcp_prompt_cache_t *cache;
+	/** Entry being rendered */
+	mrcp_prompt_entry_t *entry;
+	/** First chunk of the buffered audio */
+	mrcp_prompt_chunk_t *first_chunk;
+	/** Last chunk of the buffered audio */
+	mrcp_prompt_chunk_t *last_chunk;
+	/** Whether the prompt can't be cached (e.g. too large) */
+	apt_bool_t           failed;
+};
+
+/** Prompt cache */
+struct mrcp_prompt_cache_t {
+	/** Directory to store prompt files in */
+	const char          *dir_path;
+	/** Max total size of prompts */
+	apr_size_t           max_size;
+	/** Total size of cached prompts */
+	apr_size_t           size;
+	/** Sequence number used to compose unique file names */
+	apr_uint32_t         file_seq;
+	/** Table of entries (mrcp_prompt_entry_t*) */
+	apr_hash_t          *table;
+	/** List of entries ordered from the most to the least recently used */
+	APR_RING_HEAD(mrcp_prompt_entry_head_t, mrcp_prompt_entry_t) lru_list;
+	/** List of entries evicted while still referenced */
+	APR_RING_HEAD(mrcp_prompt_evicted_head_t, mrcp_prompt_entry_t) evicted_list;
+	/** Guard of the table and the list */
+	apr_thread_mutex_t  *guard;
+	/** Own pool entry specific pools are created from */
+	apr_pool_t          *pool;
+};
+
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME        16777619U
+
+/** Calculate FNV-1a digest of the string followed by a separator */
+static APR_INLINE apr_uint32_t mrcp_prompt_digest_update(apr_uint32_t digest, const apt_str_t *str)
+{
+	const unsigned char *pos = (const unsigned char*)str->buf;
+	const unsigned char *end = pos + str->length;
+	for(; pos < end; pos++) {
+		digest ^= *pos;
+		digest *= FNV_PRIME;
+	}
+	/* separate the fields so that their boundaries contribute to the digest */
+	return digest * FNV_PRIME;
+}
+
+static apr_uint32_t mrcp_prompt_digest_calculate(const mrcp_prompt_key_t *key)
+{
+	apr_uint32_t digest = FNV_OFFSET_BASIS;
+	digest = mrcp_prompt_digest_update(digest,&key->content);
+	digest = mrcp_prompt_digest_update(digest,&key->voice);
+	digest = mrcp_prompt_digest_update(digest,&key->rate);
+	return mrcp_prompt_digest_update(digest,&key->codec);
+}
+
+static APR_INLINE apt_bool_t mrcp_prompt_string_compare(const apt_str_t *str1, const apt_str_t *str2)
+{
+	if(str1->length != str2->length) {
+		return FALSE;
+	}
+	if(!str1->length) {
+		return TRUE;
+	}
+	return (memcmp(str1->buf,str2->buf,str1->length) == 0) ? TRUE : FALSE;
+}
+
+static apt_bool_t mrcp_prompt_key_match(const mrcp_prompt_key_t *key1, const mrcp_prompt_key_t *key2)
+{
+	return (mrcp_prompt_string_compare(&key1->content,&key2->content) == TRUE &&
+			mrcp_prompt_string_compare(&key1->codec,&key2->codec) == TRUE &&
+			mrcp_prompt_string_compare(&key1->voice,&key2->voice) == TRUE &&
+			mrcp_prompt_string_compare(&key1->rate,&key2->rate) == TRUE) ? TRUE : FALSE;
+}
+
+static void mrcp_prompt_entry_destroy(mrcp_prompt_entry_t *entry)
+{
+	if(entry->mmap) {
+		apr_mmap_delete(entry->mmap);
+		entry->mmap = NULL;
+	}
+	if(entry->file) {
+		apr_file_close(entry->file);
+		entry->file = NULL;
+	}
+	/* the file is removed only after it's unmapped and closed, which is required on Windows */
+	apr_file_remove(entry->file_path,entry->pool);
+	apr_pool_destroy(entry->pool);
+}
+
+/** Remove the entry from the cache and destroy it, unless it's still referenced */
+static void mrcp_prompt_entry_remove(mrcp_prompt_cache_t *cache, mrcp_prompt_entry_t *entry)
+{
+	if(apr_hash_get(cache->table,&entry->digest,sizeof(entry->digest)) == entry) {
+		apr_hash_set(cache->table,&entry->digest,sizeof(entry->digest),NULL);
+	}
+	APR_RING_REMOVE(entry,link);
+	entry->cached = FALSE;
+	cache->size -= entry->size;
+
+	if(!entry->ref_count) {
+		mrcp_prompt_entry_destroy(entry);
+	}
+	else {
+		/* keep track of the entry to remove its file at the latest on destroy of the cache */
+		APR_RING_INSERT_TAIL(&cache->evicted_list,entry,mrcp_prompt_entry_t,link);
+	}
+}
+
+/** Remove prompt files left by a previous run */
+static void mrcp_prompt_cache_dir_clean(const char *dir_path, apr_pool_t *pool)
+{
+	apr_dir_t *dir;
+	apr_finfo_t finfo;
+	char *file_path;
+	if(apr_dir_open(&dir,dir_path,pool) != APR_SUCCESS) {
+		return;
+	}
+	while(apr_dir_read(&finfo,APR_FINFO_NAME,dir) == APR_SUCCESS) {
+		if(apr_fnmatch(PROMPT_FILE_PATTERN,finfo.name,0) == APR_SUCCESS) {
+			if(apr_filepath_merge(&file_path,dir_path,finfo.name,APR_FILEPATH_NATIVE,pool) == APR_SUCCESS) {
+				apr_file_remove(file_path,pool);
+			}
+		}
+	}
+	apr_dir_close(dir);
+}
+
+/** Create prompt cache */
+MRCP_DECLARE(mrcp_prompt_cache_t*) mrcp_prompt_cache_create(const char *dir_path, apr_size_t max_size, apr_pool_t *pool)
+{
+	mrcp_prompt_cache_t *cache;
+	apr_pool_t *own_pool;
+	if(!dir_path || !max_size) {
+		return NULL;
+	}
+
+	if(apr_dir_make_recursive(dir_path,APR_OS_DEFAULT,pool) != APR_SUCCESS) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Prompt Cache Directory [%s]",dir_path);
+		return NULL;
+	}
+	mrcp_prompt_cache_dir_clean(dir_path,pool);
+
+	own_pool = apt_pool_create();
+	if(!own_pool) {
+		return NULL;
+	}
+
+	cache = apr_palloc(pool,sizeof(mrcp_prompt_cache_t));
+	cache->pool = own_pool;
+	cache->dir_path = apr_pstrdup(own_pool,dir_path);
+	cache->max_size = max_size;
+	cache->size = 0;
+	cache->file_seq = 0;
+	cache->table = apr_hash_make(own_pool);
+	APR_RING_INIT(&cache->lru_list, mrcp_prompt_entry_t, link);
+	APR_RING_INIT(&cache->evicted_list, mrcp_prompt_entry_t, link);
+	cache->guard = NULL;
+	if(apr_thread_mutex_create(&cache->guard,APR_THREAD_MUTEX_DEFAULT,own_pool) != APR_SUCCESS) {
+		apr_pool_destroy(own_pool);
+		return NULL;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Create Prompt Cache [%s] [%"APR_SIZE_T_FMT" bytes]",dir_path,max_size);
+	return cache;
+}
+
+/** Destroy prompt cache */
+MRCP_DECLARE(void) mrcp_prompt_cache_destroy(mrcp_prompt_cache_t *cache)
+{
+	mrcp_prompt_entry_t *entry;
+	if(!cache) {
+		return;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Destroy Prompt Cache [%s]",cache->dir_path);
+	while(!APR_RING_EMPTY(&cache->lru_list, mrcp_prompt_entry_t, link)) {
+		entry = APR_RING_FIRST(&cache->lru_list);
+		APR_RING_REMOVE(entry,link);
+		mrcp_prompt_entry_destroy(entry);
+	}
+	/* the entries evicted while referenced are destroyed regardless of their references */
+	while(!APR_RING_EMPTY(&cache->evicted_list, mrcp_prompt_entry_t, link)) {
+		entry = APR_RING_FIRST(&cache->evicted_list);
+		APR_RING_REMOVE(entry,link);
+		mrcp_prompt_entry_destroy(entry);
+	}
+	apr_thread_mutex_destroy(cache->guard);
+	apr_pool_destroy(cache->pool);
+}
+
+/** Initialize prompt key based on SPEAK request */
+MRCP_DECLARE(apt_bool_t) mrcp_prompt_key_init(
+							mrcp_prompt_key_t *key,
+							const mrcp_message_t *request,
+							const mpf_codec_descriptor_t *descriptor,
+							apr_pool_t *pool)
+{
+	mrcp_synth_header_t *synth_header;
+	if(!request->body.length || !descriptor) {
+		return FALSE;
+	}
+
+	key->content = request->body;
+	apt_string_reset(&key->voice);
+	apt_string_reset(&key->rate);
+	synth_header = mrcp_resource_header_get(request);
+	if(synth_header) {
+		if(mrcp_resource_header_property_check(request,SYNTHESIZER_HEADER_VOICE_NAME) == TRUE) {
+			key->voice = synth_header->voice_param.name;
+		}
+		if(mrcp_resource_header_property_check(request,SYNTHESIZER_HEADER_PROSODY_RATE) == TRUE) {
+			const mrcp_prosody_rate_t *rate = &synth_header->prosody_param.rate;
+			if(rate->type == PROSODY_RATE_TYPE_LABEL) {
+				apt_string_assign(&key->rate,apr_psprintf(pool,"label:%d",rate->value.label),pool);
+			}
+			else if(rate->type == PROSODY_RATE_TYPE_RELATIVE_CHANGE) {
+				apt_string_assign(&key->rate,apr_psprintf(pool,"relative:%.3f",rate->value.relative),pool);
+			}
+		}
+	}
+	apt_string_assign(&key->codec,
+		apr_psprintf(pool,"%s/%d/%d",
+			descriptor->name.buf ? descriptor->name.buf : "",
+			descriptor->sampling_rate,
+			descriptor->channel_count),
+		pool);
+	return TRUE;
+}
+
+/** Find rendered prompt */
+MRCP_DECLARE(mrcp_prompt_entry_t*) mrcp_prompt_cache_find(mrcp_prompt_cache_t *cache, const mrcp_prompt_key_t *key)
+{
+	mrcp_prompt_entry_t *entry;
+	apr_uint32_t digest;
+	if(!cache || !key) {
+		return NULL;
+	}
+
+	digest = mrcp_prompt_digest_calculate(key);
+
+	apr_thread_mutex_lock(cache->guard);
+	entry = apr_hash_get(cache->table,&digest,sizeof(digest));
+	if(entry && mrcp_prompt_key_match(&entry->key,key) == TRUE) {
+		/* move the entry to the head of the LRU list */
+		APR_RING_REMOVE(entry,link);
+		APR_RING_INSERT_HEAD(&cache->lru_list,entry,mrcp_prompt_entry_t,link);
+		entry->ref_count++;
+	}
+	else {
+		entry = NULL;
+	}
+	apr_thread_mutex_unlock(cache->guard);
+	return entry;
+}
+
+/** Release prompt entry */
+MRCP_DECLARE(void) mrcp_prompt_cache_release(mrcp_prompt_cache_t *cache, mrcp_prompt_entry_t *entry)
+{
+	if(!cache || !entry) {
+		return;
+	}
+
+	apr_thread_mutex_lock(cache->guard);
+	if(entry->ref_count) {
+		entry->ref_count--;
+	}
+	if(!entry->ref_count && entry->cached == FALSE) {
+		/* the entry has been evicted or replaced meanwhile */
+		APR_RING_REMOVE(entry,link);
+		mrcp_prompt_entry_destroy(entry);
+	}
+	apr_thread_mutex_unlock(cache->guard);
+}
+
+/** Create writer to store a prompt being rendered */
+MRCP_DECLARE(mrcp_prompt_writer_t*) mrcp_prompt_writer_create(mrcp_prompt_cache_t *cache, const mrcp_prompt_key_t *key)
+{
+	mrcp_prompt_writer_t *writer;
+	mrcp_prompt_entry_t *entry;
+	apr_pool_t *pool;
+	char *file_name;
+	apr_uint32_t file_seq;
+	if(!cache || !key) {
+		return NULL;
+	}
+
+	apr_thread_mutex_lock(cache->guard);
+	pool = apt_subpool_create(cache->pool);
+	file_seq = cache->file_seq++;
+	apr_thread_mutex_unlock(cache->guard);
+	if(!pool) {
+		return NULL;
+	}
+
+	entry = apr_palloc(pool,sizeof(mrcp_prompt_entry_t));
+	entry->pool = pool;
+	entry->digest = mrcp_prompt_digest_calculate(key);
+	apt_string_copy(&entry->key.content,&key->content,pool);
+	apt_string_copy(&entry->key.voice,&key->voice,pool);
+	apt_string_copy(&entry->key.rate,&key->rate,pool);
+	apt_string_copy(&entry->key.codec,&key->codec,pool);
+	entry->file = NULL;
+	entry->mmap = NULL;
+	entry->data = NULL;
+	entry->size = 0;
+	entry->ref_count = 1;
+	entry->cached = FALSE;
+
+	/* the file is created only on commit, the audio is buffered in memory meanwhile */
+	file_name = apr_psprintf(pool,PROMPT_FILE_PREFIX"%08x-%u.pcm",entry->digest,file_seq);
+	if(apr_filepath_merge((char**)&entry->file_path,cache->dir_path,file_name,APR_FILEPATH_NATIVE,pool) != APR_SUCCESS) {
+		apr_pool_destroy(pool);
+		return NULL;
+	}
+
+	writer = apr_palloc(pool,sizeof(mrcp_prompt_writer_t));
+	writer->cache = cache;
+	writer->entry = entry;
+	writer->first_chunk = NULL;
+	writer->last_chunk = NULL;
+	writer->failed = FALSE;
+	return writer;
+}
+
+/** Write rendered audio */
+MRCP_DECLARE(apt_bool_t) mrcp_prompt_writer_write(mrcp_prompt_writer_t *writer, const void *data, apr_size_t size)
+{
+	mrcp_prompt_entry_t *entry = writer->entry;
+	const char *pos = data;
+	if(writer->failed == TRUE) {
+		return FALSE;
+	}
+	if(entry->size + size > writer->cache->max_size) {
+		/* the prompt is too large to be cached */
+		writer->failed = TRUE;
+		return FALSE;
+	}
+
+	while(size) {
+		mrcp_prompt_chunk_t *chunk = writer->last_chunk;
+		apr_size_t chunk_size;
+		if(!chunk || chunk->size == PROMPT_CHUNK_SIZE) {
+			chunk = apr_palloc(entry->pool,sizeof(mrcp_prompt_chunk_t) + PROMPT_CHUNK_SIZE);
+			chunk->next = NULL;
+			chunk->size = 0;
+			chunk->data = (char*)(chunk + 1);
+			if(writer->last_chunk) {
+				writer->last_chunk->next = chunk;
+			}
+			else {
+				writer->first_chunk = chunk;
+			}
+			writer->last_chunk = chunk;
+		}
+
+		chunk_size = PROMPT_CHUNK_SIZE - chunk->size;
+		if(chunk_size > size) {
+			chunk_size = size;
+		}
+		memcpy(chunk->data + chunk->size,pos,chunk_size);
+		chunk->size += chunk_size;
+		entry->size += chunk_size;
+		pos += chunk_size;
+		size -= chunk_size;
+	}
+	return TRUE;
+}
+
+/** Store the buffered audio to the prompt file */
+static apt_bool_t mrcp_prompt_writer_store(mrcp_prompt_writer_t *writer)
+{
+	mrcp_prompt_entry_t *entry = writer->entry;
+	mrcp_prompt_chunk_t *chunk;
+	apt_bool_t status = TRUE;
+	if(apr_file_open(&entry->file,entry->file_path,
+			APR_FOPEN_WRITE|APR_FOPEN_CREATE|APR_FOPEN_TRUNCATE|APR_FOPEN_BINARY|APR_FOPEN_BUFFERED,
+			APR_OS_DEFAULT,entry->pool) != APR_SUCCESS) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Prompt File [%s]",entry->file_path);
+		return FALSE;
+	}
+
+	for(chunk = writer->first_chunk; chunk; chunk = chunk->next) {
+		if(apr_file_write_full(entry->file,chunk->data,chunk->size,NULL) != APR_SUCCESS) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Write Prompt File [%s]",entry->file_path);
+			status = FALSE;
+			break;
+		}
+	}
+	apr_file_close(entry->file);
+	entry->file = NULL;
+	return status;
+}
+
+/** Complete rendering and add the prompt to the cache */
+MRCP_DECLARE(mrcp_prompt_entry_t*) mrcp_prompt_writer_commit(mrcp_prompt_writer_t *writer)
+{
+	mrcp_prompt_cache_t *cache = writer->cache;
+	mrcp_prompt_entry_t *entry = writer->entry;
+	mrcp_prompt_entry_t *existing_entry;
+
+	if(writer->failed == TRUE || !entry->size) {
+		mrcp_prompt_writer_abort(writer);
+		return NULL;
+	}
+
+	if(mrcp_prompt_writer_store(writer) == FALSE ||
+		apr_file_open(&entry->file,entry->file_path,APR_FOPEN_READ|APR_FOPEN_BINARY,0,entry->pool) != APR_SUCCESS ||
+		apr_mmap_create(&entry->mmap,entry->file,0,entry->size,APR_MMAP_READ,entry->pool) != APR_SUCCESS) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Map Prompt File [%s]",entry->file_path);
+		mrcp_prompt_writer_abort(writer);
+		return NULL;
+	}
+	entry->data = entry->mmap->mm;
+
+	apr_thread_mutex_lock(cache->guard);
+	entry->cached = TRUE;
+
+	/* replace the entry previously cached with the same digest, if any */
+	existing_entry = apr_hash_get(cache->table,&entry->digest,sizeof(entry->digest));
+	if(existing_entry) {
+		mrcp_prompt_entry_remove(cache,existing_entry);
+	}
+
+	/* evict the least recently used entries to make room for the new one */
+	while(cache->size + entry->size > cache->max_size &&
+		!APR_RING_EMPTY(&cache->lru_list, mrcp_prompt_entry_t, link)) {
+		mrcp_prompt_entry_remove(cache,APR_RING_LAST(&cache->lru_list));
+	}
+
+	APR_RING_INSERT_HEAD(&cache->lru_list,entry,mrcp_prompt_entry_t,link);
+	apr_hash_set(cache->table,&entry->digest,sizeof(entry->digest),entry);
+	cache->size += entry->size;
+	apr_thread_mutex_unlock(cache->guard);
+
+	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Cache Prompt [%s] [%"APR_SIZE_T_FMT" bytes]",entry->file_path,entry->size);
+	return entry;
+}
+
+/** Abort rendering and discard the written audio */
+MRCP_DECLARE(void) mrcp_prompt_writer_abort(mrcp_prompt_writer_t *writer)
+{
+	mrcp_prompt_cache_t *cache = writer->cache;
+	apr_thread_mutex_lock(cache->guard);
+	mrcp_prompt_entry_destroy(writer->entry);
+	apr_thread_mutex_unlock(cache->guard);
+}
+
+/** Read next frame of the prompt directly from the mapping */
+MRCP_DECLARE(apt_bool_t) mrcp_prompt_entry_frame_read(const mrcp_prompt_entry_t *entry, apr_size_t *offset, mpf_frame_t *frame)
+{
+	apr_size_t size = frame->codec_frame.size;
+	if(*offset + size > entry->size) {
+		return FALSE;
+	}
+	memcpy(frame->codec_frame.buffer,entry->data + *offset,size);
+	frame->type |= MEDIA_FRAME_TYPE_AUDIO;
+	*offset += size;
+	return TRUE;
+}
+
+/** Get the size of the rendered prompt in bytes */
+MRCP_DECLARE(apr_size_t) mrcp_prompt_entry_size_get(const mrcp_prompt_entry_t *entry)
+{
+	return entry->size;
+}
@@ -24,6 +24,7 @@
 #include "mrcp_generic_header.h"
 #include "mrcp_recog_resource.h"
 #include "mrcp_message.h"
+#include "mrcp_property_store.h"
 
 /** MRCP recognizer states */
 typedef enum {
@@ -55,7 +56,7 @@ struct mrcp_recog_state_machine_t {
 	/** queue of pending recognition requests */
 	apt_obj_list_t        *queue;
 	/** properties used in set/get params */
-	mrcp_message_header_t *properties;
+	mrcp_property_store_t *properties;
 };
 
 typedef apt_bool_t (*recog_method_f)(mrcp_recog_state_machine_t *state_machine, mrcp_message_t *message);
@@ -100,7 +101,7 @@ static APR_INLINE void recog_state_change(mrcp_recog_state_machine_t *state_mach
 
 static apt_bool_t recog_request_set_params(mrcp_recog_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_set(state_machine->properties,&message->header,message->pool);
+	mrcp_property_store_set(state_machine->properties,message);
 	return recog_request_dispatch(state_machine,message);
 }
 
@@ -116,7 +117,7 @@ static apt_bool_t recog_request_get_params(mrcp_recog_state_machine_t *state_mac
 
 static apt_bool_t recog_response_get_params(mrcp_recog_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_get(&message->header,state_machine->properties,&state_machine->active_request->header,message->pool);
+	mrcp_property_store_get(state_machine->properties,message,state_machine->active_request);
 	return recog_response_dispatch(state_machine,message);
 }
 
@@ -146,7 +147,7 @@ static apt_bool_t recog_response_define_grammar(mrcp_recog_state_machine_t *stat
 
 static apt_bool_t recog_request_recognize(mrcp_recog_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_inherit(&message->header,state_machine->properties,message->pool);
+	mrcp_property_store_inherit(state_machine->properties,message);
 	if(state_machine->state == RECOGNIZER_STATE_RECOGNIZING) {
 		mrcp_message_t *response;
 		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Queue Up RECOGNIZE Request "APT_SIDRES_FMT" [%"MRCP_REQUEST_ID_FMT"]",
@@ -179,7 +180,7 @@ static apt_bool_t recog_response_recognize(mrcp_recog_state_machine_t *state_mac
 
 static apt_bool_t recog_request_interpret(mrcp_recog_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_inherit(&message->header,state_machine->properties,message->pool);
+	mrcp_property_store_inherit(state_machine->properties,message);
 	return recog_request_dispatch(state_machine,message);
 }
 
@@ -545,7 +546,7 @@ mrcp_state_machine_t* mrcp_recog_state_machine_create(void *obj, mrcp_version_e
 	state_machine->active_request = NULL;
 	state_machine->recog = NULL;
 	state_machine->queue = apt_list_create(pool);
-	state_machine->properties = mrcp_message_header_create(
+	state_machine->properties = mrcp_property_store_create(
 			mrcp_generic_header_vtable_get(version),
 			mrcp_recog_header_vtable_get(version),
 			pool);
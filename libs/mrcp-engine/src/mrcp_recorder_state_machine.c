@@ -23,6 +23,7 @@
 #include "mrcp_recorder_header.h"
 #include "mrcp_recorder_resource.h"
 #include "mrcp_message.h"
+#include "mrcp_property_store.h"
 
 /** MRCP recorder states */
 typedef enum {
@@ -49,7 +50,7 @@ struct mrcp_recorder_state_machine_t {
 	/** in-progress record request */
 	mrcp_message_t        *record;
 	/** properties used in set/get params */
-	mrcp_message_header_t *properties;
+	mrcp_property_store_t *properties;
 };
 
 typedef apt_bool_t (*recorder_method_f)(mrcp_recorder_state_machine_t *state_machine, mrcp_message_t *message);
@@ -94,7 +95,7 @@ static APR_INLINE void recorder_state_change(mrcp_recorder_state_machine_t *stat
 
 static apt_bool_t recorder_request_set_params(mrcp_recorder_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_set(state_machine->properties,&message->header,message->pool);
+	mrcp_property_store_set(state_machine->properties,message);
 	return recorder_request_dispatch(state_machine,message);
 }
 
@@ -110,13 +111,13 @@ static apt_bool_t recorder_request_get_params(mrcp_recorder_state_machine_t *sta
 
 static apt_bool_t recorder_response_get_params(mrcp_recorder_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_get(&message->header,state_machine->properties,&state_machine->active_request->header,message->pool);
+	mrcp_property_store_get(state_machine->properties,message,state_machine->active_request);
 	return recorder_response_dispatch(state_machine,message);
 }
 
 static apt_bool_t recorder_request_record(mrcp_recorder_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_inherit(&message->header,state_machine->properties,message->pool);
+	mrcp_property_store_inherit(state_machine->properties,message);
 	if(state_machine->state == RECORDER_STATE_RECORDING) {
 		mrcp_message_t *response;
 		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Reject RECORD Request "APT_SIDRES_FMT" [%"MRCP_REQUEST_ID_FMT"]",
@@ -381,7 +382,7 @@ mrcp_state_machine_t* mrcp_recorder_state_machine_create(void *obj, mrcp_version
 	state_machine->state = RECORDER_STATE_IDLE;
 	state_machine->active_request = NULL;
 	state_machine->record = NULL;
-	state_machine->properties = mrcp_message_header_create(
+	state_machine->properties = mrcp_property_store_create(
 			mrcp_generic_header_vtable_get(version),
 			mrcp_recorder_header_vtable_get(version),
 			pool);
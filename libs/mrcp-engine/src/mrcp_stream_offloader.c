@@ -0,0 +1,749 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <apr_atomic.h>
+#include <apr_ring.h>
+#include <apr_thread_mutex.h>
+#include <apr_thread_cond.h>
+#include "mrcp_stream_offloader.h"
+#include "mrcp_frame_ring.h"
+#include "mrcp_engine_impl.h"
+#include "apt_consumer_task.h"
+#include "apt_log.h"
+
+/** Number of low bits of the state word holding the state, the rest is a generation counter */
+#define OFFLOAD_STATE_BITS 3
+#define OFFLOAD_STATE_MASK ((1 << OFFLOAD_STATE_BITS) - 1)
+
+/** Interval to wait for the worker to release a stream in usec */
+#define OFFLOAD_RELEASE_TIMEOUT 1000000
+
+/** States of a direction of an offloaded stream */
+typedef enum {
+	OFFLOAD_STATE_IDLE,      /**< closed, the worker doesn't access the ring (media thread -> OPENING) */
+	OFFLOAD_STATE_OPENING,   /**< open requested (worker -> ACTIVE, media thread -> CLOSING) */
+	OFFLOAD_STATE_ACTIVE,    /**< frames are exchanged (media thread -> CLOSING) */
+	OFFLOAD_STATE_CLOSING,   /**< close requested (worker -> IDLE, media thread -> REOPENING) */
+	OFFLOAD_STATE_REOPENING  /**< open requested before close completed (worker -> OPENING, media thread -> CLOSING) */
+} mrcp_offload_state_e;
+
+/** Offload worker thread */
+typedef struct mrcp_offload_worker_t mrcp_offload_worker_t;
+/** Offloaded stream */
+typedef struct mrcp_offload_stream_t mrcp_offload_stream_t;
+/** Direction (receive or transmit) of an offloaded stream */
+typedef struct mrcp_offload_direction_t mrcp_offload_direction_t;
+
+struct mrcp_offload_direction_t {
+	/** State word (generation << OFFLOAD_STATE_BITS | mrcp_offload_state_e) */
+	volatile apr_uint32_t  state;
+	/** Ring of frames exchanged with the plugin */
+	mrcp_frame_ring_t     *ring;
+	/** Codec to open the plugin with */
+	mpf_codec_t           *codec;
+	/** Ring to use once the plugin is reopened */
+	mrcp_frame_ring_t     *pending_ring;
+	/** Codec to reopen the plugin with */
+	mpf_codec_t           *pending_codec;
+	/** Indicates whether the plugin is open (accessed by the worker only) */
+	apt_bool_t             plugin_opened;
+};
+
+struct mrcp_offload_stream_t {
+	/** Ring entry */
+	APR_RING_ENTRY(mrcp_offload_stream_t) link;
+
+	/** Stream placed into the media termination */
+	mpf_audio_stream_t      *base;
+	/** Stream the methods of the plugin are invoked with */
+	mpf_audio_stream_t       plugin_stream;
+	/** Frames read ahead from the plugin (source stream) */
+	mrcp_offload_direction_t rx;
+	/** Frames queued to the plugin (sink stream) */
+	mrcp_offload_direction_t tx;
+	/** Indicates whether the stream is linked to the worker (protected by the guard) */
+	apt_bool_t               attached;
+
+	/** Worker the stream is bound to */
+	mrcp_offload_worker_t   *worker;
+	/** Back pointer to the offloader */
+	mrcp_stream_offloader_t *offloader;
+	/** Pool to allocate rings from */
+	apr_pool_t              *pool;
+};
+
+struct mrcp_offload_worker_t {
+	/** Consumer task */
+	apt_consumer_task_t     *task;
+	/** Timer to exchange frames with */
+	apt_timer_t             *timer;
+	/** Mutex to protect streams being attached and detached, never held while calling the plugin */
+	apr_thread_mutex_t      *guard;
+	/** Condition signaled on detaching of streams */
+	apr_thread_cond_t       *detached;
+	/** Streams processed by the worker (accessed by the worker only) */
+	APR_RING_HEAD(mrcp_offload_stream_head_t, mrcp_offload_stream_t) stream_list;
+	/** Streams attached, but not taken by the worker yet (protected by the guard) */
+	struct mrcp_offload_stream_head_t attach_list;
+	/** Indicates whether the worker is running */
+	volatile apr_uint32_t    running;
+	/** Back pointer to the offloader */
+	mrcp_stream_offloader_t *offloader;
+};
+
+/** Stream offloader */
+struct mrcp_stream_offloader_t {
+	/** Array of workers */
+	mrcp_offload_worker_t *workers;
+	/** Number of workers */
+	apr_size_t             worker_count;
+	/** Number of frames read ahead from source streams */
+	apr_uint32_t           lookahead;
+	/** Max number of frames queued to sink streams */
+	apr_uint32_t           delay;
+	/** Counter to bind streams to workers in turn */
+	volatile apr_uint32_t  next_worker;
+	/** Number of frames read before being read ahead */
+	volatile apr_uint32_t  underrun_count;
+	/** Number of frames dropped */
+	volatile apr_uint32_t  overrun_count;
+};
+
+static apt_bool_t mrcp_offload_stream_destroy(mpf_audio_stream_t *stream);
+static apt_bool_t mrcp_offload_stream_open_rx(mpf_audio_stream_t *stream, mpf_codec_t *codec);
+static apt_bool_t mrcp_offload_stream_close_rx(mpf_audio_stream_t *stream);
+static apt_bool_t mrcp_offload_stream_read_frame(mpf_audio_stream_t *stream, mpf_frame_t *frame);
+static apt_bool_t mrcp_offload_stream_open_tx(mpf_audio_stream_t *stream, mpf_codec_t *codec);
+static apt_bool_t mrcp_offload_stream_close_tx(mpf_audio_stream_t *stream);
+static apt_bool_t mrcp_offload_stream_write_frame(mpf_audio_stream_t *stream, const mpf_frame_t *frame);
+static void mrcp_offload_stream_trace(mpf_audio_stream_t *stream, mpf_stream_direction_e direction, apt_text_stream_t *output);
+
+static const mpf_audio_stream_vtable_t offload_stream_vtable = {
+	mrcp_offload_stream_destroy,
+	mrcp_offload_stream_open_rx,
+	mrcp_offload_stream_close_rx,
+	mrcp_offload_stream_read_frame,
+	mrcp_offload_stream_open_tx,
+	mrcp_offload_stream_close_tx,
+	mrcp_offload_stream_write_frame,
+	mrcp_offload_stream_trace
+};
+
+static void mrcp_offload_worker_timer_proc(apt_timer_t *timer, void *obj);
+/** Create stream offloader */
+MRCP_DECLARE(mrcp_stream_offloader_t*) mrcp_stream_offloader_create(
+											apr_size_t thread_count,
+											apr_size_t lookahead,
+											apr_size_t delay,
+											const char *name,
+											apr_pool_t *pool)
+{
+	apr_size_t i;
+	mrcp_stream_offloader_t *offloader;
+
+	if(!thread_count) {
+		return NULL;
+	}
+
+	offloader = apr_palloc(pool,sizeof(mrcp_stream_offloader_t));
+	offloader->workers = apr_pcalloc(pool,sizeof(mrcp_offload_worker_t) * thread_count);
+	offloader->worker_count = thread_count;
+	offloader->lookahead = lookahead ? (apr_uint32_t)lookahead : MRCP_STREAM_DEFAULT_LOOKAHEAD;
+	offloader->delay = delay ? (apr_uint32_t)delay : MRCP_STREAM_DEFAULT_DELAY;
+	offloader->next_worker = 0;
+	offloader->underrun_count = 0;
+	offloader->overrun_count = 0;
+
+	for(i=0; i<thread_count; i++) {
+		mrcp_offload_worker_t *worker = &offloader->workers[i];
+		worker->offloader = offloader;
+		APR_RING_INIT(&worker->stream_list, mrcp_offload_stream_t, link);
+		APR_RING_INIT(&worker->attach_list, mrcp_offload_stream_t, link);
+		worker->running = 0;
+		if(apr_thread_mutex_create(&worker->guard,APR_THREAD_MUTEX_DEFAULT,pool) != APR_SUCCESS) {
+			worker->guard = NULL;
+			mrcp_stream_offloader_destroy(offloader);
+			return NULL;
+		}
+		if(apr_thread_cond_create(&worker->detached,pool) != APR_SUCCESS) {
+			worker->detached = NULL;
+			mrcp_stream_offloader_destroy(offloader);
+			return NULL;
+		}
+
+		worker->task = apt_consumer_task_create(worker,NULL,pool);
+		if(!worker->task) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Stream Offload Worker [%"APR_SIZE_T_FMT"]",i);
+			mrcp_stream_offloader_destroy(offloader);
+			return NULL;
+		}
+		if(name) {
+			apt_task_name_set(apt_consumer_task_base_get(worker->task),
+				thread_count > 1 ? apr_psprintf(pool,"%s-%"APR_SIZE_T_FMT,name,i) : name);
+		}
+		worker->timer = apt_consumer_task_timer_create(worker->task,mrcp_offload_worker_timer_proc,worker,pool);
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Create Stream Offloader %s [%"APR_SIZE_T_FMT" threads] lookahead [%u] delay [%u]",
+		name ? name : "",
+		thread_count,
+		offloader->lookahead,
+		offloader->delay);
+	return offloader;
+}
+
+/** Get numeric engine param */
+static apr_size_t mrcp_engine_size_param_get(mrcp_engine_t *engine, const char *name)
+{
+	const char *param = mrcp_engine_param_get(engine,name);
+	if(param) {
+		long value = atol(param);
+		if(value > 0) {
+			return value;
+		}
+	}
+	return 0;
+}
+
+/** Create stream offloader taking the settings from the engine params */
+MRCP_DECLARE(mrcp_stream_offloader_t*) mrcp_stream_offloader_create_ex(mrcp_engine_t *engine)
+{
+	apr_size_t thread_count = mrcp_engine_size_param_get(engine,MRCP_STREAM_OFFLOAD_THREADS_PARAM);
+	if(!thread_count) {
+		return NULL;
+	}
+	return mrcp_stream_offloader_create(
+				thread_count,
+				mrcp_engine_size_param_get(engine,MRCP_STREAM_LOOKAHEAD_PARAM),
+				mrcp_engine_size_param_get(engine,MRCP_STREAM_DELAY_PARAM),
+				engine->id ? apr_psprintf(engine->pool,"%s Stream",engine->id) : "Stream Offload",
+				engine->pool);
+}
+
+/** Destroy stream offloader */
+MRCP_DECLARE(apt_bool_t) mrcp_stream_offloader_destroy(mrcp_stream_offloader_t *offloader)
+{
+	apr_size_t i;
+	for(i=0; i<offloader->worker_count; i++) {
+		mrcp_offload_worker_t *worker = &offloader->workers[i];
+		if(worker->task) {
+			apt_task_t *task = apt_consumer_task_base_get(worker->task);
+			apt_task_destroy(task);
+			worker->task = NULL;
+		}
+		if(worker->detached) {
+			apr_thread_cond_destroy(worker->detached);
+			worker->detached = NULL;
+		}
+		if(worker->guard) {
+			apr_thread_mutex_destroy(worker->guard);
+			worker->guard = NULL;
+		}
+	}
+	return TRUE;
+}
+
+/** Start worker threads */
+MRCP_DECLARE(apt_bool_t) mrcp_stream_offloader_start(mrcp_stream_offloader_t *offloader)
+{
+	apt_bool_t status = TRUE;
+	apr_size_t i;
+	for(i=0; i<offloader->worker_count; i++) {
+		mrcp_offload_worker_t *worker = &offloader->workers[i];
+		if(worker->task) {
+			/* the timer queue is not running yet, it's safe to set the timer from this thread */
+			apt_timer_set(worker->timer,CODEC_FRAME_TIME_BASE);
+			apr_atomic_set32(&worker->running,1);
+			if(apt_task_start(apt_consumer_task_base_get(worker->task)) == FALSE) {
+				apr_atomic_set32(&worker->running,0);
+				status = FALSE;
+			}
+		}
+	}
+	return status;
+}
+
+/** Terminate worker threads */
+MRCP_DECLARE(apt_bool_t) mrcp_stream_offloader_terminate(mrcp_stream_offloader_t *offloader)
+{
+	apr_size_t i;
+	for(i=0; i<offloader->worker_count; i++) {
+		mrcp_offload_worker_t *worker = &offloader->workers[i];
+		if(worker->task) {
+			apt_task_terminate(apt_consumer_task_base_get(worker->task),FALSE);
+		}
+	}
+	for(i=0; i<offloader->worker_count; i++) {
+		mrcp_offload_worker_t *worker = &offloader->workers[i];
+		if(worker->task) {
+			apt_task_wait_till_complete(apt_consumer_task_base_get(worker->task));
+		}
+
+		/* wake up threads waiting for streams the terminated worker won't release anymore */
+		apr_thread_mutex_lock(worker->guard);
+		apr_atomic_set32(&worker->running,0);
+		apr_thread_cond_broadcast(worker->detached);
+		apr_thread_mutex_unlock(worker->guard);
+	}
+	return TRUE;
+}
+
+/** Create offloaded audio stream */
+MRCP_DECLARE(mpf_audio_stream_t*) mrcp_stream_offloader_audio_stream_create(
+										mrcp_stream_offloader_t *offloader,
+										void *obj,
+										const mpf_audio_stream_vtable_t *vtable,
+										const mpf_stream_capabilities_t *capabilities,
+										apr_pool_t *pool)
+{
+	apr_uint32_t index;
+	mrcp_offload_stream_t *offload_stream = apr_pcalloc(pool,sizeof(mrcp_offload_stream_t));
+	offload_stream->base = mpf_audio_stream_create(offload_stream,&offload_stream_vtable,capabilities,pool);
+	if(!offload_stream->base) {
+		return NULL;
+	}
+
+	offload_stream->plugin_stream = *offload_stream->base;
+	offload_stream->plugin_stream.obj = obj;
+	offload_stream->plugin_stream.vtable = vtable;
+	offload_stream->attached = FALSE;
+	APR_RING_ELEM_INIT(offload_stream,link);
+
+	index = apr_atomic_inc32(&offloader->next_worker);
+	offload_stream->worker = &offloader->workers[index % offloader->worker_count];
+	offload_stream->offloader = offloader;
+	offload_stream->pool = pool;
+	return offload_stream->base;
+}
+
+/** Wait for the worker to close the stream of the plugin and release the stream */
+MRCP_DECLARE(apt_bool_t) mrcp_stream_offloader_audio_stream_release(mrcp_stream_offloader_t *offloader, mpf_audio_stream_t *stream)
+{
+	mrcp_offload_stream_t *offload_stream;
+	mrcp_offload_worker_t *worker;
+	if(!stream || stream->vtable != &offload_stream_vtable) {
+		/* not an offloaded stream */
+		return TRUE;
+	}
+
+	offload_stream = stream->obj;
+	worker = offload_stream->worker;
+	apr_thread_mutex_lock(worker->guard);
+	while(offload_stream->attached == TRUE && apr_atomic_read32(&worker->running)) {
+		if(apr_thread_cond_timedwait(worker->detached,worker->guard,OFFLOAD_RELEASE_TIMEOUT) == APR_TIMEUP) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Wait for Offloaded Stream to be Closed");
+		}
+	}
+	apr_thread_mutex_unlock(worker->guard);
+	return TRUE;
+}
+
+/** Get the number of frames read before being read ahead */
+MRCP_DECLARE(apr_size_t) mrcp_stream_offloader_underrun_count_get(const mrcp_stream_offloader_t *offloader)
+{
+	return apr_atomic_read32((volatile apr_uint32_t*)&offloader->underrun_count);
+}
+
+/** Get the number of frames dropped */
+MRCP_DECLARE(apr_size_t) mrcp_stream_offloader_overrun_count_get(const mrcp_stream_offloader_t *offloader)
+{
+	return apr_atomic_read32((volatile apr_uint32_t*)&offloader->overrun_count);
+}
+
+
+
+/** Get the state of the state word */
+static APR_INLINE apr_uint32_t mrcp_offload_state_get(apr_uint32_t word)
+{
+	return word & OFFLOAD_STATE_MASK;
+}
+
+/**
+ * Move the direction from the state read as the specified word to the new state.
+ * @remark The generation is advanced on each transition, so a word read before
+ * any intermediate transitions (e.g. REOPENING -> CLOSING -> REOPENING) never matches.
+ */
+static APR_INLINE apt_bool_t mrcp_offload_state_transit(mrcp_offload_direction_t *direction, apr_uint32_t word, apr_uint32_t state)
+{
+	apr_uint32_t next_word = ((word & ~OFFLOAD_STATE_MASK) + (1 << OFFLOAD_STATE_BITS)) | state;
+	return apr_atomic_cas32(&direction->state,next_word,word) == word ? TRUE : FALSE;
+}
+
+/** Copy frame into the entry of the ring */
+static void mrcp_frame_copy(mpf_frame_t *dest, const mpf_frame_t *src, apr_size_t size)
+{
+	dest->type = src->type;
+	dest->marker = src->marker;
+	if((src->type & MEDIA_FRAME_TYPE_EVENT) == MEDIA_FRAME_TYPE_EVENT) {
+		dest->event_frame = src->event_frame;
+	}
+	if((src->type & MEDIA_FRAME_TYPE_AUDIO) == MEDIA_FRAME_TYPE_AUDIO) {
+		if(size > src->codec_frame.size) {
+			size = src->codec_frame.size;
+		}
+		memcpy(dest->codec_frame.buffer,src->codec_frame.buffer,size);
+		dest->codec_frame.size = size;
+	}
+}
+
+/** Calculate the size of frames exchanged with the plugin */
+static apr_size_t mrcp_offload_frame_size_calculate(const mpf_codec_descriptor_t *descriptor, const mpf_codec_t *codec)
+{
+	if(!descriptor) {
+		return mpf_codec_linear_frame_size_calculate(8000,1);
+	}
+	if(codec && codec->attribs) {
+		return mpf_codec_frame_size_calculate(descriptor,codec->attribs);
+	}
+	return mpf_codec_linear_frame_size_calculate(descriptor->sampling_rate,descriptor->channel_count);
+}
+
+/** Propagate the settings negotiated by the media context to the stream of the plugin */
+static void mrcp_offload_stream_sync(mrcp_offload_stream_t *offload_stream)
+{
+	mpf_audio_stream_t *base = offload_stream->base;
+	mpf_audio_stream_t *plugin_stream = &offload_stream->plugin_stream;
+	plugin_stream->termination = base->termination;
+	plugin_stream->capabilities = base->capabilities;
+	plugin_stream->direction = base->direction;
+	plugin_stream->rx_descriptor = base->rx_descriptor;
+	plugin_stream->rx_event_descriptor = base->rx_event_descriptor;
+	plugin_stream->tx_descriptor = base->tx_descriptor;
+	plugin_stream->tx_event_descriptor = base->tx_event_descriptor;
+}
+
+/** Get the ring to exchange frames of the specified size with, reusing the current one, if possible (media thread) */
+static mrcp_frame_ring_t* mrcp_offload_ring_get(mrcp_offload_stream_t *offload_stream, mrcp_offload_direction_t *direction, apr_size_t capacity, apr_size_t frame_size)
+{
+	if(direction->ring && direction->ring->frame_size == frame_size) {
+		return direction->ring;
+	}
+	return mrcp_frame_ring_create(capacity,frame_size,offload_stream->pool);
+}
+
+/** Request the worker to open the plugin (media thread) */
+static apt_bool_t mrcp_offload_direction_open(mrcp_offload_stream_t *offload_stream, mrcp_offload_direction_t *direction, mpf_codec_t *codec, apr_size_t capacity, apr_size_t frame_size)
+{
+	mrcp_offload_worker_t *worker = offload_stream->worker;
+	for(;;) {
+		apr_uint32_t word = apr_atomic_read32(&direction->state);
+		switch(mrcp_offload_state_get(word)) {
+			case OFFLOAD_STATE_IDLE:
+			{
+				apt_bool_t status;
+				/* the worker doesn't access the ring, prepare it right away */
+				direction->ring = mrcp_offload_ring_get(offload_stream,direction,capacity,frame_size);
+				mrcp_frame_ring_reset(direction->ring);
+				direction->codec = codec;
+
+				/* link the stream to the worker, the guard is never held while calling the plugin */
+				apr_thread_mutex_lock(worker->guard);
+				status = mrcp_offload_state_transit(direction,word,OFFLOAD_STATE_OPENING);
+				if(status == TRUE && offload_stream->attached == FALSE) {
+					APR_RING_INSERT_TAIL(&worker->attach_list,offload_stream,mrcp_offload_stream_t,link);
+					offload_stream->attached = TRUE;
+				}
+				apr_thread_mutex_unlock(worker->guard);
+				if(status == TRUE) {
+					return TRUE;
+				}
+				break;
+			}
+			case OFFLOAD_STATE_CLOSING:
+				/* the worker is about to close the plugin, hand the settings over to reopen it then */
+				direction->pending_ring = mrcp_offload_ring_get(offload_stream,direction,capacity,frame_size);
+				direction->pending_codec = codec;
+				if(mrcp_offload_state_transit(direction,word,OFFLOAD_STATE_REOPENING) == TRUE) {
+					return TRUE;
+				}
+				break;
+			default:
+				apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Offloaded Stream is Already Open");
+				return FALSE;
+		}
+	}
+}
+
+/** Request the worker to close the plugin (media thread) */
+static apt_bool_t mrcp_offload_direction_close(mrcp_offload_direction_t *direction)
+{
+	for(;;) {
+		apr_uint32_t word = apr_atomic_read32(&direction->state);
+		switch(mrcp_offload_state_get(word)) {
+			case OFFLOAD_STATE_OPENING:
+			case OFFLOAD_STATE_ACTIVE:
+			case OFFLOAD_STATE_REOPENING:
+				if(mrcp_offload_state_transit(direction,word,OFFLOAD_STATE_CLOSING) == TRUE) {
+					return TRUE;
+				}
+				break;
+			default:
+				/* already closed or being closed */
+				return TRUE;
+		}
+	}
+}
+
+/** Open the plugin (worker thread) */
+static void mrcp_offload_plugin_open(mrcp_offload_stream_t *offload_stream, mrcp_offload_direction_t *direction)
+{
+	mrcp_offload_stream_sync(offload_stream);
+	if(direction == &offload_stream->rx) {
+		direction->plugin_opened = mpf_audio_stream_rx_open(&offload_stream->plugin_stream,direction->codec);
+	}
+	else {
+		direction->plugin_opened = mpf_audio_stream_tx_open(&offload_stream->plugin_stream,direction->codec);
+	}
+	if(direction->plugin_opened == FALSE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Open Offloaded Stream");
+	}
+}
+
+/** Read frames ahead from the plugin (worker thread) */
+static void mrcp_offload_plugin_read(mrcp_offload_stream_t *offload_stream)
+{
+	mrcp_frame_ring_t *ring = offload_stream->rx.ring;
+	mpf_frame_t *frame;
+	while((frame = mrcp_frame_ring_write_begin(ring)) != NULL) {
+		frame->type = MEDIA_FRAME_TYPE_NONE;
+		frame->marker = MPF_MARKER_NONE;
+		frame->codec_frame.size = ring->frame_size;
+		mpf_audio_stream_frame_read(&offload_stream->plugin_stream,frame);
+		/* publish the frame to the media thread */
+		mrcp_frame_ring_write_end(ring);
+	}
+}
+
+/** Write queued frames to the plugin (worker thread) */
+static void mrcp_offload_plugin_write(mrcp_offload_stream_t *offload_stream)
+{
+	mrcp_frame_ring_t *ring = offload_stream->tx.ring;
+	const mpf_frame_t *frame;
+	while((frame = mrcp_frame_ring_read_begin(ring)) != NULL) {
+		mpf_audio_stream_frame_write(&offload_stream->plugin_stream,frame);
+		/* release the entry to the media thread */
+		mrcp_frame_ring_read_end(ring);
+	}
+}
+
+/** Close the plugin, if open (worker thread) */
+static void mrcp_offload_plugin_close(mrcp_offload_stream_t *offload_stream, mrcp_offload_direction_t *direction)
+{
+	if(direction->plugin_opened == FALSE) {
+		return;
+	}
+	if(direction == &offload_stream->rx) {
+		/* frames read ahead, but not played yet, are discarded */
+		mpf_audio_stream_rx_close(&offload_stream->plugin_stream);
+	}
+	else {
+		/* frames queued, but not written yet, are delivered before the plugin is closed */
+		mrcp_offload_plugin_write(offload_stream);
+		mpf_audio_stream_tx_close(&offload_stream->plugin_stream);
+	}
+	direction->plugin_opened = FALSE;
+}
+
+/** Process open and close requests and exchange frames of the direction (worker thread) */
+static apr_uint32_t mrcp_offload_direction_process(mrcp_offload_stream_t *offload_stream, mrcp_offload_direction_t *direction)
+{
+	apr_uint32_t word = apr_atomic_read32(&direction->state);
+	switch(mrcp_offload_state_get(word)) {
+		case OFFLOAD_STATE_OPENING:
+			mrcp_offload_plugin_open(offload_stream,direction);
+			/* if the stream is being closed meanwhile, the plugin is closed on the next pass */
+			mrcp_offload_state_transit(direction,word,OFFLOAD_STATE_ACTIVE);
+			break;
+		case OFFLOAD_STATE_ACTIVE:
+			if(direction->plugin_opened == TRUE) {
+				if(direction == &offload_stream->rx) {
+					mrcp_offload_plugin_read(offload_stream);
+				}
+				else {
+					mrcp_offload_plugin_write(offload_stream);
+				}
+			}
+			break;
+		case OFFLOAD_STATE_CLOSING:
+			mrcp_offload_plugin_close(offload_stream,direction);
+			mrcp_offload_state_transit(direction,word,OFFLOAD_STATE_IDLE);
+			break;
+		case OFFLOAD_STATE_REOPENING:
+			mrcp_offload_plugin_close(offload_stream,direction);
+			/* the media thread doesn't access the ring until the stream is opening */
+			direction->ring = direction->pending_ring;
+			direction->codec = direction->pending_codec;
+			mrcp_frame_ring_reset(direction->ring);
+			mrcp_offload_state_transit(direction,word,OFFLOAD_STATE_OPENING);
+			break;
+		default:
+			break;
+	}
+	return mrcp_offload_state_get(apr_atomic_read32(&direction->state));
+}
+
+static void mrcp_offload_worker_timer_proc(apt_timer_t *timer, void *obj)
+{
+	mrcp_offload_worker_t *worker = obj;
+	mrcp_offload_stream_t *offload_stream;
+	mrcp_offload_stream_t *next_stream;
+	apt_bool_t detached = FALSE;
+
+	/* take the streams attached by the media thread */
+	apr_thread_mutex_lock(worker->guard);
+	APR_RING_CONCAT(&worker->stream_list,&worker->attach_list,mrcp_offload_stream_t,link);
+	apr_thread_mutex_unlock(worker->guard);
+
+	/* the plugin is called without holding any lock the media thread may take */
+	for(offload_stream = APR_RING_FIRST(&worker->stream_list);
+			offload_stream != APR_RING_SENTINEL(&worker->stream_list, mrcp_offload_stream_t, link);
+				offload_stream = next_stream) {
+		apr_uint32_t rx_state;
+		apr_uint32_t tx_state;
+		next_stream = APR_RING_NEXT(offload_stream, link);
+
+		rx_state = mrcp_offload_direction_process(offload_stream,&offload_stream->rx);
+		tx_state = mrcp_offload_direction_process(offload_stream,&offload_stream->tx);
+		if(rx_state != OFFLOAD_STATE_IDLE || tx_state != OFFLOAD_STATE_IDLE) {
+			continue;
+		}
+
+		/* both directions are closed, unlink the stream, unless reopened meanwhile */
+		apr_thread_mutex_lock(worker->guard);
+		if(mrcp_offload_state_get(apr_atomic_read32(&offload_stream->rx.state)) == OFFLOAD_STATE_IDLE &&
+			mrcp_offload_state_get(apr_atomic_read32(&offload_stream->tx.state)) == OFFLOAD_STATE_IDLE) {
+			APR_RING_REMOVE(offload_stream,link);
+			APR_RING_ELEM_INIT(offload_stream,link);
+			offload_stream->attached = FALSE;
+			detached = TRUE;
+		}
+		apr_thread_mutex_unlock(worker->guard);
+	}
+
+	if(detached == TRUE) {
+		apr_thread_mutex_lock(worker->guard);
+		apr_thread_cond_broadcast(worker->detached);
+		apr_thread_mutex_unlock(worker->guard);
+	}
+
+	apt_timer_set(timer,CODEC_FRAME_TIME_BASE);
+}
+
+static apt_bool_t mrcp_offload_stream_destroy(mpf_audio_stream_t *stream)
+{
+	mrcp_offload_stream_t *offload_stream = stream->obj;
+	return mpf_audio_stream_destroy(&offload_stream->plugin_stream);
+}
+
+static apt_bool_t mrcp_offload_stream_open_rx(mpf_audio_stream_t *stream, mpf_codec_t *codec)
+{
+	mrcp_offload_stream_t *offload_stream = stream->obj;
+	return mrcp_offload_direction_open(
+				offload_stream,
+				&offload_stream->rx,
+				codec,
+				offload_stream->offloader->lookahead,
+				mrcp_offload_frame_size_calculate(stream->rx_descriptor,codec));
+}
+
+static apt_bool_t mrcp_offload_stream_close_rx(mpf_audio_stream_t *stream)
+{
+	mrcp_offload_stream_t *offload_stream = stream->obj;
+	return mrcp_offload_direction_close(&offload_stream->rx);
+}
+
+static apt_bool_t mrcp_offload_stream_read_frame(mpf_audio_stream_t *stream, mpf_frame_t *frame)
+{
+	mrcp_offload_stream_t *offload_stream = stream->obj;
+	mrcp_offload_direction_t *direction = &offload_stream->rx;
+	const mpf_frame_t *entry;
+
+	if(mrcp_offload_state_get(apr_atomic_read32(&direction->state)) != OFFLOAD_STATE_ACTIVE) {
+		/* the plugin is being opened or closed by the worker */
+		frame->type = MEDIA_FRAME_TYPE_NONE;
+		return TRUE;
+	}
+
+	entry = mrcp_frame_ring_read_begin(direction->ring);
+	if(!entry) {
+		/* the worker is lagging behind, keep the timing */
+		apr_atomic_inc32(&offload_stream->offloader->underrun_count);
+		frame->type = MEDIA_FRAME_TYPE_NONE;
+		return TRUE;
+	}
+
+	mrcp_frame_copy(frame,entry,frame->codec_frame.size);
+	/* release the entry to the worker thread */
+	mrcp_frame_ring_read_end(direction->ring);
+	return TRUE;
+}
+
+static apt_bool_t mrcp_offload_stream_open_tx(mpf_audio_stream_t *stream, mpf_codec_t *codec)
+{
+	mrcp_offload_stream_t *offload_stream = stream->obj;
+	return mrcp_offload_direction_open(
+				offload_stream,
+				&offload_stream->tx,
+				codec,
+				offload_stream->offloader->delay,
+				mrcp_offload_frame_size_calculate(stream->tx_descriptor,codec));
+}
+
+static apt_bool_t mrcp_offload_stream_close_tx(mpf_audio_stream_t *stream)
+{
+	mrcp_offload_stream_t *offload_stream = stream->obj;
+	/* frames queued, but not written yet, are delivered by the worker before it closes the plugin */
+	return mrcp_offload_direction_close(&offload_stream->tx);
+}
+
+static apt_bool_t mrcp_offload_stream_write_frame(mpf_audio_stream_t *stream, const mpf_frame_t *frame)
+{
+	mrcp_offload_stream_t *offload_stream = stream->obj;
+	mrcp_offload_direction_t *direction = &offload_stream->tx;
+	apr_uint32_t state = mrcp_offload_state_get(apr_atomic_read32(&direction->state));
+	mpf_frame_t *entry;
+
+	if(state != OFFLOAD_STATE_OPENING && state != OFFLOAD_STATE_ACTIVE) {
+		/* the stream is closed or being closed */
+		return FALSE;
+	}
+
+	entry = mrcp_frame_ring_write_begin(direction->ring);
+	if(!entry) {
+		/* the plugin is lagging behind, drop the frame rather than block the media thread */
+		apr_atomic_inc32(&offload_stream->offloader->overrun_count);
+		return FALSE;
+	}
+
+	entry->codec_frame.size = 0;
+	mrcp_frame_copy(entry,frame,direction->ring->frame_size);
+	/* publish the frame to the worker thread */
+	mrcp_frame_ring_write_end(direction->ring);
+	return TRUE;
+}
+
+static void mrcp_offload_stream_trace(mpf_audio_stream_t *stream, mpf_stream_direction_e direction, apt_text_stream_t *output)
+{
+	mrcp_offload_stream_t *offload_stream = stream->obj;
+	if(offload_stream->plugin_stream.vtable->trace) {
+		offload_stream->plugin_stream.vtable->trace(&offload_stream->plugin_stream,direction,output);
+	}
+}
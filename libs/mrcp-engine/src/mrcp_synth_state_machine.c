@@ -24,6 +24,7 @@
 #include "mrcp_generic_header.h"
 #include "mrcp_synth_resource.h"
 #include "mrcp_message.h"
+#include "mrcp_property_store.h"
 
 /** MRCP synthesizer states */
 typedef enum {
@@ -55,7 +56,7 @@ struct mrcp_synth_state_machine_t {
 	/** queue of pending speak requests */
 	apt_obj_list_t        *queue;
 	/** properties used in set/get params */
-	mrcp_message_header_t *properties;
+	mrcp_property_store_t *properties;
 };
 
 typedef apt_bool_t (*synth_method_f)(mrcp_synth_state_machine_t *state_machine, mrcp_message_t *message);
@@ -100,7 +101,7 @@ static APR_INLINE void synth_state_change(mrcp_synth_state_machine_t *state_mach
 
 static apt_bool_t synth_request_set_params(mrcp_synth_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_set(state_machine->properties,&message->header,message->pool);
+	mrcp_property_store_set(state_machine->properties,message);
 	return synth_request_dispatch(state_machine,message);
 }
 
@@ -116,13 +117,13 @@ static apt_bool_t synth_request_get_params(mrcp_synth_state_machine_t *state_mac
 
 static apt_bool_t synth_response_get_params(mrcp_synth_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_get(&message->header,state_machine->properties,&state_machine->active_request->header,message->pool);
+	mrcp_property_store_get(state_machine->properties,message,state_machine->active_request);
 	return synth_response_dispatch(state_machine,message);
 }
 
 static apt_bool_t synth_request_speak(mrcp_synth_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_inherit(&message->header,state_machine->properties,message->pool);
+	mrcp_property_store_inherit(state_machine->properties,message);
 	if(state_machine->speaker) {
 		mrcp_message_t *response;
 		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Queue Up SPEAK Request "APT_SIDRES_FMT" [%"MRCP_REQUEST_ID_FMT"]",
@@ -604,7 +605,7 @@ mrcp_state_machine_t* mrcp_synth_state_machine_create(void *obj, mrcp_version_e
 	state_machine->active_request = NULL;
 	state_machine->speaker = NULL;
 	state_machine->queue = apt_list_create(pool);
-	state_machine->properties = mrcp_message_header_create(
+	state_machine->properties = mrcp_property_store_create(
 			mrcp_generic_header_vtable_get(version),
 			mrcp_synth_header_vtable_get(version),
 			pool);
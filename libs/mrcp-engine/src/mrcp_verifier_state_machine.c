@@ -23,6 +23,7 @@
 #include "mrcp_verifier_header.h"
 #include "mrcp_verifier_resource.h"
 #include "mrcp_message.h"
+#include "mrcp_property_store.h"
 
 /** MRCP verifier states */
 typedef enum {
@@ -51,7 +52,7 @@ struct mrcp_verifier_state_machine_t {
 	/** in-progress verify request */
 	mrcp_message_t        *verify;
 	/** properties used in set/get params */
-	mrcp_message_header_t *properties;
+	mrcp_property_store_t *properties;
 };
 
 typedef apt_bool_t (*verifier_method_f)(mrcp_verifier_state_machine_t *state_machine, mrcp_message_t *message);
@@ -96,7 +97,7 @@ static APR_INLINE void verifier_state_change(mrcp_verifier_state_machine_t *stat
 
 static apt_bool_t verifier_request_set_params(mrcp_verifier_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_set(state_machine->properties,&message->header,message->pool);
+	mrcp_property_store_set(state_machine->properties,message);
 	return verifier_request_dispatch(state_machine,message);
 }
 
@@ -112,7 +113,7 @@ static apt_bool_t verifier_request_get_params(mrcp_verifier_state_machine_t *sta
 
 static apt_bool_t verifier_response_get_params(mrcp_verifier_state_machine_t *state_machine, mrcp_message_t *message)
 {
-	mrcp_header_fields_get(&message->header,state_machine->properties,&state_machine->active_request->header,message->pool);
+	mrcp_property_store_get(state_machine->properties,message,state_machine->active_request);
 	return verifier_response_dispatch(state_machine,message);
 }
 
@@ -516,7 +517,7 @@ mrcp_state_machine_t* mrcp_verifier_state_machine_create(void *obj, mrcp_version
 	state_machine->state = VERIFIER_STATE_IDLE;
 	state_machine->active_request = NULL;
 	state_machine->verify = NULL;
-	state_machine->properties = mrcp_message_header_create(
+	state_machine->properties = mrcp_property_store_create(
 			mrcp_generic_header_vtable_get(version),
 			mrcp_verifier_header_vtable_get(version),
 			pool);
@@ -25,6 +25,7 @@
  */ 
 
 #include "mrcp_server_types.h"
+#include "mrcp_server_admission.h"
 #include "mrcp_engine_iface.h"
 #include "mpf_rtp_descriptor.h"
 #include "apt_task.h"
@@ -82,6 +83,29 @@ MRCP_DECLARE(apt_bool_t) mrcp_server_engine_register(
  */
 MRCP_DECLARE(apt_bool_t) mrcp_server_codec_manager_register(mrcp_server_t *server, mpf_codec_manager_t *codec_manager);
 
+/**
+ * Register content cache shared by the engines.
+ * @param server the MRCP server to set content cache for
+ * @param content_cache the content cache to set
+ * @remark The server takes ownership of the cache and destroys it on mrcp_server_destroy().
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_server_content_cache_register(mrcp_server_t *server, mrcp_content_cache_t *content_cache);
+
+/**
+ * Get registered content cache.
+ * @param server the MRCP server to get content cache from
+ */
+MRCP_DECLARE(mrcp_content_cache_t*) mrcp_server_content_cache_get(const mrcp_server_t *server);
+
+/**
+ * Register load-aware admission controller.
+ * @param server the MRCP server to set admission controller for
+ * @param controller the admission controller to set
+ * @remark Sessions offered while the server is overloaded are answered with
+ *         MRCP_SESSION_STATUS_OVERLOADED (SIP/RTSP 503 Service Unavailable).
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_server_admission_controller_register(mrcp_server_t *server, mrcp_admission_controller_t *controller);
+
 /**
  * Get registered codec manager.
  * @param server the MRCP server to get codec manager from
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifndef MRCP_SERVER_ADMISSION_H
+#define MRCP_SERVER_ADMISSION_H
+
+/**
+ * @file mrcp_server_admission.h
+ * @brief Load-aware Admission Control of MRCP Sessions and Engine Channels
+ */ 
+
+#include "mrcp_engine_types.h"
+#include "mpf_engine.h"
+
+APT_BEGIN_EXTERN_C
+
+/** Opaque admission controller declaration */
+typedef struct mrcp_admission_controller_t mrcp_admission_controller_t;
+/** Admission control config declaration */
+typedef struct mrcp_admission_config_t mrcp_admission_config_t;
+
+/** Admission control config (thresholds set to 0 are not checked) */
+struct mrcp_admission_config_t {
+	/** Max number of simultaneous sessions */
+	apr_size_t max_session_count;
+	/** Max number of messages pending in the queue of the server task */
+	apr_size_t max_queue_size;
+	/** Max number of media ticks per second processed a whole period late */
+	apr_size_t max_tick_overrun_rate;
+	/** Max number of requests pending in an engine, new channels of the engine are rejected beyond */
+	apr_size_t max_pending_request_count;
+	/** Percentage of the thresholds the load must fall below to leave the overload state */
+	apr_size_t low_watermark;
+	/** Interval the tick overrun rate is measured over (msec) */
+	apr_size_t check_interval;
+};
+
+/**
+ * Allocate admission control config with the default values.
+ * @param pool the pool to allocate memory from
+ */
+MRCP_DECLARE(mrcp_admission_config_t*) mrcp_admission_config_alloc(apr_pool_t *pool);
+
+/**
+ * Create admission controller.
+ * @param config the config to use
+ * @param pool the pool to allocate memory from
+ * @remark The controller is not thread-safe, it's supposed to be used from the server task only.
+ */
+MRCP_DECLARE(mrcp_admission_controller_t*) mrcp_admission_controller_create(const mrcp_admission_config_t *config, apr_pool_t *pool);
+
+/**
+ * Check whether a new session can be admitted.
+ * @param controller the admission controller
+ * @param media_engine the media engine the session is going to use (optional)
+ * @param session_count the number of sessions currently in progress
+ * @param queue_size the number of messages pending in the queue of the server task
+ * @return TRUE to admit the session, FALSE to reject it
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_admission_session_check(
+								mrcp_admission_controller_t *controller,
+								mpf_engine_t *media_engine,
+								apr_size_t session_count,
+								apr_size_t queue_size);
+
+/**
+ * Check whether a new channel of the engine can be admitted.
+ * @param controller the admission controller
+ * @param engine the engine to check the pending work of
+ * @return TRUE to admit the channel, FALSE to reject it
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_admission_engine_check(mrcp_admission_controller_t *controller, const mrcp_engine_t *engine);
+
+/**
+ * Get the number of sessions and channels rejected so far.
+ * @param controller the admission controller
+ */
+MRCP_DECLARE(apr_size_t) mrcp_admission_rejected_count_get(const mrcp_admission_controller_t *controller);
+
+APT_END_EXTERN_C
+
+#endif /* MRCP_SERVER_ADMISSION_H */
@@ -18,6 +18,7 @@
 
 #include "mrcp_server.h"
 #include "mrcp_server_session.h"
+#include "mrcp_server_admission.h"
 #include "mrcp_message.h"
 #include "mrcp_resource_factory.h"
 #include "mrcp_resource.h"
@@ -47,6 +48,10 @@ struct mrcp_server_t {
 
 	/** Codec manager */
 	mpf_codec_manager_t     *codec_manager;
+	/** Content cache shared by the engines */
+	mrcp_content_cache_t    *content_cache;
+	/** Load-aware admission controller (optional) */
+	mrcp_admission_controller_t *admission_controller;
 	/** Table of media processing engines (mpf_engine_t*) */
 	apr_hash_t              *media_engine_table;
 	/** Table of RTP termination factories (mpf_termination_factory_t*) */
@@ -195,6 +200,8 @@ MRCP_DECLARE(mrcp_server_t*) mrcp_server_create(apt_dir_layout_t *dir_layout)
 	server->resource_factory = NULL;
 	server->engine_factory = NULL;
 	server->engine_loader = NULL;
+	server->content_cache = NULL;
+	server->admission_controller = NULL;
 	server->media_engine_table = NULL;
 	server->rtp_factory_table = NULL;
 	server->sig_agent_table = NULL;
@@ -235,6 +242,9 @@ MRCP_DECLARE(mrcp_server_t*) mrcp_server_create(apt_dir_layout_t *dir_layout)
 	server->profile_table = apr_hash_make(server->pool);
 	
 	server->session_table = apr_hash_make(server->pool);
+
+	/* recycle pools of sessions and connections */
+	apt_pool_cache_create(APT_POOL_CACHE_MAX_COUNT,APT_POOL_CACHE_MAX_FREE_SIZE);
 	return server;
 }
 
@@ -284,6 +294,11 @@ MRCP_DECLARE(apt_bool_t) mrcp_server_destroy(mrcp_server_t *server)
 		return FALSE;
 	}
 
+	if(server->content_cache) {
+		/* entries hold destroy callbacks of plugins, release them before the plugins are unloaded */
+		mrcp_content_cache_destroy(server->content_cache);
+		server->content_cache = NULL;
+	}
 	mrcp_engine_factory_destroy(server->engine_factory);
 	mrcp_engine_loader_destroy(server->engine_loader);
 
@@ -291,6 +306,7 @@ MRCP_DECLARE(apt_bool_t) mrcp_server_destroy(mrcp_server_t *server)
 	apt_task_destroy(task);
 
 	apr_pool_destroy(server->pool);
+	apt_pool_cache_destroy();
 	return TRUE;
 }
 
@@ -317,6 +333,7 @@ MRCP_DECLARE(apt_bool_t) mrcp_server_engine_register(mrcp_server_t *server, mrcp
 	}
 	engine->codec_manager = server->codec_manager;
 	engine->dir_layout = server->dir_layout;
+	engine->content_cache = server->content_cache;
 	engine->event_vtable = &engine_vtable;
 	engine->event_obj = server;
 	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Register MRCP Engine [%s]",engine->id);
@@ -333,6 +350,47 @@ MRCP_DECLARE(apt_bool_t) mrcp_server_codec_manager_register(mrcp_server_t *serve
 	return TRUE;
 }
 
+/** Register content cache */
+MRCP_DECLARE(apt_bool_t) mrcp_server_content_cache_register(mrcp_server_t *server, mrcp_content_cache_t *content_cache)
+{
+	mrcp_engine_t *engine;
+	apr_hash_index_t *it;
+	void *val;
+	if(!content_cache) {
+		return FALSE;
+	}
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Register Content Cache");
+	server->content_cache = content_cache;
+
+	/* let already registered engines use the cache either */
+	it = mrcp_engine_factory_engine_first(server->engine_factory);
+	for(; it; it = apr_hash_next(it)) {
+		apr_hash_this(it,NULL,NULL,&val);
+		engine = val;
+		if(engine) {
+			engine->content_cache = content_cache;
+		}
+	}
+	return TRUE;
+}
+
+/** Get registered content cache */
+MRCP_DECLARE(mrcp_content_cache_t*) mrcp_server_content_cache_get(const mrcp_server_t *server)
+{
+	return server->content_cache;
+}
+
+/** Register admission controller */
+MRCP_DECLARE(apt_bool_t) mrcp_server_admission_controller_register(mrcp_server_t *server, mrcp_admission_controller_t *controller)
+{
+	if(!controller) {
+		return FALSE;
+	}
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Register Admission Controller");
+	server->admission_controller = controller;
+	return TRUE;
+}
+
 /** Get registered codec manager */
 MRCP_DECLARE(const mpf_codec_manager_t*) mrcp_server_codec_manager_get(const mrcp_server_t *server)
 {
@@ -614,6 +672,28 @@ void mrcp_server_session_remove(mrcp_server_session_t *session)
 	}
 }
 
+apt_bool_t mrcp_server_session_admit(mrcp_server_session_t *session)
+{
+	mrcp_server_t *server = session->server;
+	if(!server->admission_controller) {
+		return TRUE;
+	}
+	return mrcp_admission_session_check(
+				server->admission_controller,
+				session->profile->media_engine,
+				apr_hash_count(server->session_table),
+				apt_consumer_task_queue_size_get(server->task));
+}
+
+apt_bool_t mrcp_server_engine_admit(mrcp_server_session_t *session, const mrcp_engine_t *engine)
+{
+	mrcp_server_t *server = session->server;
+	if(!server->admission_controller) {
+		return TRUE;
+	}
+	return mrcp_admission_engine_check(server->admission_controller,engine);
+}
+
 static APR_INLINE mrcp_server_session_t* mrcp_server_session_find(mrcp_server_t *server, const apt_str_t *session_id)
 {
 	return apr_hash_get(server->session_table,session_id->buf,session_id->length);
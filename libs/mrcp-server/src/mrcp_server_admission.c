@@ -0,0 +1,217 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include <apr_hash.h>
+#include "mrcp_server_admission.h"
+#include "apt_log.h"
+
+#define DEFAULT_LOW_WATERMARK   80    /* percent */
+#define DEFAULT_CHECK_INTERVAL  1000  /* msec */
+
+/** Load meter of a media engine or an MRCP engine */
+typedef struct mrcp_admission_meter_t mrcp_admission_meter_t;
+
+struct mrcp_admission_meter_t {
+	/** Object the load is metered of (used as the key) */
+	const void  *source;
+	/** Cumulative counter sampled last */
+	apr_uint32_t last_count;
+	/** Time the counter was sampled at */
+	apr_time_t   last_time;
+	/** Rate measured over the last interval (per second) */
+	apr_size_t   rate;
+	/** Overload state of the source */
+	apt_bool_t   overloaded;
+};
+
+/** Admission controller */
+struct mrcp_admission_controller_t {
+	/** Config */
+	mrcp_admission_config_t config;
+	/** Overload state of the server */
+	apt_bool_t              overloaded;
+	/** Table of load meters (mrcp_admission_meter_t*) */
+	apr_hash_t             *meter_table;
+	/** Number of rejected sessions and channels */
+	apr_size_t              rejected_count;
+	/** Memory pool */
+	apr_pool_t             *pool;
+};
+
+/** Allocate admission control config */
+MRCP_DECLARE(mrcp_admission_config_t*) mrcp_admission_config_alloc(apr_pool_t *pool)
+{
+	mrcp_admission_config_t *config = apr_palloc(pool,sizeof(mrcp_admission_config_t));
+	config->max_session_count = 0;
+	config->max_queue_size = 0;
+	config->max_tick_overrun_rate = 0;
+	config->max_pending_request_count = 0;
+	config->low_watermark = DEFAULT_LOW_WATERMARK;
+	config->check_interval = DEFAULT_CHECK_INTERVAL;
+	return config;
+}
+
+/** Create admission controller */
+MRCP_DECLARE(mrcp_admission_controller_t*) mrcp_admission_controller_create(const mrcp_admission_config_t *config, apr_pool_t *pool)
+{
+	mrcp_admission_controller_t *controller = apr_palloc(pool,sizeof(mrcp_admission_controller_t));
+	controller->config = *config;
+	if(!controller->config.low_watermark || controller->config.low_watermark > 100) {
+		controller->config.low_watermark = DEFAULT_LOW_WATERMARK;
+	}
+	if(!controller->config.check_interval) {
+		controller->config.check_interval = DEFAULT_CHECK_INTERVAL;
+	}
+	controller->overloaded = FALSE;
+	controller->meter_table = apr_hash_make(pool);
+	controller->rejected_count = 0;
+	controller->pool = pool;
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Create Admission Controller [sessions:%"APR_SIZE_T_FMT" queue:%"APR_SIZE_T_FMT" overruns:%"APR_SIZE_T_FMT"/s pending:%"APR_SIZE_T_FMT" low:%"APR_SIZE_T_FMT"%%]",
+		controller->config.max_session_count,
+		controller->config.max_queue_size,
+		controller->config.max_tick_overrun_rate,
+		controller->config.max_pending_request_count,
+		controller->config.low_watermark);
+	return controller;
+}
+
+static mrcp_admission_meter_t* mrcp_admission_meter_get(mrcp_admission_controller_t *controller, const void *source)
+{
+	mrcp_admission_meter_t *meter = apr_hash_get(controller->meter_table,&source,sizeof(source));
+	if(!meter) {
+		meter = apr_palloc(controller->pool,sizeof(mrcp_admission_meter_t));
+		meter->source = source;
+		meter->last_count = 0;
+		meter->last_time = 0;
+		meter->rate = 0;
+		meter->overloaded = FALSE;
+		apr_hash_set(controller->meter_table,&meter->source,sizeof(meter->source),meter);
+	}
+	return meter;
+}
+
+/** Sample the cumulative counter and return the rate measured over the last complete interval */
+static apr_size_t mrcp_admission_meter_update(const mrcp_admission_controller_t *controller, mrcp_admission_meter_t *meter, apr_uint32_t count)
+{
+	apr_time_t now = apr_time_now();
+	apr_interval_time_t elapsed;
+	if(!meter->last_time) {
+		meter->last_count = count;
+		meter->last_time = now;
+		return meter->rate;
+	}
+
+	elapsed = apr_time_as_msec(now - meter->last_time);
+	if(elapsed >= (apr_interval_time_t)controller->config.check_interval) {
+		meter->rate = (apr_size_t)((apr_uint32_t)(count - meter->last_count) * 1000 / elapsed);
+		meter->last_count = count;
+		meter->last_time = now;
+	}
+	return meter->rate;
+}
+
+/** Check the value against the threshold, applying the low watermark while in overload state */
+static APR_INLINE apt_bool_t mrcp_admission_threshold_exceeded(
+								const mrcp_admission_controller_t *controller,
+								apr_size_t value,
+								apr_size_t threshold,
+								apt_bool_t overloaded)
+{
+	if(!threshold) {
+		return FALSE;
+	}
+	if(overloaded == TRUE) {
+		return value * 100 > threshold * controller->config.low_watermark ? TRUE : FALSE;
+	}
+	return value >= threshold ? TRUE : FALSE;
+}
+
+/** Check whether a new session can be admitted */
+MRCP_DECLARE(apt_bool_t) mrcp_admission_session_check(
+								mrcp_admission_controller_t *controller,
+								mpf_engine_t *media_engine,
+								apr_size_t session_count,
+								apr_size_t queue_size)
+{
+	apt_bool_t overloaded;
+	apr_size_t overrun_rate = 0;
+	if(media_engine && controller->config.max_tick_overrun_rate) {
+		mrcp_admission_meter_t *meter = mrcp_admission_meter_get(controller,media_engine);
+		overrun_rate = mrcp_admission_meter_update(controller,meter,mpf_engine_overrun_count_get(media_engine));
+	}
+
+	overloaded = 
+		mrcp_admission_threshold_exceeded(controller,session_count,controller->config.max_session_count,controller->overloaded) ||
+		mrcp_admission_threshold_exceeded(controller,queue_size,controller->config.max_queue_size,controller->overloaded) ||
+		mrcp_admission_threshold_exceeded(controller,overrun_rate,controller->config.max_tick_overrun_rate,controller->overloaded);
+
+	if(overloaded != controller->overloaded) {
+		apt_log(APT_LOG_MARK,overloaded == TRUE ? APT_PRIO_WARNING : APT_PRIO_NOTICE,
+			"%s Overload State [sessions:%"APR_SIZE_T_FMT" queue:%"APR_SIZE_T_FMT" overruns:%"APR_SIZE_T_FMT"/s]",
+			overloaded == TRUE ? "Enter" : "Leave",
+			session_count,
+			queue_size,
+			overrun_rate);
+		controller->overloaded = overloaded;
+	}
+
+	if(overloaded == TRUE) {
+		controller->rejected_count++;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/** Check whether a new channel of the engine can be admitted */
+MRCP_DECLARE(apt_bool_t) mrcp_admission_engine_check(mrcp_admission_controller_t *controller, const mrcp_engine_t *engine)
+{
+	mrcp_admission_meter_t *meter;
+	apt_bool_t overloaded;
+	if(!controller->config.max_pending_request_count) {
+		return TRUE;
+	}
+
+	meter = mrcp_admission_meter_get(controller,engine);
+	overloaded = mrcp_admission_threshold_exceeded(
+					controller,
+					engine->pending_request_count,
+					controller->config.max_pending_request_count,
+					meter->overloaded);
+	if(overloaded != meter->overloaded) {
+		apt_log(APT_LOG_MARK,overloaded == TRUE ? APT_PRIO_WARNING : APT_PRIO_NOTICE,
+			"%s Overload State [%s] [pending:%"APR_SIZE_T_FMT" channels:%"APR_SIZE_T_FMT"]",
+			overloaded == TRUE ? "Enter" : "Leave",
+			engine->id,
+			engine->pending_request_count,
+			engine->cur_channel_count);
+		meter->overloaded = overloaded;
+	}
+
+	if(overloaded == TRUE) {
+		controller->rejected_count++;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/** Get the number of sessions and channels rejected so far */
+MRCP_DECLARE(apr_size_t) mrcp_admission_rejected_count_get(const mrcp_admission_controller_t *controller)
+{
+	return controller->rejected_count;
+}
@@ -59,6 +59,20 @@ struct mrcp_channel_t {
 	apt_bool_t              waiting_for_channel;
 	/** waiting state of media termination */
 	apt_bool_t              waiting_for_termination;
+	/** table of templates of responses and events (mrcp_start_line_template_t*) */
+	apr_hash_t             *message_templates;
+	/** number of requests dispatched to the engine channel and not responded yet */
+	apr_size_t              pending_request_count;
+};
+
+/** Key of response and event templates */
+typedef struct mrcp_message_template_key_t mrcp_message_template_key_t;
+
+struct mrcp_message_template_key_t {
+	mrcp_message_type_e  message_type;
+	mrcp_method_id       method_id;
+	mrcp_status_code_e   status_code;
+	mrcp_request_state_e request_state;
 };
 
 typedef struct mrcp_termination_slot_t mrcp_termination_slot_t;
@@ -81,6 +95,8 @@ extern const mrcp_engine_channel_event_vtable_t engine_channel_vtable;
 
 void mrcp_server_session_add(mrcp_server_session_t *session);
 void mrcp_server_session_remove(mrcp_server_session_t *session);
+apt_bool_t mrcp_server_session_admit(mrcp_server_session_t *session);
+apt_bool_t mrcp_server_engine_admit(mrcp_server_session_t *session, const mrcp_engine_t *engine);
 
 static apt_bool_t mrcp_server_signaling_message_dispatch(mrcp_server_session_t *session, mrcp_signaling_message_t *signaling_message);
 
@@ -137,6 +153,14 @@ static mrcp_engine_channel_t* mrcp_server_engine_channel_create(
 		return NULL;
 	}
 
+	if(mrcp_server_engine_admit(session,engine) == FALSE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Reject Engine Channel "APT_NAMESID_FMT" [%s] Overloaded",
+			MRCP_SESSION_NAMESID(session),
+			resource_name->buf);
+		session->answer->status = MRCP_SESSION_STATUS_OVERLOADED;
+		return NULL;
+	}
+
 	channel->state_machine = engine->create_state_machine(
 						channel,
 						mrcp_session_version_get(session),
@@ -165,6 +189,8 @@ static mrcp_channel_t* mrcp_server_channel_create(mrcp_server_session_t *session
 	channel->cmid_arr = cmid_arr;
 	channel->waiting_for_channel = FALSE;
 	channel->waiting_for_termination = FALSE;
+	channel->message_templates = NULL;
+	channel->pending_request_count = 0;
 
 	if(resource_name && resource_name->buf) {
 		mrcp_resource_t *resource;
@@ -189,7 +215,9 @@ static mrcp_channel_t* mrcp_server_channel_create(mrcp_server_session_t *session
 				apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Engine Channel "APT_NAMESID_FMT" [%s]",
 					MRCP_SESSION_NAMESID(session),
 					resource_name->buf);
-				session->answer->status = MRCP_SESSION_STATUS_UNACCEPTABLE_RESOURCE;
+				if(session->answer->status == MRCP_SESSION_STATUS_OK) {
+					session->answer->status = MRCP_SESSION_STATUS_UNACCEPTABLE_RESOURCE;
+				}
 			}
 		}
 		else {
@@ -351,6 +379,10 @@ apt_bool_t mrcp_server_on_engine_channel_message(mrcp_channel_t *channel, mrcp_m
 	if(!channel->state_machine) {
 		return FALSE;
 	}
+	if(message->start_line.message_type == MRCP_MESSAGE_TYPE_RESPONSE && channel->pending_request_count) {
+		channel->pending_request_count--;
+		channel->engine_channel->engine->pending_request_count--;
+	}
 	/* update state machine */
 	return mrcp_state_machine_update(channel->state_machine,message);
 }
@@ -381,15 +413,32 @@ static mrcp_session_descriptor_t* mrcp_session_answer_create(mrcp_session_descri
 	return answer;
 }
 
+static apt_bool_t mrcp_server_session_reject(mrcp_server_session_t *session, mrcp_session_descriptor_t *descriptor, mrcp_session_status_e status)
+{
+	/* answer the offer right away, no resources have been allocated yet */
+	session->offer = descriptor;
+	session->answer = mrcp_session_answer_create(descriptor,session->base.pool);
+	session->answer->status = status;
+	mrcp_server_session_state_set(session,SESSION_STATE_GENERATING_ANSWER);
+	return mrcp_server_session_answer_send(session);
+}
+
 static apt_bool_t mrcp_server_session_offer_process(mrcp_server_session_t *session, mrcp_session_descriptor_t *descriptor)
 {
 	if(!session->context) {
 		/* initial offer received, generate session id and add to session's table */
+		apt_bool_t admitted = mrcp_server_session_admit(session);
 		if(!session->base.id.length) {
 			apt_unique_id_generate(&session->base.id,MRCP_SESSION_ID_HEX_STRING_LENGTH,session->base.pool);
 		}
 		mrcp_server_session_add(session);
 
+		if(admitted == FALSE) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Reject Offer "APT_NAMESID_FMT" Overloaded",
+				MRCP_SESSION_NAMESID(session));
+			return mrcp_server_session_reject(session,descriptor,MRCP_SESSION_STATUS_OVERLOADED);
+		}
+
 		session->context = mpf_engine_context_create(
 			session->profile->media_engine,
 			session->base.name,
@@ -983,10 +1032,18 @@ static apt_bool_t mrcp_server_session_terminate_send(mrcp_server_session_t *sess
 			channel->control_channel = NULL;
 		}
 		if(channel->engine_channel) {
+			/* requests never responded by the engine are no longer pending */
+			channel->engine_channel->engine->pending_request_count -= channel->pending_request_count;
+			channel->pending_request_count = 0;
 			mrcp_engine_channel_virtual_destroy(channel->engine_channel);
 			channel->engine_channel = NULL;
 		}
 	}
+	if(session->context) {
+		/* the media engine has responded to all the requests, recycle the context */
+		mpf_engine_context_destroy(session->context);
+		session->context = NULL;
+	}
 	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Session Terminated "APT_NAMESID_FMT,MRCP_SESSION_NAMESID(session));
 	mrcp_session_terminate_response(&session->base);
 	return TRUE;
@@ -1141,6 +1198,41 @@ apt_bool_t mrcp_server_mpf_message_process(mpf_message_container_t *mpf_message_
 	return TRUE;
 }
 
+/** Attach pre-rendered template of start-line and channel-identifier to MRCPv2 response or event */
+static void mrcp_server_message_template_attach(mrcp_channel_t *channel, mrcp_message_t *message)
+{
+	mrcp_start_line_template_t *tmpl;
+	mrcp_message_template_key_t key;
+
+	/* responses differ by status code and request state, events by name and request state */
+	memset(&key,0,sizeof(key));
+	key.message_type = message->start_line.message_type;
+	key.request_state = message->start_line.request_state;
+	if(key.message_type == MRCP_MESSAGE_TYPE_RESPONSE) {
+		key.status_code = message->start_line.status_code;
+	}
+	else {
+		key.method_id = message->start_line.method_id;
+	}
+
+	if(!channel->message_templates) {
+		channel->message_templates = apr_hash_make(channel->pool);
+	}
+
+	tmpl = apr_hash_get(channel->message_templates,&key,sizeof(key));
+	if(!tmpl) {
+		mrcp_message_template_key_t *stored_key;
+		tmpl = mrcp_message_template_create(message,channel->pool);
+		if(!tmpl) {
+			return;
+		}
+		stored_key = apr_palloc(channel->pool,sizeof(key));
+		*stored_key = key;
+		apr_hash_set(channel->message_templates,stored_key,sizeof(key),tmpl);
+	}
+	message->start_line_template = tmpl;
+}
+
 static apt_bool_t state_machine_on_message_dispatch(mrcp_state_machine_t *state_machine, mrcp_message_t *message)
 {
 	mrcp_channel_t *channel = state_machine->obj;
@@ -1148,6 +1240,8 @@ static apt_bool_t state_machine_on_message_dispatch(mrcp_state_machine_t *state_
 	if(message->start_line.message_type == MRCP_MESSAGE_TYPE_REQUEST) {
 		/* send request message to engine for actual processing */
 		if(channel->engine_channel) {
+			channel->pending_request_count++;
+			channel->engine_channel->engine->pending_request_count++;
 			mrcp_engine_channel_request_process(channel->engine_channel,message);
 		}
 	}
@@ -1156,6 +1250,7 @@ static apt_bool_t state_machine_on_message_dispatch(mrcp_state_machine_t *state_
 		/* send response message to client */
 		if(channel->control_channel) {
 			/* MRCPv2 */
+			mrcp_server_message_template_attach(channel,message);
 			mrcp_server_control_message_send(channel->control_channel,message);
 		}
 		else {
@@ -1172,6 +1267,7 @@ static apt_bool_t state_machine_on_message_dispatch(mrcp_state_machine_t *state_
 		/* send event message to client */
 		if(channel->control_channel) {
 			/* MRCPv2 */
+			mrcp_server_message_template_attach(channel,message);
 			mrcp_server_control_message_send(channel->control_channel,message);
 		}
 		else {
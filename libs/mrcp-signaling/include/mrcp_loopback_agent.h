@@ -0,0 +1,54 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifndef MRCP_LOOPBACK_AGENT_H
+#define MRCP_LOOPBACK_AGENT_H
+
+/**
+ * @file mrcp_loopback_agent.h
+ * @brief In-Process Loopback Signaling Agents
+ */ 
+
+#include "mrcp_sig_agent.h"
+
+APT_BEGIN_EXTERN_C
+
+/**
+ * Create loopback server signaling agent.
+ * @param id the agent identifier
+ * @param pool the pool to allocate memory from
+ * @remark The agent is registered with the server as any other signaling agent.
+ */
+MRCP_DECLARE(mrcp_sig_agent_t*) mrcp_loopback_server_agent_create(const char *id, apr_pool_t *pool);
+
+/**
+ * Create loopback client signaling agent.
+ * @param id the agent identifier
+ * @param server_agent the loopback server agent to deliver requests to
+ * @param pool the pool to allocate memory from
+ * @remark Sessions of the client profiles using the agent are set up with the server
+ *         the server agent is registered with, in the same process and without any sockets.
+ *         Control messages are conveyed over the signaling agents, so the profiles must be
+ *         created without connection agent (MRCPv1 style), and the same loopback
+ *         termination factory should be assigned to both client and server profiles.
+ */
+MRCP_DECLARE(mrcp_sig_agent_t*) mrcp_loopback_client_agent_create(const char *id, mrcp_sig_agent_t *server_agent, apr_pool_t *pool);
+
+APT_END_EXTERN_C
+
+#endif /* MRCP_LOOPBACK_AGENT_H */
@@ -35,7 +35,8 @@ typedef enum {
 	MRCP_SESSION_STATUS_NO_SUCH_RESOURCE,     /**< no such resource found */
 	MRCP_SESSION_STATUS_UNACCEPTABLE_RESOURCE,/**< resource exists, but no implementation (plugin) found */
 	MRCP_SESSION_STATUS_UNAVAILABLE_RESOURCE, /**< resource exists, but is temporary unavailable */
-	MRCP_SESSION_STATUS_ERROR                 /**< internal error occurred */
+	MRCP_SESSION_STATUS_ERROR,                /**< internal error occurred */
+	MRCP_SESSION_STATUS_OVERLOADED            /**< server is overloaded and cannot admit the session */
 } mrcp_session_status_e;
 
 /** MRCP session descriptor */
@@ -0,0 +1,494 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include "mrcp_loopback_agent.h"
+#include "mrcp_session.h"
+#include "mrcp_session_descriptor.h"
+#include "mrcp_message.h"
+#include "mrcp_resource_factory.h"
+#include "mrcp_resource.h"
+#include "apt_consumer_task.h"
+#include "apt_log.h"
+
+typedef struct mrcp_loopback_agent_t mrcp_loopback_agent_t;
+typedef struct mrcp_loopback_session_t mrcp_loopback_session_t;
+typedef struct loopback_task_msg_data_t loopback_task_msg_data_t;
+
+/** Loopback signaling agent */
+struct mrcp_loopback_agent_t {
+	/** Base signaling agent */
+	mrcp_sig_agent_t      *sig_agent;
+	/** Consumer task the agent messages are processed in */
+	apt_consumer_task_t   *task;
+	/** Server agent to deliver requests to (client agent only) */
+	mrcp_loopback_agent_t *server_agent;
+};
+
+/** Pair of client and server sessions linked together */
+struct mrcp_loopback_session_t {
+	/** Client agent */
+	mrcp_loopback_agent_t *client_agent;
+	/** Server agent */
+	mrcp_loopback_agent_t *server_agent;
+	/** Client session */
+	mrcp_session_t        *client_session;
+	/** Server session (created on the first request) */
+	mrcp_session_t        *server_session;
+};
+
+/** Type of loopback task message */
+typedef enum {
+	LOOPBACK_MSG_OFFER,
+	LOOPBACK_MSG_TERMINATE,
+	LOOPBACK_MSG_CONTROL,
+	LOOPBACK_MSG_DISCOVER,
+
+	LOOPBACK_MSG_ANSWER,
+	LOOPBACK_MSG_TERMINATE_RESPONSE,
+	LOOPBACK_MSG_CONTROL_RESPONSE,
+	LOOPBACK_MSG_CONTROL_REJECT,
+	LOOPBACK_MSG_DISCOVER_RESPONSE
+} loopback_msg_type_e;
+
+/** Data of loopback task message */
+struct loopback_task_msg_data_t {
+	loopback_msg_type_e        type;
+	mrcp_loopback_session_t   *session;
+	mrcp_session_descriptor_t *descriptor;
+	mrcp_message_t            *message;
+};
+
+static apt_bool_t mrcp_loopback_session_offer(mrcp_session_t *session, mrcp_session_descriptor_t *descriptor);
+static apt_bool_t mrcp_loopback_session_terminate(mrcp_session_t *session);
+static apt_bool_t mrcp_loopback_session_control(mrcp_session_t *session, mrcp_message_t *message);
+static apt_bool_t mrcp_loopback_session_discover(mrcp_session_t *session, mrcp_session_descriptor_t *descriptor);
+
+static const mrcp_session_request_vtable_t session_request_vtable = {
+	mrcp_loopback_session_offer,
+	mrcp_loopback_session_terminate,
+	mrcp_loopback_session_control,
+	mrcp_loopback_session_discover
+};
+
+static apt_bool_t mrcp_loopback_on_session_answer(mrcp_session_t *session, mrcp_session_descriptor_t *descriptor);
+static apt_bool_t mrcp_loopback_on_session_terminate(mrcp_session_t *session);
+static apt_bool_t mrcp_loopback_on_session_control(mrcp_session_t *session, mrcp_message_t *message);
+static apt_bool_t mrcp_loopback_on_session_discover(mrcp_session_t *session, mrcp_session_descriptor_t *descriptor);
+
+static const mrcp_session_response_vtable_t session_response_vtable = {
+	mrcp_loopback_on_session_answer,
+	mrcp_loopback_on_session_terminate,
+	mrcp_loopback_on_session_control,
+	mrcp_loopback_on_session_discover
+};
+
+static apt_bool_t mrcp_loopback_client_session_create(mrcp_session_t *session, const mrcp_sig_settings_t *settings);
+static apt_bool_t mrcp_loopback_client_msg_process(apt_task_t *task, apt_task_msg_t *msg);
+static apt_bool_t mrcp_loopback_server_msg_process(apt_task_t *task, apt_task_msg_t *msg);
+
+
+static mrcp_loopback_agent_t* mrcp_loopback_agent_create(const char *id, apt_bool_t (*process_msg)(apt_task_t*, apt_task_msg_t*), apr_pool_t *pool)
+{
+	apt_task_t *task;
+	apt_task_vtable_t *vtable;
+	apt_task_msg_pool_t *msg_pool;
+	mrcp_loopback_agent_t *agent = apr_palloc(pool,sizeof(mrcp_loopback_agent_t));
+	agent->sig_agent = mrcp_signaling_agent_create(id,agent,pool);
+	agent->server_agent = NULL;
+
+	msg_pool = apt_task_msg_pool_create_dynamic(sizeof(loopback_task_msg_data_t),pool);
+	agent->task = apt_consumer_task_create(agent,msg_pool,pool);
+	if(!agent->task) {
+		return NULL;
+	}
+	task = apt_consumer_task_base_get(agent->task);
+	apt_task_name_set(task,id);
+	vtable = apt_consumer_task_vtable_get(agent->task);
+	if(vtable) {
+		vtable->process_msg = process_msg;
+	}
+	agent->sig_agent->task = task;
+	return agent;
+}
+
+/** Create loopback server signaling agent */
+MRCP_DECLARE(mrcp_sig_agent_t*) mrcp_loopback_server_agent_create(const char *id, apr_pool_t *pool)
+{
+	mrcp_loopback_agent_t *agent = mrcp_loopback_agent_create(id,mrcp_loopback_server_msg_process,pool);
+	if(!agent) {
+		return NULL;
+	}
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Create Loopback Server Agent [%s]",id);
+	return agent->sig_agent;
+}
+
+/** Create loopback client signaling agent */
+MRCP_DECLARE(mrcp_sig_agent_t*) mrcp_loopback_client_agent_create(const char *id, mrcp_sig_agent_t *server_agent, apr_pool_t *pool)
+{
+	mrcp_loopback_agent_t *agent;
+	if(!server_agent || !server_agent->obj) {
+		return NULL;
+	}
+	agent = mrcp_loopback_agent_create(id,mrcp_loopback_client_msg_process,pool);
+	if(!agent) {
+		return NULL;
+	}
+	agent->server_agent = server_agent->obj;
+	agent->sig_agent->create_client_session = mrcp_loopback_client_session_create;
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Create Loopback Client Agent [%s] -> [%s]",id,server_agent->id);
+	return agent->sig_agent;
+}
+
+/* Signaling messages are handed over through the message queue of the consumer task (mutex and
+   condition variable based) as in the other signaling agents, the rate is per session, not per frame */
+static apt_bool_t loopback_task_msg_signal(
+						mrcp_loopback_agent_t *agent,
+						loopback_msg_type_e type,
+						mrcp_loopback_session_t *session,
+						mrcp_session_descriptor_t *descriptor,
+						mrcp_message_t *message)
+{
+	apt_task_t *task = apt_consumer_task_base_get(agent->task);
+	apt_task_msg_t *task_msg = apt_task_msg_get(task);
+	loopback_task_msg_data_t *data;
+	if(!task_msg) {
+		return FALSE;
+	}
+	data = (loopback_task_msg_data_t*)task_msg->data;
+	data->type = type;
+	data->session = session;
+	data->descriptor = descriptor;
+	data->message = message;
+	return apt_task_msg_signal(task,task_msg);
+}
+
+static int loopback_response_code_get(mrcp_session_status_e status)
+{
+	switch(status) {
+		case MRCP_SESSION_STATUS_OK:
+			return 200;
+		case MRCP_SESSION_STATUS_NO_SUCH_RESOURCE:
+			return 404;
+		case MRCP_SESSION_STATUS_UNACCEPTABLE_RESOURCE:
+		case MRCP_SESSION_STATUS_UNAVAILABLE_RESOURCE:
+			return 406;
+		case MRCP_SESSION_STATUS_OVERLOADED:
+			return 503;
+		default:
+			break;
+	}
+	return 500;
+}
+
+static void loopback_media_array_copy(apr_array_header_t *media_arr, const apr_array_header_t *src_media_arr, apr_pool_t *pool)
+{
+	int i;
+	int j;
+	const mpf_rtp_media_descriptor_t *src_media;
+	mpf_rtp_media_descriptor_t *media;
+	const mpf_codec_descriptor_t *src_codec;
+	mpf_codec_descriptor_t *codec;
+	for(i = 0; i < src_media_arr->nelts; i++) {
+		src_media = APR_ARRAY_IDX(src_media_arr,i,const mpf_rtp_media_descriptor_t*);
+		media = apr_palloc(pool,sizeof(mpf_rtp_media_descriptor_t));
+		mpf_rtp_media_descriptor_init(media);
+		media->state = src_media->state;
+		apt_string_copy(&media->ip,&src_media->ip,pool);
+		apt_string_copy(&media->ext_ip,&src_media->ext_ip,pool);
+		media->port = src_media->port;
+		media->direction = src_media->direction;
+		media->ptime = src_media->ptime;
+		media->mid = src_media->mid;
+		media->id = src_media->id;
+
+		mpf_codec_list_init(&media->codec_list,src_media->codec_list.descriptor_arr->nelts,pool);
+		for(j = 0; j < src_media->codec_list.descriptor_arr->nelts; j++) {
+			src_codec = &APR_ARRAY_IDX(src_media->codec_list.descriptor_arr,j,mpf_codec_descriptor_t);
+			if(src_codec->enabled == FALSE) {
+				continue;
+			}
+			codec = mpf_codec_list_add(&media->codec_list);
+			*codec = *src_codec;
+			apt_string_copy(&codec->name,&src_codec->name,pool);
+			apt_string_copy(&codec->format,&src_codec->format,pool);
+		}
+		APR_ARRAY_PUSH(media_arr,mpf_rtp_media_descriptor_t*) = media;
+	}
+}
+
+/** Copy session descriptor, the control media (MRCPv2) is not conveyed */
+static mrcp_session_descriptor_t* loopback_descriptor_copy(const mrcp_session_descriptor_t *src_descriptor, apr_pool_t *pool)
+{
+	mrcp_session_descriptor_t *descriptor = mrcp_session_descriptor_create(pool);
+	apt_string_copy(&descriptor->origin,&src_descriptor->origin,pool);
+	apt_string_copy(&descriptor->ip,&src_descriptor->ip,pool);
+	apt_string_copy(&descriptor->ext_ip,&src_descriptor->ext_ip,pool);
+	apt_string_copy(&descriptor->resource_name,&src_descriptor->resource_name,pool);
+	descriptor->resource_state = src_descriptor->resource_state;
+	descriptor->status = src_descriptor->status;
+	descriptor->response_code = src_descriptor->response_code;
+	loopback_media_array_copy(descriptor->audio_media_arr,src_descriptor->audio_media_arr,pool);
+	loopback_media_array_copy(descriptor->video_media_arr,src_descriptor->video_media_arr,pool);
+	return descriptor;
+}
+
+/** Copy MRCP message using the resources of the specified factory */
+static mrcp_message_t* loopback_message_copy(const mrcp_message_t *src_message, const mrcp_resource_factory_t *resource_factory, apr_pool_t *pool)
+{
+	mrcp_resource_t *resource;
+	mrcp_message_t *message;
+	if(!src_message->resource) {
+		return NULL;
+	}
+	resource = mrcp_resource_get(resource_factory,src_message->resource->id);
+	if(!resource) {
+		return NULL;
+	}
+
+	message = mrcp_message_create(pool);
+	message->start_line = src_message->start_line;
+	apt_string_copy(&message->start_line.method_name,&src_message->start_line.method_name,pool);
+	apt_string_copy(&message->channel_id.resource_name,&src_message->channel_id.resource_name,pool);
+	if(mrcp_message_resource_set(message,resource) == FALSE) {
+		return NULL;
+	}
+	mrcp_header_fields_set(&message->header,&src_message->header,pool);
+	apt_string_copy(&message->body,&src_message->body,pool);
+	return message;
+}
+
+static apt_bool_t mrcp_loopback_client_session_create(mrcp_session_t *mrcp_session, const mrcp_sig_settings_t *settings)
+{
+	mrcp_loopback_agent_t *agent = mrcp_session->signaling_agent->obj;
+	mrcp_loopback_session_t *session = apr_palloc(mrcp_session->pool,sizeof(mrcp_loopback_session_t));
+	session->client_agent = agent;
+	session->server_agent = agent->server_agent;
+	session->client_session = mrcp_session;
+	session->server_session = NULL;
+
+	mrcp_session->request_vtable = &session_request_vtable;
+	mrcp_session->obj = session;
+	return TRUE;
+}
+
+/* Client side requests (invoked in the context of the client task) */
+
+static apt_bool_t mrcp_loopback_session_offer(mrcp_session_t *mrcp_session, mrcp_session_descriptor_t *descriptor)
+{
+	mrcp_loopback_session_t *session = mrcp_session->obj;
+	return loopback_task_msg_signal(session->server_agent,LOOPBACK_MSG_OFFER,session,descriptor,NULL);
+}
+
+static apt_bool_t mrcp_loopback_session_terminate(mrcp_session_t *mrcp_session)
+{
+	mrcp_loopback_session_t *session = mrcp_session->obj;
+	return loopback_task_msg_signal(session->server_agent,LOOPBACK_MSG_TERMINATE,session,NULL,NULL);
+}
+
+static apt_bool_t mrcp_loopback_session_control(mrcp_session_t *mrcp_session, mrcp_message_t *message)
+{
+	mrcp_loopback_session_t *session = mrcp_session->obj;
+	return loopback_task_msg_signal(session->server_agent,LOOPBACK_MSG_CONTROL,session,NULL,message);
+}
+
+static apt_bool_t mrcp_loopback_session_discover(mrcp_session_t *mrcp_session, mrcp_session_descriptor_t *descriptor)
+{
+	mrcp_loopback_session_t *session = mrcp_session->obj;
+	return loopback_task_msg_signal(session->server_agent,LOOPBACK_MSG_DISCOVER,session,descriptor,NULL);
+}
+
+/* Server side responses (invoked in the context of the server task) */
+
+static apt_bool_t mrcp_loopback_on_session_answer(mrcp_session_t *mrcp_session, mrcp_session_descriptor_t *descriptor)
+{
+	mrcp_loopback_session_t *session = mrcp_session->obj;
+	return loopback_task_msg_signal(session->client_agent,LOOPBACK_MSG_ANSWER,session,descriptor,NULL);
+}
+
+static apt_bool_t mrcp_loopback_on_session_terminate(mrcp_session_t *mrcp_session)
+{
+	mrcp_loopback_session_t *session = mrcp_session->obj;
+	return loopback_task_msg_signal(session->client_agent,LOOPBACK_MSG_TERMINATE_RESPONSE,session,NULL,NULL);
+}
+
+static apt_bool_t mrcp_loopback_on_session_control(mrcp_session_t *mrcp_session, mrcp_message_t *message)
+{
+	mrcp_loopback_session_t *session = mrcp_session->obj;
+	return loopback_task_msg_signal(session->client_agent,LOOPBACK_MSG_CONTROL_RESPONSE,session,NULL,message);
+}
+
+static apt_bool_t mrcp_loopback_on_session_discover(mrcp_session_t *mrcp_session, mrcp_session_descriptor_t *descriptor)
+{
+	mrcp_loopback_session_t *session = mrcp_session->obj;
+	return loopback_task_msg_signal(session->client_agent,LOOPBACK_MSG_DISCOVER_RESPONSE,session,descriptor,NULL);
+}
+
+static apt_bool_t mrcp_loopback_server_session_create(mrcp_loopback_agent_t *agent, mrcp_loopback_session_t *session)
+{
+	mrcp_session_t *mrcp_session;
+	if(session->server_session) {
+		return TRUE;
+	}
+	if(!agent->sig_agent->create_server_session) {
+		return FALSE;
+	}
+	mrcp_session = agent->sig_agent->create_server_session(agent->sig_agent);
+	if(!mrcp_session) {
+		return FALSE;
+	}
+	mrcp_session->response_vtable = &session_response_vtable;
+	mrcp_session->event_vtable = NULL;
+	mrcp_session->obj = session;
+	session->server_session = mrcp_session;
+	return TRUE;
+}
+
+/* Process requests in the context of the server agent task */
+static apt_bool_t mrcp_loopback_server_msg_process(apt_task_t *task, apt_task_msg_t *task_msg)
+{
+	apt_consumer_task_t *consumer_task = apt_task_object_get(task);
+	mrcp_loopback_agent_t *agent = apt_consumer_task_object_get(consumer_task);
+	loopback_task_msg_data_t *data = (loopback_task_msg_data_t*)task_msg->data;
+	mrcp_loopback_session_t *session = data->session;
+
+	switch(data->type) {
+		case LOOPBACK_MSG_OFFER:
+		{
+			mrcp_session_descriptor_t *descriptor;
+			if(mrcp_loopback_server_session_create(agent,session) == FALSE) {
+				apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Loopback Server Session");
+				loopback_task_msg_signal(session->client_agent,LOOPBACK_MSG_ANSWER,session,NULL,NULL);
+				break;
+			}
+			descriptor = loopback_descriptor_copy(data->descriptor,session->server_session->pool);
+			mrcp_session_offer(session->server_session,descriptor);
+			break;
+		}
+		case LOOPBACK_MSG_TERMINATE:
+		{
+			if(!session->server_session) {
+				loopback_task_msg_signal(session->client_agent,LOOPBACK_MSG_TERMINATE_RESPONSE,session,NULL,NULL);
+				break;
+			}
+			mrcp_session_terminate_request(session->server_session);
+			break;
+		}
+		case LOOPBACK_MSG_CONTROL:
+		{
+			mrcp_message_t *message = NULL;
+			if(session->server_session) {
+				message = loopback_message_copy(data->message,agent->sig_agent->resource_factory,session->server_session->pool);
+			}
+			if(!message) {
+				loopback_task_msg_signal(session->client_agent,LOOPBACK_MSG_CONTROL_REJECT,session,NULL,data->message);
+				break;
+			}
+			message->channel_id.session_id = session->server_session->id;
+			mrcp_session_control_request(session->server_session,message);
+			break;
+		}
+		case LOOPBACK_MSG_DISCOVER:
+		{
+			/* resources are implied by the server the agent is registered with */
+			loopback_task_msg_signal(session->client_agent,LOOPBACK_MSG_DISCOVER_RESPONSE,session,NULL,NULL);
+			break;
+		}
+		default:
+			break;
+	}
+	return TRUE;
+}
+
+static mrcp_session_descriptor_t* loopback_answer_generate(mrcp_loopback_session_t *session, const mrcp_session_descriptor_t *src_descriptor)
+{
+	mrcp_session_t *mrcp_session = session->client_session;
+	mrcp_session_descriptor_t *descriptor;
+	if(src_descriptor) {
+		descriptor = loopback_descriptor_copy(src_descriptor,mrcp_session->pool);
+	}
+	else {
+		descriptor = mrcp_session_descriptor_create(mrcp_session->pool);
+		descriptor->status = MRCP_SESSION_STATUS_ERROR;
+	}
+	descriptor->response_code = loopback_response_code_get(descriptor->status);
+	return descriptor;
+}
+
+/* Process responses in the context of the client agent task */
+static apt_bool_t mrcp_loopback_client_msg_process(apt_task_t *task, apt_task_msg_t *task_msg)
+{
+	apt_consumer_task_t *consumer_task = apt_task_object_get(task);
+	mrcp_loopback_agent_t *agent = apt_consumer_task_object_get(consumer_task);
+	loopback_task_msg_data_t *data = (loopback_task_msg_data_t*)task_msg->data;
+	mrcp_loopback_session_t *session = data->session;
+	mrcp_session_t *mrcp_session = session->client_session;
+
+	switch(data->type) {
+		case LOOPBACK_MSG_ANSWER:
+		{
+			mrcp_session_descriptor_t *descriptor = loopback_answer_generate(session,data->descriptor);
+			if(session->server_session && session->server_session->id.length && !mrcp_session->id.length) {
+				apt_string_copy(&mrcp_session->id,&session->server_session->id,mrcp_session->pool);
+			}
+			mrcp_session_answer(mrcp_session,descriptor);
+			break;
+		}
+		case LOOPBACK_MSG_TERMINATE_RESPONSE:
+		{
+			/* all the preceding messages of the server session have been processed by now */
+			if(session->server_session) {
+				mrcp_session_destroy(session->server_session);
+				session->server_session = NULL;
+			}
+			mrcp_session_terminate_response(mrcp_session);
+			break;
+		}
+		case LOOPBACK_MSG_CONTROL_RESPONSE:
+		{
+			mrcp_message_t *message = loopback_message_copy(data->message,agent->sig_agent->resource_factory,mrcp_session->pool);
+			if(!message) {
+				apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Copy Loopback MRCP Message "APT_SID_FMT,MRCP_SESSION_SID(mrcp_session));
+				break;
+			}
+			message->channel_id.session_id = mrcp_session->id;
+			mrcp_session_control_response(mrcp_session,message);
+			break;
+		}
+		case LOOPBACK_MSG_CONTROL_REJECT:
+		{
+			/* the request has not been delivered, respond on behalf of the server */
+			mrcp_message_t *message = mrcp_response_create(data->message,mrcp_session->pool);
+			message->start_line.status_code = MRCP_STATUS_CODE_METHOD_FAILED;
+			mrcp_session_control_response(mrcp_session,message);
+			break;
+		}
+		case LOOPBACK_MSG_DISCOVER_RESPONSE:
+		{
+			mrcp_session_descriptor_t *descriptor = loopback_answer_generate(session,data->descriptor);
+			if(!data->descriptor) {
+				descriptor->status = MRCP_SESSION_STATUS_OK;
+				descriptor->response_code = loopback_response_code_get(descriptor->status);
+			}
+			mrcp_session_discover_response(mrcp_session,descriptor);
+			break;
+		}
+		default:
+			break;
+	}
+	return TRUE;
+}
@@ -47,6 +47,8 @@ MRCP_DECLARE(const char*) mrcp_session_status_phrase_get(mrcp_session_status_e s
 			return "Unavailable";
 		case MRCP_SESSION_STATUS_ERROR:
 			return "Error";
+		case MRCP_SESSION_STATUS_OVERLOADED:
+			return "Service Unavailable";
 	}
 	return "Unknown";
 }
@@ -99,7 +99,7 @@ MRCP_DECLARE(mrcp_sig_settings_t*) mrcp_signaling_settings_alloc(apr_pool_t *poo
 MRCP_DECLARE(mrcp_session_t*) mrcp_session_create(apr_size_t padding)
 {
 	mrcp_session_t *session;
-	apr_pool_t *pool = apt_pool_create();
+	apr_pool_t *pool = apt_pool_recyclable_create();
 	if(!pool) {
 		return NULL;
 	}
@@ -123,6 +123,6 @@ MRCP_DECLARE(mrcp_session_t*) mrcp_session_create(apr_size_t padding)
 MRCP_DECLARE(void) mrcp_session_destroy(mrcp_session_t *session)
 {
 	if(session->pool) {
-		apr_pool_destroy(session->pool);
+		apt_pool_recycle(session->pool);
 	}
 }
@@ -48,6 +48,12 @@ MRCP_DECLARE(void) mrcp_parser_verbose_set(mrcp_parser_t *parser, apt_bool_t ver
 /** Parse MRCP stream */
 MRCP_DECLARE(apt_message_status_e) mrcp_parser_run(mrcp_parser_t *parser, apt_text_stream_t *stream, mrcp_message_t **message);
 
+/** Get the remaining part of the message body being parsed (see apt_message_parser_body_slice_get) */
+MRCP_DECLARE(apt_bool_t) mrcp_parser_body_slice_get(mrcp_parser_t *parser, char **buf, apr_size_t *length);
+
+/** Advance the message body being parsed (see apt_message_parser_body_slice_advance) */
+MRCP_DECLARE(apt_bool_t) mrcp_parser_body_slice_advance(mrcp_parser_t *parser, apr_size_t length);
+
 
 
 /** Create MRCP stream generator */
@@ -89,6 +89,18 @@ MRCP_DECLARE(apt_message_status_e) mrcp_parser_run(mrcp_parser_t *parser, apt_te
 	return apt_message_parser_run(parser->base,stream,(void**)message);
 }
 
+/** Get the remaining part of the message body being parsed */
+MRCP_DECLARE(apt_bool_t) mrcp_parser_body_slice_get(mrcp_parser_t *parser, char **buf, apr_size_t *length)
+{
+	return apt_message_parser_body_slice_get(parser->base,buf,length);
+}
+
+/** Advance the message body being parsed */
+MRCP_DECLARE(apt_bool_t) mrcp_parser_body_slice_advance(mrcp_parser_t *parser, apr_size_t length)
+{
+	return apt_message_parser_body_slice_advance(parser->base,length);
+}
+
 /** Create message and read start line */
 static apt_bool_t mrcp_parser_on_start(apt_message_parser_t *parser, apt_message_context_t *context, apt_text_stream_t *stream, apr_pool_t *pool)
 {
@@ -184,6 +196,25 @@ MRCP_DECLARE(apt_message_status_e) mrcp_generator_run(mrcp_generator_t *generato
 	return apt_message_generator_run(generator->base,message,stream);
 }
 
+/** Generate start-line and channel-identifier (v2) either from the template, if applicable, or from scratch */
+static apt_bool_t mrcp_start_line_and_channel_id_generate(mrcp_message_t *message, apt_text_stream_t *stream)
+{
+	if(message->start_line_template &&
+		mrcp_start_line_template_match(message->start_line_template,&message->start_line) == TRUE) {
+		/* splice request-id into the pre-rendered start-line and channel-identifier */
+		return mrcp_start_line_template_generate(message->start_line_template,&message->start_line,stream);
+	}
+
+	if(mrcp_start_line_generate(&message->start_line,stream) == FALSE) {
+		return FALSE;
+	}
+
+	if(message->start_line.version == MRCP_VERSION_2) {
+		mrcp_channel_id_generate(&message->channel_id,stream);
+	}
+	return TRUE;
+}
+
 /** Initialize by generating message start line and return header section and body */
 apt_bool_t mrcp_generator_on_start(apt_message_generator_t *generator, apt_message_context_t *context, apt_text_stream_t *stream)
 {
@@ -193,13 +224,9 @@ apt_bool_t mrcp_generator_on_start(apt_message_generator_t *generator, apt_messa
 		return FALSE;
 	}
 	/* generate start-line */
-	if(mrcp_start_line_generate(&mrcp_message->start_line,stream) == FALSE) {
+	if(mrcp_start_line_and_channel_id_generate(mrcp_message,stream) == FALSE) {
 		return FALSE;
 	}
-		
-	if(mrcp_message->start_line.version == MRCP_VERSION_2) {
-		mrcp_channel_id_generate(&mrcp_message->channel_id,stream);
-	}
 
 	context->header = &mrcp_message->header.header_section;
 	context->body = &mrcp_message->body;
@@ -223,14 +250,10 @@ MRCP_DECLARE(apt_bool_t) mrcp_message_generate(const mrcp_resource_factory_t *re
 	}
 	
 	/* generate start-line */
-	if(mrcp_start_line_generate(&message->start_line,stream) == FALSE) {
+	if(mrcp_start_line_and_channel_id_generate(message,stream) == FALSE) {
 		return FALSE;
 	}
 
-	if(message->start_line.version == MRCP_VERSION_2) {
-		mrcp_channel_id_generate(&message->channel_id,stream);
-	}
-
 	/* generate header section */
 	if(apt_header_section_generate(&message->header.header_section,stream) == FALSE) {
 		return FALSE;
@@ -48,6 +48,8 @@ struct mrcp_message_t {
 
 	/** Associated MRCP resource */
 	const mrcp_resource_t *resource;
+	/** Optional template of start-line and channel-identifier to generate the message from */
+	const mrcp_start_line_template_t *start_line_template;
 	/** Memory pool to allocate memory from */
 	apr_pool_t            *pool;
 };
@@ -109,6 +111,16 @@ MRCP_DECLARE(apt_bool_t) mrcp_message_validate(mrcp_message_t *message);
 MRCP_DECLARE(void) mrcp_message_destroy(mrcp_message_t *message);
 
 
+/**
+ * Create template of MRCP v2 response or event to speed up generation of similar messages.
+ * @param message the message to render the template from
+ * @param pool the pool to allocate memory from
+ * @remark The template includes the start-line and the channel-identifier,
+ *         the request-id and the message-length are the only variable fields.
+ */
+MRCP_DECLARE(mrcp_start_line_template_t*) mrcp_message_template_create(const mrcp_message_t *message, apr_pool_t *pool);
+
+
 /**
  * Get MRCP generic header.
  * @param message the message to get generic header from
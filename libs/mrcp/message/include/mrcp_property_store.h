@@ -0,0 +1,79 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifndef MRCP_PROPERTY_STORE_H
+#define MRCP_PROPERTY_STORE_H
+
+/**
+ * @file mrcp_property_store.h
+ * @brief Store of Session Properties (SET-PARAMS/GET-PARAMS)
+ */ 
+
+#include "mrcp_message.h"
+
+APT_BEGIN_EXTERN_C
+
+/** Opaque property store declaration */
+typedef struct mrcp_property_store_t mrcp_property_store_t;
+
+/**
+ * Create property store.
+ * @param generic_header_vtable the vtable of the generic header
+ * @param resource_header_vtable the vtable of the resource specific header
+ * @param pool the pool to allocate memory from
+ * @remark The properties are kept in a recyclable pool of their own. Every update rebuilds 
+ * the properties in a new pool and recycles the previous one.
+ */
+MRCP_DECLARE(mrcp_property_store_t*) mrcp_property_store_create(
+										const mrcp_header_vtable_t *generic_header_vtable,
+										const mrcp_header_vtable_t *resource_header_vtable,
+										apr_pool_t *pool);
+
+/**
+ * Destroy property store, releasing the current snapshot.
+ * @param store the store to destroy
+ * @remark The store is implicitly destroyed with the pool it has been created from.
+ */
+MRCP_DECLARE(void) mrcp_property_store_destroy(mrcp_property_store_t *store);
+
+/**
+ * Set (copy) header fields of the message to the store (SET-PARAMS).
+ * @param store the store to set properties to
+ * @param message the message to copy header fields from
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_property_store_set(mrcp_property_store_t *store, const mrcp_message_t *message);
+
+/**
+ * Get (copy) the properties masked by the header fields of the request to the response (GET-PARAMS).
+ * @param store the store to get properties from
+ * @param message the response message to copy properties to
+ * @param request the request message to use header fields of as a mask
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_property_store_get(mrcp_property_store_t *store, mrcp_message_t *message, const mrcp_message_t *request);
+
+/**
+ * Inherit (copy) the properties not set in the request.
+ * @param store the store to inherit properties from
+ * @param message the request message to inherit properties to
+ * @remark The values are copied to the pool of the message, since the request may outlive the snapshot.
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_property_store_inherit(mrcp_property_store_t *store, mrcp_message_t *message);
+
+APT_END_EXTERN_C
+
+#endif /* MRCP_PROPERTY_STORE_H */
@@ -97,6 +97,28 @@ struct mrcp_start_line_t {
 	mrcp_request_state_e request_state;
 };
 
+/** MRCP start-line template declaration */
+typedef struct mrcp_start_line_template_t mrcp_start_line_template_t;
+
+/** Pre-rendered template of MRCP v2 response or event start-line, the request-id is spliced into */
+struct mrcp_start_line_template_t {
+	/** MRCP message type */
+	mrcp_message_type_e  message_type;
+	/** MRCP method id (event) */
+	mrcp_method_id       method_id;
+	/** Status code (response) */
+	mrcp_status_code_e   status_code;
+	/** Request state */
+	mrcp_request_state_e request_state;
+
+	/** Static part preceding the request-id */
+	apt_str_t            prefix;
+	/** Static part following the request-id, including the trailer */
+	apt_str_t            suffix;
+	/** Offset of the message-length in the prefix */
+	apr_size_t           length_offset;
+};
+
 /** Initialize MRCP start-line */
 MRCP_DECLARE(void) mrcp_start_line_init(mrcp_start_line_t *start_line);
 /** Parse MRCP start-line */
@@ -106,6 +128,19 @@ MRCP_DECLARE(apt_bool_t) mrcp_start_line_generate(mrcp_start_line_t *start_line,
 /** Finalize MRCP start-line generation */
 MRCP_DECLARE(apt_bool_t) mrcp_start_line_finalize(mrcp_start_line_t *start_line, apr_size_t content_length, apt_text_stream_t *text_stream);
 
+/**
+ * Initialize MRCP v2 start-line template.
+ * @param tmpl the template to initialize
+ * @param start_line the start-line of response or event to render the template from
+ * @param trailer the pre-rendered data to follow the start-line (optional)
+ * @param pool the pool to allocate memory from
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_start_line_template_init(mrcp_start_line_template_t *tmpl, const mrcp_start_line_t *start_line, const apt_str_t *trailer, apr_pool_t *pool);
+/** Check whether MRCP start-line can be generated from the template */
+MRCP_DECLARE(apt_bool_t) mrcp_start_line_template_match(const mrcp_start_line_template_t *tmpl, const mrcp_start_line_t *start_line);
+/** Generate MRCP start-line from the template (to be finalized by mrcp_start_line_finalize()) */
+MRCP_DECLARE(apt_bool_t) mrcp_start_line_template_generate(const mrcp_start_line_template_t *tmpl, mrcp_start_line_t *start_line, apt_text_stream_t *text_stream);
+
 /** Parse MRCP request-id */
 MRCP_DECLARE(mrcp_request_id) mrcp_request_id_parse(const apt_str_t *field);
 /** Generate MRCP request-id */
@@ -106,6 +106,7 @@ MRCP_DECLARE(mrcp_message_t*) mrcp_message_create(apr_pool_t *pool)
 	mrcp_message_header_init(&message->header);
 	apt_string_reset(&message->body);
 	message->resource = NULL;
+	message->start_line_template = NULL;
 	message->pool = pool;
 	return message;
 }
@@ -180,6 +181,34 @@ MRCP_DECLARE(apt_bool_t) mrcp_message_validate(mrcp_message_t *message)
 	return TRUE;
 }
 
+/** Create template of MRCP v2 response or event */
+MRCP_DECLARE(mrcp_start_line_template_t*) mrcp_message_template_create(const mrcp_message_t *message, apr_pool_t *pool)
+{
+	mrcp_start_line_template_t *tmpl;
+	mrcp_channel_id channel_id = message->channel_id;
+	apt_text_stream_t stream;
+	apt_str_t trailer;
+	apr_size_t size;
+	if(message->start_line.version != MRCP_VERSION_2) {
+		return NULL;
+	}
+
+	/* render channel-identifier to follow the start-line */
+	size = channel_id.session_id.length + channel_id.resource_name.length + 32;
+	trailer.buf = apr_palloc(pool,size);
+	apt_text_stream_init(&stream,trailer.buf,size);
+	if(mrcp_channel_id_generate(&channel_id,&stream) == FALSE) {
+		return NULL;
+	}
+	trailer.length = stream.pos - trailer.buf;
+
+	tmpl = apr_palloc(pool,sizeof(mrcp_start_line_template_t));
+	if(mrcp_start_line_template_init(tmpl,&message->start_line,&trailer,pool) == FALSE) {
+		return NULL;
+	}
+	return tmpl;
+}
+
 /** Add MRCP generic header field by specified property (numeric identifier) */
 MRCP_DECLARE(apt_bool_t) mrcp_generic_header_property_add(mrcp_message_t *message, apr_size_t id)
 {
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include "mrcp_property_store.h"
+#include "apt_pool.h"
+
+/** Snapshot of properties */
+typedef struct mrcp_property_snapshot_t mrcp_property_snapshot_t;
+
+/** Immutable snapshot of properties */
+struct mrcp_property_snapshot_t {
+	/** Pool the snapshot is allocated from */
+	apr_pool_t           *pool;
+	/** Header fields */
+	mrcp_message_header_t header;
+};
+
+/** Property store */
+struct mrcp_property_store_t {
+	/** Pool to allocate memory from */
+	apr_pool_t                 *pool;
+	/** Generic header vtable */
+	const mrcp_header_vtable_t *generic_header_vtable;
+	/** Resource specific header vtable */
+	const mrcp_header_vtable_t *resource_header_vtable;
+	/** Current snapshot, if any properties have been set */
+	mrcp_property_snapshot_t   *current;
+};
+
+static apr_status_t mrcp_property_store_cleanup(void *obj);
+
+
+static mrcp_property_snapshot_t* mrcp_property_snapshot_create(mrcp_property_store_t *store)
+{
+	mrcp_property_snapshot_t *snapshot;
+	apr_pool_t *pool = apt_pool_recyclable_create();
+	if(!pool) {
+		return NULL;
+	}
+	snapshot = apr_palloc(pool,sizeof(mrcp_property_snapshot_t));
+	snapshot->pool = pool;
+	apt_header_section_init(&snapshot->header.header_section);
+	mrcp_message_header_data_alloc(
+		&snapshot->header,
+		store->generic_header_vtable,
+		store->resource_header_vtable,
+		pool);
+	return snapshot;
+}
+
+static void mrcp_property_snapshot_destroy(mrcp_property_snapshot_t *snapshot)
+{
+	mrcp_message_header_destroy(&snapshot->header);
+	apt_pool_recycle(snapshot->pool);
+}
+
+/** Create property store */
+MRCP_DECLARE(mrcp_property_store_t*) mrcp_property_store_create(
+										const mrcp_header_vtable_t *generic_header_vtable,
+										const mrcp_header_vtable_t *resource_header_vtable,
+										apr_pool_t *pool)
+{
+	mrcp_property_store_t *store = apr_palloc(pool,sizeof(mrcp_property_store_t));
+	store->pool = pool;
+	store->generic_header_vtable = generic_header_vtable;
+	store->resource_header_vtable = resource_header_vtable;
+	store->current = NULL;
+	apr_pool_cleanup_register(pool,store,mrcp_property_store_cleanup,apr_pool_cleanup_null);
+	return store;
+}
+
+static apr_status_t mrcp_property_store_cleanup(void *obj)
+{
+	mrcp_property_store_t *store = obj;
+	if(store->current) {
+		mrcp_property_snapshot_destroy(store->current);
+		store->current = NULL;
+	}
+	return APR_SUCCESS;
+}
+
+/** Destroy property store */
+MRCP_DECLARE(void) mrcp_property_store_destroy(mrcp_property_store_t *store)
+{
+	apr_pool_cleanup_run(store->pool,store,mrcp_property_store_cleanup);
+}
+
+/** Set (copy) header fields of the message to the store */
+MRCP_DECLARE(apt_bool_t) mrcp_property_store_set(mrcp_property_store_t *store, const mrcp_message_t *message)
+{
+	mrcp_property_snapshot_t *snapshot;
+	if(APR_RING_EMPTY(&message->header.header_section.ring, apt_header_field_t, link)) {
+		/* nothing to set */
+		return TRUE;
+	}
+
+	/* merge the current properties and the new ones into a new snapshot and reclaim the current one */
+	snapshot = mrcp_property_snapshot_create(store);
+	if(!snapshot) {
+		return FALSE;
+	}
+	if(store->current) {
+		mrcp_header_fields_set(&snapshot->header,&store->current->header,snapshot->pool);
+		mrcp_property_snapshot_destroy(store->current);
+	}
+	mrcp_header_fields_set(&snapshot->header,&message->header,snapshot->pool);
+	store->current = snapshot;
+	return TRUE;
+}
+
+/** Get (copy) properties masked by the header fields of the request to the response */
+MRCP_DECLARE(apt_bool_t) mrcp_property_store_get(mrcp_property_store_t *store, mrcp_message_t *message, const mrcp_message_t *request)
+{
+	if(!store->current) {
+		/* no properties set yet, just copy the names of requested header fields */
+		mrcp_message_header_t header;
+		mrcp_message_header_init(&header);
+		return mrcp_header_fields_get(&message->header,&header,&request->header,message->pool);
+	}
+	return mrcp_header_fields_get(&message->header,&store->current->header,&request->header,message->pool);
+}
+
+/** Inherit (copy) properties not set in the request */
+MRCP_DECLARE(apt_bool_t) mrcp_property_store_inherit(mrcp_property_store_t *store, mrcp_message_t *message)
+{
+	if(!store->current) {
+		/* nothing to inherit */
+		return TRUE;
+	}
+	return mrcp_header_fields_inherit(&message->header,&store->current->header,message->pool);
+}
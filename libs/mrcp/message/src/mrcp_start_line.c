@@ -32,6 +32,8 @@
 
 /** Max number of digits message length consists of */
 #define MAX_DIGIT_COUNT 6
+/** Max number of digits request-id consists of */
+#define MAX_REQUEST_ID_DIGIT_COUNT 20
 
 
 /** String table of MRCP request-states (mrcp_request_state_t) */
@@ -427,6 +429,104 @@ MRCP_DECLARE(apt_bool_t) mrcp_start_line_finalize(mrcp_start_line_t *start_line,
 	return TRUE;
 }
 
+/** Initialize MRCP v2 start-line template */
+MRCP_DECLARE(apt_bool_t) mrcp_start_line_template_init(mrcp_start_line_template_t *tmpl, const mrcp_start_line_t *start_line, const apt_str_t *trailer, apr_pool_t *pool)
+{
+	apt_text_stream_t stream;
+	apr_size_t size;
+	char *buffer;
+	if(start_line->version != MRCP_VERSION_2) {
+		return FALSE;
+	}
+	if(start_line->message_type == MRCP_MESSAGE_TYPE_EVENT) {
+		if(!start_line->method_name.length) {
+			return FALSE;
+		}
+	}
+	else if(start_line->message_type != MRCP_MESSAGE_TYPE_RESPONSE) {
+		return FALSE;
+	}
+
+	tmpl->message_type = start_line->message_type;
+	tmpl->method_id = start_line->method_id;
+	tmpl->status_code = start_line->status_code;
+	tmpl->request_state = start_line->request_state;
+
+	/* render version, reserved message-length and method name (event) */
+	size = MRCP_NAME_LENGTH + MAX_DIGIT_COUNT + start_line->method_name.length + 16;
+	buffer = apr_palloc(pool,size);
+	apt_text_stream_init(&stream,buffer,size);
+	if(mrcp_version_generate(start_line->version,&stream) == FALSE) {
+		return FALSE;
+	}
+	*stream.pos++ = APT_TOKEN_SP;
+	tmpl->length_offset = stream.pos - buffer;
+	memset(stream.pos,APT_TOKEN_SP,MAX_DIGIT_COUNT+1);
+	stream.pos += MAX_DIGIT_COUNT+1;
+	if(start_line->message_type == MRCP_MESSAGE_TYPE_EVENT) {
+		memcpy(stream.pos,start_line->method_name.buf,start_line->method_name.length);
+		stream.pos += start_line->method_name.length;
+		*stream.pos++ = APT_TOKEN_SP;
+	}
+	tmpl->prefix.buf = buffer;
+	tmpl->prefix.length = stream.pos - buffer;
+
+	/* render status code (response), request state and trailer */
+	size = 32 + (trailer ? trailer->length : 0);
+	buffer = apr_palloc(pool,size);
+	apt_text_stream_init(&stream,buffer,size);
+	*stream.pos++ = APT_TOKEN_SP;
+	if(start_line->message_type == MRCP_MESSAGE_TYPE_RESPONSE) {
+		mrcp_status_code_generate(start_line->status_code,&stream);
+		*stream.pos++ = APT_TOKEN_SP;
+	}
+	mrcp_request_state_generate(start_line->request_state,&stream);
+	if(apt_text_eol_insert(&stream) == FALSE) {
+		return FALSE;
+	}
+	if(trailer && trailer->length) {
+		memcpy(stream.pos,trailer->buf,trailer->length);
+		stream.pos += trailer->length;
+	}
+	tmpl->suffix.buf = buffer;
+	tmpl->suffix.length = stream.pos - buffer;
+	return TRUE;
+}
+
+/** Check whether MRCP start-line can be generated from the template */
+MRCP_DECLARE(apt_bool_t) mrcp_start_line_template_match(const mrcp_start_line_template_t *tmpl, const mrcp_start_line_t *start_line)
+{
+	if(start_line->version != MRCP_VERSION_2 ||
+		start_line->message_type != tmpl->message_type ||
+		start_line->request_state != tmpl->request_state) {
+		return FALSE;
+	}
+	if(tmpl->message_type == MRCP_MESSAGE_TYPE_RESPONSE) {
+		return (start_line->status_code == tmpl->status_code) ? TRUE : FALSE;
+	}
+	return (start_line->method_id == tmpl->method_id) ? TRUE : FALSE;
+}
+
+/** Generate MRCP start-line from the template */
+MRCP_DECLARE(apt_bool_t) mrcp_start_line_template_generate(const mrcp_start_line_template_t *tmpl, mrcp_start_line_t *start_line, apt_text_stream_t *text_stream)
+{
+	if(text_stream->pos + tmpl->prefix.length + MAX_REQUEST_ID_DIGIT_COUNT + tmpl->suffix.length >= text_stream->end) {
+		return FALSE;
+	}
+
+	memcpy(text_stream->pos,tmpl->prefix.buf,tmpl->prefix.length);
+	text_stream->pos += tmpl->prefix.length;
+	start_line->length = tmpl->length_offset; /* length is temporary used to store offset */
+
+	if(mrcp_request_id_generate(start_line->request_id,text_stream) == FALSE) {
+		return FALSE;
+	}
+
+	memcpy(text_stream->pos,tmpl->suffix.buf,tmpl->suffix.length);
+	text_stream->pos += tmpl->suffix.length;
+	return TRUE;
+}
+
 /** Parse MRCP request-id */
 MRCP_DECLARE(mrcp_request_id) mrcp_request_id_parse(const apt_str_t *field)
 {
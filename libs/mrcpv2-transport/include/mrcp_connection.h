@@ -37,6 +37,8 @@ APT_BEGIN_EXTERN_C
 
 /** Size of the buffer used for MRCP rx/tx stream */
 #define MRCP_STREAM_BUFFER_SIZE 1024
+/** Max size the rx buffer may grow up to in order to accommodate a large message header */
+#define MRCP_STREAM_MAX_BUFFER_SIZE 65536
 
 /** MRCPv2 connection */
 struct mrcp_connection_t {
@@ -74,6 +76,12 @@ struct mrcp_connection_t {
 	char             *rx_buffer;
 	/** Rx buffer size */
 	apr_size_t        rx_buffer_size;
+	/** Initial rx buffer the grown one shrinks back to */
+	char             *rx_base_buffer;
+	/** Initial rx buffer size */
+	apr_size_t        rx_base_buffer_size;
+	/** Pool the grown rx buffer is allocated from */
+	apr_pool_t       *rx_pool;
 	/** Rx stream */
 	apt_text_stream_t rx_stream;
 	/** MRCP parser to parser MRCP messages out of rx stream */
@@ -93,6 +101,15 @@ mrcp_connection_t* mrcp_connection_create(void);
 /** Destroy MRCP connection. */
 void mrcp_connection_destroy(mrcp_connection_t *connection);
 
+/** Allocate initial rx buffer and initialize rx stream of MRCP connection. */
+void mrcp_connection_rx_buffer_create(mrcp_connection_t *connection, apr_size_t size);
+
+/** Grow rx buffer of MRCP connection preserving the data remaining in rx stream. */
+apt_bool_t mrcp_connection_rx_buffer_grow(mrcp_connection_t *connection);
+
+/** Shrink grown rx buffer of MRCP connection back to the initial one, if rx stream is fully consumed. */
+void mrcp_connection_rx_buffer_shrink(mrcp_connection_t *connection);
+
 /** Add Control Channel to MRCP connection. */
 apt_bool_t mrcp_connection_channel_add(mrcp_connection_t *connection, mrcp_control_channel_t *channel);
 
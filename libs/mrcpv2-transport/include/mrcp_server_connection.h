@@ -102,6 +102,17 @@ MRCP_DECLARE(void) mrcp_server_connection_tx_size_set(
 								mrcp_connection_agent_t *agent,
 								apr_size_t size);
 
+/**
+ * Set number of worker threads processing accepted connections.
+ * @param agent the agent to set number of workers for
+ * @param count the total number of workers including the agent's own one
+ * @remark Accepted connections are assigned to workers in round-robin fashion.
+ * The function must be called before the agent is started.
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_server_connection_worker_count_set(
+								mrcp_connection_agent_t *agent,
+								apr_size_t count);
+
 /**
  * Get task.
  * @param agent the agent to get task from
@@ -345,9 +345,7 @@ static mrcp_connection_t* mrcp_client_agent_connection_create(mrcp_connection_ag
 	connection->tx_buffer_size = agent->tx_buffer_size;
 	connection->tx_buffer = apr_palloc(connection->pool,connection->tx_buffer_size+1);
 
-	connection->rx_buffer_size = agent->rx_buffer_size;
-	connection->rx_buffer = apr_palloc(connection->pool,connection->rx_buffer_size+1);
-	apt_text_stream_init(&connection->rx_stream,connection->rx_buffer,connection->rx_buffer_size);
+	mrcp_connection_rx_buffer_create(connection,agent->rx_buffer_size);
 
 	if(apt_log_masking_get() != APT_LOG_MASKING_NONE) {
 		connection->verbose = FALSE;
@@ -604,6 +602,8 @@ static apt_bool_t mrcp_client_poller_signal_process(void *obj, const apr_pollfd_
 	apr_status_t status;
 	apr_size_t offset;
 	apr_size_t length;
+	char *buffer;
+	apt_bool_t body_slice = FALSE;
 	apt_text_stream_t *stream;
 	mrcp_message_t *message;
 	apt_message_status_e msg_status;
@@ -615,10 +615,26 @@ static apt_bool_t mrcp_client_poller_signal_process(void *obj, const apr_pollfd_
 
 	/* calculate offset remaining from the previous receive / if any */
 	offset = stream->pos - stream->text.buf;
-	/* calculate available length */
-	length = connection->rx_buffer_size - offset;
+	if(!offset && mrcp_parser_body_slice_get(connection->parser,&buffer,&length) == TRUE) {
+		/* receive the rest of the message body directly into the message, bypassing rx stream */
+		body_slice = TRUE;
+	}
+	else {
+		if(offset == connection->rx_buffer_size) {
+			/* the message part remaining in rx stream does not fit into rx buffer */
+			if(mrcp_connection_rx_buffer_grow(connection) == FALSE) {
+				apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Grow Rx Buffer %s [%"APR_SIZE_T_FMT" bytes]",
+					connection->id,
+					connection->rx_buffer_size);
+			}
+			offset = stream->pos - stream->text.buf;
+		}
+		/* calculate available length */
+		buffer = stream->pos;
+		length = connection->rx_buffer_size - offset;
+	}
 
-	status = apr_socket_recv(connection->sock,stream->pos,&length);
+	status = apr_socket_recv(connection->sock,buffer,&length);
 	if(status == APR_EOF || length == 0) {
 		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"TCP/MRCPv2 Peer Disconnected %s",connection->id);
 		apt_poller_task_descriptor_remove(agent->task,&connection->sock_pfd);
@@ -629,6 +645,24 @@ static apt_bool_t mrcp_client_poller_signal_process(void *obj, const apr_pollfd_
 		return TRUE;
 	}
 	
+	if(body_slice == TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Receive MRCPv2 Body %s [%"APR_SIZE_T_FMT" bytes]\n%.*s",
+				connection->id,
+				length,
+				connection->verbose == TRUE ? length : 0,
+				buffer);
+		if(mrcp_parser_body_slice_advance(connection->parser,length) == FALSE) {
+			/* the body is still incomplete */
+			return TRUE;
+		}
+
+		/* the body is complete, run the parser over the empty stream to complete the message */
+		stream->text.length = 0;
+		apt_text_stream_reset(stream);
+		msg_status = mrcp_parser_run(connection->parser,stream,&message);
+		return mrcp_client_message_handler(connection,message,msg_status);
+	}
+
 	/* calculate actual length of the stream */
 	stream->text.length = offset + length;
 	stream->pos[length] = '\0';
@@ -651,6 +685,8 @@ static apt_bool_t mrcp_client_poller_signal_process(void *obj, const apr_pollfd_
 
 	/* scroll remaining stream */
 	apt_text_stream_scroll(stream);
+	/* release the grown rx buffer, if any, once the stream is fully consumed */
+	mrcp_connection_rx_buffer_shrink(connection);
 	return TRUE;
 }
 
@@ -22,7 +22,7 @@
 mrcp_connection_t* mrcp_connection_create(void)
 {
 	mrcp_connection_t *connection;
-	apr_pool_t *pool = apt_pool_create();
+	apr_pool_t *pool = apt_pool_recyclable_create();
 	if(!pool) {
 		return NULL;
 	}
@@ -42,6 +42,9 @@ mrcp_connection_t* mrcp_connection_create(void)
 	connection->generator = NULL;
 	connection->rx_buffer = NULL;
 	connection->rx_buffer_size = 0;
+	connection->rx_base_buffer = NULL;
+	connection->rx_base_buffer_size = 0;
+	connection->rx_pool = NULL;
 	connection->tx_buffer = NULL;
 	connection->tx_buffer_size = 0;
 
@@ -51,10 +54,68 @@ mrcp_connection_t* mrcp_connection_create(void)
 void mrcp_connection_destroy(mrcp_connection_t *connection)
 {
 	if(connection && connection->pool) {
-		apr_pool_destroy(connection->pool);
+		apt_pool_recycle(connection->pool);
 	}
 }
 
+void mrcp_connection_rx_buffer_create(mrcp_connection_t *connection, apr_size_t size)
+{
+	connection->rx_base_buffer_size = size;
+	connection->rx_base_buffer = apr_palloc(connection->pool,size+1);
+	connection->rx_buffer_size = connection->rx_base_buffer_size;
+	connection->rx_buffer = connection->rx_base_buffer;
+	apt_text_stream_init(&connection->rx_stream,connection->rx_buffer,connection->rx_buffer_size);
+}
+
+apt_bool_t mrcp_connection_rx_buffer_grow(mrcp_connection_t *connection)
+{
+	apt_text_stream_t *stream = &connection->rx_stream;
+	apr_size_t offset = stream->pos - stream->text.buf;
+	apr_size_t size = connection->rx_buffer_size * 2;
+	apr_pool_t *pool;
+	char *buffer;
+
+	if(connection->rx_buffer_size >= MRCP_STREAM_MAX_BUFFER_SIZE) {
+		return FALSE;
+	}
+	if(size > MRCP_STREAM_MAX_BUFFER_SIZE) {
+		size = MRCP_STREAM_MAX_BUFFER_SIZE;
+	}
+
+	/* allocate the grown buffer from a dedicated pool to be able to release it later */
+	pool = apt_subpool_create(connection->pool);
+	if(!pool) {
+		return FALSE;
+	}
+	buffer = apr_palloc(pool,size+1);
+	memcpy(buffer,stream->text.buf,offset);
+	if(connection->rx_pool) {
+		apr_pool_destroy(connection->rx_pool);
+	}
+	connection->rx_pool = pool;
+	connection->rx_buffer = buffer;
+	connection->rx_buffer_size = size;
+
+	stream->text.buf = buffer;
+	stream->text.length = offset;
+	stream->pos = buffer + offset;
+	stream->end = stream->pos;
+	return TRUE;
+}
+
+void mrcp_connection_rx_buffer_shrink(mrcp_connection_t *connection)
+{
+	if(!connection->rx_pool || connection->rx_stream.pos != connection->rx_stream.text.buf) {
+		return;
+	}
+
+	apr_pool_destroy(connection->rx_pool);
+	connection->rx_pool = NULL;
+	connection->rx_buffer = connection->rx_base_buffer;
+	connection->rx_buffer_size = connection->rx_base_buffer_size;
+	apt_text_stream_init(&connection->rx_stream,connection->rx_buffer,connection->rx_buffer_size);
+}
+
 apt_bool_t mrcp_connection_channel_add(mrcp_connection_t *connection, mrcp_control_channel_t *channel)
 {
 	if(!connection || !channel) {
@@ -16,6 +16,7 @@
  * $Id$
  */
 
+#include <apr_thread_mutex.h>
 #include "mrcp_connection.h"
 #include "mrcp_server_connection.h"
 #include "mrcp_control_descriptor.h"
@@ -26,18 +27,38 @@
 #include "apt_pool.h"
 #include "apt_log.h"
 
+/** Opaque MRCPv2 connection worker declaration */
+typedef struct mrcp_connection_worker_t mrcp_connection_worker_t;
+
+/** MRCPv2 connection worker (poller thread processing accepted connections) */
+struct mrcp_connection_worker_t {
+	/** Poller task */
+	apt_poller_task_t                    *task;
+	/** Connection agent the worker belongs to */
+	mrcp_connection_agent_t              *agent;
+	/** List (ring) of MRCP connections processed by the worker */
+	APR_RING_HEAD(mrcp_connection_head_t, mrcp_connection_t) connection_list;
+};
 
 struct mrcp_connection_agent_t {
 	apr_pool_t                           *pool;
 	apt_poller_task_t                    *task;
 	const mrcp_resource_factory_t        *resource_factory;
 
-	/** List (ring) of MRCP connections */
-	APR_RING_HEAD(mrcp_connection_head_t, mrcp_connection_t) connection_list;
+	/** Array of workers, where the first one is the agent's own (main) worker */
+	mrcp_connection_worker_t            **workers;
+	/** Number of workers */
+	apr_size_t                            worker_count;
+	/** Index of the worker to assign the next accepted connection to */
+	apr_size_t                            next_worker;
+	/** Guard of data shared across workers (used only if there is more than one worker) */
+	apr_thread_mutex_t                   *guard;
+
 	/** Table of pending control channels */
 	apr_hash_t                           *pending_channel_table;
 
 	apt_bool_t                            force_new_connection;
+	apr_size_t                            max_connection_count;
 	apr_size_t                            tx_buffer_size;
 	apr_size_t                            rx_buffer_size;
 
@@ -54,7 +75,8 @@ typedef enum {
 	CONNECTION_TASK_MSG_ADD_CHANNEL,
 	CONNECTION_TASK_MSG_MODIFY_CHANNEL,
 	CONNECTION_TASK_MSG_REMOVE_CHANNEL,
-	CONNECTION_TASK_MSG_SEND_MESSAGE
+	CONNECTION_TASK_MSG_SEND_MESSAGE,
+	CONNECTION_TASK_MSG_ADD_CONNECTION
 } connection_task_msg_type_e;
 
 typedef struct connection_task_msg_t connection_task_msg_t;
@@ -64,6 +86,7 @@ struct connection_task_msg_t {
 	mrcp_control_channel_t    *channel;
 	mrcp_control_descriptor_t *descriptor;
 	mrcp_message_t            *message;
+	mrcp_connection_t         *connection;
 };
 
 static apt_bool_t mrcp_server_agent_on_destroy(apt_task_t *task);
@@ -73,6 +96,24 @@ static apt_bool_t mrcp_server_poller_signal_process(void *obj, const apr_pollfd_
 static apt_bool_t mrcp_server_agent_listening_socket_create(mrcp_connection_agent_t *agent);
 static void mrcp_server_agent_listening_socket_destroy(mrcp_connection_agent_t *agent);
 
+static mrcp_connection_worker_t* mrcp_server_worker_create(mrcp_connection_agent_t *agent, const char *id, apr_pool_t *pool);
+
+/** Lock data shared across workers */
+static APR_INLINE void mrcp_server_agent_lock(mrcp_connection_agent_t *agent)
+{
+	if(agent->guard) {
+		apr_thread_mutex_lock(agent->guard);
+	}
+}
+
+/** Unlock data shared across workers */
+static APR_INLINE void mrcp_server_agent_unlock(mrcp_connection_agent_t *agent)
+{
+	if(agent->guard) {
+		apr_thread_mutex_unlock(agent->guard);
+	}
+}
+
 
 /** Create connection agent */
 MRCP_DECLARE(mrcp_connection_agent_t*) mrcp_server_connection_agent_create(
@@ -83,9 +124,7 @@ MRCP_DECLARE(mrcp_connection_agent_t*) mrcp_server_connection_agent_create(
 										apt_bool_t force_new_connection,
 										apr_pool_t *pool)
 {
-	apt_task_t *task;
-	apt_task_vtable_t *vtable;
-	apt_task_msg_pool_t *msg_pool;
+	mrcp_connection_worker_t *worker;
 	mrcp_connection_agent_t *agent;
 
 	if(!listen_ip) {
@@ -99,55 +138,83 @@ MRCP_DECLARE(mrcp_connection_agent_t*) mrcp_server_connection_agent_create(
 	agent->sockaddr = NULL;
 	agent->listen_sock = NULL;
 	agent->force_new_connection = force_new_connection;
+	agent->max_connection_count = max_connection_count;
 	agent->rx_buffer_size = MRCP_STREAM_BUFFER_SIZE;
 	agent->tx_buffer_size = MRCP_STREAM_BUFFER_SIZE;
+	agent->workers = NULL;
+	agent->worker_count = 0;
+	agent->next_worker = 0;
+	agent->guard = NULL;
 
 	apr_sockaddr_info_get(&agent->sockaddr,listen_ip,APR_INET,listen_port,0,pool);
 	if(!agent->sockaddr) {
 		return NULL;
 	}
 
+	worker = mrcp_server_worker_create(agent,id,pool);
+	if(!worker) {
+		return NULL;
+	}
+	agent->task = worker->task;
+	agent->workers = apr_palloc(pool,sizeof(mrcp_connection_worker_t*));
+	agent->workers[0] = worker;
+	agent->worker_count = 1;
+
+	agent->pending_channel_table = apr_hash_make(pool);
+
+	if(mrcp_server_agent_listening_socket_create(agent) != TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Listening Socket [%s] %s:%hu", 
+				id,
+				listen_ip,
+				listen_port);
+	}
+	return agent;
+}
+
+/** Create connection worker */
+static mrcp_connection_worker_t* mrcp_server_worker_create(mrcp_connection_agent_t *agent, const char *id, apr_pool_t *pool)
+{
+	apt_task_t *task;
+	apt_task_vtable_t *vtable;
+	apt_task_msg_pool_t *msg_pool;
+	mrcp_connection_worker_t *worker = apr_palloc(pool,sizeof(mrcp_connection_worker_t));
+	worker->agent = agent;
+	APR_RING_INIT(&worker->connection_list, mrcp_connection_t, link);
+
 	msg_pool = apt_task_msg_pool_create_dynamic(sizeof(connection_task_msg_t),pool);
 	
-	agent->task = apt_poller_task_create(
-					max_connection_count + 1,
+	worker->task = apt_poller_task_create(
+					agent->max_connection_count + 1,
 					mrcp_server_poller_signal_process,
-					agent,
+					worker,
 					msg_pool,
 					pool);
-	if(!agent->task) {
+	if(!worker->task) {
 		return NULL;
 	}
 
-	task = apt_poller_task_base_get(agent->task);
+	task = apt_poller_task_base_get(worker->task);
 	if(task) {
 		apt_task_name_set(task,id);
 	}
 
-	vtable = apt_poller_task_vtable_get(agent->task);
+	vtable = apt_poller_task_vtable_get(worker->task);
 	if(vtable) {
 		vtable->destroy = mrcp_server_agent_on_destroy;
 		vtable->process_msg = mrcp_server_agent_msg_process;
 	}
-
-	APR_RING_INIT(&agent->connection_list, mrcp_connection_t, link);
-	agent->pending_channel_table = apr_hash_make(pool);
-
-	if(mrcp_server_agent_listening_socket_create(agent) != TRUE) {
-		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Listening Socket [%s] %s:%hu", 
-				id,
-				listen_ip,
-				listen_port);
-	}
-	return agent;
+	return worker;
 }
 
 static apt_bool_t mrcp_server_agent_on_destroy(apt_task_t *task)
 {
 	apt_poller_task_t *poller_task = apt_task_object_get(task);
-	mrcp_connection_agent_t *agent = apt_poller_task_object_get(poller_task);
+	mrcp_connection_worker_t *worker = apt_poller_task_object_get(poller_task);
+	mrcp_connection_agent_t *agent = worker->agent;
 
-	mrcp_server_agent_listening_socket_destroy(agent);
+	if(worker->task == agent->task) {
+		mrcp_server_agent_listening_socket_destroy(agent);
+	}
 	apt_poller_task_cleanup(poller_task);
 	return TRUE;
 }
@@ -155,9 +222,15 @@ static apt_bool_t mrcp_server_agent_on_destroy(apt_task_t *task)
 /** Destroy connection agent. */
 MRCP_DECLARE(apt_bool_t) mrcp_server_connection_agent_destroy(mrcp_connection_agent_t *agent)
 {
+	apt_bool_t status;
 	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Destroy MRCPv2 Agent [%s]",
 		mrcp_server_connection_agent_id_get(agent));
-	return apt_poller_task_destroy(agent->task);
+	status = apt_poller_task_destroy(agent->task);
+	if(agent->guard) {
+		apr_thread_mutex_destroy(agent->guard);
+		agent->guard = NULL;
+	}
+	return status;
 }
 
 /** Start connection agent. */
@@ -212,6 +285,50 @@ MRCP_DECLARE(void) mrcp_server_connection_tx_size_set(
 	agent->tx_buffer_size = size;
 }
 
+/** Set number of worker threads */
+MRCP_DECLARE(apt_bool_t) mrcp_server_connection_worker_count_set(
+								mrcp_connection_agent_t *agent,
+								apr_size_t count)
+{
+	apr_size_t i;
+	const char *id;
+	mrcp_connection_worker_t **workers;
+	apt_task_t *main_task = apt_poller_task_base_get(agent->task);
+	if(count <= agent->worker_count) {
+		return FALSE;
+	}
+
+	if(!agent->guard) {
+		if(apr_thread_mutex_create(&agent->guard,APR_THREAD_MUTEX_DEFAULT,agent->pool) != APR_SUCCESS) {
+			agent->guard = NULL;
+			return FALSE;
+		}
+	}
+
+	workers = apr_palloc(agent->pool,sizeof(mrcp_connection_worker_t*) * count);
+	for(i = 0; i < agent->worker_count; i++) {
+		workers[i] = agent->workers[i];
+	}
+
+	for(; i < count; i++) {
+		id = apr_psprintf(agent->pool,"%s-%"APR_SIZE_T_FMT,apt_task_name_get(main_task),i);
+		workers[i] = mrcp_server_worker_create(agent,id,agent->pool);
+		if(!workers[i]) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create MRCPv2 Worker [%s]",id);
+			break;
+		}
+		/* the main task starts, terminates and destroys its child workers */
+		apt_task_add(main_task,apt_poller_task_base_get(workers[i]->task));
+	}
+
+	agent->workers = workers;
+	agent->worker_count = i;
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Set MRCPv2 Agent Workers [%s] [%"APR_SIZE_T_FMT"]",
+		apt_task_name_get(main_task),
+		agent->worker_count);
+	return (agent->worker_count == count) ? TRUE : FALSE;
+}
+
 /** Get task */
 MRCP_DECLARE(apt_task_t*) mrcp_server_connection_agent_task_get(const mrcp_connection_agent_t *agent)
 {
@@ -262,12 +379,14 @@ MRCP_DECLARE(apt_bool_t) mrcp_server_control_channel_destroy(mrcp_control_channe
 /** Signal task message */
 static apt_bool_t mrcp_server_control_message_signal(
 								connection_task_msg_type_e type,
+								apt_poller_task_t *poller_task,
 								mrcp_connection_agent_t *agent,
 								mrcp_control_channel_t *channel,
 								mrcp_control_descriptor_t *descriptor,
-								mrcp_message_t *message)
+								mrcp_message_t *message,
+								mrcp_connection_t *connection)
 {
-	apt_task_t *task = apt_poller_task_base_get(agent->task);
+	apt_task_t *task = apt_poller_task_base_get(poller_task);
 	apt_task_msg_t *task_msg = apt_task_msg_get(task);
 	if(task_msg) {
 		connection_task_msg_t *msg = (connection_task_msg_t*)task_msg->data;
@@ -276,6 +395,7 @@ static apt_bool_t mrcp_server_control_message_signal(
 		msg->channel = channel;
 		msg->descriptor = descriptor;
 		msg->message = message;
+		msg->connection = connection;
 		apt_task_msg_signal(task,task_msg);
 	}
 	return TRUE;
@@ -284,25 +404,39 @@ static apt_bool_t mrcp_server_control_message_signal(
 /** Add MRCPv2 control channel */
 MRCP_DECLARE(apt_bool_t) mrcp_server_control_channel_add(mrcp_control_channel_t *channel, mrcp_control_descriptor_t *descriptor)
 {
-	return mrcp_server_control_message_signal(CONNECTION_TASK_MSG_ADD_CHANNEL,channel->agent,channel,descriptor,NULL);
+	mrcp_connection_agent_t *agent = channel->agent;
+	return mrcp_server_control_message_signal(CONNECTION_TASK_MSG_ADD_CHANNEL,agent->task,agent,channel,descriptor,NULL,NULL);
 }
 
 /** Modify MRCPv2 control channel */
 MRCP_DECLARE(apt_bool_t) mrcp_server_control_channel_modify(mrcp_control_channel_t *channel, mrcp_control_descriptor_t *descriptor)
 {
-	return mrcp_server_control_message_signal(CONNECTION_TASK_MSG_MODIFY_CHANNEL,channel->agent,channel,descriptor,NULL);
+	mrcp_connection_agent_t *agent = channel->agent;
+	return mrcp_server_control_message_signal(CONNECTION_TASK_MSG_MODIFY_CHANNEL,agent->task,agent,channel,descriptor,NULL,NULL);
 }
 
 /** Remove MRCPv2 control channel */
 MRCP_DECLARE(apt_bool_t) mrcp_server_control_channel_remove(mrcp_control_channel_t *channel)
 {
-	return mrcp_server_control_message_signal(CONNECTION_TASK_MSG_REMOVE_CHANNEL,channel->agent,channel,NULL,NULL);
+	mrcp_connection_agent_t *agent = channel->agent;
+	return mrcp_server_control_message_signal(CONNECTION_TASK_MSG_REMOVE_CHANNEL,agent->task,agent,channel,NULL,NULL,NULL);
 }
 
 /** Send MRCPv2 message */
 MRCP_DECLARE(apt_bool_t) mrcp_server_control_message_send(mrcp_control_channel_t *channel, mrcp_message_t *message)
 {
-	return mrcp_server_control_message_signal(CONNECTION_TASK_MSG_SEND_MESSAGE,channel->agent,channel,NULL,message);
+	mrcp_connection_agent_t *agent = channel->agent;
+	apt_poller_task_t *task = agent->task;
+	if(agent->worker_count > 1) {
+		/* deliver the message directly to the worker the connection is assigned to */
+		mrcp_server_agent_lock(agent);
+		if(channel->connection) {
+			mrcp_connection_worker_t *worker = channel->connection->agent;
+			task = worker->task;
+		}
+		mrcp_server_agent_unlock(agent);
+	}
+	return mrcp_server_control_message_signal(CONNECTION_TASK_MSG_SEND_MESSAGE,task,agent,channel,NULL,message,NULL);
 }
 
 /** Create listening socket and add it to pollset */
@@ -371,6 +505,7 @@ static mrcp_control_channel_t* mrcp_connection_channel_associate(mrcp_connection
 		return NULL;
 	}
 	apt_id_resource_generate(&message->channel_id.session_id,&message->channel_id.resource_name,'@',&identifier,connection->pool);
+	mrcp_server_agent_lock(agent);
 	channel = mrcp_connection_channel_find(connection,&identifier);
 	if(!channel) {
 		channel = apr_hash_get(agent->pending_channel_table,identifier.buf,identifier.length);
@@ -384,30 +519,82 @@ static mrcp_control_channel_t* mrcp_connection_channel_associate(mrcp_connection
 				apr_hash_count(connection->channel_table));
 		}
 	}
+	mrcp_server_agent_unlock(agent);
 	return channel;
 }
 
 static mrcp_connection_t* mrcp_connection_find(mrcp_connection_agent_t *agent, const apt_str_t *remote_ip)
 {
+	apr_size_t i;
+	mrcp_connection_worker_t *worker;
 	mrcp_connection_t *connection;
 	if(!agent || !remote_ip) {
 		return NULL;
 	}
 
-	for(connection = APR_RING_FIRST(&agent->connection_list);
-			connection != APR_RING_SENTINEL(&agent->connection_list, mrcp_connection_t, link);
-				connection = APR_RING_NEXT(connection, link)) {
-		if(apt_string_compare(&connection->remote_ip,remote_ip) == TRUE) {
-			return connection;
+	mrcp_server_agent_lock(agent);
+	for(i = 0; i < agent->worker_count; i++) {
+		worker = agent->workers[i];
+		for(connection = APR_RING_FIRST(&worker->connection_list);
+				connection != APR_RING_SENTINEL(&worker->connection_list, mrcp_connection_t, link);
+					connection = APR_RING_NEXT(connection, link)) {
+			if(apt_string_compare(&connection->remote_ip,remote_ip) == TRUE) {
+				mrcp_server_agent_unlock(agent);
+				return connection;
+			}
 		}
 	}
+	mrcp_server_agent_unlock(agent);
 
 	return NULL;
 }
 
 static apt_bool_t mrcp_connection_remove(mrcp_connection_agent_t *agent, mrcp_connection_t *connection)
 {
+	mrcp_server_agent_lock(agent);
 	APR_RING_REMOVE(connection,link);
+	mrcp_server_agent_unlock(agent);
+	return TRUE;
+}
+
+/** Start processing accepted connection in the scope of the specified worker */
+static apt_bool_t mrcp_server_worker_connection_add(mrcp_connection_worker_t *worker, mrcp_connection_t *connection)
+{
+	mrcp_connection_agent_t *agent = worker->agent;
+
+	memset(&connection->sock_pfd,0,sizeof(apr_pollfd_t));
+	connection->sock_pfd.desc_type = APR_POLL_SOCKET;
+	connection->sock_pfd.reqevents = APR_POLLIN;
+	connection->sock_pfd.desc.s = connection->sock;
+	connection->sock_pfd.client_data = connection;
+	if(apt_poller_task_descriptor_add(worker->task, &connection->sock_pfd) != TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Add to Pollset %s",connection->id);
+		apr_socket_close(connection->sock);
+		mrcp_connection_destroy(connection);
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Accepted TCP/MRCPv2 Connection %s [%s]",
+		connection->id,
+		apt_task_name_get(apt_poller_task_base_get(worker->task)));
+	connection->agent = worker;
+	mrcp_server_agent_lock(agent);
+	APR_RING_INSERT_TAIL(&worker->connection_list,connection,mrcp_connection_t,link);
+	mrcp_server_agent_unlock(agent);
+
+	connection->parser = mrcp_parser_create(agent->resource_factory,connection->pool);
+	connection->generator = mrcp_generator_create(agent->resource_factory,connection->pool);
+
+	connection->tx_buffer_size = agent->tx_buffer_size;
+	connection->tx_buffer = apr_palloc(connection->pool,connection->tx_buffer_size+1);
+
+	mrcp_connection_rx_buffer_create(connection,agent->rx_buffer_size);
+	
+	if(apt_log_masking_get() != APT_LOG_MASKING_NONE) {
+		connection->verbose = FALSE;
+		mrcp_parser_verbose_set(connection->parser,TRUE);
+		mrcp_generator_verbose_set(connection->generator,TRUE);
+	}
 	return TRUE;
 }
 
@@ -415,6 +602,8 @@ static apt_bool_t mrcp_server_agent_connection_accept(mrcp_connection_agent_t *a
 {
 	char *local_ip = NULL;
 	char *remote_ip = NULL;
+	apr_size_t pending_count;
+	mrcp_connection_worker_t *worker;
 	
 	mrcp_connection_t *connection = mrcp_connection_create();
 
@@ -439,51 +628,36 @@ static apt_bool_t mrcp_server_agent_connection_accept(mrcp_connection_agent_t *a
 		local_ip,connection->l_sockaddr->port,
 		remote_ip,connection->r_sockaddr->port);
 
-	if(apr_hash_count(agent->pending_channel_table) == 0) {
+	mrcp_server_agent_lock(agent);
+	pending_count = apr_hash_count(agent->pending_channel_table);
+	mrcp_server_agent_unlock(agent);
+	if(pending_count == 0) {
 		apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Reject Unexpected TCP/MRCPv2 Connection %s",connection->id);
 		apr_socket_close(connection->sock);
 		mrcp_connection_destroy(connection);
 		return FALSE;
 	}
 
-	memset(&connection->sock_pfd,0,sizeof(apr_pollfd_t));
-	connection->sock_pfd.desc_type = APR_POLL_SOCKET;
-	connection->sock_pfd.reqevents = APR_POLLIN;
-	connection->sock_pfd.desc.s = connection->sock;
-	connection->sock_pfd.client_data = connection;
-	if(apt_poller_task_descriptor_add(agent->task, &connection->sock_pfd) != TRUE) {
-		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Add to Pollset %s",connection->id);
-		apr_socket_close(connection->sock);
-		mrcp_connection_destroy(connection);
-		return FALSE;
+	/* assign connections to workers in round-robin fashion */
+	worker = agent->workers[agent->next_worker];
+	if(++agent->next_worker >= agent->worker_count) {
+		agent->next_worker = 0;
 	}
 
-	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Accepted TCP/MRCPv2 Connection %s",connection->id);
-	connection->agent = agent;
-	APR_RING_INSERT_TAIL(&agent->connection_list,connection,mrcp_connection_t,link);
-
-	connection->parser = mrcp_parser_create(agent->resource_factory,connection->pool);
-	connection->generator = mrcp_generator_create(agent->resource_factory,connection->pool);
-
-	connection->tx_buffer_size = agent->tx_buffer_size;
-	connection->tx_buffer = apr_palloc(connection->pool,connection->tx_buffer_size+1);
-
-	connection->rx_buffer_size = agent->rx_buffer_size;
-	connection->rx_buffer = apr_palloc(connection->pool,connection->rx_buffer_size+1);
-	apt_text_stream_init(&connection->rx_stream,connection->rx_buffer,connection->rx_buffer_size);
-	
-	if(apt_log_masking_get() != APT_LOG_MASKING_NONE) {
-		connection->verbose = FALSE;
-		mrcp_parser_verbose_set(connection->parser,TRUE);
-		mrcp_generator_verbose_set(connection->generator,TRUE);
+	if(worker->task == agent->task) {
+		return mrcp_server_worker_connection_add(worker,connection);
 	}
-	return TRUE;
+
+	/* hand the accepted connection over to the worker */
+	connection->agent = worker;
+	return mrcp_server_control_message_signal(CONNECTION_TASK_MSG_ADD_CONNECTION,worker->task,agent,NULL,NULL,NULL,connection);
 }
 
 static apt_bool_t mrcp_server_agent_connection_close(mrcp_connection_agent_t *agent, mrcp_connection_t *connection)
 {
+	mrcp_connection_worker_t *worker = connection->agent;
 	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"TCP/MRCPv2 Peer Disconnected %s",connection->id);
-	apt_poller_task_descriptor_remove(agent->task,&connection->sock_pfd);
+	apt_poller_task_descriptor_remove(worker->task,&connection->sock_pfd);
 	apr_socket_close(connection->sock);
 	connection->sock = NULL;
 	if(!connection->access_count) {
@@ -517,10 +691,12 @@ static apt_bool_t mrcp_server_agent_channel_add(mrcp_connection_agent_t *agent,
 		}
 	}
 
+	mrcp_server_agent_lock(agent);
 	apr_hash_set(agent->pending_channel_table,channel->identifier.buf,channel->identifier.length,channel);
 	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Add Pending Control Channel <%s> [%d]",
 			channel->identifier.buf,
 			apr_hash_count(agent->pending_channel_table));
+	mrcp_server_agent_unlock(agent);
 	/* send response */
 	return mrcp_control_channel_add_respond(agent->vtable,channel,answer,TRUE);
 }
@@ -536,17 +712,27 @@ static apt_bool_t mrcp_server_agent_channel_modify(mrcp_connection_agent_t *agen
 	return mrcp_control_channel_modify_respond(agent->vtable,channel,answer,TRUE);
 }
 
-static apt_bool_t mrcp_server_agent_channel_remove(mrcp_connection_agent_t *agent, mrcp_control_channel_t *channel)
+static apt_bool_t mrcp_server_agent_channel_remove(mrcp_connection_worker_t *worker, mrcp_control_channel_t *channel)
 {
-	mrcp_connection_t *connection = channel->connection;
+	mrcp_connection_agent_t *agent = worker->agent;
+	mrcp_connection_t *connection;
+	mrcp_server_agent_lock(agent);
+	connection = channel->connection;
 	if(connection) {
+		mrcp_connection_worker_t *owner = connection->agent;
+		if(owner != worker) {
+			mrcp_server_agent_unlock(agent);
+			/* the connection is processed by another worker, forward the request */
+			return mrcp_server_control_message_signal(CONNECTION_TASK_MSG_REMOVE_CHANNEL,owner->task,agent,channel,NULL,NULL,NULL);
+		}
+
 		mrcp_connection_channel_remove(connection,channel);
 		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Remove Control Channel <%s> [%d]",
 				channel->identifier.buf,
 				apr_hash_count(connection->channel_table));
 		if(!connection->access_count) {
 			if(!connection->sock) {
-				mrcp_connection_remove(agent,connection);
+				APR_RING_REMOVE(connection,link);
 				/* set connection to be destroyed on channel destroy */
 				apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Mark Connection for Removal %s",connection->id);
 				channel->connection = connection;
@@ -560,6 +746,7 @@ static apt_bool_t mrcp_server_agent_channel_remove(mrcp_connection_agent_t *agen
 				channel->identifier.buf,
 				apr_hash_count(agent->pending_channel_table));
 	}
+	mrcp_server_agent_unlock(agent);
 	/* send response */
 	return mrcp_control_channel_remove_respond(agent->vtable,channel,TRUE);
 }
@@ -603,9 +790,25 @@ static apt_bool_t mrcp_server_agent_messsage_send(mrcp_connection_agent_t *agent
 	return status;
 }
 
+static apt_bool_t mrcp_server_worker_messsage_send(mrcp_connection_worker_t *worker, mrcp_control_channel_t *channel, mrcp_message_t *message)
+{
+	mrcp_connection_agent_t *agent = worker->agent;
+	mrcp_connection_t *connection;
+	mrcp_server_agent_lock(agent);
+	connection = channel->connection;
+	mrcp_server_agent_unlock(agent);
+	if(connection && connection->agent != worker) {
+		/* the connection has been assigned to another worker meanwhile, forward the message */
+		mrcp_connection_worker_t *owner = connection->agent;
+		return mrcp_server_control_message_signal(CONNECTION_TASK_MSG_SEND_MESSAGE,owner->task,agent,channel,NULL,message,NULL);
+	}
+	return mrcp_server_agent_messsage_send(agent,connection,message);
+}
+
 static apt_bool_t mrcp_server_message_handler(mrcp_connection_t *connection, mrcp_message_t *message, apt_message_status_e status)
 {
-	mrcp_connection_agent_t *agent = connection->agent;
+	mrcp_connection_worker_t *worker = connection->agent;
+	mrcp_connection_agent_t *agent = worker->agent;
 	if(status == APT_MESSAGE_STATUS_COMPLETE) {
 		/* message is completely parsed */
 		mrcp_control_channel_t *channel = mrcp_connection_channel_associate(agent,connection,message);
@@ -636,11 +839,14 @@ static apt_bool_t mrcp_server_message_handler(mrcp_connection_t *connection, mrc
 /* Receive MRCP message through TCP/MRCPv2 connection */
 static apt_bool_t mrcp_server_poller_signal_process(void *obj, const apr_pollfd_t *descriptor)
 {
-	mrcp_connection_agent_t *agent = obj;
+	mrcp_connection_worker_t *worker = obj;
+	mrcp_connection_agent_t *agent = worker->agent;
 	mrcp_connection_t *connection = descriptor->client_data;
 	apr_status_t status;
 	apr_size_t offset;
 	apr_size_t length;
+	char *buffer;
+	apt_bool_t body_slice = FALSE;
 	apt_text_stream_t *stream;
 	mrcp_message_t *message;
 	apt_message_status_e msg_status;
@@ -656,14 +862,48 @@ static apt_bool_t mrcp_server_poller_signal_process(void *obj, const apr_pollfd_
 
 	/* calculate offset remaining from the previous receive / if any */
 	offset = stream->pos - stream->text.buf;
-	/* calculate available length */
-	length = connection->rx_buffer_size - offset;
+	if(!offset && mrcp_parser_body_slice_get(connection->parser,&buffer,&length) == TRUE) {
+		/* receive the rest of the message body directly into the message, bypassing rx stream */
+		body_slice = TRUE;
+	}
+	else {
+		if(offset == connection->rx_buffer_size) {
+			/* the message part remaining in rx stream does not fit into rx buffer */
+			if(mrcp_connection_rx_buffer_grow(connection) == FALSE) {
+				apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Grow Rx Buffer %s [%"APR_SIZE_T_FMT" bytes]",
+					connection->id,
+					connection->rx_buffer_size);
+			}
+			offset = stream->pos - stream->text.buf;
+		}
+		/* calculate available length */
+		buffer = stream->pos;
+		length = connection->rx_buffer_size - offset;
+	}
 
-	status = apr_socket_recv(connection->sock,stream->pos,&length);
+	status = apr_socket_recv(connection->sock,buffer,&length);
 	if(status == APR_EOF || length == 0) {
 		return mrcp_server_agent_connection_close(agent,connection);
 	}
 
+	if(body_slice == TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Receive MRCPv2 Body %s [%"APR_SIZE_T_FMT" bytes]\n%.*s",
+				connection->id,
+				length,
+				connection->verbose == TRUE ? length : 0,
+				buffer);
+		if(mrcp_parser_body_slice_advance(connection->parser,length) == FALSE) {
+			/* the body is still incomplete */
+			return TRUE;
+		}
+
+		/* the body is complete, run the parser over the empty stream to complete the message */
+		stream->text.length = 0;
+		apt_text_stream_reset(stream);
+		msg_status = mrcp_parser_run(connection->parser,stream,&message);
+		return mrcp_server_message_handler(connection,message,msg_status);
+	}
+
 	/* calculate actual length of the stream */
 	stream->text.length = offset + length;
 	stream->pos[length] = '\0';
@@ -687,6 +927,8 @@ static apt_bool_t mrcp_server_poller_signal_process(void *obj, const apr_pollfd_
 
 	/* scroll remaining stream */
 	apt_text_stream_scroll(stream);
+	/* release the grown rx buffer, if any, once the stream is fully consumed */
+	mrcp_connection_rx_buffer_shrink(connection);
 	return TRUE;
 }
 
@@ -694,7 +936,8 @@ static apt_bool_t mrcp_server_poller_signal_process(void *obj, const apr_pollfd_
 static apt_bool_t mrcp_server_agent_msg_process(apt_task_t *task, apt_task_msg_t *task_msg)
 {
 	apt_poller_task_t *poller_task = apt_task_object_get(task);
-	mrcp_connection_agent_t *agent = apt_poller_task_object_get(poller_task);
+	mrcp_connection_worker_t *worker = apt_poller_task_object_get(poller_task);
+	mrcp_connection_agent_t *agent = worker->agent;
 	connection_task_msg_t *msg = (connection_task_msg_t*) task_msg->data;
 	switch(msg->type) {
 		case CONNECTION_TASK_MSG_ADD_CHANNEL:
@@ -704,10 +947,13 @@ static apt_bool_t mrcp_server_agent_msg_process(apt_task_t *task, apt_task_msg_t
 			mrcp_server_agent_channel_modify(agent,msg->channel,msg->descriptor);
 			break;
 		case CONNECTION_TASK_MSG_REMOVE_CHANNEL:
-			mrcp_server_agent_channel_remove(agent,msg->channel);
+			mrcp_server_agent_channel_remove(worker,msg->channel);
 			break;
 		case CONNECTION_TASK_MSG_SEND_MESSAGE:
-			mrcp_server_agent_messsage_send(agent,msg->channel->connection,msg->message);
+			mrcp_server_worker_messsage_send(worker,msg->channel,msg->message);
+			break;
+		case CONNECTION_TASK_MSG_ADD_CONNECTION:
+			mrcp_server_worker_connection_add(worker,msg->connection);
 			break;
 	}
 
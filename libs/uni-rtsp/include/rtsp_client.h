@@ -72,6 +72,16 @@ RTSP_DECLARE(rtsp_client_t*) rtsp_client_create(
  */
 RTSP_DECLARE(apt_bool_t) rtsp_client_destroy(rtsp_client_t *client);
 
+/**
+ * Set the number of persistent connections per server shared by sessions.
+ * @param client the client to set the number for
+ * @param connection_count the max number of connections per server
+ * @remark By default (0), a dedicated connection is established for each session.
+ *         Otherwise, sessions are assigned to the connection having the least number
+ *         of sessions, while new connections are established up to the specified number.
+ */
+RTSP_DECLARE(void) rtsp_client_shared_connection_count_set(rtsp_client_t *client, apr_size_t connection_count);
+
 /**
  * Start client and wait for incoming requests.
  * @param client the client to start
@@ -73,6 +73,7 @@ typedef enum {
 
 	RTSP_STATUS_CODE_INTERNAL_SERVER_ERROR     = 500,
 	RTSP_STATUS_CODE_NOT_IMPLEMENTED           = 501,
+	RTSP_STATUS_CODE_SERVICE_UNAVAILABLE       = 503,
 } rtsp_status_code_e;
 
 /** Reason phrases */
@@ -89,6 +90,7 @@ typedef enum {
 	RTSP_REASON_PHRASE_SESSION_NOT_FOUND,
 	RTSP_REASON_PHRASE_INTERNAL_SERVER_ERROR,
 	RTSP_REASON_PHRASE_NOT_IMPLEMENTED,
+	RTSP_REASON_PHRASE_SERVICE_UNAVAILABLE,
 	RTSP_REASON_PHRASE_COUNT,
 
 	/** Unknown reason phrase */
@@ -48,6 +48,8 @@ struct rtsp_client_t {
 	APR_RING_HEAD(rtsp_client_connection_head_t, rtsp_client_connection_t) connection_list;
 
 	apr_uint32_t                request_timeout;
+	/** Max number of connections per server shared by sessions (0 - dedicated connection per session) */
+	apr_size_t                  shared_connection_count;
 
 	void                       *obj;
 	const rtsp_client_vtable_t *vtable;
@@ -68,14 +70,18 @@ struct rtsp_client_connection_t {
 	const char       *id;
 	/** RTSP client, connection belongs to */
 	rtsp_client_t    *client;
+	/** Server IP address */
+	const char       *server_ip;
+	/** Server port */
+	apr_port_t        server_port;
 
 	/** Handle table (rtsp_client_session_t*) */
 	apr_hash_t       *handle_table;
 	/** Session table (rtsp_client_session_t*) */
 	apr_hash_t       *session_table;
 	
-	/** Inprogress request/session queue (rtsp_client_session_t*) */
-	apt_obj_list_t   *inprogress_request_queue;
+	/** In-progress request/session table indexed by CSeq (rtsp_client_session_t*) */
+	apr_hash_t       *inprogress_request_table;
 
 	/** Last CSeq sent */
 	apr_size_t        last_cseq;
@@ -141,6 +147,8 @@ static apt_bool_t rtsp_client_message_send(rtsp_client_t *client, rtsp_client_co
 static apt_bool_t rtsp_client_session_message_process(rtsp_client_t *client, rtsp_client_session_t *session, rtsp_message_t *message);
 static apt_bool_t rtsp_client_session_response_process(rtsp_client_t *client, rtsp_client_session_t *session, rtsp_message_t *request, rtsp_message_t *response);
 
+static apt_bool_t rtsp_client_connection_destroy(rtsp_client_connection_t *rtsp_connection);
+
 static void rtsp_client_timer_proc(apt_timer_t *timer, void *obj);
 
 /** Get string identifier */
@@ -195,6 +203,7 @@ RTSP_DECLARE(rtsp_client_t*) rtsp_client_create(
 
 	APR_RING_INIT(&client->connection_list, rtsp_client_connection_t, link);
 	client->request_timeout = (apr_uint32_t)request_timeout;
+	client->shared_connection_count = 0;
 	return client;
 }
 
@@ -203,9 +212,19 @@ RTSP_DECLARE(apt_bool_t) rtsp_client_destroy(rtsp_client_t *client)
 {
 	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Destroy RTSP Client [%s]",
 			rtsp_client_id_get(client));
+	/* destroy persistent connections left open */
+	while(!APR_RING_EMPTY(&client->connection_list, rtsp_client_connection_t, link)) {
+		rtsp_client_connection_destroy(APR_RING_FIRST(&client->connection_list));
+	}
 	return apt_poller_task_destroy(client->task);
 }
 
+/** Set the number of persistent connections per server shared by sessions */
+RTSP_DECLARE(void) rtsp_client_shared_connection_count_set(rtsp_client_t *client, apr_size_t connection_count)
+{
+	client->shared_connection_count = connection_count;
+}
+
 /** Start connection agent */
 RTSP_DECLARE(apt_bool_t) rtsp_client_start(rtsp_client_t *client)
 {
@@ -276,7 +295,7 @@ RTSP_DECLARE(rtsp_client_session_t*) rtsp_client_session_create(
 											const char *resource_location)
 {
 	rtsp_client_session_t *session;
-	apr_pool_t *pool = apt_pool_create();
+	apr_pool_t *pool = apt_pool_recyclable_create();
 	session = apr_palloc(pool,sizeof(rtsp_client_session_t));
 	session->pool = pool;
 	session->obj = NULL;
@@ -304,7 +323,7 @@ RTSP_DECLARE(void) rtsp_client_session_destroy(rtsp_client_session_t *session)
 {
 	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Destroy RTSP Handle "APT_PTR_FMT,session);
 	if(session && session->pool) {
-		apr_pool_destroy(session->pool);
+		apt_pool_recycle(session->pool);
 	}
 }
 
@@ -388,6 +407,43 @@ static apt_bool_t rtsp_client_connection_close(rtsp_client_t *client, rtsp_clien
 }
 
 
+/* Find persistent RTSP connection to share with the session */
+static rtsp_client_connection_t* rtsp_client_connection_find(rtsp_client_t *client, rtsp_client_session_t *session)
+{
+	rtsp_client_connection_t *rtsp_connection;
+	rtsp_client_connection_t *least_used_connection = NULL;
+	apr_size_t least_handle_count = 0;
+	apr_size_t handle_count;
+	apr_size_t connection_count = 0;
+
+	if(!client->shared_connection_count) {
+		return NULL;
+	}
+
+	for(rtsp_connection = APR_RING_FIRST(&client->connection_list);
+			rtsp_connection != APR_RING_SENTINEL(&client->connection_list, rtsp_client_connection_t, link);
+				rtsp_connection = APR_RING_NEXT(rtsp_connection, link)) {
+		if(!rtsp_connection->sock ||
+			rtsp_connection->server_port != session->server_port ||
+			strcmp(rtsp_connection->server_ip,session->server_ip.buf) != 0) {
+			continue;
+		}
+
+		connection_count++;
+		handle_count = apr_hash_count(rtsp_connection->handle_table);
+		if(!least_used_connection || handle_count < least_handle_count) {
+			least_used_connection = rtsp_connection;
+			least_handle_count = handle_count;
+		}
+	}
+
+	if(least_used_connection && least_handle_count && connection_count < client->shared_connection_count) {
+		/* all the connections are in use, establish a new one */
+		return NULL;
+	}
+	return least_used_connection;
+}
+
 /* Create RTSP connection */
 static apt_bool_t rtsp_client_connection_create(rtsp_client_t *client, rtsp_client_session_t *session)
 {
@@ -410,12 +466,14 @@ static apt_bool_t rtsp_client_connection_create(rtsp_client_t *client, rtsp_clie
 	}
 	rtsp_connection->handle_table = apr_hash_make(pool);
 	rtsp_connection->session_table = apr_hash_make(pool);
-	rtsp_connection->inprogress_request_queue = apt_list_create(pool);
+	rtsp_connection->inprogress_request_table = apr_hash_make(pool);
 	apt_text_stream_init(&rtsp_connection->rx_stream,rtsp_connection->rx_buffer,sizeof(rtsp_connection->rx_buffer)-1);
 	apt_text_stream_init(&rtsp_connection->tx_stream,rtsp_connection->tx_buffer,sizeof(rtsp_connection->tx_buffer)-1);
 	rtsp_connection->parser = rtsp_parser_create(pool);
 	rtsp_connection->generator = rtsp_generator_create(pool);
 	rtsp_connection->last_cseq = 0;
+	rtsp_connection->server_ip = apr_pstrdup(pool,session->server_ip.buf);
+	rtsp_connection->server_port = session->server_port;
 
 	rtsp_connection->client = client;
 	APR_RING_INSERT_TAIL(&client->connection_list,rtsp_connection,rtsp_client_connection_t,link);
@@ -435,6 +493,17 @@ static apt_bool_t rtsp_client_connection_destroy(rtsp_client_connection_t *rtsp_
 	return TRUE;
 }
 
+/* Release RTSP connection no longer used by any session, return TRUE if the connection has been destroyed */
+static apt_bool_t rtsp_client_connection_release(rtsp_client_t *client, rtsp_client_connection_t *rtsp_connection)
+{
+	if(client->shared_connection_count && rtsp_connection->sock) {
+		/* keep the connection open for subsequent sessions */
+		apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Keep Persistent RTSP Connection %s",rtsp_connection->id);
+		return FALSE;
+	}
+	return rtsp_client_connection_destroy(rtsp_connection);
+}
+
 /* Respond to session termination request */
 static apt_bool_t rtsp_client_session_terminate_respond(rtsp_client_t *client, rtsp_client_session_t *session)
 {
@@ -492,7 +561,7 @@ static apt_bool_t rtsp_client_session_terminate_process(rtsp_client_t *client, r
 			rtsp_client_session_terminate_respond(client,session);
 
 			if(apr_hash_count(rtsp_connection->handle_table) == 0) {
-				rtsp_client_connection_destroy(rtsp_connection);
+				rtsp_client_connection_release(client,rtsp_connection);
 			}
 		}
 	}
@@ -527,8 +596,14 @@ static apt_bool_t rtsp_client_request_push(rtsp_client_connection_t *rtsp_connec
 		session,
 		message->header.session_id.buf ? message->header.session_id.buf : "new",
 		message->header.cseq);
-	apt_list_push_back(rtsp_connection->inprogress_request_queue,session,session->pool);
 	session->active_request = message;
+	/* the key references the CSeq of the request, which remains in the table until the response is received;
+	   the hash entries are recycled by the table itself, thus no allocation is made per request */
+	apr_hash_set(
+		rtsp_connection->inprogress_request_table,
+		&message->header.cseq,
+		sizeof(message->header.cseq),
+		session);
 	if(rtsp_connection->client->request_timeout) {
 		apt_timer_set(session->request_timer,rtsp_connection->client->request_timeout);
 	}
@@ -537,36 +612,43 @@ static apt_bool_t rtsp_client_request_push(rtsp_client_connection_t *rtsp_connec
 
 static apt_bool_t rtsp_client_request_pop(rtsp_client_connection_t *rtsp_connection, rtsp_message_t *response, rtsp_message_t **ret_request, rtsp_client_session_t **ret_session)
 {
-	rtsp_client_session_t *session;
-	apt_list_elem_t *elem = apt_list_first_elem_get(rtsp_connection->inprogress_request_queue);
-	while(elem) {
-		session = apt_list_elem_object_get(elem);
-		if(session->active_request && session->active_request->header.cseq == response->header.cseq) {
-			if(ret_session) {
-				*ret_session = session;
-			}
-			if(ret_request) {
-				*ret_request = session->active_request;
-			}
-			apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Pop In-Progress RTSP Request "APT_PTR_FMT" CSeq:%"APR_SIZE_T_FMT, 
-				session, 
-				response->header.cseq);
-			apt_list_elem_remove(rtsp_connection->inprogress_request_queue,elem);
-			session->active_request = NULL;
-			apt_timer_kill(session->request_timer);
-			return TRUE;
-		}
-		elem = apt_list_next_elem_get(rtsp_connection->inprogress_request_queue,elem);
+	rtsp_client_session_t *session = apr_hash_get(
+										rtsp_connection->inprogress_request_table,
+										&response->header.cseq,
+										sizeof(response->header.cseq));
+	if(!session || !session->active_request) {
+		return FALSE;
 	}
-	return FALSE;
+
+	if(ret_session) {
+		*ret_session = session;
+	}
+	if(ret_request) {
+		*ret_request = session->active_request;
+	}
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Pop In-Progress RTSP Request "APT_PTR_FMT" CSeq:%"APR_SIZE_T_FMT, 
+		session, 
+		response->header.cseq);
+	apr_hash_set(
+		rtsp_connection->inprogress_request_table,
+		&response->header.cseq,
+		sizeof(response->header.cseq),
+		NULL);
+	session->active_request = NULL;
+	apt_timer_kill(session->request_timer);
+	return TRUE;
 }
 
 /* Process outgoing RTSP request */
 static apt_bool_t rtsp_client_session_request_process(rtsp_client_t *client, rtsp_client_session_t *session, rtsp_message_t *message)
 {
 	if(!session->connection) {
-		/* create RTSP connection */
-		if(rtsp_client_connection_create(client,session) == FALSE) {
+		/* find persistent RTSP connection or create a new one */
+		session->connection = rtsp_client_connection_find(client,session);
+		if(session->connection) {
+			apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Share RTSP Connection %s",session->connection->id);
+		}
+		else if(rtsp_client_connection_create(client,session) == FALSE) {
 			/* respond with error */
 			return FALSE;
 		}
@@ -777,14 +859,22 @@ static apt_bool_t rtsp_client_on_disconnect(rtsp_client_t *client, rtsp_client_c
 {
 	rtsp_client_session_t *session;
 	apr_size_t remaining_handles;
+	apr_hash_index_t *it;
+	const void *key;
+	apr_ssize_t klen;
+	void *val;
 
 	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"RTSP Peer Disconnected %s", rtsp_connection->id);
 	rtsp_client_connection_close(client,rtsp_connection);
 
 	/* Cancel in-progreess requests */
 	do {
-		session = apt_list_pop_front(rtsp_connection->inprogress_request_queue);
-		if(session) {
+		session = NULL;
+		it = apr_hash_first(NULL,rtsp_connection->inprogress_request_table);
+		if(it) {
+			apr_hash_this(it,&key,&klen,&val);
+			session = val;
+			apr_hash_set(rtsp_connection->inprogress_request_table,key,klen,NULL);
 			if(rtsp_client_request_cancel(
 						client,
 						session,
@@ -799,8 +889,6 @@ static apt_bool_t rtsp_client_on_disconnect(rtsp_client_t *client, rtsp_client_c
 	/* Walk through RTSP handles and raise termination event for them */
 	remaining_handles = apr_hash_count(rtsp_connection->handle_table);
 	if(remaining_handles) {
-		void *val;
-		apr_hash_index_t *it;
 		apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Terminate Remaining RTSP Handles [%"APR_SIZE_T_FMT"]",remaining_handles);
 		it = apr_hash_first(rtsp_connection->pool,rtsp_connection->session_table);
 		for(; it; it = apr_hash_next(it)) {
@@ -811,6 +899,11 @@ static apt_bool_t rtsp_client_on_disconnect(rtsp_client_t *client, rtsp_client_c
 			}
 		}
 	}
+	else {
+		/* persistent connection is no longer used by any session */
+		rtsp_client_connection_destroy(rtsp_connection);
+		return FALSE;
+	}
 
 	return TRUE;
 }
@@ -890,9 +983,10 @@ static apt_bool_t rtsp_client_message_handler(rtsp_client_connection_t *rtsp_con
 					rtsp_client_session_terminate_respond(rtsp_connection->client,session);
 
 					if(apr_hash_count(rtsp_connection->handle_table) == 0) {
-						rtsp_client_connection_destroy(rtsp_connection);
-						/* return FALSE to indicate connection has been destroyed */
-						return FALSE;
+						if(rtsp_client_connection_release(rtsp_connection->client,rtsp_connection) == TRUE) {
+							/* return FALSE to indicate connection has been destroyed */
+							return FALSE;
+						}
 					}
 				}
 			}
@@ -316,7 +316,7 @@ RTSP_DECLARE(apt_bool_t) rtsp_server_session_terminate(rtsp_server_t *server, rt
 static rtsp_server_session_t* rtsp_server_session_create(rtsp_server_t *server)
 {
 	rtsp_server_session_t *session;
-	apr_pool_t *pool = apt_pool_create();
+	apr_pool_t *pool = apt_pool_recyclable_create();
 	session = apr_palloc(pool,sizeof(rtsp_server_session_t));
 	session->pool = pool;
 	session->obj = NULL;
@@ -329,7 +329,7 @@ static rtsp_server_session_t* rtsp_server_session_create(rtsp_server_t *server)
 	apt_unique_id_generate(&session->id,RTSP_SESSION_ID_HEX_STRING_LENGTH,pool);
 	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Create RTSP Session "APT_SID_FMT,session->id.buf);
 	if(server->vtable->create_session(server,session) != TRUE) {
-		apr_pool_destroy(pool);
+		apt_pool_recycle(pool);
 		return NULL;
 	}
 	return session;
@@ -341,7 +341,7 @@ static void rtsp_server_session_destroy(rtsp_server_session_t *session)
 	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Destroy RTSP Session "APT_SID_FMT,
 		session ? session->id.buf : "(null)");
 	if(session && session->pool) {
-		apr_pool_destroy(session->pool);
+		apt_pool_recycle(session->pool);
 	}
 }
 
@@ -638,7 +638,8 @@ static apt_bool_t rtsp_server_message_handler(rtsp_server_connection_t *rtsp_con
 		apt_str_t *destination;
 		destination = &message->header.transport.destination;
 		if(!destination->buf && rtsp_connection->client_ip) {
-			apt_string_assign(destination,rtsp_connection->client_ip,rtsp_connection->pool);
+			/* allocate from the message pool, the connection may serve unlimited number of requests */
+			apt_string_assign(destination,rtsp_connection->client_ip,message->pool);
 		}
 		rtsp_server_session_request_process(rtsp_connection->server,rtsp_connection,message);
 	}
@@ -49,7 +49,8 @@ static const apt_str_table_item_t rtsp_reason_string_table[] = {
 	{{"Request Timeout",       15},0},
 	{{"Session Not Found",     17},0},
 	{{"Internal Server Error", 21},0},
-	{{"Not Implemented",       15},4}
+	{{"Not Implemented",       15},4},
+	{{"Service Unavailable",   19},0}
 };
 
 /** Parse RTSP URI */
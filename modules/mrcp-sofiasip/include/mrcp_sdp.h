@@ -34,6 +34,13 @@ MRCP_DECLARE(apr_size_t) sdp_string_generate_by_mrcp_descriptor(char *buffer, ap
 /** Generate MRCP descriptor by SDP session */
 MRCP_DECLARE(apt_bool_t) mrcp_descriptor_generate_by_sdp_session(mrcp_session_descriptor_t* descriptor, const sdp_session_t *sdp, const char *force_destination_ip, apr_pool_t *pool);
 
+/**
+ * Generate MRCP descriptor by SDP string using the fast-path scanner.
+ * @return FALSE, if SDP is not of the common MRCP shape; in this case the descriptor is left
+ *         intact and SDP should be parsed by sdp_parse() and mrcp_descriptor_generate_by_sdp_session()
+ */
+MRCP_DECLARE(apt_bool_t) mrcp_descriptor_generate_by_sdp_string(mrcp_session_descriptor_t *descriptor, const char *sdp_str, apr_size_t length, const char *force_destination_ip, apr_pool_t *pool);
+
 /** Generate SDP resource discovery string */
 MRCP_DECLARE(apr_size_t) sdp_resource_discovery_string_generate(const char *ip, const char *origin, char *buffer, apr_size_t size);
 
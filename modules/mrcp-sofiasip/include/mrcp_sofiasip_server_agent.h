@@ -63,6 +63,9 @@ struct mrcp_sofia_server_config_t {
 	apt_bool_t tport_log;
 	/** Dump SIP messages to the specified file */
 	char      *tport_dump_file;
+	/** Number of SIP stacks, each running its own event loop and bound to
+	the subsequent port, to distribute new calls across */
+	apr_size_t worker_count;
 };
 
 /**
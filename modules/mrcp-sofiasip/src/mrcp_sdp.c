@@ -17,6 +17,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <apr_general.h>
 #include <sofia-sip/sdp.h>
 #include "mrcp_sdp.h"
@@ -383,6 +384,493 @@ static apt_bool_t mrcp_control_media_generate(mrcp_control_descriptor_t *control
 	return TRUE;
 }
 
+/** Max number of media formats accepted by the fast-path scanner */
+#define SDP_SCAN_MAX_FORMAT_COUNT 32
+
+/** SDP line */
+typedef struct {
+	/** Line type (v, o, s, c, t, m, a, ...) */
+	char      type;
+	/** Line value following the '=' */
+	apt_str_t value;
+} sdp_line_t;
+
+/** Media description being scanned */
+typedef struct {
+	/** Media type */
+	sdp_media_e type;
+	/** Payload types listed in the m-line */
+	int         formats[SDP_SCAN_MAX_FORMAT_COUNT];
+	/** Number of payload types */
+	apr_size_t  format_count;
+	/** Payload types having an rtpmap attribute (bitmask) */
+	apr_uint32_t rtpmap_mask[4];
+} sdp_scan_media_t;
+
+/** Read next SDP line */
+static apt_bool_t sdp_line_read(const char **pos, const char *end, sdp_line_t *line)
+{
+	const char *eol;
+	const char *next;
+	if(*pos >= end) {
+		return FALSE;
+	}
+
+	eol = memchr(*pos,'\n',end - *pos);
+	if(eol) {
+		next = eol + 1;
+	}
+	else {
+		eol = next = end;
+	}
+	if(eol > *pos && *(eol - 1) == '\r') {
+		eol--;
+	}
+
+	if(eol - *pos >= 2 && (*pos)[1] == '=') {
+		line->type = **pos;
+		line->value.buf = (char*)*pos + 2;
+		line->value.length = eol - *pos - 2;
+	}
+	else {
+		line->type = 0;
+		apt_string_reset(&line->value);
+	}
+	*pos = next;
+	return TRUE;
+}
+
+/** Check whether the character separates fields of SDP line */
+#define SDP_IS_FIELD_SEPARATOR(ch) ((ch) == ' ' || (ch) == '\t')
+
+/** Read next space separated field of SDP line, skipping runs of whitespace as the full parser does */
+static apt_bool_t sdp_field_read(apt_str_t *value, apt_str_t *field)
+{
+	apr_size_t i = 0;
+	while(i < value->length && SDP_IS_FIELD_SEPARATOR(value->buf[i])) {
+		i++;
+	}
+
+	field->buf = value->buf + i;
+	while(i < value->length && !SDP_IS_FIELD_SEPARATOR(value->buf[i])) {
+		i++;
+	}
+	field->length = value->buf + i - field->buf;
+
+	value->buf += i;
+	value->length -= i;
+	return field->length ? TRUE : FALSE;
+}
+
+/** Split SDP attribute into name and value */
+static void sdp_attrib_split(const apt_str_t *attrib, apt_str_t *name, apt_str_t *value)
+{
+	char *colon = memchr(attrib->buf,':',attrib->length);
+	name->buf = attrib->buf;
+	if(colon) {
+		name->length = colon - attrib->buf;
+		value->buf = colon + 1;
+		value->length = attrib->length - name->length - 1;
+	}
+	else {
+		name->length = attrib->length;
+		apt_string_reset(value);
+	}
+}
+
+/** Parse decimal number, which may be followed by the specified delimiter only */
+static apt_bool_t sdp_number_parse(const apt_str_t *str, char delimiter, apr_size_t *number)
+{
+	apr_size_t i;
+	*number = 0;
+	for(i = 0; i < str->length; i++) {
+		if(str->buf[i] < '0' || str->buf[i] > '9') {
+			if(i && str->buf[i] == delimiter) {
+				return TRUE;
+			}
+			return FALSE;
+		}
+		*number = *number * 10 + (str->buf[i] - '0');
+		if(*number > 0xFFFF) {
+			return FALSE;
+		}
+	}
+	return i ? TRUE : FALSE;
+}
+
+/** Parse connection data (c=IN IP4 address) */
+static apt_bool_t sdp_connection_parse(const apt_str_t *value, apt_str_t *address)
+{
+	if(value->length <= 8 || strncmp(value->buf,"IN IP4 ",7) != 0) {
+		return FALSE;
+	}
+	address->buf = value->buf + 7;
+	address->length = value->length - 7;
+	/* multicast TTL and address count are not expected */
+	if(memchr(address->buf,'/',address->length) || memchr(address->buf,' ',address->length)) {
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/** Parse media description (m=media port proto fmt ...) */
+static apt_bool_t sdp_media_parse(const apt_str_t *line_value, sdp_scan_media_t *media, apr_size_t *port)
+{
+	apt_str_t value = *line_value;
+	apt_str_t field;
+	apr_size_t format;
+
+	media->format_count = 0;
+	memset(media->rtpmap_mask,0,sizeof(media->rtpmap_mask));
+	if(sdp_field_read(&value,&field) == FALSE) {
+		return FALSE;
+	}
+	if(field.length == 5 && strncmp(field.buf,"audio",5) == 0) {
+		media->type = sdp_media_audio;
+	}
+	else if(field.length == 5 && strncmp(field.buf,"video",5) == 0) {
+		media->type = sdp_media_video;
+	}
+	else if(field.length == 11 && strncmp(field.buf,"application",11) == 0) {
+		media->type = sdp_media_application;
+	}
+	else {
+		return FALSE;
+	}
+
+	if(sdp_field_read(&value,&field) == FALSE || sdp_number_parse(&field,0,port) == FALSE) {
+		return FALSE;
+	}
+
+	if(sdp_field_read(&value,&field) == FALSE) {
+		return FALSE;
+	}
+	if(media->type == sdp_media_application) {
+		return (mrcp_proto_find(&field) == MRCP_PROTO_TCP) ? TRUE : FALSE;
+	}
+	if(field.length != 7 || strncmp(field.buf,"RTP/AVP",7) != 0) {
+		return FALSE;
+	}
+
+	while(sdp_field_read(&value,&field) == TRUE) {
+		if(sdp_number_parse(&field,0,&format) == FALSE || format > RTP_PT_DYNAMIC_MAX ||
+			media->format_count >= SDP_SCAN_MAX_FORMAT_COUNT) {
+			return FALSE;
+		}
+		media->formats[media->format_count++] = (int)format;
+	}
+	return media->format_count ? TRUE : FALSE;
+}
+
+/** Parse rtpmap attribute value (pt encoding/rate[/channels]) */
+static apt_bool_t sdp_rtpmap_parse(const apt_str_t *value, apr_size_t *pt, apt_str_t *encoding, apr_size_t *rate)
+{
+	apt_str_t rest = *value;
+	apt_str_t field;
+	char *slash;
+	if(sdp_field_read(&rest,&field) == FALSE || sdp_number_parse(&field,0,pt) == FALSE) {
+		return FALSE;
+	}
+
+	if(sdp_field_read(&rest,encoding) == FALSE || sdp_field_read(&rest,&field) == TRUE) {
+		/* anything following the encoding is passed to the full parser */
+		return FALSE;
+	}
+	slash = memchr(encoding->buf,'/',encoding->length);
+	if(!slash || slash == encoding->buf) {
+		return FALSE;
+	}
+	field.buf = slash + 1;
+	field.length = encoding->length - (slash - encoding->buf) - 1;
+	encoding->length = slash - encoding->buf;
+	return sdp_number_parse(&field,'/',rate);
+}
+
+/** Check whether the listed payload types are all described */
+static apt_bool_t sdp_media_formats_check(const sdp_scan_media_t *media)
+{
+	apr_size_t i;
+	int format;
+	if(media->type == sdp_media_application) {
+		return TRUE;
+	}
+	for(i = 0; i < media->format_count; i++) {
+		format = media->formats[i];
+		if(format != RTP_PT_PCMU && format != RTP_PT_PCMA &&
+			!(media->rtpmap_mask[format / 32] & (1U << (format % 32)))) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/** Check whether SDP is of the common shape the fast-path scanner supports */
+static apt_bool_t sdp_fast_path_check(const char *pos, const char *end)
+{
+	sdp_line_t line;
+	sdp_scan_media_t media;
+	apt_str_t field;
+	apt_str_t name;
+	apt_str_t value;
+	apr_size_t number;
+	apr_size_t i;
+	apt_bool_t in_media = FALSE;
+	int mandatory_lines = 0;
+
+	if(sdp_line_read(&pos,end,&line) == FALSE || line.type != 'v' ||
+		line.value.length != 1 || *line.value.buf != '0') {
+		return FALSE;
+	}
+
+	while(sdp_line_read(&pos,end,&line) == TRUE) {
+		switch(line.type) {
+			case 'o':
+			case 's':
+			case 't':
+				if(in_media == TRUE) {
+					return FALSE;
+				}
+				mandatory_lines++;
+				break;
+			case 'i':
+				break;
+			case 'c':
+				if(sdp_connection_parse(&line.value,&field) == FALSE) {
+					return FALSE;
+				}
+				break;
+			case 'm':
+				if(in_media == TRUE && sdp_media_formats_check(&media) == FALSE) {
+					return FALSE;
+				}
+				if(sdp_media_parse(&line.value,&media,&number) == FALSE) {
+					return FALSE;
+				}
+				in_media = TRUE;
+				break;
+			case 'a':
+				/* session level attributes (e.g. direction) are not expected */
+				if(in_media == FALSE) {
+					return FALSE;
+				}
+				sdp_attrib_split(&line.value,&name,&value);
+				if(name.length == 6 && strncmp(name.buf,"rtpmap",6) == 0) {
+					if(media.type == sdp_media_application ||
+						sdp_rtpmap_parse(&value,&number,&field,&i) == FALSE || number > RTP_PT_DYNAMIC_MAX ||
+						(media.rtpmap_mask[number / 32] & (1U << (number % 32)))) {
+						return FALSE;
+					}
+					for(i = 0; i < media.format_count; i++) {
+						if(media.formats[i] == (int)number)
+							break;
+					}
+					if(i == media.format_count) {
+						/* rtpmap of unlisted payload type */
+						return FALSE;
+					}
+					media.rtpmap_mask[number / 32] |= 1U << (number % 32);
+				}
+				break;
+			case 0:
+				/* allow empty trailing lines only */
+				if(line.value.length || pos < end) {
+					return FALSE;
+				}
+				break;
+			default:
+				/* b=, k=, r=, z= and others are passed to the full parser */
+				return FALSE;
+		}
+	}
+
+	if(in_media == TRUE && sdp_media_formats_check(&media) == FALSE) {
+		return FALSE;
+	}
+	return (mandatory_lines == 3) ? TRUE : FALSE;
+}
+
+/** Generate RTP media descriptor by m-line */
+static mpf_rtp_media_descriptor_t* sdp_scan_rtp_media_create(mrcp_session_descriptor_t *descriptor, const sdp_scan_media_t *media, apr_size_t port, apr_pool_t *pool)
+{
+	apr_size_t i;
+	mpf_codec_descriptor_t *codec;
+	mpf_rtp_media_descriptor_t *rtp_media = apr_palloc(pool,sizeof(mpf_rtp_media_descriptor_t));
+	mpf_rtp_media_descriptor_init(rtp_media);
+	if(media->type == sdp_media_audio) {
+		rtp_media->id = mrcp_session_audio_media_add(descriptor,rtp_media);
+	}
+	else {
+		rtp_media->id = mrcp_session_video_media_add(descriptor,rtp_media);
+	}
+
+	mpf_codec_list_init(&rtp_media->codec_list,5,pool);
+	for(i = 0; i < media->format_count; i++) {
+		codec = mpf_codec_list_add(&rtp_media->codec_list);
+		if(codec) {
+			codec->payload_type = (apr_byte_t)media->formats[i];
+			codec->channel_count = 1;
+			/* static payload types may be described by the m-line only */
+			if(codec->payload_type == RTP_PT_PCMU) {
+				apt_string_set(&codec->name,"PCMU");
+				codec->sampling_rate = 8000;
+			}
+			else if(codec->payload_type == RTP_PT_PCMA) {
+				apt_string_set(&codec->name,"PCMA");
+				codec->sampling_rate = 8000;
+			}
+		}
+	}
+
+	rtp_media->direction = STREAM_DIRECTION_DUPLEX;
+	rtp_media->ip = descriptor->ip;
+	if(port) {
+		rtp_media->port = (apr_port_t)port;
+		rtp_media->state = MPF_MEDIA_ENABLED;
+	}
+	else {
+		rtp_media->state = MPF_MEDIA_DISABLED;
+	}
+	return rtp_media;
+}
+
+/** Set RTP media attribute */
+static void sdp_scan_rtp_attrib_set(mpf_rtp_media_descriptor_t *rtp_media, const apt_str_t *name, const apt_str_t *value, apr_pool_t *pool)
+{
+	apr_size_t number;
+	int i;
+	if(name->length == 6 && strncmp(name->buf,"rtpmap",6) == 0) {
+		apt_str_t encoding;
+		apr_size_t rate;
+		mpf_codec_descriptor_t *codec;
+		apr_array_header_t *descriptor_arr = rtp_media->codec_list.descriptor_arr;
+		sdp_rtpmap_parse(value,&number,&encoding,&rate);
+		for(i = 0; i < descriptor_arr->nelts; i++) {
+			codec = &APR_ARRAY_IDX(descriptor_arr,i,mpf_codec_descriptor_t);
+			if(codec->payload_type == number) {
+				apt_string_assign_n(&codec->name,encoding.buf,encoding.length,pool);
+				codec->sampling_rate = (apr_uint16_t)rate;
+				break;
+			}
+		}
+	}
+	else if(name->length == 8 && strncmp(name->buf,"inactive",8) == 0) {
+		rtp_media->direction = STREAM_DIRECTION_NONE;
+	}
+	else {
+		switch(mpf_rtp_attrib_id_find(name)) {
+			case RTP_ATTRIB_SENDONLY:
+				rtp_media->direction = STREAM_DIRECTION_SEND;
+				break;
+			case RTP_ATTRIB_RECVONLY:
+				rtp_media->direction = STREAM_DIRECTION_RECEIVE;
+				break;
+			case RTP_ATTRIB_SENDRECV:
+				rtp_media->direction = STREAM_DIRECTION_DUPLEX;
+				break;
+			case RTP_ATTRIB_MID:
+				if(sdp_number_parse(value,0,&number) == TRUE)
+					rtp_media->mid = number;
+				break;
+			case RTP_ATTRIB_PTIME:
+				if(sdp_number_parse(value,0,&number) == TRUE)
+					rtp_media->ptime = (apr_uint16_t)number;
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/** Set MRCP control media attribute */
+static void sdp_scan_control_attrib_set(mrcp_control_descriptor_t *control_media, const apt_str_t *name, const apt_str_t *value, apr_pool_t *pool)
+{
+	apr_size_t number;
+	switch(mrcp_attrib_id_find(name)) {
+		case MRCP_ATTRIB_SETUP:
+			control_media->setup_type = mrcp_setup_type_find(value);
+			break;
+		case MRCP_ATTRIB_CONNECTION:
+			control_media->connection_type = mrcp_connection_type_find(value);
+			break;
+		case MRCP_ATTRIB_RESOURCE:
+			apt_string_assign_n(&control_media->resource_name,value->buf,value->length,pool);
+			break;
+		case MRCP_ATTRIB_CHANNEL:
+			apt_id_resource_parse(value,'@',&control_media->session_id,&control_media->resource_name,pool);
+			break;
+		case MRCP_ATTRIB_CMID:
+			if(sdp_number_parse(value,0,&number) == TRUE)
+				mrcp_cmid_add(control_media->cmid_arr,number);
+			break;
+		default:
+			break;
+	}
+}
+
+/** Generate MRCP descriptor by SDP string using the fast-path scanner */
+MRCP_DECLARE(apt_bool_t) mrcp_descriptor_generate_by_sdp_string(mrcp_session_descriptor_t *descriptor, const char *sdp_str, apr_size_t length, const char *force_destination_ip, apr_pool_t *pool)
+{
+	const char *pos = sdp_str;
+	const char *end = sdp_str + length;
+	sdp_line_t line;
+	sdp_scan_media_t media;
+	apt_str_t address;
+	apt_str_t name;
+	apt_str_t value;
+	apr_size_t port;
+	mpf_rtp_media_descriptor_t *rtp_media = NULL;
+	mrcp_control_descriptor_t *control_media = NULL;
+
+	/* validate the whole SDP first, so that nothing is generated if the full parser is needed */
+	if(sdp_fast_path_check(pos,end) == FALSE) {
+		return FALSE;
+	}
+
+	if(force_destination_ip) {
+		apt_string_assign(&descriptor->ip,force_destination_ip,pool);
+	}
+
+	while(sdp_line_read(&pos,end,&line) == TRUE) {
+		if(line.type == 'm') {
+			sdp_media_parse(&line.value,&media,&port);
+			rtp_media = NULL;
+			control_media = NULL;
+			if(media.type == sdp_media_application) {
+				control_media = mrcp_control_descriptor_create(pool);
+				control_media->id = mrcp_session_control_media_add(descriptor,control_media);
+				control_media->proto = MRCP_PROTO_TCP;
+				control_media->ip = descriptor->ip;
+				control_media->port = (apr_port_t)port;
+			}
+			else {
+				rtp_media = sdp_scan_rtp_media_create(descriptor,&media,port,pool);
+			}
+		}
+		else if(line.type == 'c') {
+			sdp_connection_parse(&line.value,&address);
+			if(rtp_media) {
+				apt_string_assign_n(&rtp_media->ip,address.buf,address.length,pool);
+			}
+			else if(control_media) {
+				apt_string_assign_n(&control_media->ip,address.buf,address.length,pool);
+			}
+			else if(!force_destination_ip) {
+				apt_string_assign_n(&descriptor->ip,address.buf,address.length,pool);
+			}
+		}
+		else if(line.type == 'a') {
+			sdp_attrib_split(&line.value,&name,&value);
+			if(rtp_media) {
+				sdp_scan_rtp_attrib_set(rtp_media,&name,&value,pool);
+			}
+			else if(control_media) {
+				sdp_scan_control_attrib_set(control_media,&name,&value,pool);
+			}
+		}
+	}
+	return TRUE;
+}
+
 /** Generate SDP resource discovery string */
 MRCP_DECLARE(apr_size_t) sdp_resource_discovery_string_generate(const char *ip, const char *origin, char *buffer, apr_size_t size)
 {
@@ -435,14 +435,17 @@ static void mrcp_sofia_on_session_ready(
 			MRCP_SESSION_SID(session),
 			remote_sdp_str);
 
-		parser = sdp_parse(sofia_session->home,remote_sdp_str,(int)strlen(remote_sdp_str),0);
-		sdp = sdp_session(parser);
 		if(sofia_session->sip_settings->force_destination == TRUE) {
 			force_destination_ip = sofia_session->sip_settings->server_ip;
 		}
 
-		mrcp_descriptor_generate_by_sdp_session(descriptor,sdp,force_destination_ip,session->pool);
-		sdp_parser_free(parser);
+		if(mrcp_descriptor_generate_by_sdp_string(descriptor,remote_sdp_str,strlen(remote_sdp_str),force_destination_ip,session->pool) == FALSE) {
+			/* fall back to the full parser */
+			parser = sdp_parse(sofia_session->home,remote_sdp_str,(int)strlen(remote_sdp_str),0);
+			sdp = sdp_session(parser);
+			mrcp_descriptor_generate_by_sdp_session(descriptor,sdp,force_destination_ip,session->pool);
+			sdp_parser_free(parser);
+		}
 	}
 
 	mrcp_session_answer(session,descriptor);
@@ -31,6 +31,9 @@ typedef struct mrcp_sofia_session_t mrcp_sofia_session_t;
 #undef strcasecmp
 #undef strncasecmp
 #include <apr_general.h>
+#include <apr_hash.h>
+#include <apr_thread_proc.h>
+#include <apr_thread_cond.h>
 
 #include "mrcp_sofiasip_server_agent.h"
 #include "mrcp_session.h"
@@ -45,14 +48,34 @@ struct mrcp_sofia_agent_t {
 	char                       *sip_contact_str;
 	char                       *sip_bind_str;
 
+	/** Contact to redirect new calls to (worker agents only) */
+	char                       *sip_redirect_str;
+
 	su_root_t                  *root;
 	nua_t                      *nua;
+
+	/** Worker agents bound to the subsequent ports (primary agent only) */
+	mrcp_sofia_agent_t        **workers;
+	/** Number of worker agents */
+	apr_size_t                  worker_count;
+	/** Number of worker agents initialized so far */
+	apr_size_t                  worker_ready_count;
+	/** Guard and condition to wait for worker agents to initialize */
+	apr_thread_mutex_t         *worker_guard;
+	apr_thread_cond_t          *worker_cond;
+
+	/** Primary agent (worker agents only) */
+	mrcp_sofia_agent_t         *primary;
+	/** Thread running the event loop (worker agents only) */
+	apr_thread_t               *thread;
 };
 
 struct mrcp_sofia_session_t {
-	mrcp_session_t *session;
-	su_home_t      *home;
-	nua_handle_t   *nh;
+	mrcp_session_t     *session;
+	su_home_t          *home;
+	nua_handle_t       *nh;
+	/** Agent (primary or worker) the session is handled by */
+	mrcp_sofia_agent_t *agent;
 };
 
 /* Task Interface */
@@ -72,6 +95,8 @@ static const mrcp_session_response_vtable_t session_response_vtable = {
 };
 
 static apt_bool_t mrcp_sofia_config_validate(mrcp_sofia_agent_t *sofia_agent, mrcp_sofia_server_config_t *config, apr_pool_t *pool);
+static apt_bool_t mrcp_sofia_address_compose(mrcp_sofia_agent_t *sofia_agent, apr_port_t port, apr_pool_t *pool);
+static apt_bool_t mrcp_sofia_workers_create(mrcp_sofia_agent_t *sofia_agent, apr_pool_t *pool);
 
 static void mrcp_sofia_event_callback( nua_event_t           nua_event,
 									   int                   status,
@@ -94,13 +119,25 @@ MRCP_DECLARE(mrcp_sig_agent_t*) mrcp_sofiasip_server_agent_create(const char *id
 	sofia_agent = apr_palloc(pool,sizeof(mrcp_sofia_agent_t));
 	sofia_agent->sig_agent = mrcp_signaling_agent_create(id,sofia_agent,pool);
 	sofia_agent->config = config;
+	sofia_agent->sip_redirect_str = NULL;
 	sofia_agent->root = NULL;
 	sofia_agent->nua = NULL;
+	sofia_agent->workers = NULL;
+	sofia_agent->worker_count = 0;
+	sofia_agent->worker_ready_count = 0;
+	sofia_agent->worker_guard = NULL;
+	sofia_agent->worker_cond = NULL;
+	sofia_agent->primary = NULL;
+	sofia_agent->thread = NULL;
 
 	if(mrcp_sofia_config_validate(sofia_agent,config,pool) == FALSE) {
 		return NULL;
 	}
 
+	if(config->worker_count > 1 && mrcp_sofia_workers_create(sofia_agent,pool) == FALSE) {
+		return NULL;
+	}
+
 	task = apt_task_create(sofia_agent,NULL,pool);
 	if(!task) {
 		return NULL;
@@ -113,8 +150,8 @@ MRCP_DECLARE(mrcp_sig_agent_t*) mrcp_sofiasip_server_agent_create(const char *id
 		vtable->terminate = mrcp_sofia_task_terminate;
 	}
 	sofia_agent->sig_agent->task = task;
-	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Create SofiaSIP Agent [%s] ["SOFIA_SIP_VERSION"] %s",
-				id,sofia_agent->sip_bind_str);
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Create SofiaSIP Agent [%s] ["SOFIA_SIP_VERSION"] %s [%"APR_SIZE_T_FMT"]",
+				id,sofia_agent->sip_bind_str,sofia_agent->worker_count + 1);
 	return sofia_agent->sig_agent;
 }
 
@@ -137,6 +174,7 @@ MRCP_DECLARE(mrcp_sofia_server_config_t*) mrcp_sofiasip_server_config_alloc(apr_
 
 	config->tport_log = FALSE;
 	config->tport_dump_file = NULL;
+	config->worker_count = 1;
 
 	return config;
 }
@@ -149,28 +187,70 @@ MRCP_DECLARE(apt_bool_t) mrcp_sofiasip_server_logger_init(const char *name, cons
 static apt_bool_t mrcp_sofia_config_validate(mrcp_sofia_agent_t *sofia_agent, mrcp_sofia_server_config_t *config, apr_pool_t *pool)
 {
 	sofia_agent->config = config;
+	return mrcp_sofia_address_compose(sofia_agent,config->local_port,pool);
+}
+
+static apt_bool_t mrcp_sofia_address_compose(mrcp_sofia_agent_t *sofia_agent, apr_port_t port, apr_pool_t *pool)
+{
+	mrcp_sofia_server_config_t *config = sofia_agent->config;
 	sofia_agent->sip_contact_str = NULL; /* Let Sofia-SIP implicitly set Contact header by default */
 	if(config->ext_ip) {
 		/* Use external IP address in Contact header, if behind NAT */
-		sofia_agent->sip_contact_str = apr_psprintf(pool,"sip:%s:%hu",config->ext_ip,config->local_port);
+		sofia_agent->sip_contact_str = apr_psprintf(pool,"sip:%s:%hu",config->ext_ip,port);
 	}
 	if(config->transport) {
 		sofia_agent->sip_bind_str = apr_psprintf(pool,"sip:%s:%hu;transport=%s",
 											config->local_ip,
-											config->local_port,
+											port,
 											config->transport);
 	}
 	else {
 		sofia_agent->sip_bind_str = apr_psprintf(pool,"sip:%s:%hu",
 											config->local_ip,
-											config->local_port);
+											port);
 	}
 	return TRUE;
 }
 
-static void mrcp_sofia_task_initialize(apt_task_t *task)
+/** Create worker agents bound to the ports subsequent to the port of the primary agent */
+static apt_bool_t mrcp_sofia_workers_create(mrcp_sofia_agent_t *sofia_agent, apr_pool_t *pool)
+{
+	apr_size_t i;
+	apr_port_t port;
+	mrcp_sofia_agent_t *worker;
+	mrcp_sofia_server_config_t *config = sofia_agent->config;
+
+	if(apr_thread_mutex_create(&sofia_agent->worker_guard,APR_THREAD_MUTEX_DEFAULT,pool) != APR_SUCCESS ||
+		apr_thread_cond_create(&sofia_agent->worker_cond,pool) != APR_SUCCESS) {
+		return FALSE;
+	}
+
+	sofia_agent->worker_count = config->worker_count - 1;
+	sofia_agent->workers = apr_palloc(pool,sizeof(mrcp_sofia_agent_t*) * sofia_agent->worker_count);
+	for(i = 0; i < sofia_agent->worker_count; i++) {
+		port = (apr_port_t)(config->local_port + i + 1);
+		worker = apr_palloc(pool,sizeof(mrcp_sofia_agent_t));
+		*worker = *sofia_agent;
+		worker->workers = NULL;
+		worker->worker_count = 0;
+		worker->worker_guard = NULL;
+		worker->worker_cond = NULL;
+		worker->primary = sofia_agent;
+		mrcp_sofia_address_compose(worker,port,pool);
+
+		/* new calls are redirected to the worker by the Contact header of 302 response */
+		worker->sip_redirect_str = apr_psprintf(pool,"sip:%s:%hu%s%s",
+									config->ext_ip ? config->ext_ip : config->local_ip,
+									port,
+									config->transport ? ";transport=" : "",
+									config->transport ? config->transport : "");
+		sofia_agent->workers[i] = worker;
+	}
+	return TRUE;
+}
+
+static void mrcp_sofia_stack_create(mrcp_sofia_agent_t *sofia_agent, const char *name)
 {
-	mrcp_sofia_agent_t *sofia_agent = apt_task_object_get(task);
 	mrcp_sofia_server_config_t *sofia_config = sofia_agent->config;
 
 	/* Initialize Sofia-SIP library and create event loop */
@@ -198,15 +278,13 @@ static void mrcp_sofia_task_initialize(apt_task_t *task)
 		TAG_END());                /* Last tag should always finish the sequence */
 	if(!sofia_agent->nua) {
 		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create NUA [%s] %s",
-					apt_task_name_get(task),
+					name,
 					sofia_agent->sip_bind_str);
 	}
 }
 
-static apt_bool_t mrcp_sofia_task_run(apt_task_t *task)
+static void mrcp_sofia_stack_run(mrcp_sofia_agent_t *sofia_agent)
 {
-	mrcp_sofia_agent_t *sofia_agent = apt_task_object_get(task);
-
 	if(sofia_agent->nua) {
 		/* Run event loop */
 		su_root_run(sofia_agent->root);
@@ -218,6 +296,72 @@ static apt_bool_t mrcp_sofia_task_run(apt_task_t *task)
 	su_root_destroy(sofia_agent->root);
 	sofia_agent->root = NULL;
 	su_deinit();
+}
+
+static void* APR_THREAD_FUNC mrcp_sofia_worker_run(apr_thread_t *thread, void *data)
+{
+	mrcp_sofia_agent_t *worker = data;
+	mrcp_sofia_agent_t *primary = worker->primary;
+
+	mrcp_sofia_stack_create(worker,primary->sig_agent->id);
+
+	/* let the primary agent know the worker is initialized */
+	apr_thread_mutex_lock(primary->worker_guard);
+	primary->worker_ready_count++;
+	apr_thread_cond_signal(primary->worker_cond);
+	apr_thread_mutex_unlock(primary->worker_guard);
+
+	mrcp_sofia_stack_run(worker);
+
+	apr_thread_exit(thread,APR_SUCCESS);
+	return NULL;
+}
+
+static void mrcp_sofia_task_initialize(apt_task_t *task)
+{
+	apr_size_t i;
+	mrcp_sofia_agent_t *worker;
+	mrcp_sofia_agent_t *sofia_agent = apt_task_object_get(task);
+
+	mrcp_sofia_stack_create(sofia_agent,apt_task_name_get(task));
+
+	if(!sofia_agent->worker_count) {
+		return;
+	}
+
+	/* launch worker agents and wait for them to initialize */
+	apr_thread_mutex_lock(sofia_agent->worker_guard);
+	for(i = 0; i < sofia_agent->worker_count; i++) {
+		worker = sofia_agent->workers[i];
+		if(apr_thread_create(&worker->thread,NULL,mrcp_sofia_worker_run,worker,sofia_agent->sig_agent->pool) != APR_SUCCESS) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Launch SIP Worker [%s] %s",
+						apt_task_name_get(task),
+						worker->sip_bind_str);
+			worker->thread = NULL;
+			sofia_agent->worker_ready_count++;
+		}
+	}
+	while(sofia_agent->worker_ready_count < sofia_agent->worker_count) {
+		apr_thread_cond_wait(sofia_agent->worker_cond,sofia_agent->worker_guard);
+	}
+	apr_thread_mutex_unlock(sofia_agent->worker_guard);
+}
+
+static apt_bool_t mrcp_sofia_task_run(apt_task_t *task)
+{
+	apr_size_t i;
+	apr_status_t rv;
+	mrcp_sofia_agent_t *sofia_agent = apt_task_object_get(task);
+
+	mrcp_sofia_stack_run(sofia_agent);
+
+	/* wait for worker agents to complete */
+	for(i = 0; i < sofia_agent->worker_count; i++) {
+		if(sofia_agent->workers[i]->thread) {
+			apr_thread_join(&rv,sofia_agent->workers[i]->thread);
+			sofia_agent->workers[i]->thread = NULL;
+		}
+	}
 
 	apt_task_terminate_request_process(task);
 	return TRUE;
@@ -225,7 +369,13 @@ static apt_bool_t mrcp_sofia_task_run(apt_task_t *task)
 
 static apt_bool_t mrcp_sofia_task_terminate(apt_task_t *task)
 {
+	apr_size_t i;
 	mrcp_sofia_agent_t *sofia_agent = apt_task_object_get(task);
+	for(i = 0; i < sofia_agent->worker_count; i++) {
+		if(sofia_agent->workers[i]->nua) {
+			nua_shutdown(sofia_agent->workers[i]->nua);
+		}
+	}
 	if(sofia_agent->nua) {
 		apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Send Shutdown Signal to NUA [%s]",
 				apt_task_name_get(task));
@@ -245,8 +395,10 @@ static mrcp_sofia_session_t* mrcp_sofia_session_create(mrcp_sofia_agent_t *sofia
 	session->event_vtable = NULL;
 
 	sofia_session = apr_palloc(session->pool,sizeof(mrcp_sofia_session_t));
-	sofia_session->home = su_home_new(sizeof(*sofia_session->home));
+	/* the home is created on demand, only if SDP has to be parsed by the full parser */
+	sofia_session->home = NULL;
 	sofia_session->session = session;
+	sofia_session->agent = sofia_agent;
 	session->obj = sofia_session;
 	
 	nua_handle_bind(nh, sofia_session);
@@ -267,6 +419,8 @@ static int sip_status_get(mrcp_session_status_e status)
 			return 480;
 		case MRCP_SESSION_STATUS_ERROR:
 			return 500;
+		case MRCP_SESSION_STATUS_OVERLOADED:
+			return 503;
 	}
 	return 200;
 }
@@ -274,13 +428,14 @@ static int sip_status_get(mrcp_session_status_e status)
 static apt_bool_t mrcp_sofia_on_session_answer(mrcp_session_t *session, mrcp_session_descriptor_t *descriptor)
 {
 	mrcp_sofia_session_t *sofia_session = session->obj;
-	mrcp_sofia_agent_t *sofia_agent = session->signaling_agent->obj;
+	mrcp_sofia_agent_t *sofia_agent;
 	const char *local_sdp_str = NULL;
 	char sdp_str[2048];
 
-	if(!sofia_agent || !sofia_session || !sofia_session->nh) {
+	if(!sofia_session || !sofia_session->nh) {
 		return FALSE;
 	}
+	sofia_agent = sofia_session->agent;
 
 	if(descriptor->status != MRCP_SESSION_STATUS_OK) {
 		int status = sip_status_get(descriptor->status);
@@ -343,6 +498,22 @@ static void mrcp_sofia_on_call_receive(mrcp_sofia_agent_t   *sofia_agent,
 	mrcp_session_descriptor_t *descriptor;
 
 	if(!sofia_session) {
+		if(sofia_agent->worker_count && sip && sip->sip_call_id && sip->sip_call_id->i_id) {
+			/* distribute new calls across the agents by Call-ID */
+			apr_ssize_t len = (apr_ssize_t)strlen(sip->sip_call_id->i_id);
+			apr_size_t index = apr_hashfunc_default(sip->sip_call_id->i_id,&len) % (sofia_agent->worker_count + 1);
+			if(index > 0 && sofia_agent->workers[index - 1]->nua) {
+				mrcp_sofia_agent_t *worker = sofia_agent->workers[index - 1];
+				apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Redirect SIP Call to %s [%s]",
+					worker->sip_redirect_str,
+					sip->sip_call_id->i_id);
+				nua_respond(nh, SIP_302_MOVED_TEMPORARILY,
+							SIPTAG_CONTACT_STR(worker->sip_redirect_str),
+							TAG_END());
+				return;
+			}
+		}
+
 		sofia_session = mrcp_sofia_session_create(sofia_agent,nh);
 		if(!sofia_session) {
 			nua_respond(nh, SIP_488_NOT_ACCEPTABLE, TAG_END());
@@ -364,10 +535,17 @@ static void mrcp_sofia_on_call_receive(mrcp_sofia_agent_t   *sofia_agent,
 			MRCP_SESSION_SID(sofia_session->session),
 			remote_sdp_str);
 
-		parser = sdp_parse(sofia_session->home,remote_sdp_str,(int)strlen(remote_sdp_str),0);
-		sdp = sdp_session(parser);
-		status = mrcp_descriptor_generate_by_sdp_session(descriptor,sdp,NULL,sofia_session->session->pool);
-		sdp_parser_free(parser);
+		status = mrcp_descriptor_generate_by_sdp_string(descriptor,remote_sdp_str,strlen(remote_sdp_str),NULL,sofia_session->session->pool);
+		if(status == FALSE) {
+			/* fall back to the full parser */
+			if(!sofia_session->home) {
+				sofia_session->home = su_home_new(sizeof(*sofia_session->home));
+			}
+			parser = sdp_parse(sofia_session->home,remote_sdp_str,(int)strlen(remote_sdp_str),0);
+			sdp = sdp_session(parser);
+			status = mrcp_descriptor_generate_by_sdp_session(descriptor,sdp,NULL,sofia_session->session->pool);
+			sdp_parser_free(parser);
+		}
 	}
 
 	if(status == FALSE) {
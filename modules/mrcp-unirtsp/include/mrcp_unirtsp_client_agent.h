@@ -41,6 +41,8 @@ struct rtsp_client_config_t {
 	apr_size_t   max_connection_count;
 	/** Request timeout */
 	apr_size_t   request_timeout;
+	/** Number of persistent RTSP connections per server shared by sessions (0 - connection per session) */
+	apr_size_t   shared_connection_count;
 };
 
 /**
@@ -103,6 +103,7 @@ MRCP_DECLARE(mrcp_sig_agent_t*) mrcp_unirtsp_client_agent_create(const char *id,
 	if(!agent->rtsp_client) {
 		return NULL;
 	}
+	rtsp_client_shared_connection_count_set(agent->rtsp_client,config->shared_connection_count);
 
 	task = rtsp_client_task_get(agent->rtsp_client);
 	agent->sig_agent->task = task;
@@ -117,6 +118,7 @@ MRCP_DECLARE(rtsp_client_config_t*) mrcp_unirtsp_client_config_alloc(apr_pool_t
 	config->origin = NULL;
 	config->max_connection_count = 100;
 	config->request_timeout = 0;
+	config->shared_connection_count = 0;
 	return config;
 }
 
@@ -392,6 +392,9 @@ MRCP_DECLARE(rtsp_message_t*) rtsp_response_generate_by_mrcp_descriptor(const rt
 		case MRCP_SESSION_STATUS_ERROR:
 			response = rtsp_response_create(request,RTSP_STATUS_CODE_INTERNAL_SERVER_ERROR,RTSP_REASON_PHRASE_INTERNAL_SERVER_ERROR,pool);
 			break;
+		case MRCP_SESSION_STATUS_OVERLOADED:
+			response = rtsp_response_create(request,RTSP_STATUS_CODE_SERVICE_UNAVAILABLE,RTSP_REASON_PHRASE_SERVICE_UNAVAILABLE,pool);
+			break;
 	}
 
 	if(!response) {
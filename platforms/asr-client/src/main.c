@@ -59,8 +59,34 @@ static void* APR_THREAD_FUNC asr_session_run(apr_thread_t *thread, void *data)
 	return NULL;
 }
 
+/** Handler of asynchronous ASR session events, called from the client stack task */
+static void asr_session_event_handle(const asr_event_t *event)
+{
+	asr_params_t *params = event->obj;
+	switch(event->type) {
+		case ASR_EVENT_SESSION_CREATED:
+			if(event->status != TRUE ||
+				asr_session_file_recognize_async(event->session,params->grammar_file,params->input_file) != TRUE) {
+				asr_session_destroy_async(event->session);
+			}
+			break;
+		case ASR_EVENT_RECOGNITION_COMPLETED:
+			if(event->result) {
+				printf("Recog Result [%s]",event->result);
+			}
+			asr_session_destroy_async(event->session);
+			break;
+		case ASR_EVENT_SESSION_DESTROYED:
+			/* the session must no longer be referenced, destroy pool params allocated from */
+			apr_pool_destroy(params->pool);
+			break;
+		default:
+			break;
+	}
+}
+
 /** Launch demo ASR session */
-static apt_bool_t asr_session_launch(asr_engine_t *engine, const char *grammar_file, const char *input_file, const char *profile)
+static apt_bool_t asr_session_launch(asr_engine_t *engine, const char *grammar_file, const char *input_file, const char *profile, apt_bool_t async)
 {
 	apr_pool_t *pool;
 	asr_params_t *params;
@@ -92,6 +118,15 @@ static apt_bool_t asr_session_launch(asr_engine_t *engine, const char *grammar_f
 		params->profile = "uni2";
 	}
 
+	if(async == TRUE) {
+		/* Create asynchronous ASR session, the scenario is driven by its events */
+		if(!asr_session_create_async(engine,params->profile,asr_session_event_handle,params)) {
+			apr_pool_destroy(pool);
+			return FALSE;
+		}
+		return TRUE;
+	}
+
 	/* Launch a thread to run demo ASR session in */
 	if(apr_thread_create(&params->thread,NULL,asr_session_run,params,pool) != APR_SUCCESS) {
 		apr_pool_destroy(pool);
@@ -108,11 +143,12 @@ static apt_bool_t cmdline_process(asr_engine_t *engine, char *cmdline)
 	char *last;
 	name = apr_strtok(cmdline, " ", &last);
 
-	if(strcasecmp(name,"run") == 0) {
+	if(strcasecmp(name,"run") == 0 || strcasecmp(name,"arun") == 0) {
+		apt_bool_t async = (strcasecmp(name,"arun") == 0) ? TRUE : FALSE;
 		char *grammar = apr_strtok(NULL, " ", &last);
 		char *input = apr_strtok(NULL, " ", &last);
 		char *profile = apr_strtok(NULL, " ", &last);
-		asr_session_launch(engine,grammar,input,profile);
+		asr_session_launch(engine,grammar,input,profile,async);
 	}
 	else if(strcasecmp(name,"loglevel") == 0) {
 		char *priority = apr_strtok(NULL, " ", &last);
@@ -133,6 +169,8 @@ static apt_bool_t cmdline_process(asr_engine_t *engine, char *cmdline)
 			"           run\n"
 			"           run grammar.xml one.pcm\n"
 			"           run grammar.xml one.pcm uni1\n"
+			"\n- arun [grammar_file] [audio_input_file] [profile_name] (run demo asr client asynchronously)\n"
+			"       the arguments are the same as of the run command\n"
 		    "\n- loglevel [level] (set loglevel, one of 0,1...7)\n"
 		    "\n- quit, exit\n");
 	}
@@ -49,6 +49,38 @@ typedef struct asr_engine_t asr_engine_t;
 /** Opaque ASR session */
 typedef struct asr_session_t asr_session_t;
 
+/** ASR event declaration */
+typedef struct asr_event_t asr_event_t;
+
+/** Types of ASR events raised on completion of asynchronous operations */
+typedef enum {
+	ASR_EVENT_SESSION_CREATED,       /**< session created (response to asr_session_create_async) */
+	ASR_EVENT_RECOGNITION_STARTED,   /**< recognition started, audio data can be written */
+	ASR_EVENT_RECOGNITION_COMPLETED, /**< recognition completed, the result is available */
+	ASR_EVENT_SESSION_DESTROYED      /**< session destroyed (response to asr_session_destroy_async) */
+} asr_event_type_e;
+
+/** ASR event */
+struct asr_event_t {
+	/** Event type */
+	asr_event_type_e type;
+	/** Session the event belongs to */
+	asr_session_t   *session;
+	/** User object associated with the session */
+	void            *obj;
+	/** Status of the completed operation */
+	apt_bool_t       status;
+	/** Recognition result (input element of NLSML content), if any */
+	const char      *result;
+};
+
+/**
+ * Function called on ASR event.
+ * @param event the event raised
+ * @remark The function is called from the context of the client stack task and must not block.
+ */
+typedef void (*asr_event_handler_f)(const asr_event_t *event);
+
 
 /**
  * Create ASR engine.
@@ -121,6 +153,80 @@ ASR_CLIENT_DECLARE(apt_bool_t) asr_session_stream_write(
 ASR_CLIENT_DECLARE(apt_bool_t) asr_session_destroy(asr_session_t *session);
 
 
+/**
+ * Create ASR session asynchronously.
+ * @param engine the engine session belongs to
+ * @param profile the name of UniMRCP profile to use
+ * @param handler the handler to call on session events, or NULL to queue the events
+ *                to be retrieved by asr_engine_event_poll()
+ * @param obj the user object to associate with the session
+ * @remark ASR_EVENT_SESSION_CREATED is raised on completion. If the status of the event
+ *         is FALSE, the session should be destroyed by asr_session_destroy_async().
+ */
+ASR_CLIENT_DECLARE(asr_session_t*) asr_session_create_async(
+									asr_engine_t *engine,
+									const char *profile,
+									asr_event_handler_f handler,
+									void *obj);
+
+/**
+ * Initiate recognition based on specified grammar and input file asynchronously.
+ * @param session the session to run recognition in the scope of
+ * @param grammar_file the name of the grammar file to use (path is relative to data dir)
+ * @param input_file the name of the audio input file to use (path is relative to data dir)
+ * @remark ASR_EVENT_RECOGNITION_STARTED and ASR_EVENT_RECOGNITION_COMPLETED are raised in turn.
+ */
+ASR_CLIENT_DECLARE(apt_bool_t) asr_session_file_recognize_async(
+									asr_session_t *session,
+									const char *grammar_file,
+									const char *input_file);
+
+/**
+ * Initiate recognition based on specified grammar and input stream asynchronously.
+ * @param session the session to run recognition in the scope of
+ * @param grammar_file the name of the grammar file to use (path is relative to data dir)
+ * @remark Audio data should be streamed through asr_session_stream_write_nb() function calls,
+ *         once ASR_EVENT_RECOGNITION_STARTED is raised.
+ */
+ASR_CLIENT_DECLARE(apt_bool_t) asr_session_stream_recognize_async(
+									asr_session_t *session,
+									const char *grammar_file);
+
+/**
+ * Write audio data to recognize without blocking.
+ * @param session the session to write audio data for
+ * @param data the audio data
+ * @param size the size of data
+ * @return the number of bytes accepted, which is less than the size, if the buffer is full
+ * @remark Audio data is accepted by whole frames of 10 msec (160 bytes of 8kHz LPCM),
+ *         the remaining data should be written again later.
+ */
+ASR_CLIENT_DECLARE(int) asr_session_stream_write_nb(
+									asr_session_t *session,
+									const char *data,
+									int size);
+
+/**
+ * Destroy ASR session asynchronously.
+ * @param session the session to destroy
+ * @remark ASR_EVENT_SESSION_DESTROYED is raised on completion, after which the session
+ *         must no longer be referenced. Sessions created by asr_session_create_async()
+ *         must be destroyed by this function only.
+ */
+ASR_CLIENT_DECLARE(apt_bool_t) asr_session_destroy_async(asr_session_t *session);
+
+/**
+ * Retrieve the next queued event of the sessions created without an event handler.
+ * @param engine the engine to retrieve the event from
+ * @param event the event to fill
+ * @param timeout the time in msec to wait for an event (0 - do not wait, -1 - wait infinitely)
+ * @return TRUE if an event is retrieved, FALSE on timeout
+ */
+ASR_CLIENT_DECLARE(apt_bool_t) asr_engine_event_poll(
+									asr_engine_t *engine,
+									asr_event_t *event,
+									long timeout);
+
 /**
  * Set log priority.
  * @param priority the priority to set
@@ -21,6 +21,7 @@
 /* APR includes */
 #include <apr_thread_cond.h>
 #include <apr_thread_proc.h>
+#include <apr_atomic.h>
 
 /* Common includes */
 #include "unimrcp_client.h"
@@ -45,6 +46,24 @@ typedef enum {
 	INPUT_MODE_STREAM
 } input_mode_e;
 
+/** States of asynchronous session */
+typedef enum {
+	ASYNC_STATE_NONE,
+	ASYNC_STATE_ADDING_CHANNEL,
+	ASYNC_STATE_IDLE,
+	ASYNC_STATE_DEFINING_GRAMMAR,
+	ASYNC_STATE_STARTING_RECOGNITION,
+	ASYNC_STATE_RECOGNIZING,
+	ASYNC_STATE_TERMINATING
+} async_state_e;
+
+/** Initial capacity of the event queue */
+#define ASR_EVENT_QUEUE_CAPACITY 256
+/** Size of audio frame written to the media buffer */
+#define ASR_FRAME_SIZE           160
+/** Number of audio frames held in the media buffer */
+#define ASR_FRAME_COUNT          20
+
 /** ASR engine on top of UniMRCP client stack */
 struct asr_engine_t {
 	/** MRCP client stack */
@@ -53,6 +72,21 @@ struct asr_engine_t {
 	mrcp_application_t *mrcp_app;
 	/** Memory pool */
 	apr_pool_t         *pool;
+
+	/** Memory pool of the event queue */
+	apr_pool_t         *event_pool;
+	/** Mutex of the event queue */
+	apr_thread_mutex_t *event_mutex;
+	/** Conditional wait object of the event queue */
+	apr_thread_cond_t  *event_cond;
+	/** Ring of queued events */
+	asr_event_t        *events;
+	/** Capacity of the ring */
+	apr_size_t          event_capacity;
+	/** Index of the first queued event */
+	apr_size_t          event_head;
+	/** Number of queued events */
+	apr_size_t          event_count;
 };
 
 
@@ -83,6 +117,13 @@ struct asr_session_t {
 
 	/** Message sent from client stack */
 	const mrcp_app_message_t *app_message;
+
+	/** State of asynchronous session (async_state_e), accessed by both the user and the client stack threads */
+	volatile apr_uint32_t     async_state;
+	/** Handler of asynchronous session events (NULL - queue events) */
+	asr_event_handler_f       handler;
+	/** User object of asynchronous session */
+	void                     *obj;
 };
 
 
@@ -101,6 +142,19 @@ static const mpf_audio_stream_vtable_t audio_stream_vtable = {
 };
 
 static apt_bool_t app_message_handler(const mrcp_app_message_t *app_message);
+static void asr_async_message_process(asr_session_t *asr_session, const mrcp_app_message_t *app_message);
+
+/** Get state of asynchronous session */
+static APR_INLINE async_state_e asr_async_state_get(asr_session_t *asr_session)
+{
+	return (async_state_e)apr_atomic_read32(&asr_session->async_state);
+}
+
+/** Set state of asynchronous session */
+static APR_INLINE void asr_async_state_set(asr_session_t *asr_session, async_state_e state)
+{
+	apr_atomic_set32(&asr_session->async_state,state);
+}
 
 
 /** Create ASR engine */
@@ -136,6 +190,23 @@ ASR_CLIENT_DECLARE(asr_engine_t*) asr_engine_create(
 	engine->pool = pool;
 	engine->mrcp_client = NULL;
 	engine->mrcp_app = NULL;
+	engine->event_pool = NULL;
+	engine->event_mutex = NULL;
+	engine->event_cond = NULL;
+	engine->event_capacity = ASR_EVENT_QUEUE_CAPACITY;
+	engine->event_head = 0;
+	engine->event_count = 0;
+
+	/* create the event queue */
+	if(apr_pool_create(&engine->event_pool,pool) != APR_SUCCESS ||
+		apr_thread_mutex_create(&engine->event_mutex,APR_THREAD_MUTEX_DEFAULT,pool) != APR_SUCCESS ||
+		apr_thread_cond_create(&engine->event_cond,pool) != APR_SUCCESS) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Event Queue");
+		apt_log_instance_destroy();
+		apr_pool_destroy(pool);
+		return NULL;
+	}
+	engine->events = apr_palloc(engine->event_pool,sizeof(asr_event_t) * engine->event_capacity);
 
 	/* create UniMRCP client stack */
 	mrcp_client = unimrcp_client_create(dir_layout);
@@ -185,6 +256,15 @@ ASR_CLIENT_DECLARE(apt_bool_t) asr_engine_destroy(asr_engine_t *engine)
 		engine->mrcp_app = NULL;
 	}
 
+	if(engine->event_cond) {
+		apr_thread_cond_destroy(engine->event_cond);
+		engine->event_cond = NULL;
+	}
+	if(engine->event_mutex) {
+		apr_thread_mutex_destroy(engine->event_mutex);
+		engine->event_mutex = NULL;
+	}
+
 	/* destroy singleton logger */
 	apt_log_instance_destroy();
 	/* destroy APR pool */
@@ -421,7 +501,10 @@ static apt_bool_t app_message_handler(const mrcp_app_message_t *app_message)
 		app_message->message_type == MRCP_APP_MESSAGE_TYPE_CONTROL) {
 
 		asr_session_t *asr_session = mrcp_application_session_object_get(app_message->session);
-		if(asr_session) {
+		if(asr_session && asr_async_state_get(asr_session) != ASYNC_STATE_NONE) {
+			asr_async_message_process(asr_session,app_message);
+		}
+		else if(asr_session) {
 			apr_thread_mutex_lock(asr_session->mutex);
 			asr_session->app_message = app_message;
 			apr_thread_cond_signal(asr_session->wait_object);
@@ -474,13 +557,124 @@ static mrcp_message_t* mrcp_event_get(const mrcp_app_message_t *app_message)
 	return mrcp_message;
 }
 
-/** Create ASR session */
-ASR_CLIENT_DECLARE(asr_session_t*) asr_session_create(asr_engine_t *engine, const char *profile)
+/** Push event to the queue of the engine */
+static void asr_event_queue_push(asr_engine_t *engine, const asr_event_t *event)
+{
+	apr_thread_mutex_lock(engine->event_mutex);
+	if(engine->event_count == engine->event_capacity) {
+		/* grow the ring twice, preserving the order of queued events */
+		apr_size_t i;
+		asr_event_t *events = apr_palloc(engine->event_pool,sizeof(asr_event_t) * engine->event_capacity * 2);
+		for(i = 0; i < engine->event_count; i++) {
+			events[i] = engine->events[(engine->event_head + i) % engine->event_capacity];
+		}
+		engine->events = events;
+		engine->event_head = 0;
+		engine->event_capacity *= 2;
+	}
+	engine->events[(engine->event_head + engine->event_count) % engine->event_capacity] = *event;
+	engine->event_count++;
+	apr_thread_cond_signal(engine->event_cond);
+	apr_thread_mutex_unlock(engine->event_mutex);
+}
+
+/** Raise event of asynchronous session */
+static void asr_event_raise(asr_session_t *asr_session, asr_event_type_e type, apt_bool_t status, const char *result)
+{
+	asr_event_t event;
+	event.type = type;
+	event.session = asr_session;
+	event.obj = asr_session->obj;
+	event.status = status;
+	event.result = result;
+
+	if(asr_session->handler) {
+		asr_session->handler(&event);
+	}
+	else {
+		asr_event_queue_push(asr_session->engine,&event);
+	}
+}
+
+/** Complete recognition of asynchronous session with failure */
+static void asr_async_recognition_fail(asr_session_t *asr_session)
+{
+	asr_session->streaming = FALSE;
+	asr_async_state_set(asr_session,ASYNC_STATE_IDLE);
+	asr_event_raise(asr_session,ASR_EVENT_RECOGNITION_COMPLETED,FALSE,NULL);
+}
+
+/** Process message of asynchronous session sent from client stack */
+static void asr_async_message_process(asr_session_t *asr_session, const mrcp_app_message_t *app_message)
+{
+	mrcp_message_t *mrcp_message;
+	if(app_message->message_type == MRCP_APP_MESSAGE_TYPE_SIGNALING) {
+		if(app_message->sig_message.command_id == MRCP_SIG_COMMAND_CHANNEL_ADD) {
+			if(asr_async_state_get(asr_session) == ASYNC_STATE_ADDING_CHANNEL) {
+				asr_async_state_set(asr_session,ASYNC_STATE_IDLE);
+			}
+			asr_event_raise(asr_session,ASR_EVENT_SESSION_CREATED,sig_response_check(app_message),NULL);
+		}
+		else if(app_message->sig_message.command_id == MRCP_SIG_COMMAND_SESSION_TERMINATE) {
+			asr_session->streaming = FALSE;
+			asr_event_raise(asr_session,ASR_EVENT_SESSION_DESTROYED,sig_response_check(app_message),NULL);
+			/* nothing refers to the session past the response, destroy it right away */
+			asr_session_destroy_ex(asr_session,FALSE);
+		}
+		return;
+	}
+
+	switch(asr_async_state_get(asr_session)) {
+		case ASYNC_STATE_DEFINING_GRAMMAR:
+			if(mrcp_response_check(app_message,MRCP_REQUEST_STATE_COMPLETE) == TRUE) {
+				/* grammar is defined, proceed with RECOGNIZE request */
+				mrcp_message = recognize_message_create(asr_session);
+				if(mrcp_message) {
+					asr_async_state_set(asr_session,ASYNC_STATE_STARTING_RECOGNITION);
+					if(mrcp_application_message_send(asr_session->mrcp_session,asr_session->mrcp_channel,mrcp_message) == TRUE) {
+						break;
+					}
+				}
+				else {
+					apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create RECOGNIZE Request");
+				}
+			}
+			asr_async_recognition_fail(asr_session);
+			break;
+		case ASYNC_STATE_STARTING_RECOGNITION:
+			if(mrcp_response_check(app_message,MRCP_REQUEST_STATE_INPROGRESS) == TRUE) {
+				if(asr_session->input_mode == INPUT_MODE_STREAM) {
+					/* Reset media buffer */
+					mpf_frame_buffer_restart(asr_session->media_buffer);
+				}
+				asr_async_state_set(asr_session,ASYNC_STATE_RECOGNIZING);
+				asr_session->streaming = TRUE;
+				asr_event_raise(asr_session,ASR_EVENT_RECOGNITION_STARTED,TRUE,NULL);
+			}
+			else {
+				asr_async_recognition_fail(asr_session);
+			}
+			break;
+		case ASYNC_STATE_RECOGNIZING:
+			mrcp_message = mrcp_event_get(app_message);
+			if(mrcp_message && mrcp_message->start_line.method_id == RECOGNIZER_RECOGNITION_COMPLETE) {
+				asr_session->recog_complete = mrcp_message;
+				asr_session->streaming = FALSE;
+				asr_async_state_set(asr_session,ASYNC_STATE_IDLE);
+				asr_event_raise(asr_session,ASR_EVENT_RECOGNITION_COMPLETED,TRUE,nlsml_result_get(mrcp_message));
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/** Allocate ASR session along with MRCP session and channel */
+static asr_session_t* asr_session_alloc(asr_engine_t *engine, const char *profile)
 {
 	mpf_termination_t *termination;
 	mrcp_channel_t *channel;
 	mrcp_session_t *session;
-	const mrcp_app_message_t *app_message;
 	apr_pool_t *pool;
 	asr_session_t *asr_session;
 	mpf_stream_capabilities_t *capabilities;
@@ -532,14 +726,30 @@ ASR_CLIENT_DECLARE(asr_session_t*) asr_session_create(asr_engine_t *engine, cons
 	asr_session->mutex = NULL;
 	asr_session->wait_object = NULL;
 	asr_session->app_message = NULL;
+	asr_async_state_set(asr_session,ASYNC_STATE_NONE);
+	asr_session->handler = NULL;
+	asr_session->obj = NULL;
+
+	/* Create media buffer */
+	asr_session->media_buffer = mpf_frame_buffer_create(ASR_FRAME_SIZE,ASR_FRAME_COUNT,pool);
+	return asr_session;
+}
+
+/** Create ASR session */
+ASR_CLIENT_DECLARE(asr_session_t*) asr_session_create(asr_engine_t *engine, const char *profile)
+{
+	const mrcp_app_message_t *app_message;
+	apr_pool_t *pool;
+	asr_session_t *asr_session = asr_session_alloc(engine,profile);
+	if(!asr_session) {
+		return NULL;
+	}
+	pool = mrcp_application_session_pool_get(asr_session->mrcp_session);
 
 	/* Create cond wait object and mutex */
 	apr_thread_mutex_create(&asr_session->mutex,APR_THREAD_MUTEX_DEFAULT,pool);
 	apr_thread_cond_create(&asr_session->wait_object,pool);
 
-	/* Create media buffer */
-	asr_session->media_buffer = mpf_frame_buffer_create(160,20,pool);
-
 	/* Send add channel request and wait for the response */
 	apr_thread_mutex_lock(asr_session->mutex);
 	app_message = NULL;
@@ -745,6 +955,144 @@ ASR_CLIENT_DECLARE(apt_bool_t) asr_session_destroy(asr_session_t *asr_session)
 	return asr_session_destroy_ex(asr_session,TRUE);
 }
 
+/** Create ASR session asynchronously */
+ASR_CLIENT_DECLARE(asr_session_t*) asr_session_create_async(
+									asr_engine_t *engine,
+									const char *profile,
+									asr_event_handler_f handler,
+									void *obj)
+{
+	asr_session_t *asr_session = asr_session_alloc(engine,profile);
+	if(!asr_session) {
+		return NULL;
+	}
+	asr_session->handler = handler;
+	asr_session->obj = obj;
+
+	/* Send add channel request, the response is processed by the client stack task */
+	asr_async_state_set(asr_session,ASYNC_STATE_ADDING_CHANNEL);
+	if(mrcp_application_channel_add(asr_session->mrcp_session,asr_session->mrcp_channel) != TRUE) {
+		asr_session_destroy_ex(asr_session,FALSE);
+		return NULL;
+	}
+	return asr_session;
+}
+
+/** Initiate recognition of asynchronous session */
+static apt_bool_t asr_session_recognize_async(asr_session_t *asr_session, const char *grammar_file, input_mode_e input_mode)
+{
+	mrcp_message_t *mrcp_message;
+	async_state_e state = asr_async_state_get(asr_session);
+	if(state != ASYNC_STATE_IDLE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Cannot Initiate Recognition in State [%d]",state);
+		return FALSE;
+	}
+
+	mrcp_message = define_grammar_message_create(asr_session,grammar_file);
+	if(!mrcp_message) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create DEFINE-GRAMMAR Request");
+		return FALSE;
+	}
+
+	/* Reset prev recog result (if any) */
+	asr_session->recog_complete = NULL;
+	asr_session->input_mode = input_mode;
+
+	/* Send DEFINE-GRAMMAR request, RECOGNIZE is sent on its completion */
+	asr_async_state_set(asr_session,ASYNC_STATE_DEFINING_GRAMMAR);
+	if(mrcp_application_message_send(asr_session->mrcp_session,asr_session->mrcp_channel,mrcp_message) != TRUE) {
+		asr_async_state_set(asr_session,ASYNC_STATE_IDLE);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/** Initiate recognition based on specified grammar and input file asynchronously */
+ASR_CLIENT_DECLARE(apt_bool_t) asr_session_file_recognize_async(
+									asr_session_t *asr_session,
+									const char *grammar_file,
+									const char *input_file)
+{
+	async_state_e state = asr_async_state_get(asr_session);
+	if(state != ASYNC_STATE_IDLE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Cannot Initiate Recognition in State [%d]",state);
+		return FALSE;
+	}
+
+	/* Open input file in advance, streaming starts on IN-PROGRESS response */
+	if(asr_input_file_open(asr_session,input_file) == FALSE) {
+		return FALSE;
+	}
+	return asr_session_recognize_async(asr_session,grammar_file,INPUT_MODE_FILE);
+}
+
+/** Initiate recognition based on specified grammar and input stream asynchronously */
+ASR_CLIENT_DECLARE(apt_bool_t) asr_session_stream_recognize_async(
+									asr_session_t *asr_session,
+									const char *grammar_file)
+{
+	return asr_session_recognize_async(asr_session,grammar_file,INPUT_MODE_STREAM);
+}
+
+/** Write audio data to recognize without blocking */
+ASR_CLIENT_DECLARE(int) asr_session_stream_write_nb(
+									asr_session_t *asr_session,
+									const char *data,
+									int size)
+{
+	mpf_frame_t frame;
+	int written = 0;
+	frame.type = MEDIA_FRAME_TYPE_AUDIO;
+	frame.marker = MPF_MARKER_NONE;
+	frame.codec_frame.size = ASR_FRAME_SIZE;
+
+	/* write frame by frame, until the buffer is full */
+	while(size - written >= ASR_FRAME_SIZE) {
+		frame.codec_frame.buffer = (void*)(data + written);
+		if(mpf_frame_buffer_write(asr_session->media_buffer,&frame) != TRUE) {
+			break;
+		}
+		written += ASR_FRAME_SIZE;
+	}
+	return written;
+}
+
+/** Destroy ASR session asynchronously */
+ASR_CLIENT_DECLARE(apt_bool_t) asr_session_destroy_async(asr_session_t *asr_session)
+{
+	asr_async_state_set(asr_session,ASYNC_STATE_TERMINATING);
+	return mrcp_application_session_terminate(asr_session->mrcp_session);
+}
+
+/** Retrieve the next queued event */
+ASR_CLIENT_DECLARE(apt_bool_t) asr_engine_event_poll(
+									asr_engine_t *engine,
+									asr_event_t *event,
+									long timeout)
+{
+	apt_bool_t status = FALSE;
+	apr_thread_mutex_lock(engine->event_mutex);
+	if(!engine->event_count && timeout) {
+		if(timeout < 0) {
+			while(!engine->event_count) {
+				apr_thread_cond_wait(engine->event_cond,engine->event_mutex);
+			}
+		}
+		else {
+			apr_thread_cond_timedwait(engine->event_cond,engine->event_mutex,(apr_interval_time_t)timeout * 1000);
+		}
+	}
+
+	if(engine->event_count) {
+		*event = engine->events[engine->event_head];
+		engine->event_head = (engine->event_head + 1) % engine->event_capacity;
+		engine->event_count--;
+		status = TRUE;
+	}
+	apr_thread_mutex_unlock(engine->event_mutex);
+	return status;
+}
+
 /** Set log priority */
 ASR_CLIENT_DECLARE(apt_bool_t) asr_engine_log_priority_set(apt_log_priority_e log_priority)
 {
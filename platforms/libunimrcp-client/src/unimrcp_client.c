@@ -483,6 +483,11 @@ static apt_bool_t unimrcp_client_rtsp_uac_load(unimrcp_client_loader_t *loader,
 				config->request_timeout = atol(cdata_text_get(elem));
 			}
 		}
+		else if(strcasecmp(elem->name,"shared-connection-count") == 0) {
+			if(is_cdata_valid(elem) == TRUE) {
+				config->shared_connection_count = atol(cdata_text_get(elem));
+			}
+		}
 		else {
 			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unknown Element <%s>",elem->name);
 		}
@@ -557,6 +562,8 @@ static apt_bool_t unimrcp_client_media_engine_load(unimrcp_client_loader_t *load
 	const apr_xml_elem *elem;
 	mpf_engine_t *media_engine;
 	unsigned long realtime_rate = 1;
+	apr_size_t rtcp_worker_streams = 0;
+	apr_size_t preallocated_sessions = 0;
 
 	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Loading Media Engine <%s>",id);
 	for(elem = root->first_child; elem; elem = elem->next) {
@@ -566,6 +573,16 @@ static apt_bool_t unimrcp_client_media_engine_load(unimrcp_client_loader_t *load
 				realtime_rate = atol(cdata_text_get(elem));
 			}
 		}
+		else if(strcasecmp(elem->name,"rtcp-worker-streams") == 0) {
+			if(is_cdata_valid(elem) == TRUE) {
+				rtcp_worker_streams = atol(cdata_text_get(elem));
+			}
+		}
+		else if(strcasecmp(elem->name,"preallocated-sessions") == 0) {
+			if(is_cdata_valid(elem) == TRUE) {
+				preallocated_sessions = atol(cdata_text_get(elem));
+			}
+		}
 		else {
 			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unknown Element <%s>",elem->name);
 		}
@@ -574,6 +591,12 @@ static apt_bool_t unimrcp_client_media_engine_load(unimrcp_client_loader_t *load
 	media_engine = mpf_engine_create(id,loader->pool);
 	if(media_engine) {
 		mpf_engine_scheduler_rate_set(media_engine,realtime_rate);
+		if(rtcp_worker_streams) {
+			mpf_engine_rtcp_worker_set(media_engine,rtcp_worker_streams);
+		}
+		if(preallocated_sessions) {
+			mpf_engine_slab_set(media_engine,preallocated_sessions);
+		}
 	}
 	return mrcp_client_media_engine_register(loader->client,media_engine);
 }
@@ -28,6 +28,13 @@
 
 APT_BEGIN_EXTERN_C
 
+/** 
+ * Create UniMRCP server and load its configuration, but do not start it yet.
+ * @param dir_layout the dir layout structure
+ * @remark Further components and profiles can be registered before mrcp_server_start() is called.
+ */
+MRCP_DECLARE(mrcp_server_t*) unimrcp_server_create(apt_dir_layout_t *dir_layout);
+
 /** 
  * Start UniMRCP server.
  * @param dir_layout the dir layout structure
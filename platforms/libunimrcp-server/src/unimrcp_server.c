@@ -45,6 +45,7 @@
 #define DEFAULT_MRCP_PORT         1544
 #define DEFAULT_RTP_PORT_MIN      5000
 #define DEFAULT_RTP_PORT_MAX      6000
+#define DEFAULT_CONTENT_CACHE_SIZE (16 * 1024 * 1024)
 
 #define DEFAULT_SOFIASIP_UA_NAME  "UniMRCP SofiaSIP"
 #define DEFAULT_SDP_ORIGIN        "UniMRCPServer"
@@ -76,8 +77,8 @@ struct unimrcp_server_loader_t {
 
 static apt_bool_t unimrcp_server_load(mrcp_server_t *mrcp_server, apt_dir_layout_t *dir_layout, apr_pool_t *pool);
 
-/** Start UniMRCP server */
-MRCP_DECLARE(mrcp_server_t*) unimrcp_server_start(apt_dir_layout_t *dir_layout)
+/** Create and load UniMRCP server */
+MRCP_DECLARE(mrcp_server_t*) unimrcp_server_create(apt_dir_layout_t *dir_layout)
 {
 	apr_pool_t *pool;
 	mrcp_server_t *server;
@@ -100,6 +101,16 @@ MRCP_DECLARE(mrcp_server_t*) unimrcp_server_start(apt_dir_layout_t *dir_layout)
 	if(unimrcp_server_load(server,dir_layout,pool) == FALSE) {
 		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Load UniMRCP Server Document");
 	}
+	return server;
+}
+
+/** Start UniMRCP server */
+MRCP_DECLARE(mrcp_server_t*) unimrcp_server_start(apt_dir_layout_t *dir_layout)
+{
+	mrcp_server_t *server = unimrcp_server_create(dir_layout);
+	if(!server) {
+		return NULL;
+	}
 
 	mrcp_server_start(server);
 	return server;
@@ -380,6 +391,11 @@ static apt_bool_t unimrcp_server_sip_uas_load(unimrcp_server_loader_t *loader, c
 					config->tport_dump_file = cdata_copy(elem,loader->pool);
 			}
 		}
+		else if(strcasecmp(elem->name,"sip-worker-count") == 0) {
+			if(is_cdata_valid(elem) == TRUE) {
+				config->worker_count = atol(cdata_text_get(elem));
+			}
+		}
 		else {
 			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unknown Element <%s>",elem->name);
 		}
@@ -471,6 +487,7 @@ static apt_bool_t unimrcp_server_mrcpv2_uas_load(unimrcp_server_loader_t *loader
 	apt_bool_t force_new_connection = FALSE;
 	apr_size_t rx_buffer_size = 0;
 	apr_size_t tx_buffer_size = 0;
+	apr_size_t worker_count = 0;
 
 	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Loading MRCPv2 Agent <%s>",id);
 	for(elem = root->first_child; elem; elem = elem->next) {
@@ -503,6 +520,11 @@ static apt_bool_t unimrcp_server_mrcpv2_uas_load(unimrcp_server_loader_t *loader
 				tx_buffer_size = atol(cdata_text_get(elem));
 			}
 		}
+		else if(strcasecmp(elem->name,"worker-count") == 0) {
+			if(is_cdata_valid(elem) == TRUE) {
+				worker_count = atol(cdata_text_get(elem));
+			}
+		}
 		else {
 			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unknown Element <%s>",elem->name);
 		}
@@ -521,6 +543,9 @@ static apt_bool_t unimrcp_server_mrcpv2_uas_load(unimrcp_server_loader_t *loader
 		if(tx_buffer_size) {
 			mrcp_server_connection_tx_size_set(agent,tx_buffer_size);
 		}
+		if(worker_count > 1) {
+			mrcp_server_connection_worker_count_set(agent,worker_count);
+		}
 	}
 	return mrcp_server_connection_agent_register(loader->server,agent);
 }
@@ -531,6 +556,8 @@ static apt_bool_t unimrcp_server_media_engine_load(unimrcp_server_loader_t *load
 	const apr_xml_elem *elem;
 	mpf_engine_t *media_engine;
 	unsigned long realtime_rate = 1;
+	apr_size_t rtcp_worker_streams = 0;
+	apr_size_t preallocated_sessions = 0;
 
 	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Loading Media Engine <%s>",id);
 	for(elem = root->first_child; elem; elem = elem->next) {
@@ -540,6 +567,16 @@ static apt_bool_t unimrcp_server_media_engine_load(unimrcp_server_loader_t *load
 				realtime_rate = atol(cdata_text_get(elem));
 			}
 		}
+		else if(strcasecmp(elem->name,"rtcp-worker-streams") == 0) {
+			if(is_cdata_valid(elem) == TRUE) {
+				rtcp_worker_streams = atol(cdata_text_get(elem));
+			}
+		}
+		else if(strcasecmp(elem->name,"preallocated-sessions") == 0) {
+			if(is_cdata_valid(elem) == TRUE) {
+				preallocated_sessions = atol(cdata_text_get(elem));
+			}
+		}
 		else {
 			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unknown Element <%s>",elem->name);
 		}
@@ -548,6 +585,12 @@ static apt_bool_t unimrcp_server_media_engine_load(unimrcp_server_loader_t *load
 	media_engine = mpf_engine_create(id,loader->pool);
 	if(media_engine) {
 		mpf_engine_scheduler_rate_set(media_engine,realtime_rate);
+		if(rtcp_worker_streams) {
+			mpf_engine_rtcp_worker_set(media_engine,rtcp_worker_streams);
+		}
+		if(preallocated_sessions) {
+			mpf_engine_slab_set(media_engine,preallocated_sessions);
+		}
 	}
 	return mrcp_server_media_engine_register(loader->server,media_engine);
 }
@@ -685,6 +728,101 @@ static apt_bool_t unimrcp_server_plugin_load(unimrcp_server_loader_t *loader, co
 	return mrcp_server_engine_register(loader->server,engine);
 }
 
+/** Load content cache shared by the engines */
+static apt_bool_t unimrcp_server_content_cache_load(unimrcp_server_loader_t *loader, const apr_xml_elem *root)
+{
+	const apr_xml_elem *elem;
+	const apr_xml_attr *attr;
+	mrcp_content_cache_t *content_cache;
+	apr_size_t max_size = DEFAULT_CONTENT_CACHE_SIZE;
+	for(attr = root->attr; attr; attr = attr->next) {
+		if(strcasecmp(attr->name,"enable") == 0) {
+			if(is_attr_enabled(attr) == FALSE) {
+				/* disabled cache, just skip it */
+				return TRUE;
+			}
+		}
+		else {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unknown Attribute <%s>",attr->name);
+		}
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Loading Content Cache");
+	for(elem = root->first_child; elem; elem = elem->next) {
+		if(strcasecmp(elem->name,"max-size") == 0) {
+			if(is_cdata_valid(elem) == TRUE) {
+				max_size = atol(cdata_text_get(elem));
+			}
+		}
+		else {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unknown Element <%s>",elem->name);
+		}
+	}
+
+	content_cache = mrcp_content_cache_create(max_size,loader->pool);
+	if(!content_cache) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Content Cache");
+		return FALSE;
+	}
+	return mrcp_server_content_cache_register(loader->server,content_cache);
+}
+
+/** Load admission control */
+static apt_bool_t unimrcp_server_admission_control_load(unimrcp_server_loader_t *loader, const apr_xml_elem *root)
+{
+	const apr_xml_elem *elem;
+	const apr_xml_attr *attr;
+	mrcp_admission_controller_t *controller;
+	mrcp_admission_config_t *config;
+	for(attr = root->attr; attr; attr = attr->next) {
+		if(strcasecmp(attr->name,"enable") == 0) {
+			if(is_attr_enabled(attr) == FALSE) {
+				/* disabled admission control, just skip it */
+				return TRUE;
+			}
+		}
+		else {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unknown Attribute <%s>",attr->name);
+		}
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_DEBUG,"Loading Admission Control");
+	config = mrcp_admission_config_alloc(loader->pool);
+	for(elem = root->first_child; elem; elem = elem->next) {
+		if(is_cdata_valid(elem) == FALSE) {
+			continue;
+		}
+		if(strcasecmp(elem->name,"max-session-count") == 0) {
+			config->max_session_count = atol(cdata_text_get(elem));
+		}
+		else if(strcasecmp(elem->name,"max-queue-size") == 0) {
+			config->max_queue_size = atol(cdata_text_get(elem));
+		}
+		else if(strcasecmp(elem->name,"max-tick-overrun-rate") == 0) {
+			config->max_tick_overrun_rate = atol(cdata_text_get(elem));
+		}
+		else if(strcasecmp(elem->name,"max-pending-request-count") == 0) {
+			config->max_pending_request_count = atol(cdata_text_get(elem));
+		}
+		else if(strcasecmp(elem->name,"low-watermark") == 0) {
+			config->low_watermark = atol(cdata_text_get(elem));
+		}
+		else if(strcasecmp(elem->name,"check-interval") == 0) {
+			config->check_interval = atol(cdata_text_get(elem));
+		}
+		else {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unknown Element <%s>",elem->name);
+		}
+	}
+
+	controller = mrcp_admission_controller_create(config,loader->pool);
+	if(!controller) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Admission Controller");
+		return FALSE;
+	}
+	return mrcp_server_admission_controller_register(loader->server,controller);
+}
+
 /** Load plugin (engine) factory */
 static apt_bool_t unimrcp_server_plugin_factory_load(unimrcp_server_loader_t *loader, const apr_xml_elem *root)
 {
@@ -696,6 +834,9 @@ static apt_bool_t unimrcp_server_plugin_factory_load(unimrcp_server_loader_t *lo
 		if(strcasecmp(elem->name,"engine") == 0) {
 			unimrcp_server_plugin_load(loader,elem);
 		}
+		else if(strcasecmp(elem->name,"content-cache") == 0) {
+			unimrcp_server_content_cache_load(loader,elem);
+		}
 		else {
 			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unknown Element <%s>",elem->name);
 		}
@@ -1007,6 +1148,10 @@ static apt_bool_t unimrcp_server_components_load(unimrcp_server_loader_t *loader
 			unimrcp_server_plugin_factory_load(loader,elem);
 			continue;
 		}
+		if(strcasecmp(elem->name,"admission-control") == 0) {
+			unimrcp_server_admission_control_load(loader,elem);
+			continue;
+		}
 		
 		/* get common "id" and "enable" attributes */
 		if(header_attribs_get(elem,&id_attr,&enable_attr) == FALSE) {
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifndef UMC_BENCHMARK_H
+#define UMC_BENCHMARK_H
+
+/**
+ * @file umcbenchmark.h
+ * @brief UMC Benchmark (Embedded Server over Loopback Transport)
+ */ 
+
+#include <stdio.h>
+#include "mrcp_client.h"
+#include "mrcp_server.h"
+#include "mpf_engine.h"
+
+/** Name of the client profile to run sessions with the embedded server */
+#define UMC_LOOPBACK_PROFILE "loopback"
+
+/** Resource usage of the process */
+struct UmcResourceUsage
+{
+	apr_uint64_t m_CpuTime;  /* user and system CPU time in usec */
+	apr_size_t   m_Memory;   /* resident memory in bytes */
+
+	UmcResourceUsage() : m_CpuTime(0), m_Memory(0) {}
+};
+
+/** Runs the server in the same process and measures the cost of calls */
+class UmcBenchmark
+{
+public:
+/* ============================ CREATORS =================================== */
+	UmcBenchmark(const char* pMediaEngineName, const char* pRtpSettingsName);
+	~UmcBenchmark();
+
+/* ============================ MANIPULATORS =============================== */
+	bool StartServer(apt_dir_layout_t* pDirLayout);
+	void StopServer();
+	bool RegisterClientProfile(mrcp_client_t* pMrcpClient);
+
+	void Begin();
+	void Sample(apr_size_t activeCount);
+	void End(apr_size_t callCount);
+
+	void Report(FILE* pFile) const;
+
+/* ============================ ACCESSORS ================================== */
+	double GetCpuPerCall() const;
+	double GetMemoryPerCall() const;
+	apr_uint32_t GetServerJitterMean() const;
+
+private:
+	static bool GetResourceUsage(UmcResourceUsage& usage);
+	static void GetTickStats(mpf_engine_t* pEngine, mpf_scheduler_stats_t& stats);
+	static void ReportTickStats(FILE* pFile, const char* pName, const mpf_scheduler_stats_t& begin, const mpf_scheduler_stats_t& end);
+
+/* ============================ DATA ======================================= */
+	const char*                m_pMediaEngineName;
+	const char*                m_pRtpSettingsName;
+
+	mrcp_server_t*             m_pMrcpServer;
+	mrcp_sig_agent_t*          m_pServerAgent;
+	mpf_termination_factory_t* m_pTerminationFactory;
+	mpf_engine_t*              m_pServerMediaEngine;
+	mpf_engine_t*              m_pClientMediaEngine;
+
+	UmcResourceUsage           m_BeginUsage;
+	UmcResourceUsage           m_EndUsage;
+	apr_size_t                 m_PeakMemory;
+	apr_size_t                 m_PeakConcurrency;
+	apr_size_t                 m_CallCount;
+	apr_size_t                 m_SampleCount;
+
+	mpf_scheduler_stats_t      m_ServerTicks[2];
+	mpf_scheduler_stats_t      m_ClientTicks[2];
+};
+
+#endif /* UMC_BENCHMARK_H */
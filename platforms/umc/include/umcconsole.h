@@ -25,6 +25,7 @@
  */ 
 
 #include "apt_log.h"
+#include "umcloadgenerator.h"
 
 class UmcFramework;
 
@@ -52,6 +53,7 @@ private:
 		const char*        m_DirLayoutConf;
 		const char*        m_LogPriority;
 		const char*        m_LogOutput;
+		UmcLoadParams      m_LoadParams;
 
 		UmcOptions() : 
 			m_RootDirPath(NULL), m_DirLayoutConf(NULL), 
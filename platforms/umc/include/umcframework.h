@@ -26,11 +26,15 @@
 
 #include <apr_xml.h>
 #include <apr_hash.h>
+#include <apr_thread_mutex.h>
+#include <apr_thread_cond.h>
 #include "mrcp_application.h"
 #include "apt_consumer_task.h"
+#include "umcloadgenerator.h"
 
 class UmcSession;
 class UmcScenario;
+class UmcBenchmark;
 
 class UmcFramework
 {
@@ -40,7 +44,7 @@ public:
 	~UmcFramework();
 
 /* ============================ MANIPULATORS =============================== */
-	bool Create(apt_dir_layout_t* pDirLayout, apr_pool_t* pool);
+	bool Create(apt_dir_layout_t* pDirLayout, apr_pool_t* pool, const UmcLoadParams& params);
 	void Destroy();
 
 	void RunSession(const char* pScenarioName, const char* pProfileName);
@@ -50,6 +54,8 @@ public:
 	void ShowScenarios();
 	void ShowSessions();
 
+	bool RunLoad(const UmcLoadParams& params);
+
 protected:
 	bool CreateMrcpClient();
 	void DestroyMrcpClient();
@@ -69,6 +75,12 @@ protected:
 	void ProcessShowScenarios();
 	void ProcessShowSessions();
 
+	void ProcessLoadRequest();
+	void ProcessLoadTimer();
+	bool LaunchLoadSession(UmcScenario* pScenario);
+	void TerminateSessions();
+	void CompleteLoad(bool result);
+
 	bool AddSession(UmcSession* pSession);
 	bool RemoveSession(UmcSession* pSession);
 
@@ -76,6 +88,7 @@ protected:
 	friend apt_bool_t UmcProcessMsg(apt_task_t* pTask, apt_task_msg_t* pMsg);
 	friend void UmcOnStartComplete(apt_task_t* pTask);
 	friend void UmcOnTerminateComplete(apt_task_t* pTask);
+	friend void UmcOnLoadTimer(apt_timer_t* pTimer, void* pObj);
 
 	friend apt_bool_t AppMessageHandler(const mrcp_app_message_t* pAppMessage);
 	friend apt_bool_t AppOnSessionTerminate(mrcp_application_t *application, mrcp_session_t *session, mrcp_sig_status_code_e status);
@@ -91,6 +104,16 @@ private:
 
 	apr_hash_t*          m_pScenarioTable;
 	apr_hash_t*          m_pSessionTable;
+
+	UmcLoadParams        m_LoadParams;
+	UmcLoadGenerator*    m_pLoadGenerator;
+	apt_timer_t*         m_pLoadTimer;
+	apr_thread_mutex_t*  m_pLoadMutex;
+	apr_thread_cond_t*   m_pLoadCond;
+	bool                 m_LoadComplete;
+	bool                 m_LoadResult;
+	bool                 m_LoadTerminating;
+	UmcBenchmark*        m_pBenchmark;
 };
 
 #endif /* UMC_FRAMEWORK_H */
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifndef UMC_LOAD_GENERATOR_H
+#define UMC_LOAD_GENERATOR_H
+
+/**
+ * @file umcloadgenerator.h
+ * @brief UMC Load Generator
+ */ 
+
+#include <stdio.h>
+#include <apr_hash.h>
+#include "apt.h"
+
+class UmcScenario;
+class UmcBenchmark;
+
+/** Phases of a session the latency is measured for */
+enum UmcLatencyPhase
+{
+	UMC_LATENCY_SETUP,        /**< session setup (run -> channel added) */
+	UMC_LATENCY_IN_PROGRESS,  /**< request -> IN-PROGRESS response */
+	UMC_LATENCY_COMPLETE,     /**< request -> COMPLETE response or event */
+	UMC_LATENCY_TEARDOWN,     /**< terminate -> session terminated */
+
+	UMC_LATENCY_PHASE_COUNT
+};
+
+/** Parameters of the load mode */
+struct UmcLoadParams
+{
+	const char* m_pScenarioMix;   /* comma separated list of scenario[:weight] */
+	const char* m_pProfileName;   /* MRCP profile to use (scenario specific by default) */
+	const char* m_pReportPath;    /* path to the report file (stdout by default) */
+	apr_size_t  m_Concurrency;    /* max number of simultaneous sessions */
+	apr_size_t  m_CallsPerSecond; /* rate of new sessions (0 - keep max concurrency) */
+	apr_size_t  m_Duration;       /* duration of the test in seconds */
+	apr_size_t  m_RampUp;         /* ramp-up time in seconds */
+	bool        m_Loopback;       /* run sessions with the embedded server over the loopback transport */
+	const char* m_pMediaEngine;   /* media engine of the loopback profiles (Media-Engine-1 by default) */
+	const char* m_pRtpSettings;   /* RTP settings of the loopback profiles (RTP-Settings-1 by default) */
+	const char* m_pBaselinePath;  /* path to the report to compare the results with */
+	apr_size_t  m_Tolerance;      /* allowed regression against the baseline in percent */
+
+	UmcLoadParams() :
+		m_pScenarioMix(NULL), m_pProfileName(NULL), m_pReportPath(NULL),
+		m_Concurrency(1), m_CallsPerSecond(0), m_Duration(60), m_RampUp(0),
+		m_Loopback(false), m_pMediaEngine(NULL), m_pRtpSettings(NULL),
+		m_pBaselinePath(NULL), m_Tolerance(10) {}
+};
+
+/** Log-linear histogram of latencies in usec (16 sub-buckets per power of 2, ~6% precision) */
+class UmcLatencyHistogram
+{
+public:
+/* ============================ CREATORS =================================== */
+	UmcLatencyHistogram();
+
+/* ============================ MANIPULATORS =============================== */
+	void Record(apr_interval_time_t latency);
+
+/* ============================ ACCESSORS ================================== */
+	apr_size_t GetCount() const;
+	apr_uint32_t GetPercentile(double percentile) const;
+	void Report(FILE* pFile, const char* pName) const;
+
+private:
+	enum
+	{
+		SUB_BUCKET_BITS  = 4,
+		SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS,
+		BUCKET_COUNT     = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT
+	};
+
+	static apr_size_t BucketIndex(apr_uint32_t value);
+	static apr_uint32_t BucketUpperBound(apr_size_t index);
+
+/* ============================ DATA ======================================= */
+	apr_size_t   m_Buckets[BUCKET_COUNT];
+	apr_size_t   m_Count;
+	apr_uint64_t m_Sum;
+	apr_uint32_t m_Min;
+	apr_uint32_t m_Max;
+};
+
+/** Paces new sessions, picks scenarios from the mix and collects statistics */
+class UmcLoadGenerator
+{
+public:
+/* ============================ CREATORS =================================== */
+	UmcLoadGenerator();
+	~UmcLoadGenerator();
+
+/* ============================ MANIPULATORS =============================== */
+	bool Load(const UmcLoadParams& params, apr_hash_t* pScenarioTable, apr_pool_t* pool);
+	void Start();
+
+	apr_size_t GetLaunchCount(apr_size_t activeCount);
+	UmcScenario* NextScenario();
+
+	void OnLatency(UmcLatencyPhase phase, apr_interval_time_t latency);
+	void OnSessionLaunch(bool success);
+	void OnSessionFailure();
+	void OnSessionComplete();
+	void OnRequestFailure();
+
+	bool Report(const UmcBenchmark* pBenchmark) const;
+	bool Compare(const UmcBenchmark* pBenchmark) const;
+
+/* ============================ ACCESSORS ================================== */
+	const UmcLoadParams& GetParams() const;
+	apr_size_t GetCompletedCount() const;
+
+/* ============================ INQUIRIES ================================== */
+	bool IsLaunching() const;
+	bool IsDrainExpired() const;
+
+private:
+	static bool FindBaselineValue(const char* pText, const char* pSection, const char* pName, double& value);
+	bool CheckRegression(const char* pText, const char* pSection, const char* pName, double current) const;
+
+	struct MixEntry
+	{
+		UmcScenario* m_pScenario;
+		long         m_Weight;
+		long         m_Current;
+	};
+
+/* ============================ DATA ======================================= */
+	UmcLoadParams       m_Params;
+	MixEntry*           m_pMix;
+	apr_size_t          m_MixCount;
+	long                m_TotalWeight;
+
+	apr_time_t          m_StartTime;
+	apr_time_t          m_LastTime;
+	apr_time_t          m_StopTime;
+	double              m_Credit;
+	bool                m_Launching;
+
+	apr_size_t          m_Launched;
+	apr_size_t          m_LaunchFailed;
+	apr_size_t          m_Failed;
+	apr_size_t          m_Completed;
+	apr_size_t          m_Throttled;
+	apr_size_t          m_RequestFailed;
+
+	UmcLatencyHistogram m_Histograms[UMC_LATENCY_PHASE_COUNT];
+};
+
+
+/* ============================ INLINE METHODS ============================= */
+inline apr_size_t UmcLatencyHistogram::GetCount() const
+{
+	return m_Count;
+}
+
+inline const UmcLoadParams& UmcLoadGenerator::GetParams() const
+{
+	return m_Params;
+}
+
+inline apr_size_t UmcLoadGenerator::GetCompletedCount() const
+{
+	return m_Completed;
+}
+
+inline bool UmcLoadGenerator::IsLaunching() const
+{
+	return m_Launching;
+}
+
+inline void UmcLoadGenerator::OnLatency(UmcLatencyPhase phase, apr_interval_time_t latency)
+{
+	m_Histograms[phase].Record(latency);
+}
+
+inline void UmcLoadGenerator::OnSessionFailure()
+{
+	m_Failed++;
+}
+
+inline void UmcLoadGenerator::OnSessionComplete()
+{
+	m_Completed++;
+}
+
+inline void UmcLoadGenerator::OnRequestFailure()
+{
+	m_RequestFailed++;
+}
+
+#endif /* UMC_LOAD_GENERATOR_H */
@@ -27,6 +27,7 @@
 #include "mrcp_application.h"
 
 class UmcScenario;
+class UmcLoadGenerator;
 
 class UmcSession
 {
@@ -42,6 +43,7 @@ public:
 
 	void SetMrcpProfile(const char* pMrcpProfile);
 	void SetMrcpApplication(mrcp_application_t* pMrcpApplication);
+	void SetLoadGenerator(UmcLoadGenerator* pLoadGenerator);
 
 /* ============================ HANDLERS =================================== */
 	virtual bool OnSessionTerminate(mrcp_sig_status_code_e status);
@@ -57,6 +59,8 @@ public:
 
 	const char* GetId() const;
 
+	bool IsTerminating() const;
+
 protected:
 /* ============================ MANIPULATORS =============================== */
 	virtual bool Start() = 0;
@@ -99,6 +103,14 @@ private:
 	mrcp_message_t*     m_pMrcpMessage; /* last message sent */
 	bool                m_Running;
 	bool                m_Terminating;
+
+	/* latency measurement in load mode */
+	UmcLoadGenerator*   m_pLoadGenerator;
+	apr_time_t          m_SetupTime;     /* time the session was run at */
+	apr_time_t          m_RequestTime;   /* time the last request was sent at */
+	apr_time_t          m_TeardownTime;  /* time the session was terminated at */
+	bool                m_SetupFailed;
+	bool                m_ResponseReceived; /* whether the response to the last request was received */
 };
 
 
@@ -113,11 +125,21 @@ inline const char* UmcSession::GetId() const
 	return m_Id;
 }
 
+inline bool UmcSession::IsTerminating() const
+{
+	return m_Terminating;
+}
+
 inline void UmcSession::SetMrcpApplication(mrcp_application_t* pMrcpApplication)
 {
 	m_pMrcpApplication = pMrcpApplication;
 }
 
+inline void UmcSession::SetLoadGenerator(UmcLoadGenerator* pLoadGenerator)
+{
+	m_pLoadGenerator = pLoadGenerator;
+}
+
 inline void UmcSession::SetMrcpProfile(const char* pMrcpProfile)
 {
 	m_pMrcpProfile = pMrcpProfile;
@@ -21,6 +21,5 @@
 int main(int argc, const char * const *argv)
 {
 	UmcConsole console;
-	console.Run(argc,argv);
-	return 0;
+	return console.Run(argc,argv) ? 0 : 1;
 }
@@ -0,0 +1,337 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#ifdef WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+#include <string.h>
+#include "umcbenchmark.h"
+#ifdef UMC_BENCH
+#include "unimrcp_server.h"
+#endif
+#include "mrcp_loopback_agent.h"
+#include "mpf_loopback_termination_factory.h"
+#include "apt_log.h"
+
+/* names of the objects the loopback profiles are composed of */
+#define UMC_LOOPBACK_AGENT        "Loopback-Agent"
+#define UMC_LOOPBACK_FACTORY      "Loopback-Factory"
+
+/* media engine and RTP settings of the server and client configurations used by default */
+#define UMC_DEFAULT_MEDIA_ENGINE  "Media-Engine-1"
+#define UMC_DEFAULT_RTP_SETTINGS  "RTP-Settings-1"
+
+/* max number of media streams to exist simultaneously over the loopback transport */
+#define UMC_LOOPBACK_MAX_STREAMS  2000
+
+UmcBenchmark::UmcBenchmark(const char* pMediaEngineName, const char* pRtpSettingsName) :
+	m_pMediaEngineName(pMediaEngineName ? pMediaEngineName : UMC_DEFAULT_MEDIA_ENGINE),
+	m_pRtpSettingsName(pRtpSettingsName ? pRtpSettingsName : UMC_DEFAULT_RTP_SETTINGS),
+	m_pMrcpServer(NULL),
+	m_pServerAgent(NULL),
+	m_pTerminationFactory(NULL),
+	m_pServerMediaEngine(NULL),
+	m_pClientMediaEngine(NULL),
+	m_PeakMemory(0),
+	m_PeakConcurrency(0),
+	m_CallCount(0),
+	m_SampleCount(0)
+{
+	memset(m_ServerTicks,0,sizeof(m_ServerTicks));
+	memset(m_ClientTicks,0,sizeof(m_ClientTicks));
+}
+
+UmcBenchmark::~UmcBenchmark()
+{
+}
+
+#ifdef UMC_BENCH
+bool UmcBenchmark::StartServer(apt_dir_layout_t* pDirLayout)
+{
+	/* create and load the server the same way as the standalone one, but start it here */
+	m_pMrcpServer = unimrcp_server_create(pDirLayout);
+	if(!m_pMrcpServer)
+		return false;
+
+	apr_pool_t* pool = mrcp_server_memory_pool_get(m_pMrcpServer);
+	m_pServerMediaEngine = mrcp_server_media_engine_get(m_pMrcpServer,m_pMediaEngineName);
+	mpf_rtp_settings_t* pRtpSettings = mrcp_server_rtp_settings_get(m_pMrcpServer,m_pRtpSettingsName);
+	if(!m_pServerMediaEngine || !pRtpSettings)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"No Such Server Media Engine [%s] or RTP Settings [%s]",
+			m_pMediaEngineName,m_pRtpSettingsName);
+		mrcp_server_destroy(m_pMrcpServer);
+		m_pMrcpServer = NULL;
+		return false;
+	}
+
+	m_pServerAgent = mrcp_loopback_server_agent_create(UMC_LOOPBACK_AGENT,pool);
+	m_pTerminationFactory = mpf_loopback_termination_factory_create(UMC_LOOPBACK_MAX_STREAMS,pool);
+	if(!m_pServerAgent || !m_pTerminationFactory)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Loopback Transport");
+		mrcp_server_destroy(m_pMrcpServer);
+		m_pMrcpServer = NULL;
+		return false;
+	}
+
+	mrcp_server_signaling_agent_register(m_pMrcpServer,m_pServerAgent);
+	mrcp_server_rtp_factory_register(m_pMrcpServer,m_pTerminationFactory,UMC_LOOPBACK_FACTORY);
+
+	mrcp_server_profile_t* pProfile = mrcp_server_profile_create(
+										UMC_LOOPBACK_PROFILE,
+										MRCP_VERSION_1,
+										NULL,
+										m_pServerAgent,
+										NULL,
+										m_pServerMediaEngine,
+										m_pTerminationFactory,
+										pRtpSettings,
+										pool);
+	if(!pProfile || mrcp_server_profile_register(m_pMrcpServer,pProfile,NULL) == FALSE)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Register Server Profile [%s]",UMC_LOOPBACK_PROFILE);
+		mrcp_server_destroy(m_pMrcpServer);
+		m_pMrcpServer = NULL;
+		return false;
+	}
+
+	if(mrcp_server_start(m_pMrcpServer) == FALSE)
+	{
+		mrcp_server_destroy(m_pMrcpServer);
+		m_pMrcpServer = NULL;
+		return false;
+	}
+	return true;
+}
+
+void UmcBenchmark::StopServer()
+{
+	if(m_pMrcpServer)
+	{
+		/* shutdown and destroy the server (blocking call) */
+		unimrcp_server_shutdown(m_pMrcpServer);
+		m_pMrcpServer = NULL;
+		m_pServerAgent = NULL;
+		m_pTerminationFactory = NULL;
+		m_pServerMediaEngine = NULL;
+	}
+}
+#else
+bool UmcBenchmark::StartServer(apt_dir_layout_t* pDirLayout)
+{
+	apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Bench Mode Not Available: umc Built without Server Library");
+	return false;
+}
+
+void UmcBenchmark::StopServer()
+{
+}
+#endif
+
+bool UmcBenchmark::RegisterClientProfile(mrcp_client_t* pMrcpClient)
+{
+	if(!m_pServerAgent)
+		return false;
+
+	apr_pool_t* pool = mrcp_client_memory_pool_get(pMrcpClient);
+	m_pClientMediaEngine = mrcp_client_media_engine_get(pMrcpClient,m_pMediaEngineName);
+	mpf_rtp_settings_t* pRtpSettings = mrcp_client_rtp_settings_get(pMrcpClient,m_pRtpSettingsName);
+	if(!m_pClientMediaEngine || !pRtpSettings)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"No Such Client Media Engine [%s] or RTP Settings [%s]",
+			m_pMediaEngineName,m_pRtpSettingsName);
+		return false;
+	}
+
+	mrcp_sig_agent_t* pClientAgent = mrcp_loopback_client_agent_create(UMC_LOOPBACK_AGENT,m_pServerAgent,pool);
+	if(!pClientAgent)
+		return false;
+
+	mrcp_client_signaling_agent_register(pMrcpClient,pClientAgent);
+	mrcp_client_rtp_factory_register(pMrcpClient,m_pTerminationFactory,UMC_LOOPBACK_FACTORY);
+
+	mrcp_client_profile_t* pProfile = mrcp_client_profile_create(
+										NULL,
+										pClientAgent,
+										NULL,
+										m_pClientMediaEngine,
+										m_pTerminationFactory,
+										pRtpSettings,
+										mrcp_signaling_settings_alloc(pool),
+										pool);
+	if(!pProfile || mrcp_client_profile_register(pMrcpClient,pProfile,UMC_LOOPBACK_PROFILE) == FALSE)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Register Client Profile [%s]",UMC_LOOPBACK_PROFILE);
+		return false;
+	}
+	return true;
+}
+
+void UmcBenchmark::Begin()
+{
+	GetResourceUsage(m_BeginUsage);
+	m_EndUsage = m_BeginUsage;
+	m_PeakMemory = m_BeginUsage.m_Memory;
+	m_PeakConcurrency = 0;
+	m_CallCount = 0;
+	m_SampleCount = 0;
+
+	GetTickStats(m_pServerMediaEngine,m_ServerTicks[0]);
+	GetTickStats(m_pClientMediaEngine,m_ClientTicks[0]);
+}
+
+void UmcBenchmark::Sample(apr_size_t activeCount)
+{
+	if(activeCount > m_PeakConcurrency)
+		m_PeakConcurrency = activeCount;
+
+	/* reading the resident size costs a syscall, sample it every 10th tick of the load timer */
+	if(m_SampleCount++ % 10 == 0)
+	{
+		UmcResourceUsage usage;
+		if(GetResourceUsage(usage) && usage.m_Memory > m_PeakMemory)
+			m_PeakMemory = usage.m_Memory;
+	}
+}
+
+void UmcBenchmark::End(apr_size_t callCount)
+{
+	GetResourceUsage(m_EndUsage);
+	if(m_EndUsage.m_Memory > m_PeakMemory)
+		m_PeakMemory = m_EndUsage.m_Memory;
+	m_CallCount = callCount;
+
+	GetTickStats(m_pServerMediaEngine,m_ServerTicks[1]);
+	GetTickStats(m_pClientMediaEngine,m_ClientTicks[1]);
+}
+
+double UmcBenchmark::GetCpuPerCall() const
+{
+	if(!m_CallCount)
+		return 0;
+	return (double)(m_EndUsage.m_CpuTime - m_BeginUsage.m_CpuTime) / m_CallCount;
+}
+
+double UmcBenchmark::GetMemoryPerCall() const
+{
+	if(!m_PeakConcurrency || m_PeakMemory <= m_BeginUsage.m_Memory)
+		return 0;
+	/* growth of the resident size per simultaneous call, in KB */
+	return (double)(m_PeakMemory - m_BeginUsage.m_Memory) / 1024 / m_PeakConcurrency;
+}
+
+apr_uint32_t UmcBenchmark::GetServerJitterMean() const
+{
+	return m_ServerTicks[1].jitter_mean;
+}
+
+void UmcBenchmark::Report(FILE* pFile) const
+{
+	fprintf(pFile,
+		"  \"bench\": {\n"
+		"    \"calls\": %" APR_SIZE_T_FMT ",\n"
+		"    \"peak-concurrency\": %" APR_SIZE_T_FMT ",\n"
+		"    \"cpu-usec-per-call\": %.1f,\n"
+		"    \"memory-kb-per-call\": %.1f,\n"
+		"    \"peak-memory-kb\": %" APR_SIZE_T_FMT ",\n",
+		m_CallCount,
+		m_PeakConcurrency,
+		GetCpuPerCall(),
+		GetMemoryPerCall(),
+		m_PeakMemory / 1024);
+	ReportTickStats(pFile,"server-media-tick",m_ServerTicks[0],m_ServerTicks[1]);
+	fprintf(pFile,",\n");
+	ReportTickStats(pFile,"client-media-tick",m_ClientTicks[0],m_ClientTicks[1]);
+	fprintf(pFile,"\n  }");
+}
+
+void UmcBenchmark::ReportTickStats(FILE* pFile, const char* pName, const mpf_scheduler_stats_t& begin, const mpf_scheduler_stats_t& end)
+{
+	/* jitter is accumulated since the start of the scheduler, counters are reported for the test only */
+	fprintf(pFile,
+		"    \"%s\": {\"ticks\": %u, \"overruns\": %u, "
+		"\"jitter-mean-usec\": %u, \"jitter-max-usec\": %u}",
+		pName,
+		end.tick_count - begin.tick_count,
+		end.overrun_count - begin.overrun_count,
+		end.jitter_mean,
+		end.jitter_max);
+}
+
+void UmcBenchmark::GetTickStats(mpf_engine_t* pEngine, mpf_scheduler_stats_t& stats)
+{
+	if(pEngine)
+		mpf_engine_scheduler_stats_get(pEngine,&stats);
+	else
+		memset(&stats,0,sizeof(stats));
+}
+
+bool UmcBenchmark::GetResourceUsage(UmcResourceUsage& usage)
+{
+#ifdef WIN32
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if(!GetProcessTimes(GetCurrentProcess(),&creationTime,&exitTime,&kernelTime,&userTime))
+		return false;
+
+	ULARGE_INTEGER kernel, user;
+	kernel.LowPart = kernelTime.dwLowDateTime;
+	kernel.HighPart = kernelTime.dwHighDateTime;
+	user.LowPart = userTime.dwLowDateTime;
+	user.HighPart = userTime.dwHighDateTime;
+	/* FILETIME is in 100-nanosecond units */
+	usage.m_CpuTime = (kernel.QuadPart + user.QuadPart) / 10;
+
+	PROCESS_MEMORY_COUNTERS counters;
+	if(GetProcessMemoryInfo(GetCurrentProcess(),&counters,sizeof(counters)))
+		usage.m_Memory = counters.WorkingSetSize;
+	return true;
+#else
+	struct rusage ru;
+	if(getrusage(RUSAGE_SELF,&ru) != 0)
+		return false;
+
+	usage.m_CpuTime = (apr_uint64_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 +
+		ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+
+	/* current resident size is only available on Linux, fall back to the max one elsewhere */
+	usage.m_Memory = 0;
+	FILE* pFile = fopen("/proc/self/statm","r");
+	if(pFile)
+	{
+		unsigned long size, resident;
+		if(fscanf(pFile,"%lu %lu",&size,&resident) == 2)
+			usage.m_Memory = (apr_size_t)resident * sysconf(_SC_PAGESIZE);
+		fclose(pFile);
+	}
+	if(!usage.m_Memory)
+	{
+#ifdef __APPLE__
+		usage.m_Memory = (apr_size_t)ru.ru_maxrss;
+#else
+		usage.m_Memory = (apr_size_t)ru.ru_maxrss * 1024;
+#endif
+	}
+	return true;
+#endif
+}
@@ -110,13 +110,26 @@ bool UmcConsole::Run(int argc, const char * const *argv)
 	}
 
 	/* create demo framework */
-	if(m_pFramework->Create(pDirLayout,pool))
+	bool status = true;
+	if(m_pFramework->Create(pDirLayout,pool,m_Options.m_LoadParams))
 	{
-		/* run command line  */
-		RunCmdLine();
+		if(m_Options.m_LoadParams.m_pScenarioMix)
+		{
+			/* run load non-interactively */
+			status = m_pFramework->RunLoad(m_Options.m_LoadParams);
+		}
+		else
+		{
+			/* run command line  */
+			RunCmdLine();
+		}
 		/* destroy demo framework */
 		m_pFramework->Destroy();
 	}
+	else
+	{
+		status = false;
+	}
 
 	/* destroy singleton logger */
 	apt_log_instance_destroy();
@@ -124,7 +137,7 @@ bool UmcConsole::Run(int argc, const char * const *argv)
 	apr_pool_destroy(pool);
 	/* APR global termination */
 	apr_terminate();
-	return true;
+	return status;
 }
 
 bool UmcConsole::ProcessCmdLine(char* pCmdLine)
@@ -267,6 +280,40 @@ void UmcConsole::Usage()
 		"   -o [--log-output] mode   : Set the log output mode.\n"
 		"                              (0-none, 1-console only, 2-file only, 3-both)\n"
 		"\n"
+		"   -L [--load] mix          : Run sessions non-interactively in load mode and exit.\n"
+		"                              (mix is a list of scenario[:weight], e.g. synth:3,recog:1)\n"
+		"\n"
+		"   -n [--concurrency] count : Set the max number of simultaneous sessions in load mode.\n"
+		"                              (1 by default)\n"
+		"\n"
+		"   -R [--cps] rate          : Set the number of new sessions per second in load mode.\n"
+		"                              (0 by default, keep the max number of sessions)\n"
+		"\n"
+		"   -d [--duration] sec      : Set the duration of the load in seconds.\n"
+		"                              (60 by default)\n"
+		"\n"
+		"   -u [--ramp-up] sec       : Set the ramp-up time of the load in seconds.\n"
+		"\n"
+		"   -p [--profile] name      : Set the MRCP profile to use in load mode.\n"
+		"\n"
+		"   -f [--report] path       : Write the latency report (JSON) to the file instead of stdout.\n"
+		"\n"
+		"   -B [--bench]             : Run the load with the server embedded in process.\n"
+		"                              (sessions are set up over the loopback transport and\n"
+		"                               the report includes CPU, memory and media clock usage)\n"
+		"\n"
+		"   -e [--media-engine] name : Set the media engine of the loopback profiles in bench mode.\n"
+		"                              (Media-Engine-1 by default)\n"
+		"\n"
+		"   -s [--rtp-settings] name : Set the RTP settings of the loopback profiles in bench mode.\n"
+		"                              (RTP-Settings-1 by default)\n"
+		"\n"
+		"   -b [--baseline] path     : Compare the results with the report of a baseline run.\n"
+		"                              (exit with a non-zero status, if regressed)\n"
+		"\n"
+		"   -t [--tolerance] percent : Set the allowed regression against the baseline.\n"
+		"                              (10 by default)\n"
+		"\n"
 		"   -v [--version]           : Show the version.\n"
 		"\n"
 		"   -h [--help]              : Show the help.\n"
@@ -287,6 +334,18 @@ bool UmcConsole::LoadOptions(int argc, const char * const *argv, apr_pool_t *poo
 		{ "dir-layout",  'c', TRUE,  "path to dir layout conf" },  /* -c arg or --dir-layout arg */
 		{ "log-prio",    'l', TRUE,  "log priority" },             /* -l arg or --log-prio arg */
 		{ "log-output",  'o', TRUE,  "log output mode" },          /* -o arg or --log-output arg */
+		{ "load",        'L', TRUE,  "scenario mix" },             /* -L arg or --load arg */
+		{ "concurrency", 'n', TRUE,  "max sessions" },             /* -n arg or --concurrency arg */
+		{ "cps",         'R', TRUE,  "sessions per second" },      /* -R arg or --cps arg */
+		{ "duration",    'd', TRUE,  "load duration" },            /* -d arg or --duration arg */
+		{ "ramp-up",     'u', TRUE,  "ramp-up time" },             /* -u arg or --ramp-up arg */
+		{ "profile",     'p', TRUE,  "MRCP profile" },             /* -p arg or --profile arg */
+		{ "report",      'f', TRUE,  "path to report file" },      /* -f arg or --report arg */
+		{ "bench",       'B', FALSE, "embedded server" },          /* -B or --bench */
+		{ "media-engine",'e', TRUE,  "media engine" },             /* -e arg or --media-engine arg */
+		{ "rtp-settings",'s', TRUE,  "RTP settings" },             /* -s arg or --rtp-settings arg */
+		{ "baseline",    'b', TRUE,  "path to baseline report" },  /* -b arg or --baseline arg */
+		{ "tolerance",   't', TRUE,  "allowed regression" },       /* -t arg or --tolerance arg */
 		{ "version",     'v', FALSE, "show version" },             /* -v or --version */
 		{ "help",        'h', FALSE, "show help" },                /* -h or --help */
 		{ NULL, 0, 0, NULL },                                      /* end */
@@ -314,6 +373,42 @@ bool UmcConsole::LoadOptions(int argc, const char * const *argv, apr_pool_t *poo
 				if(optarg) 
 				m_Options.m_LogOutput = optarg;
 				break;
+			case 'L':
+				m_Options.m_LoadParams.m_pScenarioMix = optarg;
+				break;
+			case 'n':
+				m_Options.m_LoadParams.m_Concurrency = atol(optarg);
+				break;
+			case 'R':
+				m_Options.m_LoadParams.m_CallsPerSecond = atol(optarg);
+				break;
+			case 'd':
+				m_Options.m_LoadParams.m_Duration = atol(optarg);
+				break;
+			case 'u':
+				m_Options.m_LoadParams.m_RampUp = atol(optarg);
+				break;
+			case 'p':
+				m_Options.m_LoadParams.m_pProfileName = optarg;
+				break;
+			case 'f':
+				m_Options.m_LoadParams.m_pReportPath = optarg;
+				break;
+			case 'B':
+				m_Options.m_LoadParams.m_Loopback = true;
+				break;
+			case 'e':
+				m_Options.m_LoadParams.m_pMediaEngine = optarg;
+				break;
+			case 's':
+				m_Options.m_LoadParams.m_pRtpSettings = optarg;
+				break;
+			case 'b':
+				m_Options.m_LoadParams.m_pBaselinePath = optarg;
+				break;
+			case 't':
+				m_Options.m_LoadParams.m_Tolerance = atol(optarg);
+				break;
 			case 'v':
 				printf(UNI_VERSION_STRING);
 				return FALSE;
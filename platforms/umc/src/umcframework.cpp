@@ -24,9 +24,13 @@
 #include "dtmfscenario.h"
 #include "setparamscenario.h"
 #include "verifierscenario.h"
+#include "umcbenchmark.h"
 #include "unimrcp_client.h"
 #include "apt_log.h"
 
+/* interval of pacing new sessions in load mode (msec) */
+#define UMC_LOAD_TIMER_INTERVAL 10
+
 typedef struct
 {
 	char                      m_SessionId[10];
@@ -42,12 +46,14 @@ enum UmcTaskMsgType
 	UMC_TASK_STOP_SESSION_MSG,
 	UMC_TASK_KILL_SESSION_MSG,
 	UMC_TASK_SHOW_SCENARIOS_MSG,
-	UMC_TASK_SHOW_SESSIONS_MSG
+	UMC_TASK_SHOW_SESSIONS_MSG,
+	UMC_TASK_RUN_LOAD_MSG
 };
 
 apt_bool_t UmcProcessMsg(apt_task_t* pTask, apt_task_msg_t* pMsg);
 void UmcOnStartComplete(apt_task_t* pTask);
 void UmcOnTerminateComplete(apt_task_t* pTask);
+void UmcOnLoadTimer(apt_timer_t* pTimer, void* pObj);
 apt_bool_t AppMessageHandler(const mrcp_app_message_t* pAppMessage);
 
 
@@ -58,7 +64,15 @@ UmcFramework::UmcFramework() :
 	m_pMrcpClient(NULL),
 	m_pMrcpApplication(NULL),
 	m_pScenarioTable(NULL),
-	m_pSessionTable(NULL)
+	m_pSessionTable(NULL),
+	m_pLoadGenerator(NULL),
+	m_pLoadTimer(NULL),
+	m_pLoadMutex(NULL),
+	m_pLoadCond(NULL),
+	m_LoadComplete(false),
+	m_LoadResult(false),
+	m_LoadTerminating(false),
+	m_pBenchmark(NULL)
 {
 }
 
@@ -66,11 +80,24 @@ UmcFramework::~UmcFramework()
 {
 }
 
-bool UmcFramework::Create(apt_dir_layout_t* pDirLayout, apr_pool_t* pool)
+bool UmcFramework::Create(apt_dir_layout_t* pDirLayout, apr_pool_t* pool, const UmcLoadParams& params)
 {
 	m_pDirLayout = pDirLayout;
 	m_pPool = pool;
 
+	if(params.m_Loopback)
+	{
+		/* start the server in process prior to the client, which connects to it over the loopback transport */
+		m_pBenchmark = new UmcBenchmark(params.m_pMediaEngine,params.m_pRtpSettings);
+		if(!m_pBenchmark->StartServer(m_pDirLayout))
+		{
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Start Embedded Server");
+			delete m_pBenchmark;
+			m_pBenchmark = NULL;
+			return false;
+		}
+	}
+
 	m_pSessionTable = apr_hash_make(m_pPool);
 	m_pScenarioTable = apr_hash_make(m_pPool);
 	return CreateTask();
@@ -80,6 +107,29 @@ void UmcFramework::Destroy()
 {
 	DestroyTask();
 
+	if(m_pBenchmark)
+	{
+		/* stop the server once the client is gone */
+		m_pBenchmark->StopServer();
+		delete m_pBenchmark;
+		m_pBenchmark = NULL;
+	}
+	if(m_pLoadGenerator)
+	{
+		delete m_pLoadGenerator;
+		m_pLoadGenerator = NULL;
+	}
+	if(m_pLoadCond)
+	{
+		apr_thread_cond_destroy(m_pLoadCond);
+		m_pLoadCond = NULL;
+	}
+	if(m_pLoadMutex)
+	{
+		apr_thread_mutex_destroy(m_pLoadMutex);
+		m_pLoadMutex = NULL;
+	}
+
 	m_pScenarioTable = NULL;
 	m_pSessionTable = NULL;
 }
@@ -102,6 +152,11 @@ bool UmcFramework::CreateMrcpClient()
 
 	/* register MRCP application to MRCP client */
 	mrcp_client_application_register(m_pMrcpClient,m_pMrcpApplication,"UMC");
+	if(m_pBenchmark)
+	{
+		/* register the profile to run sessions with the embedded server */
+		m_pBenchmark->RegisterClientProfile(m_pMrcpClient);
+	}
 	/* start MRCP client stack processing */
 	if(mrcp_client_start(m_pMrcpClient) == FALSE)
 	{
@@ -416,6 +471,183 @@ void UmcFramework::ProcessShowSessions()
 	}
 }
 
+void UmcFramework::ProcessLoadRequest()
+{
+	if(m_pLoadGenerator)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Load Already Run");
+		CompleteLoad(false);
+		return;
+	}
+
+	m_pLoadGenerator = new UmcLoadGenerator;
+	if(!m_pLoadGenerator->Load(m_LoadParams,m_pScenarioTable,m_pPool))
+	{
+		CompleteLoad(false);
+		return;
+	}
+
+	m_pLoadTimer = apt_consumer_task_timer_create(m_pTask,UmcOnLoadTimer,this,m_pPool);
+	if(!m_pLoadTimer)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Load Timer");
+		CompleteLoad(false);
+		return;
+	}
+
+	if(m_pBenchmark)
+		m_pBenchmark->Begin();
+	m_pLoadGenerator->Start();
+	ProcessLoadTimer();
+}
+
+void UmcFramework::ProcessLoadTimer()
+{
+	apr_size_t activeCount = apr_hash_count(m_pSessionTable);
+	if(m_pBenchmark)
+		m_pBenchmark->Sample(activeCount);
+	if(m_pLoadGenerator->IsLaunching())
+	{
+		apr_size_t count = m_pLoadGenerator->GetLaunchCount(activeCount);
+		for(apr_size_t i = 0; i < count; i++)
+		{
+			LaunchLoadSession(m_pLoadGenerator->NextScenario());
+		}
+	}
+	else if(!activeCount)
+	{
+		CompleteLoad(true);
+		return;
+	}
+	else if(m_pLoadGenerator->IsDrainExpired())
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Terminate %" APR_SIZE_T_FMT " Session(s) Not Completed in Time",activeCount);
+		/* the load is completed once the last session is terminated */
+		m_LoadTerminating = true;
+		TerminateSessions();
+		return;
+	}
+
+	apt_timer_set(m_pLoadTimer,UMC_LOAD_TIMER_INTERVAL);
+}
+
+bool UmcFramework::LaunchLoadSession(UmcScenario* pScenario)
+{
+	UmcSession* pSession = pScenario->CreateSession();
+	if(!pSession)
+	{
+		m_pLoadGenerator->OnSessionLaunch(false);
+		return false;
+	}
+
+	pSession->SetMrcpProfile(m_LoadParams.m_pProfileName);
+	pSession->SetMrcpApplication(m_pMrcpApplication);
+	pSession->SetLoadGenerator(m_pLoadGenerator);
+	if(!pSession->Run())
+	{
+		m_pLoadGenerator->OnSessionLaunch(false);
+		delete pSession;
+		return false;
+	}
+
+	m_pLoadGenerator->OnSessionLaunch(true);
+	AddSession(pSession);
+	return true;
+}
+
+void UmcFramework::TerminateSessions()
+{
+	UmcSession* pSession;
+	void* pVal;
+	apr_hash_index_t* it = apr_hash_first(m_pPool,m_pSessionTable);
+	for(; it; it = apr_hash_next(it)) 
+	{
+		apr_hash_this(it,NULL,NULL,&pVal);
+		pSession = (UmcSession*) pVal;
+		if(pSession && !pSession->IsTerminating() && !pSession->Terminate())
+		{
+			/* no termination response is expected, stop waiting for the session;
+			the object is left to the MRCP session, which still refers to it */
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Terminate Session [%s]",pSession->GetId());
+			if(m_pLoadGenerator)
+				m_pLoadGenerator->OnSessionFailure();
+			RemoveSession(pSession);
+		}
+	}
+
+	/* the load is also completed, if no termination response is pending */
+	if(m_LoadTerminating && !apr_hash_count(m_pSessionTable))
+		CompleteLoad(true);
+}
+
+void UmcFramework::CompleteLoad(bool result)
+{
+	if(m_pLoadTimer)
+	{
+		apt_timer_kill(m_pLoadTimer);
+		m_pLoadTimer = NULL;
+	}
+	m_LoadTerminating = false;
+	if(result)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Load Completed");
+		if(m_pBenchmark)
+			m_pBenchmark->End(m_pLoadGenerator->GetCompletedCount());
+		result = m_pLoadGenerator->Report(m_pBenchmark);
+		if(result)
+			result = m_pLoadGenerator->Compare(m_pBenchmark);
+	}
+
+	apr_thread_mutex_lock(m_pLoadMutex);
+	m_LoadResult = result;
+	m_LoadComplete = true;
+	apr_thread_cond_signal(m_pLoadCond);
+	apr_thread_mutex_unlock(m_pLoadMutex);
+}
+
+bool UmcFramework::RunLoad(const UmcLoadParams& params)
+{
+	if(!m_pLoadMutex)
+	{
+		if(apr_thread_mutex_create(&m_pLoadMutex,APR_THREAD_MUTEX_DEFAULT,m_pPool) != APR_SUCCESS)
+			return false;
+	}
+	if(!m_pLoadCond)
+	{
+		if(apr_thread_cond_create(&m_pLoadCond,m_pPool) != APR_SUCCESS)
+			return false;
+	}
+
+	apt_task_t* pTask = apt_consumer_task_base_get(m_pTask);
+	apt_task_msg_t* pTaskMsg = apt_task_msg_get(pTask);
+	if(!pTaskMsg) 
+		return false;
+
+	m_LoadParams = params;
+	if(m_pBenchmark && !m_LoadParams.m_pProfileName)
+	{
+		/* run sessions with the embedded server by default */
+		m_LoadParams.m_pProfileName = UMC_LOOPBACK_PROFILE;
+	}
+	m_LoadComplete = false;
+	m_LoadResult = false;
+
+	pTaskMsg->type = TASK_MSG_USER;
+	pTaskMsg->sub_type = UMC_TASK_RUN_LOAD_MSG;
+	UmcTaskMsg* pUmcMsg = (UmcTaskMsg*) pTaskMsg->data;
+	pUmcMsg->m_pAppMessage = NULL;
+
+	/* wait for the load to complete */
+	apr_thread_mutex_lock(m_pLoadMutex);
+	if(apt_task_msg_signal(pTask,pTaskMsg) == TRUE)
+	{
+		while(!m_LoadComplete)
+			apr_thread_cond_wait(m_pLoadCond,m_pLoadMutex);
+	}
+	apr_thread_mutex_unlock(m_pLoadMutex);
+	return m_LoadResult;
+}
+
 void UmcFramework::RunSession(const char* pScenarioName, const char* pProfileName)
 {
 	apt_task_t* pTask = apt_consumer_task_base_get(m_pTask);
@@ -525,6 +757,8 @@ apt_bool_t AppOnSessionTerminate(mrcp_application_t *application, mrcp_session_t
 	UmcFramework* pFramework = (UmcFramework*) mrcp_application_object_get(application);
 	pFramework->RemoveSession(pSession);
 	delete pSession;
+	if(pFramework->m_LoadTerminating && !apr_hash_count(pFramework->m_pSessionTable))
+		pFramework->CompleteLoad(true);
 	return true;
 }
 
@@ -576,6 +810,12 @@ void UmcOnTerminateComplete(apt_task_t* pTask)
 	pFramework->DestroyScenarios();
 }
 
+void UmcOnLoadTimer(apt_timer_t* pTimer, void* pObj)
+{
+	UmcFramework* pFramework = (UmcFramework*) pObj;
+	pFramework->ProcessLoadTimer();
+}
+
 apt_bool_t UmcProcessMsg(apt_task_t *pTask, apt_task_msg_t *pMsg)
 {
 	if(pMsg->type != TASK_MSG_USER)
@@ -627,6 +867,11 @@ apt_bool_t UmcProcessMsg(apt_task_t *pTask, apt_task_msg_t *pMsg)
 			pFramework->ProcessShowSessions();
 			break;
 		}
+		case UMC_TASK_RUN_LOAD_MSG:
+		{
+			pFramework->ProcessLoadRequest();
+			break;
+		}
 	}
 	return TRUE;
 }
@@ -0,0 +1,436 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include <stdlib.h>
+#include <apr_strings.h>
+#include "umcloadgenerator.h"
+#include "umcscenario.h"
+#include "umcbenchmark.h"
+#include "apt_log.h"
+
+/* time to wait for in-progress sessions to complete after the test duration elapsed */
+#define UMC_LOAD_DRAIN_TIMEOUT apr_time_from_sec(30)
+
+UmcLatencyHistogram::UmcLatencyHistogram() :
+	m_Count(0),
+	m_Sum(0),
+	m_Min(0),
+	m_Max(0)
+{
+	memset(m_Buckets,0,sizeof(m_Buckets));
+}
+
+apr_size_t UmcLatencyHistogram::BucketIndex(apr_uint32_t value)
+{
+	if(value < SUB_BUCKET_COUNT)
+		return value;
+
+	apr_size_t msb = 0;
+	for(apr_uint32_t v = value; v > 1; v >>= 1)
+		msb++;
+
+	/* the top bit is implied, the next SUB_BUCKET_BITS bits select the sub-bucket */
+	apr_size_t shift = msb - SUB_BUCKET_BITS;
+	return (shift + 1) * SUB_BUCKET_COUNT + (apr_size_t)((value >> shift) - SUB_BUCKET_COUNT);
+}
+
+apr_uint32_t UmcLatencyHistogram::BucketUpperBound(apr_size_t index)
+{
+	if(index < SUB_BUCKET_COUNT)
+		return (apr_uint32_t)index;
+
+	apr_size_t shift = index / SUB_BUCKET_COUNT - 1;
+	apr_uint64_t sub = index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+	apr_uint64_t bound = ((sub + 1) << shift) - 1;
+	return bound > 0xFFFFFFFF ? 0xFFFFFFFF : (apr_uint32_t)bound;
+}
+
+void UmcLatencyHistogram::Record(apr_interval_time_t latency)
+{
+	apr_uint32_t value;
+	if(latency < 0)
+		value = 0;
+	else if(latency > 0xFFFFFFFF)
+		value = 0xFFFFFFFF;
+	else
+		value = (apr_uint32_t)latency;
+
+	m_Buckets[BucketIndex(value)]++;
+	if(!m_Count || value < m_Min)
+		m_Min = value;
+	if(value > m_Max)
+		m_Max = value;
+	m_Sum += value;
+	m_Count++;
+}
+
+apr_uint32_t UmcLatencyHistogram::GetPercentile(double percentile) const
+{
+	if(!m_Count)
+		return 0;
+
+	/* rank of the sample the percentile falls on */
+	apr_size_t rank = (apr_size_t)(percentile * m_Count / 100);
+	if(rank < m_Count * percentile / 100)
+		rank++;
+	if(!rank)
+		rank = 1;
+
+	apr_size_t count = 0;
+	for(apr_size_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		count += m_Buckets[i];
+		if(count >= rank)
+		{
+			apr_uint32_t bound = BucketUpperBound(i);
+			return bound < m_Max ? bound : m_Max;
+		}
+	}
+	return m_Max;
+}
+
+void UmcLatencyHistogram::Report(FILE* pFile, const char* pName) const
+{
+	fprintf(pFile,
+		"    \"%s\": {\"count\": %" APR_SIZE_T_FMT ", \"min\": %u, \"mean\": %" APR_UINT64_T_FMT ", "
+		"\"p50\": %u, \"p99\": %u, \"p999\": %u, \"max\": %u}",
+		pName,
+		m_Count,
+		m_Min,
+		m_Count ? m_Sum / m_Count : 0,
+		GetPercentile(50),
+		GetPercentile(99),
+		GetPercentile(99.9),
+		m_Max);
+}
+
+
+UmcLoadGenerator::UmcLoadGenerator() :
+	m_pMix(NULL),
+	m_MixCount(0),
+	m_TotalWeight(0),
+	m_StartTime(0),
+	m_LastTime(0),
+	m_StopTime(0),
+	m_Credit(0),
+	m_Launching(false),
+	m_Launched(0),
+	m_LaunchFailed(0),
+	m_Failed(0),
+	m_Completed(0),
+	m_Throttled(0),
+	m_RequestFailed(0)
+{
+}
+
+UmcLoadGenerator::~UmcLoadGenerator()
+{
+}
+
+bool UmcLoadGenerator::Load(const UmcLoadParams& params, apr_hash_t* pScenarioTable, apr_pool_t* pool)
+{
+	m_Params = params;
+	if(!m_Params.m_pScenarioMix || !m_Params.m_Concurrency)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Invalid Load Params");
+		return false;
+	}
+
+	char* pMix = apr_pstrdup(pool,m_Params.m_pScenarioMix);
+	apr_size_t maxCount = 1;
+	for(const char* pos = pMix; *pos; pos++)
+	{
+		if(*pos == ',')
+			maxCount++;
+	}
+	m_pMix = (MixEntry*) apr_palloc(pool,sizeof(MixEntry) * maxCount);
+	m_MixCount = 0;
+	m_TotalWeight = 0;
+
+	char* last;
+	for(char* pItem = apr_strtok(pMix,",",&last); pItem; pItem = apr_strtok(NULL,",",&last))
+	{
+		long weight = 1;
+		char* pWeight = strchr(pItem,':');
+		if(pWeight)
+		{
+			*pWeight = '\0';
+			weight = atol(pWeight + 1);
+		}
+
+		UmcScenario* pScenario = (UmcScenario*) apr_hash_get(pScenarioTable,pItem,APR_HASH_KEY_STRING);
+		if(!pScenario || weight <= 0)
+		{
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Invalid Scenario in Load Mix [%s]",pItem);
+			return false;
+		}
+
+		MixEntry* pEntry = &m_pMix[m_MixCount++];
+		pEntry->m_pScenario = pScenario;
+		pEntry->m_Weight = weight;
+		pEntry->m_Current = 0;
+		m_TotalWeight += weight;
+	}
+
+	if(!m_MixCount)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Empty Load Mix");
+		return false;
+	}
+	return true;
+}
+
+void UmcLoadGenerator::Start()
+{
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Start Load [%s] concurrency [%" APR_SIZE_T_FMT "] cps [%" APR_SIZE_T_FMT "] "
+		"duration [%" APR_SIZE_T_FMT "] ramp-up [%" APR_SIZE_T_FMT "]",
+		m_Params.m_pScenarioMix,
+		m_Params.m_Concurrency,
+		m_Params.m_CallsPerSecond,
+		m_Params.m_Duration,
+		m_Params.m_RampUp);
+	m_StartTime = m_LastTime = apr_time_now();
+	m_StopTime = 0;
+	m_Credit = 0;
+	m_Launching = true;
+}
+
+apr_size_t UmcLoadGenerator::GetLaunchCount(apr_size_t activeCount)
+{
+	if(!m_Launching)
+		return 0;
+
+	apr_time_t now = apr_time_now();
+	apr_interval_time_t elapsed = now - m_StartTime;
+	if(elapsed >= apr_time_from_sec(m_Params.m_Duration))
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Stop Load, Wait for %" APR_SIZE_T_FMT " Session(s) to Complete",activeCount);
+		m_Launching = false;
+		m_StopTime = now;
+		return 0;
+	}
+
+	/* both the rate and the concurrency grow linearly during the ramp-up */
+	double ramp = 1;
+	if(m_Params.m_RampUp && elapsed < apr_time_from_sec(m_Params.m_RampUp))
+		ramp = (double)elapsed / apr_time_from_sec(m_Params.m_RampUp);
+
+	apr_size_t limit = (apr_size_t)(m_Params.m_Concurrency * ramp);
+	if(!limit)
+		limit = 1;
+	apr_size_t available = limit > activeCount ? limit - activeCount : 0;
+
+	if(!m_Params.m_CallsPerSecond)
+	{
+		/* closed loop, keep the sessions up to the limit */
+		m_LastTime = now;
+		return available;
+	}
+
+	m_Credit += m_Params.m_CallsPerSecond * ramp * (now - m_LastTime) / APR_USEC_PER_SEC;
+	m_LastTime = now;
+
+	apr_size_t count = (apr_size_t)m_Credit;
+	m_Credit -= count;
+	if(count > available)
+	{
+		/* the server doesn't keep up with the rate at the concurrency limit, skip the excess */
+		m_Throttled += count - available;
+		count = available;
+	}
+	return count;
+}
+
+UmcScenario* UmcLoadGenerator::NextScenario()
+{
+	/* smooth weighted round-robin, which keeps the mix deterministic and evenly interleaved */
+	MixEntry* pBest = NULL;
+	for(apr_size_t i = 0; i < m_MixCount; i++)
+	{
+		MixEntry* pEntry = &m_pMix[i];
+		pEntry->m_Current += pEntry->m_Weight;
+		if(!pBest || pEntry->m_Current > pBest->m_Current)
+			pBest = pEntry;
+	}
+	pBest->m_Current -= m_TotalWeight;
+	return pBest->m_pScenario;
+}
+
+void UmcLoadGenerator::OnSessionLaunch(bool success)
+{
+	if(success)
+		m_Launched++;
+	else
+		m_LaunchFailed++;
+}
+
+bool UmcLoadGenerator::IsDrainExpired() const
+{
+	return !m_Launching && m_StopTime && apr_time_now() - m_StopTime >= UMC_LOAD_DRAIN_TIMEOUT;
+}
+
+bool UmcLoadGenerator::Report(const UmcBenchmark* pBenchmark) const
+{
+	static const char* phaseNames[UMC_LATENCY_PHASE_COUNT] =
+	{
+		"setup",
+		"in-progress",
+		"complete",
+		"teardown"
+	};
+
+	FILE* pFile = stdout;
+	if(m_Params.m_pReportPath)
+	{
+		pFile = fopen(m_Params.m_pReportPath,"w");
+		if(!pFile)
+		{
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Open Report File [%s]",m_Params.m_pReportPath);
+			return false;
+		}
+	}
+
+	fprintf(pFile,
+		"{\n"
+		"  \"scenario-mix\": \"%s\",\n"
+		"  \"profile\": \"%s\",\n"
+		"  \"concurrency\": %" APR_SIZE_T_FMT ",\n"
+		"  \"cps\": %" APR_SIZE_T_FMT ",\n"
+		"  \"duration\": %" APR_SIZE_T_FMT ",\n"
+		"  \"ramp-up\": %" APR_SIZE_T_FMT ",\n"
+		"  \"elapsed-msec\": %" APR_TIME_T_FMT ",\n"
+		"  \"sessions\": {\"launched\": %" APR_SIZE_T_FMT ", \"launch-failed\": %" APR_SIZE_T_FMT ", "
+		"\"completed\": %" APR_SIZE_T_FMT ", \"failed\": %" APR_SIZE_T_FMT ", \"throttled\": %" APR_SIZE_T_FMT "},\n"
+		"  \"requests\": {\"failed\": %" APR_SIZE_T_FMT "},\n"
+		"  \"latency-usec\": {\n",
+		m_Params.m_pScenarioMix,
+		m_Params.m_pProfileName ? m_Params.m_pProfileName : "",
+		m_Params.m_Concurrency,
+		m_Params.m_CallsPerSecond,
+		m_Params.m_Duration,
+		m_Params.m_RampUp,
+		apr_time_as_msec(apr_time_now() - m_StartTime),
+		m_Launched,
+		m_LaunchFailed,
+		m_Completed,
+		m_Failed,
+		m_Throttled,
+		m_RequestFailed);
+	for(int i = 0; i < UMC_LATENCY_PHASE_COUNT; i++)
+	{
+		m_Histograms[i].Report(pFile,phaseNames[i]);
+		fprintf(pFile,i + 1 < UMC_LATENCY_PHASE_COUNT ? ",\n" : "\n");
+	}
+	if(pBenchmark)
+	{
+		fprintf(pFile,"  },\n");
+		pBenchmark->Report(pFile);
+		fprintf(pFile,"\n}\n");
+	}
+	else
+	{
+		fprintf(pFile,"  }\n}\n");
+	}
+
+	if(pFile != stdout)
+		fclose(pFile);
+	else
+		fflush(pFile);
+	return true;
+}
+
+bool UmcLoadGenerator::FindBaselineValue(const char* pText, const char* pSection, const char* pName, double& value)
+{
+	/* the report is written by Report() above, so a plain lookup of "section" and then "name": is enough */
+	char key[64];
+	const char* pPos = pText;
+	if(pSection)
+	{
+		apr_snprintf(key,sizeof(key),"\"%s\"",pSection);
+		pPos = strstr(pPos,key);
+		if(!pPos)
+			return false;
+	}
+
+	apr_snprintf(key,sizeof(key),"\"%s\":",pName);
+	pPos = strstr(pPos,key);
+	if(!pPos)
+		return false;
+
+	value = strtod(pPos + strlen(key),NULL);
+	return true;
+}
+
+bool UmcLoadGenerator::CheckRegression(const char* pText, const char* pSection, const char* pName, double current) const
+{
+	double baseline;
+	if(!FindBaselineValue(pText,pSection,pName,baseline) || baseline <= 0)
+		return true;
+
+	double limit = baseline * (100 + m_Params.m_Tolerance) / 100;
+	if(current > limit)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Regression %s %s: %.1f > %.1f (baseline %.1f, tolerance %" APR_SIZE_T_FMT "%%)",
+			pSection ? pSection : "",pName,current,limit,baseline,m_Params.m_Tolerance);
+		return false;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Check %s %s: %.1f (baseline %.1f)",
+		pSection ? pSection : "",pName,current,baseline);
+	return true;
+}
+
+bool UmcLoadGenerator::Compare(const UmcBenchmark* pBenchmark) const
+{
+	if(!m_Params.m_pBaselinePath)
+		return true;
+
+	FILE* pFile = fopen(m_Params.m_pBaselinePath,"r");
+	if(!pFile)
+	{
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Open Baseline File [%s]",m_Params.m_pBaselinePath);
+		return false;
+	}
+
+	char text[8192];
+	apr_size_t size = fread(text,1,sizeof(text) - 1,pFile);
+	text[size] = '\0';
+	fclose(pFile);
+
+	bool status = true;
+	if(!CheckRegression(text,"setup","p50",m_Histograms[UMC_LATENCY_SETUP].GetPercentile(50)))
+		status = false;
+	if(!CheckRegression(text,"setup","p99",m_Histograms[UMC_LATENCY_SETUP].GetPercentile(99)))
+		status = false;
+	if(!CheckRegression(text,"teardown","p99",m_Histograms[UMC_LATENCY_TEARDOWN].GetPercentile(99)))
+		status = false;
+
+	if(pBenchmark)
+	{
+		if(!CheckRegression(text,"bench","cpu-usec-per-call",pBenchmark->GetCpuPerCall()))
+			status = false;
+		if(!CheckRegression(text,"bench","memory-kb-per-call",pBenchmark->GetMemoryPerCall()))
+			status = false;
+		if(!CheckRegression(text,"server-media-tick","jitter-mean-usec",pBenchmark->GetServerJitterMean()))
+			status = false;
+	}
+
+	if(!status)
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Load Regressed against Baseline [%s]",m_Params.m_pBaselinePath);
+	return status;
+}
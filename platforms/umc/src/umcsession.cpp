@@ -18,6 +18,7 @@
 
 #include "umcsession.h"
 #include "umcscenario.h"
+#include "umcloadgenerator.h"
 #include "mrcp_message.h"
 
 UmcSession::UmcSession(const UmcScenario* pScenario) :
@@ -27,7 +28,13 @@ UmcSession::UmcSession(const UmcScenario* pScenario) :
 	m_pMrcpSession(NULL),
 	m_pMrcpMessage(NULL),
 	m_Running(false),
-	m_Terminating(false)
+	m_Terminating(false),
+	m_pLoadGenerator(NULL),
+	m_SetupTime(0),
+	m_RequestTime(0),
+	m_TeardownTime(0),
+	m_SetupFailed(false),
+	m_ResponseReceived(false)
 {
 	static int id = 0;
 	if(id == INT_MAX)
@@ -57,6 +64,9 @@ bool UmcSession::Run()
 	if(!CreateMrcpSession(m_pMrcpProfile))
 		return false;
 	
+	if(m_pLoadGenerator)
+		m_SetupTime = apr_time_now();
+	
 	m_Running = true;
 	
 	bool ret = false;
@@ -88,7 +98,15 @@ bool UmcSession::Terminate()
 
 	m_Running = false;
 	m_Terminating = true;
-	return (mrcp_application_session_terminate(m_pMrcpSession) == TRUE);
+	if(m_pLoadGenerator)
+		m_TeardownTime = apr_time_now();
+	if(mrcp_application_session_terminate(m_pMrcpSession) != TRUE)
+	{
+		/* no response is expected */
+		m_Terminating = false;
+		return false;
+	}
+	return true;
 }
 
 bool UmcSession::OnSessionTerminate(mrcp_sig_status_code_e status)
@@ -97,6 +115,15 @@ bool UmcSession::OnSessionTerminate(mrcp_sig_status_code_e status)
 		return false;
 
 	m_Terminating = false;
+	if(m_pLoadGenerator)
+	{
+		if(m_TeardownTime)
+			m_pLoadGenerator->OnLatency(UMC_LATENCY_TEARDOWN,apr_time_now() - m_TeardownTime);
+		if(status == MRCP_SIG_STATUS_CODE_SUCCESS && !m_SetupFailed)
+			m_pLoadGenerator->OnSessionComplete();
+		else
+			m_pLoadGenerator->OnSessionFailure();
+	}
 	return DestroyMrcpSession();
 }
 
@@ -107,6 +134,15 @@ bool UmcSession::OnSessionUpdate(mrcp_sig_status_code_e status)
 
 bool UmcSession::OnChannelAdd(mrcp_channel_t *channel, mrcp_sig_status_code_e status) 
 {
+	if(m_pLoadGenerator && m_SetupTime)
+	{
+		/* the session is set up once the first channel is added */
+		if(status == MRCP_SIG_STATUS_CODE_SUCCESS)
+			m_pLoadGenerator->OnLatency(UMC_LATENCY_SETUP,apr_time_now() - m_SetupTime);
+		else
+			m_SetupFailed = true;
+		m_SetupTime = 0;
+	}
 	return m_Running;
 }
 
@@ -127,6 +163,39 @@ bool UmcSession::OnMessageReceive(mrcp_channel_t *channel, mrcp_message_t *messa
 	if(m_pMrcpMessage->start_line.request_id != message->start_line.request_id)
 		return false;
 
+	if(m_pLoadGenerator && m_RequestTime)
+	{
+		const mrcp_start_line_t* pStartLine = &message->start_line;
+		if(pStartLine->message_type == MRCP_MESSAGE_TYPE_RESPONSE)
+		{
+			/* the response is measured once per request */
+			if(m_ResponseReceived)
+				return true;
+			m_ResponseReceived = true;
+
+			if(pStartLine->status_code != MRCP_STATUS_CODE_SUCCESS &&
+				pStartLine->status_code != MRCP_STATUS_CODE_SUCCESS_WITH_IGNORE)
+			{
+				m_pLoadGenerator->OnRequestFailure();
+				m_RequestTime = 0;
+			}
+			else if(pStartLine->request_state == MRCP_REQUEST_STATE_INPROGRESS)
+			{
+				m_pLoadGenerator->OnLatency(UMC_LATENCY_IN_PROGRESS,apr_time_now() - m_RequestTime);
+			}
+			else if(pStartLine->request_state == MRCP_REQUEST_STATE_COMPLETE)
+			{
+				m_pLoadGenerator->OnLatency(UMC_LATENCY_COMPLETE,apr_time_now() - m_RequestTime);
+				m_RequestTime = 0;
+			}
+		}
+		else if(pStartLine->request_state == MRCP_REQUEST_STATE_COMPLETE)
+		{
+			/* IN-PROGRESS events (e.g. START-OF-INPUT) aren't measured */
+			m_pLoadGenerator->OnLatency(UMC_LATENCY_COMPLETE,apr_time_now() - m_RequestTime);
+			m_RequestTime = 0;
+		}
+	}
 	return true;
 }
 
@@ -189,6 +258,11 @@ bool UmcSession::SendMrcpRequest(mrcp_channel_t* pMrcpChannel, mrcp_message_t* p
 		return false;
 
 	m_pMrcpMessage = pMrcpMessage;
+	if(m_pLoadGenerator)
+	{
+		m_RequestTime = apr_time_now();
+		m_ResponseReceived = false;
+	}
 	return (mrcp_application_message_send(m_pMrcpSession,pMrcpChannel,pMrcpMessage) == TRUE);
 }
 
@@ -29,15 +29,17 @@
  * 5. Methods (callbacks) of the MPF engine stream MUST not block.
  */
 
+#include <stdlib.h>
 #include "mrcp_synth_engine.h"
-#include "apt_consumer_task.h"
+#include "mrcp_engine_worker.h"
+#include "mrcp_prompt_cache.h"
 #include "apt_log.h"
 
 #define SYNTH_ENGINE_TASK_NAME "Demo Synth Engine"
+#define SYNTH_PROMPT_CACHE_DIR "prompt-cache"
 
 typedef struct demo_synth_engine_t demo_synth_engine_t;
 typedef struct demo_synth_channel_t demo_synth_channel_t;
-typedef struct demo_synth_msg_t demo_synth_msg_t;
 
 /** Declaration of synthesizer engine methods */
 static apt_bool_t demo_synth_engine_destroy(mrcp_engine_t *engine);
@@ -85,7 +87,9 @@ static const mpf_audio_stream_vtable_t audio_stream_vtable = {
 
 /** Declaration of demo synthesizer engine */
 struct demo_synth_engine_t {
-	apt_consumer_task_t    *task;
+	mrcp_engine_worker_pool_t *worker_pool;
+	/** Cache of rendered prompts (optional) */
+	mrcp_prompt_cache_t       *prompt_cache;
 };
 
 /** Declaration of demo synthesizer channel */
@@ -105,24 +109,30 @@ struct demo_synth_channel_t {
 	apt_bool_t             paused;
 	/** Speech source (used instead of actual synthesis) */
 	FILE                  *audio_file;
+	/** Cached prompt being played */
+	mrcp_prompt_entry_t   *prompt;
+	/** Offset of the cached prompt being played */
+	apr_size_t             prompt_offset;
+	/** Writer of the prompt being rendered */
+	mrcp_prompt_writer_t  *prompt_writer;
+	/** Cached prompt played to completion, released by the worker thread */
+	mrcp_prompt_entry_t   *completed_prompt;
+	/** Writer of the prompt rendered to completion, committed or aborted by the worker thread */
+	mrcp_prompt_writer_t  *completed_prompt_writer;
 };
 
 typedef enum {
 	DEMO_SYNTH_MSG_OPEN_CHANNEL,
 	DEMO_SYNTH_MSG_CLOSE_CHANNEL,
-	DEMO_SYNTH_MSG_REQUEST_PROCESS
+	DEMO_SYNTH_MSG_REQUEST_PROCESS,
+	DEMO_SYNTH_MSG_PROMPT_COMMIT,
+	DEMO_SYNTH_MSG_PROMPT_ABORT
 } demo_synth_msg_type_e;
 
-/** Declaration of demo synthesizer task message */
-struct demo_synth_msg_t {
-	demo_synth_msg_type_e  type;
-	mrcp_engine_channel_t *channel; 
-	mrcp_message_t        *request;
-};
-
-
 static apt_bool_t demo_synth_msg_signal(demo_synth_msg_type_e type, mrcp_engine_channel_t *channel, mrcp_message_t *request);
-static apt_bool_t demo_synth_msg_process(apt_task_t *task, apt_task_msg_t *msg);
+static apt_bool_t demo_synth_msg_process(void *obj, const mrcp_engine_worker_msg_t *msg);
+static void demo_synth_prompt_complete(demo_synth_channel_t *synth_channel, apt_bool_t completed);
+static void demo_synth_prompt_release(demo_synth_engine_t *demo_engine, mrcp_prompt_entry_t *prompt, mrcp_prompt_writer_t *prompt_writer, apt_bool_t completed);
 
 /** Declare this macro to set plugin version */
 MRCP_PLUGIN_VERSION_DECLARE
@@ -135,22 +145,9 @@ MRCP_PLUGIN_DECLARE(mrcp_engine_t*) mrcp_plugin_create(apr_pool_t *pool)
 {
 	/* create demo engine */
 	demo_synth_engine_t *demo_engine = apr_palloc(pool,sizeof(demo_synth_engine_t));
-	apt_task_t *task;
-	apt_task_vtable_t *vtable;
-	apt_task_msg_pool_t *msg_pool;
-
-	/* create task/thread to run demo engine in the context of this task */
-	msg_pool = apt_task_msg_pool_create_dynamic(sizeof(demo_synth_msg_t),pool);
-	demo_engine->task = apt_consumer_task_create(demo_engine,msg_pool,pool);
-	if(!demo_engine->task) {
-		return NULL;
-	}
-	task = apt_consumer_task_base_get(demo_engine->task);
-	apt_task_name_set(task,SYNTH_ENGINE_TASK_NAME);
-	vtable = apt_task_vtable_get(task);
-	if(vtable) {
-		vtable->process_msg = demo_synth_msg_process;
-	}
+	/* worker threads and prompt cache are created on engine open, once the engine params are loaded */
+	demo_engine->worker_pool = NULL;
+	demo_engine->prompt_cache = NULL;
 
 	/* create engine base */
 	return mrcp_engine_create(
@@ -164,10 +161,13 @@ MRCP_PLUGIN_DECLARE(mrcp_engine_t*) mrcp_plugin_create(apr_pool_t *pool)
 static apt_bool_t demo_synth_engine_destroy(mrcp_engine_t *engine)
 {
 	demo_synth_engine_t *demo_engine = engine->obj;
-	if(demo_engine->task) {
-		apt_task_t *task = apt_consumer_task_base_get(demo_engine->task);
-		apt_task_destroy(task);
-		demo_engine->task = NULL;
+	if(demo_engine->worker_pool) {
+		mrcp_engine_worker_pool_destroy(demo_engine->worker_pool);
+		demo_engine->worker_pool = NULL;
+	}
+	if(demo_engine->prompt_cache) {
+		mrcp_prompt_cache_destroy(demo_engine->prompt_cache);
+		demo_engine->prompt_cache = NULL;
 	}
 	return TRUE;
 }
@@ -176,9 +176,28 @@ static apt_bool_t demo_synth_engine_destroy(mrcp_engine_t *engine)
 static apt_bool_t demo_synth_engine_open(mrcp_engine_t *engine)
 {
 	demo_synth_engine_t *demo_engine = engine->obj;
-	if(demo_engine->task) {
-		apt_task_t *task = apt_consumer_task_base_get(demo_engine->task);
-		apt_task_start(task);
+	if(!demo_engine->worker_pool) {
+		demo_engine->worker_pool = mrcp_engine_worker_pool_create_ex(
+										engine,
+										demo_engine,
+										demo_synth_msg_process,
+										SYNTH_ENGINE_TASK_NAME);
+		if(!demo_engine->worker_pool) {
+			return mrcp_engine_open_respond(engine,FALSE);
+		}
+	}
+	mrcp_engine_worker_pool_start(demo_engine->worker_pool);
+
+	if(!demo_engine->prompt_cache) {
+		/* prompt cache is enabled by specifying its max size in bytes */
+		const char *max_size = mrcp_engine_param_get(engine,"prompt-cache-size");
+		if(max_size && atol(max_size) > 0) {
+			const char *dir_path = mrcp_engine_param_get(engine,"prompt-cache-dir");
+			if(!dir_path) {
+				dir_path = apt_vardir_filepath_get(engine->dir_layout,SYNTH_PROMPT_CACHE_DIR,engine->pool);
+			}
+			demo_engine->prompt_cache = mrcp_prompt_cache_create(dir_path,atol(max_size),engine->pool);
+		}
 	}
 	return mrcp_engine_open_respond(engine,TRUE);
 }
@@ -187,9 +206,8 @@ static apt_bool_t demo_synth_engine_open(mrcp_engine_t *engine)
 static apt_bool_t demo_synth_engine_close(mrcp_engine_t *engine)
 {
 	demo_synth_engine_t *demo_engine = engine->obj;
-	if(demo_engine->task) {
-		apt_task_t *task = apt_consumer_task_base_get(demo_engine->task);
-		apt_task_terminate(task,TRUE);
+	if(demo_engine->worker_pool) {
+		mrcp_engine_worker_pool_terminate(demo_engine->worker_pool);
 	}
 	return mrcp_engine_close_respond(engine);
 }
@@ -208,6 +226,11 @@ static mrcp_engine_channel_t* demo_synth_engine_channel_create(mrcp_engine_t *en
 	synth_channel->time_to_complete = 0;
 	synth_channel->paused = FALSE;
 	synth_channel->audio_file = NULL;
+	synth_channel->prompt = NULL;
+	synth_channel->prompt_offset = 0;
+	synth_channel->prompt_writer = NULL;
+	synth_channel->completed_prompt = NULL;
+	synth_channel->completed_prompt_writer = NULL;
 	
 	capabilities = mpf_source_stream_capabilities_create(pool);
 	mpf_codec_capabilities_add(
@@ -236,7 +259,11 @@ static mrcp_engine_channel_t* demo_synth_engine_channel_create(mrcp_engine_t *en
 /** Destroy engine channel */
 static apt_bool_t demo_synth_channel_destroy(mrcp_engine_channel_t *channel)
 {
-	/* nothing to destroy */
+	demo_synth_channel_t *synth_channel = channel->method_obj;
+	/* release prompt resources left by a SPEAK request interrupted by the channel termination */
+	demo_synth_prompt_release(synth_channel->demo_engine,synth_channel->prompt,synth_channel->prompt_writer,FALSE);
+	synth_channel->prompt = NULL;
+	synth_channel->prompt_writer = NULL;
 	return TRUE;
 }
 
@@ -272,6 +299,26 @@ static apt_bool_t demo_synth_channel_speak(mrcp_engine_channel_t *channel, mrcp_
 	}
 
 	synth_channel->time_to_complete = 0;
+	if(synth_channel->demo_engine->prompt_cache) {
+		mrcp_prompt_cache_t *prompt_cache = synth_channel->demo_engine->prompt_cache;
+		mrcp_prompt_key_t key;
+		if(mrcp_prompt_key_init(&key,request,descriptor,request->pool) == TRUE) {
+			synth_channel->prompt = mrcp_prompt_cache_find(prompt_cache,&key);
+			if(synth_channel->prompt) {
+				apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Play Cached Prompt [%"APR_SIZE_T_FMT" bytes] "APT_SIDRES_FMT,
+					mrcp_prompt_entry_size_get(synth_channel->prompt),
+					MRCP_MESSAGE_SIDRES(request));
+				synth_channel->prompt_offset = 0;
+				response->start_line.request_state = MRCP_REQUEST_STATE_INPROGRESS;
+				/* send asynchronous response */
+				mrcp_engine_channel_message_send(channel,response);
+				synth_channel->speak_request = request;
+				return TRUE;
+			}
+			/* store the prompt being rendered for subsequent requests */
+			synth_channel->prompt_writer = mrcp_prompt_writer_create(prompt_cache,&key);
+		}
+	}
 	if(channel->engine) {
 		char *file_name = apr_psprintf(channel->pool,"demo-%dkHz.pcm",descriptor->sampling_rate/1000);
 		file_path = apt_datadir_filepath_get(channel->engine->dir_layout,file_name,channel->pool);
@@ -441,12 +488,49 @@ static apt_bool_t demo_synth_stream_close(mpf_audio_stream_t *stream)
 	return TRUE;
 }
 
+/** Release cached prompt played and commit or abort prompt rendered (blocks on file I/O) */
+static void demo_synth_prompt_release(demo_synth_engine_t *demo_engine, mrcp_prompt_entry_t *prompt, mrcp_prompt_writer_t *prompt_writer, apt_bool_t completed)
+{
+	if(prompt) {
+		mrcp_prompt_cache_release(demo_engine->prompt_cache,prompt);
+	}
+	if(prompt_writer) {
+		if(completed == TRUE) {
+			mrcp_prompt_cache_release(demo_engine->prompt_cache,mrcp_prompt_writer_commit(prompt_writer));
+		}
+		else {
+			mrcp_prompt_writer_abort(prompt_writer);
+		}
+	}
+}
+
+/** Hand cached prompt being played and prompt being rendered over to the worker thread */
+static void demo_synth_prompt_complete(demo_synth_channel_t *synth_channel, apt_bool_t completed)
+{
+	if(!synth_channel->prompt && !synth_channel->prompt_writer) {
+		return;
+	}
+
+	/* the next SPEAK request is processed by the same worker thread after this message,
+	   so there is no more than one completed prompt per channel at a time */
+	synth_channel->completed_prompt = synth_channel->prompt;
+	synth_channel->completed_prompt_writer = synth_channel->prompt_writer;
+	synth_channel->prompt = NULL;
+	synth_channel->prompt_writer = NULL;
+	demo_synth_msg_signal(
+		completed == TRUE ? DEMO_SYNTH_MSG_PROMPT_COMMIT : DEMO_SYNTH_MSG_PROMPT_ABORT,
+		synth_channel->channel,
+		NULL);
+}
+
 /** Callback is called from MPF engine context to read/get new frame */
 static apt_bool_t demo_synth_stream_read(mpf_audio_stream_t *stream, mpf_frame_t *frame)
 {
 	demo_synth_channel_t *synth_channel = stream->obj;
 	/* check if STOP was requested */
 	if(synth_channel->stop_response) {
+		/* abort the prompt prior to the response, so it's handed over ahead of any subsequent request */
+		demo_synth_prompt_complete(synth_channel,FALSE);
 		/* send asynchronous response to STOP request */
 		mrcp_engine_channel_message_send(synth_channel->channel,synth_channel->stop_response);
 		synth_channel->stop_response = NULL;
@@ -463,11 +547,21 @@ static apt_bool_t demo_synth_stream_read(mpf_audio_stream_t *stream, mpf_frame_t
 	if(synth_channel->speak_request && synth_channel->paused == FALSE) {
 		/* normal processing */
 		apt_bool_t completed = FALSE;
-		if(synth_channel->audio_file) {
+		if(synth_channel->prompt) {
+			/* play cached prompt directly from the mapping */
+			if(mrcp_prompt_entry_frame_read(synth_channel->prompt,&synth_channel->prompt_offset,frame) == FALSE) {
+				completed = TRUE;
+			}
+		}
+		else if(synth_channel->audio_file) {
 			/* read speech from file */
 			apr_size_t size = frame->codec_frame.size;
 			if(fread(frame->codec_frame.buffer,1,size,synth_channel->audio_file) == size) {
 				frame->type |= MEDIA_FRAME_TYPE_AUDIO;
+				if(synth_channel->prompt_writer) {
+					/* buffered in memory, an uncacheable prompt is discarded on completion */
+					mrcp_prompt_writer_write(synth_channel->prompt_writer,frame->codec_frame.buffer,size);
+				}
 			}
 			else {
 				completed = TRUE;
@@ -507,6 +601,7 @@ static apt_bool_t demo_synth_stream_read(mpf_audio_stream_t *stream, mpf_frame_t
 					fclose(synth_channel->audio_file);
 					synth_channel->audio_file = NULL;
 				}
+				demo_synth_prompt_complete(synth_channel,TRUE);
 				/* send asynch event */
 				mrcp_engine_channel_message_send(synth_channel->channel,message);
 			}
@@ -517,27 +612,13 @@ static apt_bool_t demo_synth_stream_read(mpf_audio_stream_t *stream, mpf_frame_t
 
 static apt_bool_t demo_synth_msg_signal(demo_synth_msg_type_e type, mrcp_engine_channel_t *channel, mrcp_message_t *request)
 {
-	apt_bool_t status = FALSE;
 	demo_synth_channel_t *demo_channel = channel->method_obj;
 	demo_synth_engine_t *demo_engine = demo_channel->demo_engine;
-	apt_task_t *task = apt_consumer_task_base_get(demo_engine->task);
-	apt_task_msg_t *msg = apt_task_msg_get(task);
-	if(msg) {
-		demo_synth_msg_t *demo_msg;
-		msg->type = TASK_MSG_USER;
-		demo_msg = (demo_synth_msg_t*) msg->data;
-
-		demo_msg->type = type;
-		demo_msg->channel = channel;
-		demo_msg->request = request;
-		status = apt_task_msg_signal(task,msg);
-	}
-	return status;
+	return mrcp_engine_worker_pool_signal(demo_engine->worker_pool,type,channel,request);
 }
 
-static apt_bool_t demo_synth_msg_process(apt_task_t *task, apt_task_msg_t *msg)
+static apt_bool_t demo_synth_msg_process(void *obj, const mrcp_engine_worker_msg_t *demo_msg)
 {
-	demo_synth_msg_t *demo_msg = (demo_synth_msg_t*)msg->data;
 	switch(demo_msg->type) {
 		case DEMO_SYNTH_MSG_OPEN_CHANNEL:
 			/* open channel and send asynch response */
@@ -550,6 +631,20 @@ static apt_bool_t demo_synth_msg_process(apt_task_t *task, apt_task_msg_t *msg)
 		case DEMO_SYNTH_MSG_REQUEST_PROCESS:
 			demo_synth_channel_request_dispatch(demo_msg->channel,demo_msg->request);
 			break;
+		case DEMO_SYNTH_MSG_PROMPT_COMMIT:
+		case DEMO_SYNTH_MSG_PROMPT_ABORT:
+		{
+			/* store or discard the prompt off the media thread */
+			demo_synth_channel_t *synth_channel = demo_msg->channel->method_obj;
+			demo_synth_prompt_release(
+				synth_channel->demo_engine,
+				synth_channel->completed_prompt,
+				synth_channel->completed_prompt_writer,
+				demo_msg->type == DEMO_SYNTH_MSG_PROMPT_COMMIT ? TRUE : FALSE);
+			synth_channel->completed_prompt = NULL;
+			synth_channel->completed_prompt_writer = NULL;
+			break;
+		}
 		default:
 			break;
 	}
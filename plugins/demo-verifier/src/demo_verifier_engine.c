@@ -31,14 +31,13 @@
 
 #include "mrcp_verifier_engine.h"
 #include "mpf_activity_detector.h"
-#include "apt_consumer_task.h"
+#include "mrcp_engine_worker.h"
 #include "apt_log.h"
 
 #define VERIFIER_ENGINE_TASK_NAME "Demo Verifier Engine"
 
 typedef struct demo_verifier_engine_t demo_verifier_engine_t;
 typedef struct demo_verifier_channel_t demo_verifier_channel_t;
-typedef struct demo_verifier_msg_t demo_verifier_msg_t;
 
 /** Declaration of verification engine methods */
 static apt_bool_t demo_verifier_engine_destroy(mrcp_engine_t *engine);
@@ -86,7 +85,7 @@ static const mpf_audio_stream_vtable_t audio_stream_vtable = {
 
 /** Declaration of demo verification engine */
 struct demo_verifier_engine_t {
-	apt_consumer_task_t    *task;
+	mrcp_engine_worker_pool_t *worker_pool;
 };
 
 /** Declaration of demo verification channel */
@@ -114,15 +113,8 @@ typedef enum {
 	DEMO_VERIF_MSG_REQUEST_PROCESS
 } demo_verifier_msg_type_e;
 
-/** Declaration of demo verification task message */
-struct demo_verifier_msg_t {
-	demo_verifier_msg_type_e  type;
-	mrcp_engine_channel_t *channel; 
-	mrcp_message_t        *request;
-};
-
 static apt_bool_t demo_verifier_msg_signal(demo_verifier_msg_type_e type, mrcp_engine_channel_t *channel, mrcp_message_t *request);
-static apt_bool_t demo_verifier_msg_process(apt_task_t *task, apt_task_msg_t *msg);
+static apt_bool_t demo_verifier_msg_process(void *obj, const mrcp_engine_worker_msg_t *msg);
 
 static apt_bool_t demo_verifier_result_load(demo_verifier_channel_t *verifier_channel, mrcp_message_t *message);
 
@@ -136,21 +128,8 @@ MRCP_PLUGIN_LOGGER_IMPLEMENT
 MRCP_PLUGIN_DECLARE(mrcp_engine_t*) mrcp_plugin_create(apr_pool_t *pool)
 {
 	demo_verifier_engine_t *demo_engine = apr_palloc(pool,sizeof(demo_verifier_engine_t));
-	apt_task_t *task;
-	apt_task_vtable_t *vtable;
-	apt_task_msg_pool_t *msg_pool;
-
-	msg_pool = apt_task_msg_pool_create_dynamic(sizeof(demo_verifier_msg_t),pool);
-	demo_engine->task = apt_consumer_task_create(demo_engine,msg_pool,pool);
-	if(!demo_engine->task) {
-		return NULL;
-	}
-	task = apt_consumer_task_base_get(demo_engine->task);
-	apt_task_name_set(task,VERIFIER_ENGINE_TASK_NAME);
-	vtable = apt_task_vtable_get(task);
-	if(vtable) {
-		vtable->process_msg = demo_verifier_msg_process;
-	}
+	/* worker threads are created on engine open, once the engine params are loaded */
+	demo_engine->worker_pool = NULL;
 
 	/* create engine base */
 	return mrcp_engine_create(
@@ -164,10 +143,9 @@ MRCP_PLUGIN_DECLARE(mrcp_engine_t*) mrcp_plugin_create(apr_pool_t *pool)
 static apt_bool_t demo_verifier_engine_destroy(mrcp_engine_t *engine)
 {
 	demo_verifier_engine_t *demo_engine = engine->obj;
-	if(demo_engine->task) {
-		apt_task_t *task = apt_consumer_task_base_get(demo_engine->task);
-		apt_task_destroy(task);
-		demo_engine->task = NULL;
+	if(demo_engine->worker_pool) {
+		mrcp_engine_worker_pool_destroy(demo_engine->worker_pool);
+		demo_engine->worker_pool = NULL;
 	}
 	return TRUE;
 }
@@ -176,10 +154,17 @@ static apt_bool_t demo_verifier_engine_destroy(mrcp_engine_t *engine)
 static apt_bool_t demo_verifier_engine_open(mrcp_engine_t *engine)
 {
 	demo_verifier_engine_t *demo_engine = engine->obj;
-	if(demo_engine->task) {
-		apt_task_t *task = apt_consumer_task_base_get(demo_engine->task);
-		apt_task_start(task);
+	if(!demo_engine->worker_pool) {
+		demo_engine->worker_pool = mrcp_engine_worker_pool_create_ex(
+										engine,
+										demo_engine,
+										demo_verifier_msg_process,
+										VERIFIER_ENGINE_TASK_NAME);
+		if(!demo_engine->worker_pool) {
+			return mrcp_engine_open_respond(engine,FALSE);
+		}
 	}
+	mrcp_engine_worker_pool_start(demo_engine->worker_pool);
 	return mrcp_engine_open_respond(engine,TRUE);
 }
 
@@ -187,9 +172,8 @@ static apt_bool_t demo_verifier_engine_open(mrcp_engine_t *engine)
 static apt_bool_t demo_verifier_engine_close(mrcp_engine_t *engine)
 {
 	demo_verifier_engine_t *demo_engine = engine->obj;
-	if(demo_engine->task) {
-		apt_task_t *task = apt_consumer_task_base_get(demo_engine->task);
-		apt_task_terminate(task,TRUE);
+	if(demo_engine->worker_pool) {
+		mrcp_engine_worker_pool_terminate(demo_engine->worker_pool);
 	}
 	return mrcp_engine_close_respond(engine);
 }
@@ -541,27 +525,13 @@ static apt_bool_t demo_verifier_stream_write(mpf_audio_stream_t *stream, const m
 
 static apt_bool_t demo_verifier_msg_signal(demo_verifier_msg_type_e type, mrcp_engine_channel_t *channel, mrcp_message_t *request)
 {
-	apt_bool_t status = FALSE;
 	demo_verifier_channel_t *demo_channel = channel->method_obj;
 	demo_verifier_engine_t *demo_engine = demo_channel->demo_engine;
-	apt_task_t *task = apt_consumer_task_base_get(demo_engine->task);
-	apt_task_msg_t *msg = apt_task_msg_get(task);
-	if(msg) {
-		demo_verifier_msg_t *demo_msg;
-		msg->type = TASK_MSG_USER;
-		demo_msg = (demo_verifier_msg_t*) msg->data;
-
-		demo_msg->type = type;
-		demo_msg->channel = channel;
-		demo_msg->request = request;
-		status = apt_task_msg_signal(task,msg);
-	}
-	return status;
+	return mrcp_engine_worker_pool_signal(demo_engine->worker_pool,type,channel,request);
 }
 
-static apt_bool_t demo_verifier_msg_process(apt_task_t *task, apt_task_msg_t *msg)
+static apt_bool_t demo_verifier_msg_process(void *obj, const mrcp_engine_worker_msg_t *demo_msg)
 {
-	demo_verifier_msg_t *demo_msg = (demo_verifier_msg_t*)msg->data;
 	switch(demo_msg->type) {
 		case DEMO_VERIF_MSG_OPEN_CHANNEL:
 			/* open channel and send asynch response */
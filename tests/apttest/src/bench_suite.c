@@ -0,0 +1,237 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include "apt_test_suite.h"
+#include "apt_text_stream.h"
+#include "apt_timer_queue.h"
+#include "apt_cyclic_queue.h"
+#include "apt_nlsml_doc.h"
+#include "apt_nlsml_stream.h"
+#include "apt_log.h"
+
+#define SAMPLE_MESSAGE \
+	"MRCP/2.0 732 SPEAK 543257\r\n" \
+	"Channel-Identifier: 32AECB23433802@speechsynth\r\n" \
+	"Voice-Gender: neutral\r\n" \
+	"Voice-Age: 25\r\n" \
+	"Prosody-Volume: medium\r\n" \
+	"Content-Type: application/ssml+xml\r\n" \
+	"Content-Length: 542\r\n" \
+	"\r\n"
+#define SAMPLE_HEADER_COUNT 6
+
+#define TIMER_COUNT 64
+#define QUEUE_DEPTH 32
+
+#define NLSML_GRAMMAR "session:request1@form-level.store"
+
+static char sample_message[] = SAMPLE_MESSAGE;
+
+/** Timer queue benchmark object */
+typedef struct {
+	apt_timer_queue_t *queue;
+	apt_timer_t       *timers[TIMER_COUNT];
+	apr_size_t         index;
+} timer_bench_t;
+
+/** NLSML benchmark object */
+typedef struct {
+	nlsml_writer_t *writer;
+	apr_size_t      alternative_count;
+	apt_str_t       document;
+} nlsml_bench_t;
+
+
+/* Read start-line and header fields of a message */
+static apt_bool_t text_stream_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	apt_text_stream_t stream;
+	apt_str_t line;
+	apt_str_t field;
+	apt_pair_t pair;
+	apr_size_t count = 0;
+
+	apt_text_stream_init(&stream,sample_message,sizeof(sample_message)-1);
+	if(apt_text_line_read(&stream,&line) == FALSE) {
+		return FALSE;
+	}
+
+	/* split start-line into fields */
+	{
+		apt_text_stream_t line_stream;
+		line_stream.text = line;
+		apt_text_stream_reset(&line_stream);
+		while(apt_text_field_read(&line_stream,APT_TOKEN_SP,TRUE,&field) == TRUE);
+	}
+
+	while(apt_text_header_read(&stream,&pair) == TRUE && pair.name.length) {
+		count++;
+	}
+	return (count == SAMPLE_HEADER_COUNT) ? TRUE : FALSE;
+}
+
+static void timer_bench_proc(apt_timer_t *timer, void *obj)
+{
+	/* nothing to do */
+}
+
+/* Set a timer and advance the queue by 1 msec, so that a timer fires every iteration or so */
+static apt_bool_t timer_queue_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	timer_bench_t *timer_bench = bench->obj;
+	apr_size_t index = timer_bench->index;
+	if(apt_timer_set(timer_bench->timers[index],TIMER_COUNT + (apr_uint32_t)(index % 7)) == FALSE) {
+		return FALSE;
+	}
+	timer_bench->index = (index + 1) % TIMER_COUNT;
+	apt_timer_queue_advance(timer_bench->queue,1);
+	return TRUE;
+}
+
+/* Push an object to and pop an object from the queue of steady depth */
+static apt_bool_t cyclic_queue_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	apt_cyclic_queue_t *queue = bench->obj;
+	if(apt_cyclic_queue_push(queue,bench) == FALSE) {
+		return FALSE;
+	}
+	return apt_cyclic_queue_pop(queue) ? TRUE : FALSE;
+}
+
+static apr_status_t cyclic_queue_bench_cleanup(void *obj)
+{
+	apt_cyclic_queue_destroy(obj);
+	return APR_SUCCESS;
+}
+
+/* Compose N-best result by the NLSML writer */
+static apt_bool_t nlsml_write_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	nlsml_bench_t *nlsml_bench = bench->obj;
+	apt_str_t content;
+	apr_size_t i;
+
+	apt_string_set(&content,"one two three");
+	nlsml_writer_result_begin(nlsml_bench->writer,NULL);
+	for(i = 0; i < nlsml_bench->alternative_count; i++) {
+		nlsml_writer_interpretation_begin(nlsml_bench->writer,NLSML_GRAMMAR,1.0f - (float)i / 200);
+		nlsml_writer_instance_add(nlsml_bench->writer,&content,TRUE);
+		nlsml_writer_input_add(nlsml_bench->writer,"speech",1.0f - (float)i / 200,&content);
+		nlsml_writer_interpretation_end(nlsml_bench->writer);
+	}
+	return nlsml_writer_result_end(nlsml_bench->writer,&nlsml_bench->document);
+}
+
+/* Parse N-best result into XML tree and generate the content of every instance */
+static apt_bool_t nlsml_dom_parse_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	nlsml_bench_t *nlsml_bench = bench->obj;
+	nlsml_interpretation_t *interpretation;
+	nlsml_instance_t *instance;
+	apr_size_t count = 0;
+	nlsml_result_t *result = nlsml_result_parse(nlsml_bench->document.buf,nlsml_bench->document.length,pool);
+	if(!result) {
+		return FALSE;
+	}
+
+	for(interpretation = nlsml_first_interpretation_get(result); interpretation;
+			interpretation = nlsml_next_interpretation_get(result,interpretation)) {
+		instance = nlsml_interpretation_first_instance_get(interpretation);
+		if(instance && nlsml_instance_content_generate(instance,pool)) {
+			count++;
+		}
+	}
+	return (count == nlsml_bench->alternative_count) ? TRUE : FALSE;
+}
+
+/* Parse N-best result in a single pass and get the text of every instance */
+static apt_bool_t nlsml_stream_parse_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	nlsml_bench_t *nlsml_bench = bench->obj;
+	apt_str_t text;
+	apr_size_t i;
+	nlsml_stream_result_t *result = nlsml_stream_result_parse(nlsml_bench->document.buf,nlsml_bench->document.length,pool);
+	if(!result || result->interpretation_count != nlsml_bench->alternative_count) {
+		return FALSE;
+	}
+
+	for(i = 0; i < result->interpretation_count; i++) {
+		if(!result->interpretations[i].instance_count) {
+			return FALSE;
+		}
+		nlsml_stream_text_get(&result->interpretations[i].instances[0],&text,pool);
+	}
+	return TRUE;
+}
+
+static void nlsml_benchmarks_add(apt_test_framework_t *framework, apr_size_t alternative_count, apr_pool_t *pool)
+{
+	char name[32];
+	nlsml_bench_t *nlsml_bench = apr_palloc(pool,sizeof(nlsml_bench_t));
+	apt_benchmark_t *bench;
+	nlsml_bench->writer = nlsml_writer_create(256 * alternative_count,pool);
+	nlsml_bench->alternative_count = alternative_count;
+
+	apr_snprintf(name,sizeof(name),"nlsml-write-%"APR_SIZE_T_FMT,alternative_count);
+	bench = apt_benchmark_create(pool,name,nlsml_bench,nlsml_write_bench_run);
+	apt_test_framework_benchmark_add(framework,bench);
+
+	/* compose the document to parse by the writer; the writer buffer is reused by the write benchmark */
+	nlsml_write_bench_run(bench,pool);
+	apt_string_copy(&nlsml_bench->document,&nlsml_bench->document,pool);
+
+	apr_snprintf(name,sizeof(name),"nlsml-dom-parse-%"APR_SIZE_T_FMT,alternative_count);
+	apt_test_framework_benchmark_add(framework,apt_benchmark_create(pool,name,nlsml_bench,nlsml_dom_parse_bench_run));
+	apr_snprintf(name,sizeof(name),"nlsml-stream-parse-%"APR_SIZE_T_FMT,alternative_count);
+	apt_test_framework_benchmark_add(framework,apt_benchmark_create(pool,name,nlsml_bench,nlsml_stream_parse_bench_run));
+}
+
+static apt_benchmark_t* timer_queue_bench_create(apr_pool_t *pool)
+{
+	apr_size_t i;
+	timer_bench_t *timer_bench = apr_palloc(pool,sizeof(timer_bench_t));
+	timer_bench->queue = apt_timer_queue_create(pool);
+	for(i = 0; i < TIMER_COUNT; i++) {
+		timer_bench->timers[i] = apt_timer_create(timer_bench->queue,timer_bench_proc,timer_bench,pool);
+	}
+	timer_bench->index = 0;
+	return apt_benchmark_create(pool,"timer-queue",timer_bench,timer_queue_bench_run);
+}
+
+static apt_benchmark_t* cyclic_queue_bench_create(apr_pool_t *pool)
+{
+	apr_size_t i;
+	apt_cyclic_queue_t *queue = apt_cyclic_queue_create(QUEUE_DEPTH * 2);
+	for(i = 0; i < QUEUE_DEPTH; i++) {
+		apt_cyclic_queue_push(queue,queue);
+	}
+	apr_pool_cleanup_register(pool,queue,cyclic_queue_bench_cleanup,apr_pool_cleanup_null);
+	return apt_benchmark_create(pool,"cyclic-queue",queue,cyclic_queue_bench_run);
+}
+
+apt_bool_t toolkit_benchmarks_add(apt_test_framework_t *framework)
+{
+	apr_pool_t *pool = apt_test_framework_pool_get(framework);
+	apt_test_framework_benchmark_add(framework,apt_benchmark_create(pool,"text-stream",NULL,text_stream_bench_run));
+	apt_test_framework_benchmark_add(framework,timer_queue_bench_create(pool));
+	apt_test_framework_benchmark_add(framework,cyclic_queue_bench_create(pool));
+	nlsml_benchmarks_add(framework,1,pool);
+	nlsml_benchmarks_add(framework,10,pool);
+	nlsml_benchmarks_add(framework,100,pool);
+	return TRUE;
+}
@@ -22,6 +22,8 @@
 apt_test_suite_t* task_test_suite_create(apr_pool_t *pool);
 apt_test_suite_t* consumer_task_test_suite_create(apr_pool_t *pool);
 apt_test_suite_t* multipart_test_suite_create(apr_pool_t *pool);
+apt_test_suite_t* nlsml_test_suite_create(apr_pool_t *pool);
+apt_bool_t toolkit_benchmarks_add(apt_test_framework_t *framework);
 
 int main(int argc, const char * const *argv)
 {
@@ -48,6 +50,12 @@ int main(int argc, const char * const *argv)
 	test_suite = multipart_test_suite_create(pool);
 	apt_test_framework_suite_add(test_framework,test_suite);
 
+	test_suite = nlsml_test_suite_create(pool);
+	apt_test_framework_suite_add(test_framework,test_suite);
+
+	/* add benchmarks to test framework */
+	toolkit_benchmarks_add(test_framework);
+
 	/* run tests */
 	apt_test_framework_run(test_framework,argc,argv);
 
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include <string.h>
+#include "apt_test_suite.h"
+#include "apt_nlsml_doc.h"
+#include "apt_nlsml_stream.h"
+#include "apt_log.h"
+
+static const char sample_result[] =
+	"<?xml version=\"1.0\"?>\n"
+	"<result xmlns=\"http://www.ietf.org/xml/ns/mrcpv2\">\n"
+	"  <interpretation grammar=\"session:request1@form-level.store\" confidence=\"0.85\">\n"
+	"    <instance>Boston &amp; Denver</instance>\n"
+	"    <input mode=\"speech\" confidence=\"0.9\">from boston to denver</input>\n"
+	"  </interpretation>\n"
+	"  <interpretation grammar=\"session:request1@form-level.store\" confidence=\"60\">\n"
+	"    <instance><![CDATA[Austin <TX>]]></instance>\n"
+	"    <input mode=\"speech\">from austin</input>\n"
+	"  </interpretation>\n"
+	"</result>\n";
+
+static const char * const sample_instances[] = {"Boston & Denver", "Austin <TX>", NULL};
+static const char * const writer_instances[] = {"Boston & Denver", NULL};
+
+/* Compare the result of the streaming parser against the DOM based one and the expected instances */
+static apt_bool_t nlsml_stream_parse_test(apt_test_suite_t *suite, const char *data, apr_size_t length, const char * const *instances)
+{
+	nlsml_result_t *dom_result;
+	nlsml_interpretation_t *interpretation;
+	nlsml_input_t *input;
+	apr_size_t i = 0;
+	apt_str_t text;
+	nlsml_stream_result_t *result = nlsml_stream_result_parse(data,length,suite->pool);
+	if(!result) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Parse NLSML Result");
+		return FALSE;
+	}
+
+	dom_result = nlsml_result_parse(data,length,suite->pool);
+	if(!dom_result) {
+		return FALSE;
+	}
+
+	for(interpretation = nlsml_first_interpretation_get(dom_result); interpretation;
+			interpretation = nlsml_next_interpretation_get(dom_result,interpretation), i++) {
+		nlsml_stream_interpretation_t *stream_interpretation;
+		if(i >= result->interpretation_count || !instances[i]) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Missing Interpretation [%"APR_SIZE_T_FMT"]",i);
+			return FALSE;
+		}
+		stream_interpretation = &result->interpretations[i];
+		if(stream_interpretation->confidence != nlsml_interpretation_confidence_get(interpretation)) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Confidence Mismatch [%"APR_SIZE_T_FMT"]",i);
+			return FALSE;
+		}
+
+		if(!stream_interpretation->instance_count ||
+			nlsml_stream_text_get(&stream_interpretation->instances[0],&text,suite->pool) == FALSE ||
+			text.length != strlen(instances[i]) || memcmp(text.buf,instances[i],text.length) != 0) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Instance Mismatch [%"APR_SIZE_T_FMT"]",i);
+			return FALSE;
+		}
+
+		input = nlsml_interpretation_input_get(interpretation);
+		if(!input != !stream_interpretation->input ||
+			(input && stream_interpretation->input->confidence != nlsml_input_confidence_get(input))) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Input Mismatch [%"APR_SIZE_T_FMT"]",i);
+			return FALSE;
+		}
+	}
+
+	if(i != result->interpretation_count) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Interpretation Count Mismatch [%"APR_SIZE_T_FMT"]",result->interpretation_count);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* Compose a result by the writer and parse it back */
+static apt_bool_t nlsml_writer_test(apt_test_suite_t *suite)
+{
+	nlsml_writer_t *writer = nlsml_writer_create(64,suite->pool);
+	apt_str_t document;
+	apt_str_t content;
+
+	nlsml_writer_result_begin(writer,NULL);
+	apt_string_set(&content,"Boston & Denver");
+	nlsml_writer_interpretation_begin(writer,"session:request1@form-level.store",0.85f);
+	nlsml_writer_instance_add(writer,&content,TRUE);
+	apt_string_set(&content,"from boston to denver");
+	nlsml_writer_input_add(writer,"speech",0.9f,&content);
+	nlsml_writer_interpretation_end(writer);
+	if(nlsml_writer_result_end(writer,&document) == FALSE) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Composed NLSML Result [%"APR_SIZE_T_FMT" bytes]\n%.*s",
+		document.length,
+		(int)document.length,
+		document.buf);
+	return nlsml_stream_parse_test(suite,document.buf,document.length,writer_instances);
+}
+
+static apt_bool_t nlsml_test_run(apt_test_suite_t *suite, int argc, const char * const *argv)
+{
+	/* a truncated document must be rejected */
+	if(nlsml_stream_result_parse(sample_result,sizeof(sample_result) / 2,suite->pool) != NULL) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Truncated NLSML Result Accepted");
+		return FALSE;
+	}
+
+	if(nlsml_stream_parse_test(suite,sample_result,sizeof(sample_result) - 1,sample_instances) == FALSE) {
+		return FALSE;
+	}
+	return nlsml_writer_test(suite);
+}
+
+apt_test_suite_t* nlsml_test_suite_create(apr_pool_t *pool)
+{
+	apt_test_suite_t *suite = apt_test_suite_create(pool,"nlsml",NULL,nlsml_test_run);
+	return suite;
+}
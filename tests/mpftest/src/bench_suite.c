@@ -0,0 +1,292 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include "apt_test_suite.h"
+#include "apt_log.h"
+#include "mpf_engine.h"
+#include "mpf_context.h"
+#include "mpf_codec_manager.h"
+#include "mpf_jitter_buffer.h"
+#include "mpf_rtp_stream.h"
+
+/** Number of samples in a frame (20 msec at 8 kHz) */
+#define SAMPLE_COUNT 160
+
+/** Codec benchmark object */
+typedef struct {
+	mpf_codec_t      *codec;
+	mpf_codec_frame_t frame_in;
+	mpf_codec_frame_t frame_out;
+} codec_bench_t;
+
+/** Jitter buffer benchmark object */
+typedef struct {
+	mpf_jitter_buffer_t *jb;
+	apr_byte_t          *data;
+	apr_size_t           size;
+	apr_uint32_t         ts;
+	mpf_frame_t          frame;
+} jb_bench_t;
+
+/** Media context benchmark object */
+typedef struct {
+	mpf_context_factory_t *factory;
+} context_bench_t;
+
+/** RTP transmitter benchmark object */
+typedef struct {
+	mpf_audio_stream_t *stream;
+	mpf_frame_t         frame;
+} rtp_tx_bench_t;
+
+
+static apt_bool_t codec_encode_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	codec_bench_t *codec_bench = bench->obj;
+	return mpf_codec_encode(codec_bench->codec,&codec_bench->frame_in,&codec_bench->frame_out);
+}
+
+static apt_bool_t codec_decode_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	codec_bench_t *codec_bench = bench->obj;
+	return mpf_codec_decode(codec_bench->codec,&codec_bench->frame_in,&codec_bench->frame_out);
+}
+
+/* Write a frame to and read a frame from the jitter buffer at the steady playout delay */
+static apt_bool_t jb_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	jb_bench_t *jb_bench = bench->obj;
+	if(mpf_jitter_buffer_write(jb_bench->jb,jb_bench->data,jb_bench->size,jb_bench->ts,0) != JB_OK) {
+		return FALSE;
+	}
+	jb_bench->ts += (apr_uint32_t)jb_bench->size;
+	return mpf_jitter_buffer_read(jb_bench->jb,&jb_bench->frame);
+}
+
+/* Write a frame to the RTP stream, which sends a packet every ptime */
+static apt_bool_t rtp_tx_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	rtp_tx_bench_t *rtp_tx_bench = bench->obj;
+	mpf_audio_stream_frame_write(rtp_tx_bench->stream,&rtp_tx_bench->frame);
+	return TRUE;
+}
+
+/* Create and release a media context, as done once per session */
+static apt_bool_t context_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	context_bench_t *context_bench = bench->obj;
+	mpf_context_t *context = mpf_context_create(context_bench->factory,"bench",NULL,5,pool);
+	return mpf_context_release(context);
+}
+
+static mpf_codec_descriptor_t* bench_descriptor_create(apr_byte_t payload_type, const char *name, apr_pool_t *pool)
+{
+	mpf_codec_descriptor_t *descriptor = mpf_codec_descriptor_create(pool);
+	descriptor->payload_type = payload_type;
+	apt_string_set(&descriptor->name,name);
+	descriptor->sampling_rate = 8000;
+	descriptor->channel_count = 1;
+	return descriptor;
+}
+
+static apt_benchmark_t* codec_bench_create(mpf_codec_manager_t *codec_manager, apr_byte_t payload_type, const char *codec_name, apt_bool_t encode, apr_pool_t *pool)
+{
+	codec_bench_t *codec_bench;
+	apr_size_t linear_size = SAMPLE_COUNT * sizeof(apr_int16_t);
+	apr_int16_t *samples;
+	apr_size_t i;
+	mpf_codec_frame_t linear_frame;
+	mpf_codec_descriptor_t *descriptor = bench_descriptor_create(payload_type,codec_name,pool);
+	mpf_codec_t *codec = mpf_codec_manager_codec_get(codec_manager,descriptor,pool);
+	if(!codec) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"No Such Codec [%s]",codec_name);
+		return NULL;
+	}
+
+	codec_bench = apr_palloc(pool,sizeof(codec_bench_t));
+	codec_bench->codec = codec;
+	mpf_codec_open(codec);
+
+	/* a sawtooth covers the whole range of segments of the companding */
+	samples = apr_palloc(pool,linear_size);
+	for(i = 0; i < SAMPLE_COUNT; i++) {
+		samples[i] = (apr_int16_t)((int)(i * 409 % 65536) - 32768);
+	}
+	linear_frame.buffer = samples;
+	linear_frame.size = linear_size;
+
+	codec_bench->frame_out.buffer = apr_palloc(pool,SAMPLE_COUNT);
+	codec_bench->frame_out.size = SAMPLE_COUNT;
+	if(encode == TRUE) {
+		codec_bench->frame_in = linear_frame;
+	}
+	else {
+		/* decode the encoded samples back into the linear buffer */
+		mpf_codec_encode(codec,&linear_frame,&codec_bench->frame_out);
+		codec_bench->frame_in = codec_bench->frame_out;
+		codec_bench->frame_out = linear_frame;
+	}
+
+	return apt_benchmark_create(pool,
+		apr_psprintf(pool,"%s-%s",codec_name,encode == TRUE ? "encode" : "decode"),
+		codec_bench,
+		encode == TRUE ? codec_encode_bench_run : codec_decode_bench_run);
+}
+
+static apt_benchmark_t* jb_bench_create(mpf_codec_manager_t *codec_manager, apr_pool_t *pool)
+{
+	jb_bench_t *jb_bench;
+	mpf_jb_config_t *jb_config;
+	mpf_codec_descriptor_t *descriptor = bench_descriptor_create(0,"PCMU",pool);
+	mpf_codec_t *codec = mpf_codec_manager_codec_get(codec_manager,descriptor,pool);
+	if(!codec) {
+		return NULL;
+	}
+
+	jb_config = apr_palloc(pool,sizeof(mpf_jb_config_t));
+	jb_config->min_playout_delay = 20;
+	jb_config->initial_playout_delay = 50;
+	jb_config->max_playout_delay = 200;
+	jb_config->adaptive = 0;
+	jb_config->time_skew_detection = 0;
+
+	jb_bench = apr_palloc(pool,sizeof(jb_bench_t));
+	jb_bench->jb = mpf_jitter_buffer_create(jb_config,descriptor,codec,pool);
+	/* write and read 10 msec frames, which is the time base of the jitter buffer */
+	jb_bench->size = mpf_codec_frame_size_calculate(descriptor,codec->attribs);
+	jb_bench->data = apr_palloc(pool,jb_bench->size);
+	memset(jb_bench->data,0xFF,jb_bench->size);
+	jb_bench->ts = 0;
+	jb_bench->frame.type = MEDIA_FRAME_TYPE_NONE;
+	jb_bench->frame.marker = MPF_MARKER_NONE;
+	jb_bench->frame.codec_frame.buffer = apr_palloc(pool,jb_bench->size);
+	jb_bench->frame.codec_frame.size = jb_bench->size;
+	return apt_benchmark_create(pool,"jitter-buffer",jb_bench,jb_bench_run);
+}
+
+static apt_benchmark_t* rtp_tx_bench_create(mpf_codec_manager_t *codec_manager, apr_uint16_t ptime, apr_pool_t *pool)
+{
+	rtp_tx_bench_t *rtp_tx_bench;
+	mpf_rtp_config_t *rtp_config;
+	mpf_rtp_settings_t *rtp_settings;
+	mpf_rtp_stream_descriptor_t descriptor;
+	mpf_rtp_media_descriptor_t *remote_media;
+	mpf_codec_descriptor_t *codec_descriptor;
+	mpf_audio_stream_t *stream;
+	apr_size_t frame_size;
+	mpf_codec_descriptor_t *descriptor1 = bench_descriptor_create(0,"PCMU",pool);
+	mpf_codec_t *codec = mpf_codec_manager_codec_get(codec_manager,descriptor1,pool);
+	if(!codec) {
+		return NULL;
+	}
+
+	rtp_config = mpf_rtp_config_alloc(pool);
+	apt_string_set(&rtp_config->ip,"127.0.0.1");
+	rtp_config->rtp_port_min = 41000;
+	rtp_config->rtp_port_max = 42000;
+	rtp_config->rtp_port_cur = rtp_config->rtp_port_min;
+
+	rtp_settings = mpf_rtp_settings_alloc(pool);
+	rtp_settings->ptime = ptime;
+	codec_descriptor = mpf_codec_list_add(&rtp_settings->codec_list);
+	*codec_descriptor = *descriptor1;
+
+	stream = mpf_rtp_stream_create(NULL,rtp_config,rtp_settings,pool);
+	if(!stream) {
+		return NULL;
+	}
+
+	/* create the local media first, then loop the packets back to the local port */
+	mpf_rtp_stream_descriptor_init(&descriptor);
+	if(mpf_rtp_stream_modify(stream,&descriptor) == FALSE) {
+		return NULL;
+	}
+
+	remote_media = apr_palloc(pool,sizeof(mpf_rtp_media_descriptor_t));
+	mpf_rtp_media_descriptor_init(remote_media);
+	remote_media->state = MPF_MEDIA_ENABLED;
+	remote_media->direction = STREAM_DIRECTION_RECEIVE;
+	apt_string_set(&remote_media->ip,"127.0.0.1");
+	remote_media->port = rtp_config->rtp_port_cur - 2;
+	remote_media->ptime = ptime;
+	mpf_codec_list_init(&remote_media->codec_list,1,pool);
+	codec_descriptor = mpf_codec_list_add(&remote_media->codec_list);
+	*codec_descriptor = *descriptor1;
+	descriptor.remote = remote_media;
+	if(mpf_rtp_stream_modify(stream,&descriptor) == FALSE || !stream->tx_descriptor) {
+		return NULL;
+	}
+
+	if(mpf_audio_stream_tx_open(stream,codec) == FALSE) {
+		return NULL;
+	}
+
+	rtp_tx_bench = apr_palloc(pool,sizeof(rtp_tx_bench_t));
+	rtp_tx_bench->stream = stream;
+	frame_size = mpf_codec_frame_size_calculate(descriptor1,codec->attribs);
+	rtp_tx_bench->frame.type = MEDIA_FRAME_TYPE_AUDIO;
+	rtp_tx_bench->frame.marker = MPF_MARKER_NONE;
+	rtp_tx_bench->frame.codec_frame.buffer = apr_palloc(pool,frame_size);
+	rtp_tx_bench->frame.codec_frame.size = frame_size;
+	memset(rtp_tx_bench->frame.codec_frame.buffer,0xFF,frame_size);
+	return apt_benchmark_create(pool,
+		apr_psprintf(pool,"rtp-transmit-%hums",ptime),
+		rtp_tx_bench,
+		rtp_tx_bench_run);
+}
+
+static apt_benchmark_t* context_bench_create(apr_size_t max_context_count, apr_pool_t *pool)
+{
+	context_bench_t *context_bench = apr_palloc(pool,sizeof(context_bench_t));
+	context_bench->factory = mpf_context_factory_create(pool);
+	if(max_context_count) {
+		mpf_context_factory_slab_set(context_bench->factory,max_context_count,pool);
+	}
+	return apt_benchmark_create(pool,
+		max_context_count ? "context-create-slab" : "context-create-pool",
+		context_bench,
+		context_bench_run);
+}
+
+static void mpf_benchmark_add(apt_test_framework_t *framework, apt_benchmark_t *bench)
+{
+	if(bench) {
+		apt_test_framework_benchmark_add(framework,bench);
+	}
+}
+
+apt_bool_t mpf_benchmarks_add(apt_test_framework_t *framework)
+{
+	apr_pool_t *pool = apt_test_framework_pool_get(framework);
+	mpf_codec_manager_t *codec_manager = mpf_engine_codec_manager_create(pool);
+	if(!codec_manager) {
+		return FALSE;
+	}
+
+	mpf_benchmark_add(framework,codec_bench_create(codec_manager,0,"PCMU",TRUE,pool));
+	mpf_benchmark_add(framework,codec_bench_create(codec_manager,0,"PCMU",FALSE,pool));
+	mpf_benchmark_add(framework,codec_bench_create(codec_manager,8,"PCMA",TRUE,pool));
+	mpf_benchmark_add(framework,codec_bench_create(codec_manager,8,"PCMA",FALSE,pool));
+	mpf_benchmark_add(framework,jb_bench_create(codec_manager,pool));
+	mpf_benchmark_add(framework,rtp_tx_bench_create(codec_manager,20,pool));
+	mpf_benchmark_add(framework,rtp_tx_bench_create(codec_manager,30,pool));
+	mpf_benchmark_add(framework,rtp_tx_bench_create(codec_manager,60,pool));
+	mpf_benchmark_add(framework,context_bench_create(0,pool));
+	mpf_benchmark_add(framework,context_bench_create(100,pool));
+	return TRUE;
+}
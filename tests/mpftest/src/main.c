@@ -20,6 +20,8 @@
 #include "apt_log.h"
 
 apt_test_suite_t* mpf_suite_create(apr_pool_t *pool);
+apt_test_suite_t* slab_suite_create(apr_pool_t *pool);
+apt_bool_t mpf_benchmarks_add(apt_test_framework_t *framework);
 
 int main(int argc, const char * const *argv)
 {
@@ -39,6 +41,11 @@ int main(int argc, const char * const *argv)
 	/* create test suites and add them to test framework */
 	test_suite = mpf_suite_create(pool);
 	apt_test_framework_suite_add(test_framework,test_suite);
+	test_suite = slab_suite_create(pool);
+	apt_test_framework_suite_add(test_framework,test_suite);
+
+	/* add benchmarks to test framework */
+	mpf_benchmarks_add(test_framework);
 
 	/* run tests */
 	apt_test_framework_run(test_framework,argc,argv);
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include "apt_test_suite.h"
+#include "apt_log.h"
+#include "mpf_slab.h"
+
+/* number of blocks of the test slab */
+#define TEST_BLOCK_COUNT 4
+/* size of each block of the test slab */
+#define TEST_BLOCK_SIZE  100
+
+/* Test the number of blocks in use */
+static apt_bool_t used_count_test(mpf_slab_t *slab, apr_size_t expected)
+{
+	apr_size_t used_count = mpf_slab_used_count_get(slab);
+	if(used_count != expected) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Number of Blocks in Use: %"APR_SIZE_T_FMT" (expected %"APR_SIZE_T_FMT")",
+			used_count,
+			expected);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* Test whether the memory is a block of the slab */
+static apt_bool_t block_test(const void *block, const void *first_block)
+{
+	apr_size_t offset;
+	if(!block || (const char*)block < (const char*)first_block) {
+		return FALSE;
+	}
+	offset = (const char*)block - (const char*)first_block;
+	if(offset % MPF_SLAB_ALIGN(TEST_BLOCK_SIZE) != 0 || offset / MPF_SLAB_ALIGN(TEST_BLOCK_SIZE) >= TEST_BLOCK_COUNT) {
+		return FALSE;
+	}
+	return ((apr_size_t)block % MPF_SLAB_ALIGNMENT == 0) ? TRUE : FALSE;
+}
+
+static apt_bool_t lifo_test(mpf_slab_t *slab)
+{
+	void *blocks[TEST_BLOCK_COUNT];
+	void *block;
+	apr_size_t i;
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Test LIFO Order");
+	for(i=0; i<TEST_BLOCK_COUNT; i++) {
+		blocks[i] = mpf_slab_block_take(slab,TEST_BLOCK_SIZE);
+		if(!block_test(blocks[i],blocks[0])) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Block [%"APR_SIZE_T_FMT"]",i);
+			return FALSE;
+		}
+	}
+	if(used_count_test(slab,TEST_BLOCK_COUNT) != TRUE) {
+		return FALSE;
+	}
+
+	/* the block released last is taken first */
+	mpf_slab_block_release(slab,blocks[1]);
+	mpf_slab_block_release(slab,blocks[2]);
+	block = mpf_slab_block_take(slab,TEST_BLOCK_SIZE);
+	if(block != blocks[2]) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Block Released Last Not Taken First");
+		return FALSE;
+	}
+	block = mpf_slab_block_take(slab,TEST_BLOCK_SIZE);
+	if(block != blocks[1]) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Block Released First Not Taken Last");
+		return FALSE;
+	}
+
+	for(i=TEST_BLOCK_COUNT; i>0; i--) {
+		if(mpf_slab_block_release(slab,blocks[i-1]) != TRUE) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Release Block [%"APR_SIZE_T_FMT"]",i-1);
+			return FALSE;
+		}
+	}
+	return used_count_test(slab,0);
+}
+
+static apt_bool_t exhaustion_test(mpf_slab_t *slab, apr_pool_t *pool)
+{
+	void *blocks[TEST_BLOCK_COUNT];
+	void *mem;
+	apr_size_t i;
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Test Exhaustion");
+	for(i=0; i<TEST_BLOCK_COUNT; i++) {
+		blocks[i] = mpf_slab_palloc(slab,TEST_BLOCK_SIZE,pool);
+	}
+	if(used_count_test(slab,TEST_BLOCK_COUNT) != TRUE) {
+		return FALSE;
+	}
+
+	/* no block is left, the memory is allocated from the pool */
+	if(mpf_slab_block_take(slab,TEST_BLOCK_SIZE) != NULL) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Block Taken from Exhausted Slab");
+		return FALSE;
+	}
+	mem = mpf_slab_palloc(slab,TEST_BLOCK_SIZE,pool);
+	if(!mem || block_test(mem,blocks[0]) == TRUE || used_count_test(slab,TEST_BLOCK_COUNT) != TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Memory Not Allocated from Pool");
+		return FALSE;
+	}
+
+	/* the memory allocated from the pool is ignored */
+	if(mpf_slab_block_release(slab,mem) != FALSE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Pool Memory Released to Slab");
+		return FALSE;
+	}
+	mpf_slab_pfree(slab,mem);
+	if(used_count_test(slab,TEST_BLOCK_COUNT) != TRUE ||
+		mpf_slab_block_take(slab,TEST_BLOCK_SIZE) != NULL) {
+		return FALSE;
+	}
+
+	for(i=0; i<TEST_BLOCK_COUNT; i++) {
+		mpf_slab_pfree(slab,blocks[i]);
+	}
+	return used_count_test(slab,0);
+}
+
+static apt_bool_t oversize_test(mpf_slab_t *slab, apr_pool_t *pool)
+{
+	void *mem;
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Test Size Exceeding Block Size");
+	if(mpf_slab_block_take(slab,MPF_SLAB_ALIGN(TEST_BLOCK_SIZE) + 1) != NULL) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Block Taken for Exceeding Size");
+		return FALSE;
+	}
+	mem = mpf_slab_palloc(slab,MPF_SLAB_ALIGN(TEST_BLOCK_SIZE) + 1,pool);
+	if(!mem || used_count_test(slab,0) != TRUE) {
+		return FALSE;
+	}
+	mpf_slab_pfree(slab,mem);
+	return used_count_test(slab,0);
+}
+
+static apt_bool_t slab_test_run(apt_test_suite_t *suite, int argc, const char * const *argv)
+{
+	apt_bool_t status;
+	mpf_slab_t *slab = mpf_slab_create(TEST_BLOCK_SIZE,TEST_BLOCK_COUNT,suite->pool);
+	if(!slab) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Slab");
+		return FALSE;
+	}
+
+	status = lifo_test(slab) &&
+		exhaustion_test(slab,suite->pool) &&
+		oversize_test(slab,suite->pool);
+
+	mpf_slab_destroy(slab);
+	return status;
+}
+
+/** Create slab test suite */
+apt_test_suite_t* slab_suite_create(apr_pool_t *pool)
+{
+	apt_test_suite_t *suite = apt_test_suite_create(pool,"slab",NULL,slab_test_run);
+	return suite;
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include <string.h>
+#include "apt_test_suite.h"
+#include "apt_log.h"
+#include "mrcp_audio_batcher.h"
+
+#define TEST_CHANNEL_COUNT 2
+#define TEST_FRAME_SIZE    4
+#define TEST_FRAME_COUNT   2
+
+/** Collector of processed batches */
+typedef struct {
+	apr_size_t             batch_count;
+	apr_size_t             channel_count;
+	mrcp_engine_channel_t *channels[TEST_CHANNEL_COUNT];
+	char                   data[TEST_CHANNEL_COUNT * TEST_FRAME_SIZE * TEST_FRAME_COUNT];
+} batch_collector_t;
+
+static apt_bool_t batch_collect(void *obj, const mrcp_audio_batch_t *batch)
+{
+	batch_collector_t *collector = obj;
+	apr_size_t i;
+	collector->batch_count++;
+	collector->channel_count = batch->count;
+	for(i=0; i<batch->count; i++) {
+		collector->channels[i] = batch->channels[i];
+	}
+	memcpy(collector->data,batch->data,batch->count * batch->stride);
+	return TRUE;
+}
+
+/* Write audio frame filled with the specified value */
+static apt_bool_t frame_write(mrcp_audio_batcher_t *batcher, apr_size_t slot, char value)
+{
+	char buffer[TEST_FRAME_SIZE];
+	mpf_frame_t frame;
+	memset(buffer,value,sizeof(buffer));
+	frame.type = MEDIA_FRAME_TYPE_AUDIO;
+	frame.marker = MPF_MARKER_NONE;
+	frame.codec_frame.buffer = buffer;
+	frame.codec_frame.size = sizeof(buffer);
+	return mrcp_audio_batcher_frame_write(batcher,slot,&frame);
+}
+
+/* Test the frames of the channel delivered in the last batch */
+static apt_bool_t batch_data_test(const batch_collector_t *collector, apr_size_t index, char first, char second)
+{
+	const char *data = collector->data + index * TEST_FRAME_SIZE * TEST_FRAME_COUNT;
+	if(data[0] != first || data[TEST_FRAME_SIZE - 1] != first ||
+		data[TEST_FRAME_SIZE] != second || data[2 * TEST_FRAME_SIZE - 1] != second) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Batch Data [%"APR_SIZE_T_FMT"]",index);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static apt_bool_t audio_batcher_test_run(apt_test_suite_t *suite, mrcp_audio_batcher_t *batcher, batch_collector_t *collector)
+{
+	mrcp_engine_channel_t *channels[TEST_CHANNEL_COUNT + 1];
+	apr_size_t slots[TEST_CHANNEL_COUNT + 1];
+	apr_size_t i;
+
+	for(i=0; i<TEST_CHANNEL_COUNT + 1; i++) {
+		channels[i] = apr_pcalloc(suite->pool,sizeof(mrcp_engine_channel_t));
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Add Channels");
+	slots[0] = mrcp_audio_batcher_channel_add(batcher,channels[0]);
+	slots[1] = mrcp_audio_batcher_channel_add(batcher,channels[1]);
+	if(slots[0] == MRCP_AUDIO_BATCHER_INVALID_SLOT || slots[1] == MRCP_AUDIO_BATCHER_INVALID_SLOT || slots[0] == slots[1]) {
+		return FALSE;
+	}
+	/* all the slots are in use */
+	if(mrcp_audio_batcher_channel_add(batcher,channels[2]) != MRCP_AUDIO_BATCHER_INVALID_SLOT) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Flush Incomplete Frames");
+	if(frame_write(batcher,slots[0],'a') != TRUE || mrcp_audio_batcher_flush(batcher) != 0 || collector->batch_count != 0) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Flush Complete Frames");
+	if(frame_write(batcher,slots[0],'b') != TRUE ||
+		frame_write(batcher,slots[1],'c') != TRUE ||
+		frame_write(batcher,slots[1],'d') != TRUE) {
+		return FALSE;
+	}
+	if(mrcp_audio_batcher_flush(batcher) != 2 || collector->batch_count != 1 || collector->channel_count != 2) {
+		return FALSE;
+	}
+	if(collector->channels[0] != channels[0] || collector->channels[1] != channels[1]) {
+		return FALSE;
+	}
+	if(batch_data_test(collector,0,'a','b') != TRUE || batch_data_test(collector,1,'c','d') != TRUE) {
+		return FALSE;
+	}
+	/* delivered frames are consumed */
+	if(mrcp_audio_batcher_flush(batcher) != 0) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Remove Channel");
+	if(frame_write(batcher,slots[1],'e') != TRUE || mrcp_audio_batcher_channel_remove(batcher,slots[1]) != TRUE) {
+		return FALSE;
+	}
+	/* frames are neither accepted nor delivered for the removed channel */
+	if(frame_write(batcher,slots[1],'f') != FALSE) {
+		return FALSE;
+	}
+	if(frame_write(batcher,slots[0],'g') != TRUE || frame_write(batcher,slots[0],'h') != TRUE) {
+		return FALSE;
+	}
+	if(mrcp_audio_batcher_flush(batcher) != 1 || collector->channels[0] != channels[0] || batch_data_test(collector,0,'g','h') != TRUE) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Reuse Slot of Removed Channel");
+	slots[2] = mrcp_audio_batcher_channel_add(batcher,channels[2]);
+	if(slots[2] != slots[1]) {
+		return FALSE;
+	}
+	/* discarded frames of the removed channel must not leak into the new one */
+	if(frame_write(batcher,slots[2],'i') != TRUE || frame_write(batcher,slots[2],'j') != TRUE) {
+		return FALSE;
+	}
+	if(mrcp_audio_batcher_flush(batcher) != 1 || collector->channels[0] != channels[2] || batch_data_test(collector,0,'i','j') != TRUE) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Overrun Ring");
+	for(i=0; frame_write(batcher,slots[0],'k') == TRUE; i++);
+	if(i == 0 || mrcp_audio_batcher_overrun_count_get(batcher) != 1) {
+		return FALSE;
+	}
+	/* the full ring is drained batch by batch */
+	while(mrcp_audio_batcher_flush(batcher) == 1) {
+		i -= TEST_FRAME_COUNT;
+	}
+	if(i != 0) {
+		return FALSE;
+	}
+
+	mrcp_audio_batcher_channel_remove(batcher,slots[0]);
+	mrcp_audio_batcher_channel_remove(batcher,slots[2]);
+	return TRUE;
+}
+
+static apt_bool_t audio_batcher_test_suite_run(apt_test_suite_t *suite, int argc, const char * const *argv)
+{
+	apt_bool_t status;
+	mrcp_audio_batcher_t *batcher;
+	batch_collector_t *collector = apr_pcalloc(suite->pool,sizeof(batch_collector_t));
+
+	batcher = mrcp_audio_batcher_create(
+				TEST_CHANNEL_COUNT,
+				TEST_FRAME_SIZE,
+				TEST_FRAME_COUNT,
+				0,
+				collector,
+				batch_collect,
+				"Audio Batcher Test",
+				suite->pool);
+	if(!batcher) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Audio Batcher");
+		return FALSE;
+	}
+
+	/* the batcher is not started, batches are delivered by explicit flushes */
+	status = audio_batcher_test_run(suite,batcher,collector);
+
+	mrcp_audio_batcher_destroy(batcher);
+	return status;
+}
+
+apt_test_suite_t* audio_batcher_test_suite_create(apr_pool_t *pool)
+{
+	apt_test_suite_t *suite = apt_test_suite_create(pool,"audio-batcher",NULL,audio_batcher_test_suite_run);
+	return suite;
+}
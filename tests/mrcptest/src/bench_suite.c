@@ -0,0 +1,151 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include "apt_test_suite.h"
+#include "apt_log.h"
+/* common includes */
+#include "mrcp_resource_loader.h"
+#include "mrcp_resource_factory.h"
+#include "mrcp_message.h"
+#include "mrcp_stream.h"
+#include "mrcp_generic_header.h"
+/* synthesizer includes */
+#include "mrcp_synth_header.h"
+#include "mrcp_synth_resource.h"
+
+#define SAMPLE_VOICE_AGE 28
+#define SAMPLE_CONTENT_TYPE "application/synthesis+ssml"
+#define SAMPLE_CONTENT "SSML content goes here"
+
+#define MESSAGE_BUFFER_SIZE 1024
+
+/** MRCP message benchmark object */
+typedef struct {
+	mrcp_resource_factory_t *factory;
+	mrcp_generator_t        *generator;
+	mrcp_message_t          *message;
+	char                     buffer[MESSAGE_BUFFER_SIZE];
+	apt_str_t                text;
+} message_bench_t;
+
+
+/* Create SPEAK request */
+static mrcp_message_t* speak_request_create(mrcp_resource_factory_t *factory, apr_pool_t *pool)
+{
+	mrcp_message_t *message;
+	mrcp_generic_header_t *generic_header;
+	mrcp_synth_header_t *synth_header;
+	mrcp_resource_t *resource = mrcp_resource_get(factory,MRCP_SYNTHESIZER_RESOURCE);
+	if(!resource) {
+		return NULL;
+	}
+	message = mrcp_request_create(resource,MRCP_VERSION_2,SYNTHESIZER_SPEAK,pool);
+	if(!message) {
+		return NULL;
+	}
+	apt_string_assign(&message->channel_id.session_id,"32AECB23433802",message->pool);
+	message->start_line.request_id = 543257;
+
+	generic_header = mrcp_generic_header_prepare(message);
+	if(generic_header) {
+		apt_string_assign(&generic_header->content_type,SAMPLE_CONTENT_TYPE,message->pool);
+		mrcp_generic_header_property_add(message,GENERIC_HEADER_CONTENT_TYPE);
+	}
+	synth_header = mrcp_resource_header_prepare(message);
+	if(synth_header) {
+		synth_header->voice_param.age = SAMPLE_VOICE_AGE;
+		mrcp_resource_header_property_add(message,SYNTHESIZER_HEADER_VOICE_AGE);
+	}
+	apt_string_assign(&message->body,SAMPLE_CONTENT,message->pool);
+	return message;
+}
+
+/* Generate the message into the specified buffer, the generated text may start past the beginning of the buffer */
+static apt_bool_t message_generate(mrcp_generator_t *generator, mrcp_message_t *message, char *buffer, apt_str_t *text)
+{
+	apt_text_stream_t stream;
+	apt_text_stream_init(&stream,buffer,MESSAGE_BUFFER_SIZE);
+	if(mrcp_generator_run(generator,message,&stream) != APT_MESSAGE_STATUS_COMPLETE) {
+		return FALSE;
+	}
+	text->buf = stream.text.buf;
+	text->length = stream.pos - stream.text.buf;
+	return TRUE;
+}
+
+/* Parse the sample message by a parser created on the iteration pool */
+static apt_bool_t message_parse_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	message_bench_t *message_bench = bench->obj;
+	mrcp_message_t *message = NULL;
+	apt_text_stream_t stream;
+	mrcp_parser_t *parser = mrcp_parser_create(message_bench->factory,pool);
+
+	apt_text_stream_init(&stream,message_bench->text.buf,message_bench->text.length);
+	if(mrcp_parser_run(parser,&stream,&message) != APT_MESSAGE_STATUS_COMPLETE) {
+		return FALSE;
+	}
+	return message ? TRUE : FALSE;
+}
+
+/* Generate the sample message into a stack buffer */
+static apt_bool_t message_generate_bench_run(apt_benchmark_t *bench, apr_pool_t *pool)
+{
+	message_bench_t *message_bench = bench->obj;
+	char buffer[MESSAGE_BUFFER_SIZE];
+	apt_str_t text;
+	return message_generate(message_bench->generator,message_bench->message,buffer,&text);
+}
+
+static message_bench_t* message_bench_create(apr_pool_t *pool)
+{
+	message_bench_t *message_bench;
+	mrcp_resource_loader_t *resource_loader = mrcp_resource_loader_create(TRUE,pool);
+	if(!resource_loader) {
+		return NULL;
+	}
+
+	message_bench = apr_palloc(pool,sizeof(message_bench_t));
+	message_bench->factory = mrcp_resource_factory_get(resource_loader);
+	message_bench->generator = mrcp_generator_create(message_bench->factory,pool);
+	message_bench->message = speak_request_create(message_bench->factory,pool);
+	if(!message_bench->message) {
+		return NULL;
+	}
+	if(message_generate(
+			message_bench->generator,
+			message_bench->message,
+			message_bench->buffer,
+			&message_bench->text) == FALSE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Generate Sample Message");
+		return NULL;
+	}
+	return message_bench;
+}
+
+apt_bool_t mrcp_benchmarks_add(apt_test_framework_t *framework)
+{
+	apr_pool_t *pool = apt_test_framework_pool_get(framework);
+	message_bench_t *message_bench = message_bench_create(pool);
+	if(!message_bench) {
+		return FALSE;
+	}
+	apt_test_framework_benchmark_add(framework,apt_benchmark_create(pool,"mrcp-parse",message_bench,message_parse_bench_run));
+	apt_test_framework_benchmark_add(framework,apt_benchmark_create(pool,"mrcp-generate",message_bench,message_generate_bench_run));
+	return TRUE;
+}
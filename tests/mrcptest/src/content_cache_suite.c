@@ -0,0 +1,232 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include <string.h>
+#include "apt_test_suite.h"
+#include "apt_log.h"
+#include "mrcp_content_cache.h"
+
+/* size of the object accounted for each entry, which dominates the size of the entry */
+#define TEST_OBJECT_SIZE 1000
+/* max size of the cache, which holds two entries but not three */
+#define TEST_CACHE_SIZE  2500
+#define TEST_OBJECT_COUNT 4
+
+/** Object associated with cached content, counting its destructions */
+typedef struct {
+	apr_size_t destroy_count;
+} cached_object_t;
+
+static void cached_object_destroy(void *obj)
+{
+	cached_object_t *object = obj;
+	object->destroy_count++;
+}
+
+/* Add content with the specified body to the cache */
+static mrcp_content_entry_t* content_add(mrcp_content_cache_t *cache, const char *body, cached_object_t *object, apr_size_t object_size)
+{
+	apt_str_t content_type;
+	apt_str_t content_body;
+	apt_string_set(&content_type,"application/srgs+xml");
+	apt_string_set(&content_body,body);
+	return mrcp_content_cache_add(cache,&content_type,NULL,&content_body,object,object_size,cached_object_destroy);
+}
+
+/* Find content with the specified body in the cache */
+static mrcp_content_entry_t* content_find(mrcp_content_cache_t *cache, const char *body)
+{
+	apt_str_t content_type;
+	apt_str_t content_body;
+	apt_string_set(&content_type,"application/srgs+xml");
+	apt_string_set(&content_body,body);
+	return mrcp_content_cache_find(cache,&content_type,NULL,&content_body);
+}
+
+/* Test whether the content is cached, releasing the found entry */
+static apt_bool_t content_cached_test(mrcp_content_cache_t *cache, const char *body, apt_bool_t expected)
+{
+	mrcp_content_entry_t *entry = content_find(cache,body);
+	if(entry) {
+		mrcp_content_cache_release(cache,entry);
+	}
+	if((entry ? TRUE : FALSE) != expected) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Content [%s] Unexpectedly %s",body,entry ? "Cached" : "Not Cached");
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* Test the number of destructions of the object */
+static apt_bool_t destroy_count_test(const cached_object_t *object, apr_size_t expected)
+{
+	if(object->destroy_count != expected) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Number of Destructions: %"APR_SIZE_T_FMT" (expected %"APR_SIZE_T_FMT")",
+			object->destroy_count,
+			expected);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static apt_bool_t lru_eviction_test(mrcp_content_cache_t *cache, cached_object_t *objects)
+{
+	mrcp_content_cache_stats_t stats;
+	mrcp_content_entry_t *entry;
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Test LRU Eviction");
+	entry = content_add(cache,"grammar-a",&objects[0],TEST_OBJECT_SIZE);
+	if(!entry) {
+		return FALSE;
+	}
+	mrcp_content_cache_release(cache,entry);
+	entry = content_add(cache,"grammar-b",&objects[1],TEST_OBJECT_SIZE);
+	if(!entry) {
+		return FALSE;
+	}
+	mrcp_content_cache_release(cache,entry);
+
+	/* use the first entry, so that the second one becomes the least recently used */
+	if(content_cached_test(cache,"grammar-a",TRUE) != TRUE) {
+		return FALSE;
+	}
+
+	entry = content_add(cache,"grammar-c",&objects[2],TEST_OBJECT_SIZE);
+	if(!entry) {
+		return FALSE;
+	}
+	mrcp_content_cache_release(cache,entry);
+
+	if(content_cached_test(cache,"grammar-b",FALSE) != TRUE ||
+		content_cached_test(cache,"grammar-a",TRUE) != TRUE ||
+		content_cached_test(cache,"grammar-c",TRUE) != TRUE) {
+		return FALSE;
+	}
+	if(destroy_count_test(&objects[0],0) != TRUE ||
+		destroy_count_test(&objects[1],1) != TRUE ||
+		destroy_count_test(&objects[2],0) != TRUE) {
+		return FALSE;
+	}
+
+	mrcp_content_cache_stats_get(cache,&stats);
+	if(stats.entry_count != 2 || stats.evictions != 1) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Stats [%"APR_SIZE_T_FMT" entries %"APR_SIZE_T_FMT" evictions]",
+			stats.entry_count,
+			stats.evictions);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static apt_bool_t size_cap_test(mrcp_content_cache_t *cache, cached_object_t *objects)
+{
+	mrcp_content_cache_stats_t stats;
+	mrcp_content_entry_t *entry;
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Test Size Cap");
+	entry = content_add(cache,"grammar-huge",&objects[3],TEST_CACHE_SIZE);
+	if(entry) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Content Larger than Cache Unexpectedly Cached");
+		mrcp_content_cache_release(cache,entry);
+		return FALSE;
+	}
+	/* the object remains owned by the caller */
+	if(destroy_count_test(&objects[3],0) != TRUE) {
+		return FALSE;
+	}
+
+	mrcp_content_cache_stats_get(cache,&stats);
+	if(stats.size > stats.max_size || stats.entry_count != 2) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Stats [%"APR_SIZE_T_FMT" entries %"APR_SIZE_T_FMT" bytes]",
+			stats.entry_count,
+			stats.size);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static apt_bool_t referenced_eviction_test(mrcp_content_cache_t *cache, cached_object_t *objects)
+{
+	mrcp_content_entry_t *held_entry;
+	mrcp_content_entry_t *entry;
+	const apt_str_t *body;
+	const char *bodies[] = {"grammar-d", "grammar-e"};
+	int i;
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Test Eviction of Referenced Entry");
+	/* hold the reference to the most recently used entry */
+	held_entry = content_find(cache,"grammar-c");
+	if(!held_entry) {
+		return FALSE;
+	}
+
+	/* replace all the cached entries */
+	for(i = 0; i < 2; i++) {
+		entry = content_add(cache,bodies[i],NULL,TEST_OBJECT_SIZE);
+		if(!entry) {
+			mrcp_content_cache_release(cache,held_entry);
+			return FALSE;
+		}
+		mrcp_content_cache_release(cache,entry);
+	}
+
+	/* the entry is evicted, but must stay valid until released, while the unreferenced one is destroyed */
+	if(content_cached_test(cache,"grammar-c",FALSE) != TRUE ||
+		destroy_count_test(&objects[2],0) != TRUE ||
+		destroy_count_test(&objects[0],1) != TRUE) {
+		mrcp_content_cache_release(cache,held_entry);
+		return FALSE;
+	}
+	body = mrcp_content_entry_body_get(held_entry);
+	if(mrcp_content_entry_object_get(held_entry) != &objects[2] ||
+		body->length != 9 || strncmp(body->buf,"grammar-c",body->length) != 0) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Evicted Entry Modified");
+		mrcp_content_cache_release(cache,held_entry);
+		return FALSE;
+	}
+
+	mrcp_content_cache_release(cache,held_entry);
+	return destroy_count_test(&objects[2],1);
+}
+
+static apt_bool_t content_cache_test_suite_run(apt_test_suite_t *suite, int argc, const char * const *argv)
+{
+	apt_bool_t status = FALSE;
+	cached_object_t *objects = apr_pcalloc(suite->pool,sizeof(cached_object_t) * TEST_OBJECT_COUNT);
+	mrcp_content_cache_t *cache = mrcp_content_cache_create(TEST_CACHE_SIZE,suite->pool);
+	if(!cache) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Content Cache");
+		return FALSE;
+	}
+
+	if(lru_eviction_test(cache,objects) == TRUE &&
+		size_cap_test(cache,objects) == TRUE &&
+		referenced_eviction_test(cache,objects) == TRUE) {
+		status = TRUE;
+	}
+
+	mrcp_content_cache_destroy(cache);
+	return status;
+}
+
+apt_test_suite_t* content_cache_test_suite_create(apr_pool_t *pool)
+{
+	apt_test_suite_t *suite = apt_test_suite_create(pool,"content-cache",NULL,content_cache_test_suite_run);
+	return suite;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include "apt_test_suite.h"
+#include "apt_log.h"
+#include "mrcp_frame_ring.h"
+
+#define TEST_RING_CAPACITY 4
+#define TEST_FRAME_SIZE    2
+
+/* Write frame filled with the specified value */
+static apt_bool_t frame_write(mrcp_frame_ring_t *ring, char value)
+{
+	mpf_frame_t *frame = mrcp_frame_ring_write_begin(ring);
+	if(!frame) {
+		return FALSE;
+	}
+	frame->type = MEDIA_FRAME_TYPE_AUDIO;
+	((char*)frame->codec_frame.buffer)[0] = value;
+	((char*)frame->codec_frame.buffer)[TEST_FRAME_SIZE - 1] = value;
+	mrcp_frame_ring_write_end(ring);
+	return TRUE;
+}
+
+/* Read frame and test it's filled with the specified value */
+static apt_bool_t frame_read(mrcp_frame_ring_t *ring, char value)
+{
+	const mpf_frame_t *frame = mrcp_frame_ring_read_begin(ring);
+	const char *buffer;
+	if(!frame) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"No Frame to Read [%c]",value);
+		return FALSE;
+	}
+	buffer = frame->codec_frame.buffer;
+	if(buffer[0] != value || buffer[TEST_FRAME_SIZE - 1] != value) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Frame [%c] (expected [%c])",buffer[0],value);
+		return FALSE;
+	}
+	mrcp_frame_ring_read_end(ring);
+	return TRUE;
+}
+
+/* Fill the ring up, then read the frames back */
+static apt_bool_t fill_drain_test(mrcp_frame_ring_t *ring, char first)
+{
+	char i;
+	for(i=0; i<TEST_RING_CAPACITY; i++) {
+		if(frame_write(ring,first + i) != TRUE) {
+			return FALSE;
+		}
+	}
+	/* the ring is full */
+	if(frame_write(ring,'x') != FALSE || mrcp_frame_ring_count_get(ring) != TEST_RING_CAPACITY) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Frame Written to Full Ring");
+		return FALSE;
+	}
+	for(i=0; i<TEST_RING_CAPACITY; i++) {
+		if(frame_read(ring,first + i) != TRUE) {
+			return FALSE;
+		}
+	}
+	/* the ring is empty */
+	if(mrcp_frame_ring_read_begin(ring) != NULL || mrcp_frame_ring_count_get(ring) != 0) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Frame Read from Empty Ring");
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static apt_bool_t frame_ring_test_suite_run(apt_test_suite_t *suite, int argc, const char * const *argv)
+{
+	apr_size_t i;
+	mrcp_frame_ring_t *ring = mrcp_frame_ring_create(TEST_RING_CAPACITY - 1,TEST_FRAME_SIZE,suite->pool);
+	if(!ring) {
+		return FALSE;
+	}
+	/* the capacity is rounded up to a power of two */
+	if(ring->capacity != TEST_RING_CAPACITY) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Ring Capacity [%u]",ring->capacity);
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Read from Empty Ring");
+	if(mrcp_frame_ring_read_begin(ring) != NULL) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Fill and Drain Ring");
+	if(fill_drain_test(ring,'a') != TRUE) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Wrap Around End of Ring");
+	/* interleave writes and reads, so that the entries wrap around the end of the ring */
+	for(i=0; i<TEST_RING_CAPACITY * 3; i++) {
+		if(frame_write(ring,'a' + (char)i) != TRUE || frame_write(ring,'A' + (char)i) != TRUE) {
+			return FALSE;
+		}
+		if(frame_read(ring,'a' + (char)i) != TRUE || frame_read(ring,'A' + (char)i) != TRUE) {
+			return FALSE;
+		}
+	}
+	if(fill_drain_test(ring,'k') != TRUE) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Wrap Around Counters");
+	/* the ring stays consistent, when the counters overflow */
+	ring->head = ring->tail = (apr_uint32_t)-2;
+	if(fill_drain_test(ring,'p') != TRUE) {
+		return FALSE;
+	}
+	if(ring->head != TEST_RING_CAPACITY - 2) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Reset Ring");
+	if(frame_write(ring,'z') != TRUE) {
+		return FALSE;
+	}
+	mrcp_frame_ring_reset(ring);
+	if(mrcp_frame_ring_read_begin(ring) != NULL) {
+		return FALSE;
+	}
+	return fill_drain_test(ring,'u');
+}
+
+apt_test_suite_t* frame_ring_test_suite_create(apr_pool_t *pool)
+{
+	apt_test_suite_t *suite = apt_test_suite_create(pool,"frame-ring",NULL,frame_ring_test_suite_run);
+	return suite;
+}
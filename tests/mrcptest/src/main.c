@@ -19,9 +19,17 @@
 #include "apt_test_suite.h"
 #include "apt_log.h"
 
+apt_test_suite_t* audio_batcher_test_suite_create(apr_pool_t *pool);
+apt_test_suite_t* content_cache_test_suite_create(apr_pool_t *pool);
+apt_test_suite_t* frame_ring_test_suite_create(apr_pool_t *pool);
+apt_test_suite_t* message_template_test_suite_create(apr_pool_t *pool);
 apt_test_suite_t* parse_gen_test_suite_create(apr_pool_t *pool);
+apt_test_suite_t* prompt_cache_test_suite_create(apr_pool_t *pool);
+apt_test_suite_t* property_store_test_suite_create(apr_pool_t *pool);
+apt_test_suite_t* sdp_test_suite_create(apr_pool_t *pool);
 apt_test_suite_t* set_get_test_suite_create(apr_pool_t *pool);
 apt_test_suite_t* transparent_set_get_test_suite_create(apr_pool_t *pool);
+apt_bool_t mrcp_benchmarks_add(apt_test_framework_t *framework);
 
 int main(int argc, const char * const *argv)
 {
@@ -45,6 +53,23 @@ int main(int argc, const char * const *argv)
 	apt_test_framework_suite_add(test_framework,test_suite);
 	test_suite = parse_gen_test_suite_create(pool);
 	apt_test_framework_suite_add(test_framework,test_suite);
+	test_suite = message_template_test_suite_create(pool);
+	apt_test_framework_suite_add(test_framework,test_suite);
+	test_suite = property_store_test_suite_create(pool);
+	apt_test_framework_suite_add(test_framework,test_suite);
+	test_suite = audio_batcher_test_suite_create(pool);
+	apt_test_framework_suite_add(test_framework,test_suite);
+	test_suite = frame_ring_test_suite_create(pool);
+	apt_test_framework_suite_add(test_framework,test_suite);
+	test_suite = content_cache_test_suite_create(pool);
+	apt_test_framework_suite_add(test_framework,test_suite);
+	test_suite = prompt_cache_test_suite_create(pool);
+	apt_test_framework_suite_add(test_framework,test_suite);
+	test_suite = sdp_test_suite_create(pool);
+	apt_test_framework_suite_add(test_framework,test_suite);
+
+	/* add benchmarks to test framework */
+	mrcp_benchmarks_add(test_framework);
 
 	/* run tests */
 	apt_test_framework_run(test_framework,argc,argv);
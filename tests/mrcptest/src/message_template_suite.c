@@ -0,0 +1,258 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include <string.h>
+#include "apt_test_suite.h"
+#include "apt_pool.h"
+#include "apt_log.h"
+/* common includes */
+#include "mrcp_resource_loader.h"
+#include "mrcp_resource_factory.h"
+#include "mrcp_message.h"
+#include "mrcp_stream.h"
+#include "mrcp_generic_header.h"
+/* synthesizer includes */
+#include "mrcp_synth_header.h"
+#include "mrcp_synth_resource.h"
+
+#define SAMPLE_SESSION_ID "32AECB23433802"
+#define SAMPLE_CONTENT_TYPE "application/ssml+xml"
+
+/* max body length, so that the message-length crosses the boundaries of 3 and 4 digits */
+#define MAX_BODY_LENGTH 1100
+#define MESSAGE_BUFFER_SIZE 2048
+
+/** Sample response or event, generated either from scratch or from the template */
+typedef struct {
+	const char          *name;
+	mrcp_message_type_e  message_type;
+	mrcp_method_id       event_id;
+	mrcp_status_code_e   status_code;
+	mrcp_request_state_e request_state;
+} message_sample_t;
+
+static const message_sample_t samples[] = {
+	{"200 COMPLETE",    MRCP_MESSAGE_TYPE_RESPONSE, 0,                          MRCP_STATUS_CODE_SUCCESS,       MRCP_REQUEST_STATE_COMPLETE},
+	{"200 IN-PROGRESS", MRCP_MESSAGE_TYPE_RESPONSE, 0,                          MRCP_STATUS_CODE_SUCCESS,       MRCP_REQUEST_STATE_INPROGRESS},
+	{"407 COMPLETE",    MRCP_MESSAGE_TYPE_RESPONSE, 0,                          MRCP_STATUS_CODE_METHOD_FAILED, MRCP_REQUEST_STATE_COMPLETE},
+	{"SPEECH-MARKER",   MRCP_MESSAGE_TYPE_EVENT,    SYNTHESIZER_SPEECH_MARKER,  MRCP_STATUS_CODE_UNKNOWN,       MRCP_REQUEST_STATE_INPROGRESS},
+	{"SPEAK-COMPLETE",  MRCP_MESSAGE_TYPE_EVENT,    SYNTHESIZER_SPEAK_COMPLETE, MRCP_STATUS_CODE_UNKNOWN,       MRCP_REQUEST_STATE_COMPLETE}
+};
+
+#define SAMPLE_COUNT (sizeof(samples) / sizeof(samples[0]))
+
+/* request-ids, which differ in the number of digits */
+static const mrcp_request_id request_ids[] = {1, 9, 10, 99, 100, 543257, 4294967295U};
+
+#define REQUEST_ID_COUNT (sizeof(request_ids) / sizeof(request_ids[0]))
+
+static char body_buffer[MAX_BODY_LENGTH];
+
+/* Create SPEAK request, the samples are created in response to */
+static mrcp_message_t* speak_request_create(mrcp_resource_factory_t *factory, apr_pool_t *pool)
+{
+	mrcp_message_t *message;
+	mrcp_resource_t *resource = mrcp_resource_get(factory,MRCP_SYNTHESIZER_RESOURCE);
+	if(!resource) {
+		return NULL;
+	}
+	message = mrcp_request_create(resource,MRCP_VERSION_2,SYNTHESIZER_SPEAK,pool);
+	if(!message) {
+		return NULL;
+	}
+	apt_string_assign(&message->channel_id.session_id,SAMPLE_SESSION_ID,message->pool);
+	return message;
+}
+
+/* Create sample response or event with the specified request-id and body length */
+static mrcp_message_t* sample_create(const message_sample_t *sample, const mrcp_message_t *request, mrcp_request_id request_id, apr_size_t body_length, apr_pool_t *pool)
+{
+	mrcp_message_t *message;
+	if(sample->message_type == MRCP_MESSAGE_TYPE_RESPONSE) {
+		message = mrcp_response_create(request,pool);
+		if(!message) {
+			return NULL;
+		}
+		message->start_line.status_code = sample->status_code;
+	}
+	else {
+		mrcp_synth_header_t *synth_header;
+		message = mrcp_event_create(request,sample->event_id,pool);
+		if(!message) {
+			return NULL;
+		}
+		if(sample->event_id == SYNTHESIZER_SPEAK_COMPLETE) {
+			synth_header = mrcp_resource_header_prepare(message);
+			if(synth_header) {
+				synth_header->completion_cause = SYNTHESIZER_COMPLETION_CAUSE_NORMAL;
+				mrcp_resource_header_property_add(message,SYNTHESIZER_HEADER_COMPLETION_CAUSE);
+			}
+		}
+	}
+	message->start_line.request_state = sample->request_state;
+	message->start_line.request_id = request_id;
+
+	if(body_length) {
+		mrcp_generic_header_t *generic_header = mrcp_generic_header_prepare(message);
+		if(generic_header) {
+			apt_string_assign(&generic_header->content_type,SAMPLE_CONTENT_TYPE,message->pool);
+			mrcp_generic_header_property_add(message,GENERIC_HEADER_CONTENT_TYPE);
+		}
+		apt_string_assign_n(&message->body,body_buffer,body_length,message->pool);
+	}
+	return message;
+}
+
+/* Generate the message into the specified buffer, the generated text may start past the beginning of the buffer */
+static apt_bool_t message_generate(mrcp_generator_t *generator, mrcp_message_t *message, char *buffer, apt_str_t *text)
+{
+	apt_text_stream_t stream;
+	apt_text_stream_init(&stream,buffer,MESSAGE_BUFFER_SIZE);
+	if(mrcp_generator_run(generator,message,&stream) != APT_MESSAGE_STATUS_COMPLETE) {
+		return FALSE;
+	}
+	text->buf = stream.text.buf;
+	text->length = stream.pos - stream.text.buf;
+	return TRUE;
+}
+
+/* Test whether the message generated from the template is equal to the message generated from scratch */
+static apt_bool_t template_output_test(mrcp_generator_t *generator, mrcp_message_t *message, const mrcp_start_line_template_t *tmpl, const char *name)
+{
+	char expected_buffer[MESSAGE_BUFFER_SIZE];
+	char generated_buffer[MESSAGE_BUFFER_SIZE];
+	apt_str_t expected;
+	apt_str_t generated;
+
+	message->start_line_template = NULL;
+	if(message_generate(generator,message,expected_buffer,&expected) == FALSE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Generate Message [%s]",name);
+		return FALSE;
+	}
+
+	message->start_line_template = tmpl;
+	if(message_generate(generator,message,generated_buffer,&generated) == FALSE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Generate Message from Template [%s]",name);
+		return FALSE;
+	}
+
+	if(generated.length != expected.length || memcmp(generated.buf,expected.buf,expected.length) != 0) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Message Generated from Template [%s] request-id %"MRCP_REQUEST_ID_FMT"\n%.*s\nexpected\n%.*s",
+			name,
+			message->start_line.request_id,
+			(int)generated.length,
+			generated.buf,
+			(int)expected.length,
+			expected.buf);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static apt_bool_t template_test_run(mrcp_generator_t *generator, const mrcp_message_t *request, apr_pool_t *pool)
+{
+	mrcp_start_line_template_t *templates[SAMPLE_COUNT];
+	mrcp_message_t *message;
+	apr_pool_t *message_pool;
+	apr_size_t i;
+	apr_size_t j;
+	apr_size_t k;
+	apr_size_t body_length;
+
+	/* render the templates from the first messages of the kind, like the server does per channel */
+	for(i=0; i<SAMPLE_COUNT; i++) {
+		message = sample_create(&samples[i],request,request_ids[0],0,pool);
+		if(!message || mrcp_message_validate(message) == FALSE) {
+			return FALSE;
+		}
+		templates[i] = mrcp_message_template_create(message,pool);
+		if(!templates[i]) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Template [%s]",samples[i].name);
+			return FALSE;
+		}
+	}
+
+	for(i=0; i<SAMPLE_COUNT; i++) {
+		apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Test Template Output [%s]",samples[i].name);
+		for(j=0; j<REQUEST_ID_COUNT; j++) {
+			for(body_length=0; body_length<=MAX_BODY_LENGTH; body_length++) {
+				message_pool = apt_subpool_create(pool);
+				message = sample_create(&samples[i],request,request_ids[j],body_length,message_pool);
+				if(!message) {
+					apr_pool_destroy(message_pool);
+					return FALSE;
+				}
+
+				/* the templates of other kinds don't match, the message is generated from scratch then */
+				for(k=0; k<SAMPLE_COUNT; k++) {
+					if(mrcp_start_line_template_match(templates[k],&message->start_line) != (k == i ? TRUE : FALSE)) {
+						apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Template Match [%s] [%s]",samples[k].name,samples[i].name);
+						apr_pool_destroy(message_pool);
+						return FALSE;
+					}
+					if(template_output_test(generator,message,templates[k],samples[i].name) == FALSE) {
+						apr_pool_destroy(message_pool);
+						return FALSE;
+					}
+				}
+				apr_pool_destroy(message_pool);
+			}
+		}
+	}
+	return TRUE;
+}
+
+static apt_bool_t message_template_test_suite_run(apt_test_suite_t *suite, int argc, const char * const *argv)
+{
+	apt_bool_t status;
+	mrcp_message_t *request;
+	mrcp_generator_t *generator;
+	mrcp_resource_factory_t *factory;
+	mrcp_resource_loader_t *resource_loader;
+	resource_loader = mrcp_resource_loader_create(TRUE,suite->pool);
+	if(!resource_loader) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Resource Loader");
+		return FALSE;
+	}
+
+	factory = mrcp_resource_factory_get(resource_loader);
+	if(!factory) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Resource Factory");
+		return FALSE;
+	}
+
+	request = speak_request_create(factory,suite->pool);
+	if(!request) {
+		mrcp_resource_factory_destroy(factory);
+		return FALSE;
+	}
+
+	memset(body_buffer,'x',sizeof(body_buffer));
+	generator = mrcp_generator_create(factory,suite->pool);
+	status = template_test_run(generator,request,suite->pool);
+
+	mrcp_resource_factory_destroy(factory);
+	return status;
+}
+
+apt_test_suite_t* message_template_test_suite_create(apr_pool_t *pool)
+{
+	apt_test_suite_t *suite = apt_test_suite_create(pool,"message-template",NULL,message_template_test_suite_run);
+	return suite;
+}
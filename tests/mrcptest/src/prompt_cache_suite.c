@@ -0,0 +1,286 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include <string.h>
+#include <apr_file_info.h>
+#include <apr_file_io.h>
+#include <apr_fnmatch.h>
+#include "apt_test_suite.h"
+#include "apt_log.h"
+#include "mrcp_prompt_cache.h"
+
+/* size of each rendered prompt */
+#define TEST_PROMPT_SIZE 1600
+/* max size of the cache, which holds two prompts but not three */
+#define TEST_CACHE_SIZE  4000
+/* size of the frame prompts are read by */
+#define TEST_FRAME_SIZE  160
+
+/* Initialize prompt key by the content */
+static void prompt_key_init(mrcp_prompt_key_t *key, const char *content)
+{
+	apt_string_set(&key->content,content);
+	apt_string_reset(&key->voice);
+	apt_string_reset(&key->rate);
+	apt_string_set(&key->codec,"LPCM/8000/1");
+}
+
+/* Render prompt filled with the last character of the content and store it to the cache */
+static apt_bool_t prompt_store(mrcp_prompt_cache_t *cache, const char *content)
+{
+	mrcp_prompt_key_t key;
+	mrcp_prompt_writer_t *writer;
+	mrcp_prompt_entry_t *entry;
+	char data[TEST_FRAME_SIZE];
+	apr_size_t size;
+
+	prompt_key_init(&key,content);
+	writer = mrcp_prompt_writer_create(cache,&key);
+	if(!writer) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Prompt Writer [%s]",content);
+		return FALSE;
+	}
+	memset(data,content[strlen(content) - 1],sizeof(data));
+	for(size = 0; size < TEST_PROMPT_SIZE; size += sizeof(data)) {
+		mrcp_prompt_writer_write(writer,data,sizeof(data));
+	}
+
+	entry = mrcp_prompt_writer_commit(writer);
+	if(!entry) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Commit Prompt [%s]",content);
+		return FALSE;
+	}
+	mrcp_prompt_cache_release(cache,entry);
+	return TRUE;
+}
+
+/* Find prompt by the content */
+static mrcp_prompt_entry_t* prompt_find(mrcp_prompt_cache_t *cache, const char *content)
+{
+	mrcp_prompt_key_t key;
+	prompt_key_init(&key,content);
+	return mrcp_prompt_cache_find(cache,&key);
+}
+
+/* Test whether the prompt is cached, releasing the found entry */
+static apt_bool_t prompt_cached_test(mrcp_prompt_cache_t *cache, const char *content, apt_bool_t expected)
+{
+	mrcp_prompt_entry_t *entry = prompt_find(cache,content);
+	if(entry) {
+		mrcp_prompt_cache_release(cache,entry);
+	}
+	if((entry ? TRUE : FALSE) != expected) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Prompt [%s] Unexpectedly %s",content,entry ? "Cached" : "Not Cached");
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* Test whether the whole prompt is read back as rendered */
+static apt_bool_t prompt_data_test(const mrcp_prompt_entry_t *entry, const char *content)
+{
+	mpf_frame_t frame;
+	char data[TEST_FRAME_SIZE];
+	char expected[TEST_FRAME_SIZE];
+	apr_size_t offset = 0;
+
+	memset(expected,content[strlen(content) - 1],sizeof(expected));
+	frame.codec_frame.buffer = data;
+	frame.codec_frame.size = sizeof(data);
+	while(offset < TEST_PROMPT_SIZE) {
+		frame.type = MEDIA_FRAME_TYPE_NONE;
+		if(mrcp_prompt_entry_frame_read(entry,&offset,&frame) != TRUE || memcmp(data,expected,sizeof(data)) != 0) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Prompt Data [%s] at %"APR_SIZE_T_FMT,content,offset);
+			return FALSE;
+		}
+	}
+	if(mrcp_prompt_entry_size_get(entry) != TEST_PROMPT_SIZE || mrcp_prompt_entry_frame_read(entry,&offset,&frame) == TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Prompt Size [%s]",content);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* Test the number of prompt files in the directory */
+static apt_bool_t prompt_file_count_test(const char *dir_path, apr_size_t expected, apr_pool_t *pool)
+{
+	apr_dir_t *dir;
+	apr_finfo_t finfo;
+	apr_size_t count = 0;
+	if(apr_dir_open(&dir,dir_path,pool) != APR_SUCCESS) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Open Directory [%s]",dir_path);
+		return FALSE;
+	}
+	while(apr_dir_read(&finfo,APR_FINFO_NAME,dir) == APR_SUCCESS) {
+		if(apr_fnmatch("prompt-*.pcm",finfo.name,0) == APR_SUCCESS) {
+			count++;
+		}
+	}
+	apr_dir_close(dir);
+
+	if(count != expected) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Number of Prompt Files: %"APR_SIZE_T_FMT" (expected %"APR_SIZE_T_FMT")",
+			count,
+			expected);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static apt_bool_t hit_miss_test(mrcp_prompt_cache_t *cache, const char *dir_path, apr_pool_t *pool)
+{
+	mrcp_prompt_entry_t *entry;
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Test Miss and Hit");
+	if(prompt_cached_test(cache,"prompt-a",FALSE) != TRUE) {
+		return FALSE;
+	}
+	if(prompt_store(cache,"prompt-a") != TRUE) {
+		return FALSE;
+	}
+
+	entry = prompt_find(cache,"prompt-a");
+	if(!entry) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Stored Prompt Not Found");
+		return FALSE;
+	}
+	if(prompt_data_test(entry,"prompt-a") != TRUE) {
+		mrcp_prompt_cache_release(cache,entry);
+		return FALSE;
+	}
+	mrcp_prompt_cache_release(cache,entry);
+
+	/* the prompt never stored must not match */
+	if(prompt_cached_test(cache,"prompt-b",FALSE) != TRUE) {
+		return FALSE;
+	}
+	return prompt_file_count_test(dir_path,1,pool);
+}
+
+static apt_bool_t lru_eviction_test(mrcp_prompt_cache_t *cache, const char *dir_path, apr_pool_t *pool)
+{
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Test LRU Eviction");
+	if(prompt_store(cache,"prompt-b") != TRUE) {
+		return FALSE;
+	}
+
+	/* use the first prompt, so that the second one becomes the least recently used */
+	if(prompt_cached_test(cache,"prompt-a",TRUE) != TRUE) {
+		return FALSE;
+	}
+
+	if(prompt_store(cache,"prompt-c") != TRUE) {
+		return FALSE;
+	}
+
+	if(prompt_cached_test(cache,"prompt-b",FALSE) != TRUE ||
+		prompt_cached_test(cache,"prompt-a",TRUE) != TRUE ||
+		prompt_cached_test(cache,"prompt-c",TRUE) != TRUE) {
+		return FALSE;
+	}
+	/* the file of the evicted prompt is removed */
+	return prompt_file_count_test(dir_path,2,pool);
+}
+
+static apt_bool_t referenced_eviction_test(mrcp_prompt_cache_t *cache, const char *dir_path, apr_pool_t *pool)
+{
+	mrcp_prompt_entry_t *held_entry;
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Test Eviction of Referenced Prompt");
+	/* hold the reference to the most recently used prompt */
+	held_entry = prompt_find(cache,"prompt-c");
+	if(!held_entry) {
+		return FALSE;
+	}
+
+	/* replace all the cached prompts */
+	if(prompt_store(cache,"prompt-d") != TRUE || prompt_store(cache,"prompt-e") != TRUE) {
+		mrcp_prompt_cache_release(cache,held_entry);
+		return FALSE;
+	}
+
+	/* the prompt is evicted, but must stay readable until released */
+	if(prompt_cached_test(cache,"prompt-c",FALSE) != TRUE ||
+		prompt_data_test(held_entry,"prompt-c") != TRUE ||
+		prompt_file_count_test(dir_path,3,pool) != TRUE) {
+		mrcp_prompt_cache_release(cache,held_entry);
+		return FALSE;
+	}
+
+	mrcp_prompt_cache_release(cache,held_entry);
+	return prompt_file_count_test(dir_path,2,pool);
+}
+
+static apt_bool_t referenced_destroy_test(mrcp_prompt_cache_t *cache, const char *dir_path, apr_pool_t *pool)
+{
+	mrcp_prompt_entry_t *held_entry;
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Test Destroy with Evicted Referenced Prompt");
+	held_entry = prompt_find(cache,"prompt-d");
+	if(!held_entry) {
+		return FALSE;
+	}
+	if(prompt_store(cache,"prompt-f") != TRUE || prompt_store(cache,"prompt-g") != TRUE) {
+		mrcp_prompt_cache_release(cache,held_entry);
+		return FALSE;
+	}
+	if(prompt_cached_test(cache,"prompt-d",FALSE) != TRUE ||
+		prompt_file_count_test(dir_path,3,pool) != TRUE) {
+		mrcp_prompt_cache_release(cache,held_entry);
+		return FALSE;
+	}
+
+	/* the evicted prompt is not released, the cache must remove its file anyway */
+	mrcp_prompt_cache_destroy(cache);
+	return prompt_file_count_test(dir_path,0,pool);
+}
+
+static apt_bool_t prompt_cache_test_suite_run(apt_test_suite_t *suite, int argc, const char * const *argv)
+{
+	const char *temp_dir_path;
+	char *dir_path;
+	mrcp_prompt_cache_t *cache;
+	if(apr_temp_dir_get(&temp_dir_path,suite->pool) != APR_SUCCESS ||
+		apr_filepath_merge(&dir_path,temp_dir_path,"mrcptest-prompts",APR_FILEPATH_NATIVE,suite->pool) != APR_SUCCESS) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Compose Prompt Directory");
+		return FALSE;
+	}
+
+	cache = mrcp_prompt_cache_create(dir_path,TEST_CACHE_SIZE,suite->pool);
+	if(!cache) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Prompt Cache");
+		return FALSE;
+	}
+
+	if(hit_miss_test(cache,dir_path,suite->pool) != TRUE ||
+		lru_eviction_test(cache,dir_path,suite->pool) != TRUE ||
+		referenced_eviction_test(cache,dir_path,suite->pool) != TRUE) {
+		mrcp_prompt_cache_destroy(cache);
+		return FALSE;
+	}
+
+	/* the cache is destroyed by the test */
+	return referenced_destroy_test(cache,dir_path,suite->pool);
+}
+
+apt_test_suite_t* prompt_cache_test_suite_create(apr_pool_t *pool)
+{
+	apt_test_suite_t *suite = apt_test_suite_create(pool,"prompt-cache",NULL,prompt_cache_test_suite_run);
+	return suite;
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+#include "apt_test_suite.h"
+#include "apt_log.h"
+/* common includes */
+#include "mrcp_resource_loader.h"
+#include "mrcp_resource_factory.h"
+#include "mrcp_message.h"
+#include "mrcp_generic_header.h"
+#include "mrcp_property_store.h"
+/* synthesizer includes */
+#include "mrcp_synth_header.h"
+#include "mrcp_synth_resource.h"
+
+#define INITIAL_VOICE_AGE 28
+#define UPDATED_VOICE_AGE 35
+
+/* Create request of the specified method */
+static mrcp_message_t* request_create(mrcp_resource_t *resource, mrcp_method_id method_id, mrcp_request_id request_id, apr_pool_t *pool)
+{
+	mrcp_message_t *message = mrcp_request_create(resource,MRCP_VERSION_2,method_id,pool);
+	if(message) {
+		message->start_line.request_id = request_id;
+	}
+	return message;
+}
+
+/* Create SET-PARAMS request with Voice-Age */
+static mrcp_message_t* set_params_request_create(mrcp_resource_t *resource, mrcp_request_id request_id, apr_size_t voice_age, apr_pool_t *pool)
+{
+	mrcp_synth_header_t *synth_header;
+	mrcp_message_t *message = request_create(resource,SYNTHESIZER_SET_PARAMS,request_id,pool);
+	if(!message) {
+		return NULL;
+	}
+	synth_header = mrcp_resource_header_prepare(message);
+	if(!synth_header) {
+		return NULL;
+	}
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Set Voice-Age: %"APR_SIZE_T_FMT,voice_age);
+	synth_header->voice_param.age = voice_age;
+	mrcp_resource_header_property_add(message,SYNTHESIZER_HEADER_VOICE_AGE);
+	return message;
+}
+
+/* Test Voice-Age of the message */
+static apt_bool_t voice_age_test(mrcp_message_t *message, apr_size_t voice_age)
+{
+	mrcp_synth_header_t *synth_header = mrcp_resource_header_get(message);
+	if(!synth_header || mrcp_resource_header_property_check(message,SYNTHESIZER_HEADER_VOICE_AGE) != TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"No Voice-Age Found");
+		return FALSE;
+	}
+	if(synth_header->voice_param.age != voice_age) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Unexpected Voice-Age: %"APR_SIZE_T_FMT,synth_header->voice_param.age);
+		return FALSE;
+	}
+	apt_log(APT_LOG_MARK,APT_PRIO_INFO,"Get Voice-Age: %"APR_SIZE_T_FMT,synth_header->voice_param.age);
+	return TRUE;
+}
+
+static apt_bool_t property_store_test_run(apt_test_suite_t *suite, mrcp_resource_t *resource)
+{
+	mrcp_message_t *message;
+	mrcp_message_t *speak;
+	mrcp_message_t *response;
+	mrcp_property_store_t *store = mrcp_property_store_create(
+			mrcp_generic_header_vtable_get(MRCP_VERSION_2),
+			mrcp_synth_header_vtable_get(MRCP_VERSION_2),
+			suite->pool);
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Set Initial Properties");
+	message = set_params_request_create(resource,1,INITIAL_VOICE_AGE,suite->pool);
+	if(!message || mrcp_property_store_set(store,message) != TRUE) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Inherit Properties by SPEAK Request");
+	speak = request_create(resource,SYNTHESIZER_SPEAK,2,suite->pool);
+	if(!speak || mrcp_property_store_inherit(store,speak) != TRUE || voice_age_test(speak,INITIAL_VOICE_AGE) != TRUE) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Update Properties while SPEAK Request is in Progress");
+	message = set_params_request_create(resource,3,UPDATED_VOICE_AGE,suite->pool);
+	if(!message || mrcp_property_store_set(store,message) != TRUE) {
+		return FALSE;
+	}
+	/* the previous snapshot has been reclaimed, the in-progress request must keep its own copy of the initial properties */
+	if(voice_age_test(speak,INITIAL_VOICE_AGE) != TRUE) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Get Updated Properties");
+	message = request_create(resource,SYNTHESIZER_GET_PARAMS,4,suite->pool);
+	if(!message) {
+		return FALSE;
+	}
+	mrcp_resource_header_name_property_add(message,SYNTHESIZER_HEADER_VOICE_AGE);
+	response = mrcp_response_create(message,suite->pool);
+	if(!response || mrcp_property_store_get(store,response,message) != TRUE || voice_age_test(response,UPDATED_VOICE_AGE) != TRUE) {
+		return FALSE;
+	}
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Destroy Store while SPEAK Request is in Progress");
+	mrcp_property_store_destroy(store);
+	/* the inherited properties must outlive the store */
+	return voice_age_test(speak,INITIAL_VOICE_AGE);
+}
+
+static apt_bool_t property_store_test_suite_run(apt_test_suite_t *suite, int argc, const char * const *argv)
+{
+	apt_bool_t status;
+	mrcp_resource_t *resource;
+	mrcp_resource_factory_t *factory;
+	mrcp_resource_loader_t *resource_loader;
+	resource_loader = mrcp_resource_loader_create(TRUE,suite->pool);
+	if(!resource_loader) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Resource Loader");
+		return FALSE;
+	}
+	
+	factory = mrcp_resource_factory_get(resource_loader);
+	if(!factory) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Resource Factory");
+		return FALSE;
+	}
+
+	resource = mrcp_resource_get(factory,MRCP_SYNTHESIZER_RESOURCE);
+	if(!resource) {
+		mrcp_resource_factory_destroy(factory);
+		return FALSE;
+	}
+
+	status = property_store_test_run(suite,resource);
+	
+	mrcp_resource_factory_destroy(factory);
+	return status;
+}
+
+apt_test_suite_t* property_store_test_suite_create(apr_pool_t *pool)
+{
+	apt_test_suite_t *suite = apt_test_suite_create(pool,"property-store",NULL,property_store_test_suite_run);
+	return suite;
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright 2008-2014 Arsen Chaloyan
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * $Id$
+ */
+
+
+#include <string.h>
+#include <sofia-sip/su_alloc.h>
+#include <sofia-sip/sdp.h>
+#include "apt_test_suite.h"
+#include "apt_log.h"
+#include "mrcp_sdp.h"
+#include "mrcp_session_descriptor.h"
+#include "mrcp_control_descriptor.h"
+#include "mpf_rtp_descriptor.h"
+
+/* SDP offer of the client */
+static const char *sdp_offer =
+	"v=0\r\n"
+	"o=UniMRCPClient 0 0 IN IP4 10.0.0.1\r\n"
+	"s=-\r\n"
+	"c=IN IP4 10.0.0.1\r\n"
+	"t=0 0\r\n"
+	"m=application 9 TCP/MRCPv2 1\r\n"
+	"a=setup:active\r\n"
+	"a=connection:new\r\n"
+	"a=resource:speechrecog\r\n"
+	"a=cmid:1\r\n"
+	"m=audio 4000 RTP/AVP 0 8 96 101\r\n"
+	"a=rtpmap:0 PCMU/8000\r\n"
+	"a=rtpmap:96 L16/8000/1\r\n"
+	"a=rtpmap:101 telephone-event/8000\r\n"
+	"a=fmtp:101 0-15\r\n"
+	"a=sendonly\r\n"
+	"a=ptime:20\r\n"
+	"a=mid:1\r\n";
+
+/* SDP answer of the server */
+static const char *sdp_answer =
+	"v=0\r\n"
+	"o=UniMRCPServer 0 0 IN IP4 10.0.0.2\r\n"
+	"s=-\r\n"
+	"c=IN IP4 10.0.0.2\r\n"
+	"t=0 0\r\n"
+	"m=application 1544 TCP/MRCPv2 1\r\n"
+	"a=setup:passive\r\n"
+	"a=connection:new\r\n"
+	"a=channel:6a8b0d2c@speechrecog\r\n"
+	"a=cmid:1\r\n"
+	"m=audio 5000 RTP/AVP 0 101\r\n"
+	"c=IN IP4 10.0.0.3\r\n"
+	"a=rtpmap:0 PCMU/8000\r\n"
+	"a=rtpmap:101 telephone-event/8000\r\n"
+	"a=recvonly\r\n"
+	"a=mid:1\r\n";
+
+/* SDP offer having runs of whitespace in m-lines */
+static const char *sdp_offer_whitespace =
+	"v=0\r\n"
+	"o=UniMRCPClient 0 0 IN IP4 10.0.0.1\r\n"
+	"s=-\r\n"
+	"c=IN IP4 10.0.0.1\r\n"
+	"t=0 0\r\n"
+	"m=application  9 TCP/MRCPv2 1\r\n"
+	"a=setup:active\r\n"
+	"a=connection:existing\r\n"
+	"a=resource:speechsynth\r\n"
+	"a=cmid:1\r\n"
+	"m=audio 4000  RTP/AVP 0  8 \t 96   101 \r\n"
+	"a=rtpmap:96 L16/8000\r\n"
+	"a=rtpmap:101 telephone-event/8000\r\n"
+	"a=mid:1\r\n";
+
+/* Compare strings (case sensitive, empty strings are equal) */
+static apt_bool_t sdp_str_compare(const apt_str_t *str1, const apt_str_t *str2)
+{
+	if(str1->length != str2->length) {
+		return FALSE;
+	}
+	if(!str1->length) {
+		return TRUE;
+	}
+	return (memcmp(str1->buf,str2->buf,str1->length) == 0) ? TRUE : FALSE;
+}
+
+/* Compare RTP media descriptors generated by the fast-path scanner and the full parser */
+static apt_bool_t rtp_media_compare(const mpf_rtp_media_descriptor_t *media1, const mpf_rtp_media_descriptor_t *media2)
+{
+	int i;
+	const mpf_codec_descriptor_t *codec1;
+	const mpf_codec_descriptor_t *codec2;
+	const apr_array_header_t *codec_arr1 = media1->codec_list.descriptor_arr;
+	const apr_array_header_t *codec_arr2 = media2->codec_list.descriptor_arr;
+	if(media1->id != media2->id || media1->state != media2->state || media1->port != media2->port ||
+		media1->direction != media2->direction || media1->ptime != media2->ptime || media1->mid != media2->mid ||
+		sdp_str_compare(&media1->ip,&media2->ip) != TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"RTP Media Mismatch [%"APR_SIZE_T_FMT"]",media1->id);
+		return FALSE;
+	}
+
+	if(codec_arr1->nelts != codec_arr2->nelts) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Codec Count Mismatch [%d] [%d]",codec_arr1->nelts,codec_arr2->nelts);
+		return FALSE;
+	}
+	for(i = 0; i < codec_arr1->nelts; i++) {
+		codec1 = &APR_ARRAY_IDX(codec_arr1,i,mpf_codec_descriptor_t);
+		codec2 = &APR_ARRAY_IDX(codec_arr2,i,mpf_codec_descriptor_t);
+		if(codec1->payload_type != codec2->payload_type || codec1->sampling_rate != codec2->sampling_rate ||
+			codec1->channel_count != codec2->channel_count || sdp_str_compare(&codec1->name,&codec2->name) != TRUE) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Codec Mismatch [%d] [%d]",codec1->payload_type,codec2->payload_type);
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/* Compare arrays of RTP media descriptors */
+static apt_bool_t rtp_media_arr_compare(const apr_array_header_t *media_arr1, const apr_array_header_t *media_arr2)
+{
+	int i;
+	if(media_arr1->nelts != media_arr2->nelts) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"RTP Media Count Mismatch [%d] [%d]",media_arr1->nelts,media_arr2->nelts);
+		return FALSE;
+	}
+	for(i = 0; i < media_arr1->nelts; i++) {
+		if(rtp_media_compare(
+				APR_ARRAY_IDX(media_arr1,i,mpf_rtp_media_descriptor_t*),
+				APR_ARRAY_IDX(media_arr2,i,mpf_rtp_media_descriptor_t*)) != TRUE) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/* Compare control media descriptors */
+static apt_bool_t control_media_compare(const mrcp_control_descriptor_t *media1, const mrcp_control_descriptor_t *media2)
+{
+	int i;
+	if(media1->id != media2->id || media1->port != media2->port || media1->proto != media2->proto ||
+		media1->setup_type != media2->setup_type || media1->connection_type != media2->connection_type ||
+		sdp_str_compare(&media1->ip,&media2->ip) != TRUE ||
+		sdp_str_compare(&media1->resource_name,&media2->resource_name) != TRUE ||
+		sdp_str_compare(&media1->session_id,&media2->session_id) != TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Control Media Mismatch [%"APR_SIZE_T_FMT"]",media1->id);
+		return FALSE;
+	}
+
+	if(media1->cmid_arr->nelts != media2->cmid_arr->nelts) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Cmid Count Mismatch [%d] [%d]",media1->cmid_arr->nelts,media2->cmid_arr->nelts);
+		return FALSE;
+	}
+	for(i = 0; i < media1->cmid_arr->nelts; i++) {
+		if(APR_ARRAY_IDX(media1->cmid_arr,i,apr_size_t) != APR_ARRAY_IDX(media2->cmid_arr,i,apr_size_t)) {
+			apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Cmid Mismatch");
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/* Compare session descriptors */
+static apt_bool_t descriptor_compare(const mrcp_session_descriptor_t *descriptor1, const mrcp_session_descriptor_t *descriptor2)
+{
+	int i;
+	if(sdp_str_compare(&descriptor1->ip,&descriptor2->ip) != TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Session IP Mismatch");
+		return FALSE;
+	}
+
+	if(descriptor1->control_media_arr->nelts != descriptor2->control_media_arr->nelts) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Control Media Count Mismatch [%d] [%d]",
+			descriptor1->control_media_arr->nelts,
+			descriptor2->control_media_arr->nelts);
+		return FALSE;
+	}
+	for(i = 0; i < descriptor1->control_media_arr->nelts; i++) {
+		if(control_media_compare(
+				APR_ARRAY_IDX(descriptor1->control_media_arr,i,mrcp_control_descriptor_t*),
+				APR_ARRAY_IDX(descriptor2->control_media_arr,i,mrcp_control_descriptor_t*)) != TRUE) {
+			return FALSE;
+		}
+	}
+
+	if(rtp_media_arr_compare(descriptor1->audio_media_arr,descriptor2->audio_media_arr) != TRUE) {
+		return FALSE;
+	}
+	return rtp_media_arr_compare(descriptor1->video_media_arr,descriptor2->video_media_arr);
+}
+
+/* Generate descriptors by the fast-path scanner and the full parser and compare them */
+static apt_bool_t sdp_parse_compare(const char *name, const char *sdp_str, su_home_t *home, apr_pool_t *pool)
+{
+	apt_bool_t status;
+	sdp_parser_t *parser;
+	mrcp_session_descriptor_t *fast_descriptor = mrcp_session_descriptor_create(pool);
+	mrcp_session_descriptor_t *full_descriptor = mrcp_session_descriptor_create(pool);
+
+	apt_log(APT_LOG_MARK,APT_PRIO_NOTICE,"Compare Parsed SDP [%s]",name);
+	if(mrcp_descriptor_generate_by_sdp_string(fast_descriptor,sdp_str,strlen(sdp_str),NULL,pool) != TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"SDP Not Taken by Fast-Path Scanner [%s]",name);
+		return FALSE;
+	}
+
+	parser = sdp_parse(home,sdp_str,(int)strlen(sdp_str),0);
+	status = mrcp_descriptor_generate_by_sdp_session(full_descriptor,sdp_session(parser),NULL,pool);
+	sdp_parser_free(parser);
+	if(status != TRUE) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Parse SDP [%s]",name);
+		return FALSE;
+	}
+
+	return descriptor_compare(fast_descriptor,full_descriptor);
+}
+
+static apt_bool_t sdp_test_suite_run(apt_test_suite_t *suite, int argc, const char * const *argv)
+{
+	apt_bool_t status = FALSE;
+	su_home_t *home = su_home_new(sizeof(*home));
+	if(!home) {
+		apt_log(APT_LOG_MARK,APT_PRIO_WARNING,"Failed to Create Sofia-SIP Home");
+		return FALSE;
+	}
+
+	if(sdp_parse_compare("offer",sdp_offer,home,suite->pool) == TRUE &&
+		sdp_parse_compare("answer",sdp_answer,home,suite->pool) == TRUE &&
+		sdp_parse_compare("offer-whitespace",sdp_offer_whitespace,home,suite->pool) == TRUE) {
+		status = TRUE;
+	}
+
+	su_home_unref(home);
+	return status;
+}
+
+apt_test_suite_t* sdp_test_suite_create(apr_pool_t *pool)
+{
+	apt_test_suite_t *suite = apt_test_suite_create(pool,"sdp",NULL,sdp_test_suite_run);
+	return suite;
+}